@@ -0,0 +1,555 @@
+#include "AssetRegistry.hpp"
+#include <stb_image.h>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <utility>
+
+#include "core/JobSystem.hpp"
+#include "systems/RenderingSystem/RenderResources.hpp"
+
+AssetRegistry gAssetRegistry;
+
+struct AssetRegistry::Entry
+{
+    std::atomic<uint32_t> id{0};  // published last; 0 while the slot is unused
+    AssetType type{AssetType::Mesh};
+    std::string path;  // canonical
+    std::atomic<AssetState> state{AssetState::Unloaded};
+    std::atomic<uint64_t> contentHash{0};
+    std::atomic<unsigned> glTexture{0};
+    std::atomic<uint32_t> alias{0};  // texture with the same bytes that holds the GL copy for this one
+    // Guarded by the shard mutex of the id.
+    uint32_t users{0};
+    size_t gpuBytes{0};
+    std::vector<uint32_t> dependencies;  // meshes: the textures they hold
+};
+
+// A spelling of a path: the canonical one, or one a caller registered with.
+struct AssetRegistry::Key
+{
+    uint64_t hash;
+    AssetType type;
+    std::string path;
+    Entry* entry;
+};
+
+// Open addressing, insert only, at most half full. Readers probe whichever
+// table they loaded; a grown table replaces it, and the outgrown one stays
+// alive with the shard.
+struct AssetRegistry::Table
+{
+    explicit Table(size_t capacity) : mask(capacity - 1), slots(new std::atomic<Key*>[capacity])
+    {
+        for (size_t i = 0; i < capacity; ++i) slots[i].store(nullptr, std::memory_order_relaxed);
+    }
+
+    void Place(Key* key)
+    {
+        size_t i = key->hash & mask;
+        while (slots[i].load(std::memory_order_relaxed)) i = (i + 1) & mask;
+        slots[i].store(key, std::memory_order_release);
+        ++count;
+    }
+
+    size_t mask;
+    size_t count{0};
+    std::unique_ptr<std::atomic<Key*>[]> slots;
+};
+
+struct AssetRegistry::Shard
+{
+    // Inserts of keys hashing to this shard, and changes to entries whose id
+    // falls in it. Never held while taking another shard's mutex.
+    std::mutex mutex;
+    std::atomic<Table*> table{nullptr};
+    std::vector<std::unique_ptr<Table>> tables;  // current one last
+    std::vector<std::unique_ptr<Key>> keys;
+};
+
+struct AssetRegistry::DecodedTexture
+{
+    uint32_t id{0};
+    TextureUpload upload;
+
+    ~DecodedTexture() { stbi_image_free(const_cast<unsigned char*>(upload.pixels)); }
+};
+
+namespace
+{
+constexpr size_t TypeIndex(AssetType type) { return static_cast<size_t>(type); }
+
+uint64_t KeyHash(AssetType type, const std::string& path)
+{
+    return AssetRegistry::HashBytes(path.data(), path.size(), 14695981039346656037ull ^ (uint64_t(type) + 1));
+}
+
+bool IsLoaded(AssetState state)
+{
+    return state == AssetState::Queued || state == AssetState::Loading || state == AssetState::Resident;
+}
+
+const std::string& EmptyPath()
+{
+    static const std::string empty;
+    return empty;
+}
+}
+
+AssetRegistry::AssetRegistry() : m_shards(new Shard[SHARD_COUNT])
+{
+    for (uint32_t s = 0; s < SHARD_COUNT; ++s)
+    {
+        m_shards[s].tables.push_back(std::make_unique<Table>(64));
+        m_shards[s].table.store(m_shards[s].tables.back().get(), std::memory_order_release);
+    }
+    for (auto& segments : m_segments)
+        for (auto& segment : segments) segment.store(nullptr, std::memory_order_relaxed);
+    for (auto& next : m_nextId) next.store(1, std::memory_order_relaxed);
+}
+
+AssetRegistry::~AssetRegistry()
+{
+    for (auto& segments : m_segments)
+        for (auto& segment : segments) delete[] segment.load(std::memory_order_relaxed);
+}
+
+AssetRegistry::Shard& AssetRegistry::ShardOf(uint32_t id) const
+{
+    return m_shards[id % SHARD_COUNT];
+}
+
+std::string AssetRegistry::CanonicalPath(const std::string& path)
+{
+    if (path.empty() || path.rfind("AARTZE:", 0) == 0) return path;
+    std::error_code ec;
+    const std::filesystem::path absolute = std::filesystem::absolute(path, ec);
+    if (ec) return path;
+    const std::filesystem::path canonical = std::filesystem::weakly_canonical(absolute, ec);
+    std::string result = (ec ? absolute.lexically_normal() : canonical).generic_string();
+#ifdef _WIN32
+    for (char& c : result) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+#endif
+    return result;
+}
+
+uint64_t AssetRegistry::HashBytes(const void* data, size_t size, uint64_t seed)
+{
+    // FNV-1a over 8-byte words, then the tail bytes.
+    constexpr uint64_t PRIME = 1099511628211ull;
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    uint64_t hash = seed;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, bytes + i, 8);
+        hash = (hash ^ word) * PRIME;
+        hash ^= hash >> 32;
+    }
+    for (; i < size; ++i) hash = (hash ^ bytes[i]) * PRIME;
+    return hash;
+}
+
+const AssetRegistry::Key* AssetRegistry::Lookup(AssetType type, const std::string& key) const
+{
+    const uint64_t hash = KeyHash(type, key);
+    const Table* table = m_shards[hash >> 60].table.load(std::memory_order_acquire);
+    for (size_t i = hash & table->mask;; i = (i + 1) & table->mask)
+    {
+        const Key* slot = table->slots[i].load(std::memory_order_acquire);
+        if (!slot) return nullptr;
+        if (slot->hash == hash && slot->type == type && slot->path == key) return slot;
+    }
+}
+
+AssetRegistry::Entry* AssetRegistry::Insert(AssetType type, const std::string& key, Entry* entry)
+{
+    const uint64_t hash = KeyHash(type, key);
+    Shard& shard = m_shards[hash >> 60];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (const Key* existing = Lookup(type, key)) return existing->entry;
+
+    if (!entry)
+    {
+        const uint32_t id = m_nextId[TypeIndex(type)].fetch_add(1, std::memory_order_relaxed);
+        const uint32_t segment = id / SEGMENT_SIZE;
+        if (segment >= MAX_SEGMENTS)
+        {
+            std::cerr << "AssetRegistry: out of ids registering " << key << std::endl;
+            return nullptr;
+        }
+        std::atomic<Entry*>& slot = m_segments[TypeIndex(type)][segment];
+        Entry* entries = slot.load(std::memory_order_acquire);
+        if (!entries)
+        {
+            // Another shard may be allocating the same segment.
+            Entry* fresh = new Entry[SEGMENT_SIZE];
+            if (slot.compare_exchange_strong(entries, fresh, std::memory_order_acq_rel))
+                entries = fresh;
+            else
+                delete[] fresh;
+        }
+        entry = &entries[id % SEGMENT_SIZE];
+        entry->type = type;
+        entry->path = key;
+        entry->id.store(id, std::memory_order_release);
+    }
+
+    Table* table = shard.table.load(std::memory_order_relaxed);
+    if ((table->count + 1) * 2 > table->mask + 1)
+    {
+        auto grown = std::make_unique<Table>((table->mask + 1) * 2);
+        for (size_t i = 0; i <= table->mask; ++i)
+            if (Key* k = table->slots[i].load(std::memory_order_relaxed)) grown->Place(k);
+        table = grown.get();
+        shard.tables.push_back(std::move(grown));
+        shard.table.store(table, std::memory_order_release);
+    }
+    shard.keys.push_back(std::make_unique<Key>(Key{hash, type, key, entry}));
+    table->Place(shard.keys.back().get());
+    return entry;
+}
+
+uint32_t AssetRegistry::Register(AssetType type, const std::string& path)
+{
+    if (path.empty()) return 0;
+    // Known spellings skip canonicalization and its filesystem calls.
+    if (const Key* key = Lookup(type, path)) return key->entry->id.load(std::memory_order_relaxed);
+    const std::string canonical = CanonicalPath(path);
+    Entry* entry = Insert(type, canonical, nullptr);
+    if (!entry) return 0;
+    if (canonical != path) Insert(type, path, entry);
+    return entry->id.load(std::memory_order_relaxed);
+}
+
+uint32_t AssetRegistry::Find(AssetType type, const std::string& path) const
+{
+    if (path.empty()) return 0;
+    const Key* key = Lookup(type, path);
+    if (!key) key = Lookup(type, CanonicalPath(path));
+    return key ? key->entry->id.load(std::memory_order_relaxed) : 0;
+}
+
+AssetRegistry::Entry* AssetRegistry::Get(AssetType type, uint32_t id) const
+{
+    if (id == 0 || id / SEGMENT_SIZE >= MAX_SEGMENTS) return nullptr;
+    Entry* entries = m_segments[TypeIndex(type)][id / SEGMENT_SIZE].load(std::memory_order_acquire);
+    if (!entries) return nullptr;
+    Entry* entry = &entries[id % SEGMENT_SIZE];
+    return entry->id.load(std::memory_order_acquire) == id ? entry : nullptr;
+}
+
+const std::string& AssetRegistry::Path(MeshHandle mesh) const
+{
+    const Entry* entry = Get(AssetType::Mesh, mesh.id);
+    return entry ? entry->path : EmptyPath();
+}
+
+const std::string& AssetRegistry::Path(TextureHandle texture) const
+{
+    const Entry* entry = Get(AssetType::Texture, texture.id);
+    return entry ? entry->path : EmptyPath();
+}
+
+AssetState AssetRegistry::State(MeshHandle mesh) const
+{
+    const Entry* entry = Get(AssetType::Mesh, mesh.id);
+    return entry ? entry->state.load(std::memory_order_acquire) : AssetState::Unloaded;
+}
+
+AssetState AssetRegistry::State(TextureHandle texture) const
+{
+    const Entry* entry = Get(AssetType::Texture, texture.id);
+    if (!entry) return AssetState::Unloaded;
+    if (const uint32_t owner = entry->alias.load(std::memory_order_acquire)) return State(TextureHandle{owner});
+    return entry->state.load(std::memory_order_acquire);
+}
+
+void AssetRegistry::SetState(MeshHandle mesh, AssetState state)
+{
+    Entry* entry = Get(AssetType::Mesh, mesh.id);
+    if (!entry) return;
+    std::vector<uint32_t> released;
+    {
+        std::lock_guard<std::mutex> lock(ShardOf(mesh.id).mutex);
+        entry->state.store(state, std::memory_order_release);
+        if (!IsLoaded(state)) released.swap(entry->dependencies);
+    }
+    for (uint32_t texture : released) ReleaseTexture(TextureHandle{texture});
+}
+
+TextureHandle AssetRegistry::AddDependency(MeshHandle mesh, const std::string& texturePath)
+{
+    const TextureHandle texture = RegisterTexture(texturePath);
+    Entry* entry = Get(AssetType::Mesh, mesh.id);
+    if (!entry || !texture) return texture;
+    {
+        std::lock_guard<std::mutex> lock(ShardOf(mesh.id).mutex);
+        if (!IsLoaded(entry->state.load(std::memory_order_relaxed))) return texture;
+        auto& dependencies = entry->dependencies;
+        if (std::find(dependencies.begin(), dependencies.end(), texture.id) != dependencies.end()) return texture;
+        dependencies.push_back(texture.id);
+    }
+    RequestTexture(texture);
+    return texture;
+}
+
+std::vector<TextureHandle> AssetRegistry::Dependencies(MeshHandle mesh) const
+{
+    std::vector<TextureHandle> out;
+    const Entry* entry = Get(AssetType::Mesh, mesh.id);
+    if (!entry) return out;
+    std::lock_guard<std::mutex> lock(ShardOf(mesh.id).mutex);
+    for (uint32_t texture : entry->dependencies) out.push_back(TextureHandle{texture});
+    return out;
+}
+
+bool AssetRegistry::IsFullyResident(MeshHandle mesh) const
+{
+    if (State(mesh) != AssetState::Resident) return false;
+    for (TextureHandle texture : Dependencies(mesh))
+        if (State(texture) != AssetState::Resident) return false;
+    return true;
+}
+
+void AssetRegistry::RequestTexture(TextureHandle texture)
+{
+    Entry* entry = Get(AssetType::Texture, texture.id);
+    if (!entry) return;
+    {
+        std::lock_guard<std::mutex> lock(ShardOf(texture.id).mutex);
+        if (entry->users++ > 0) return;
+        // A texture released but not freed yet is simply kept.
+        const AssetState state = entry->state.load(std::memory_order_relaxed);
+        if (state != AssetState::Unloaded && state != AssetState::Failed) return;
+        entry->state.store(AssetState::Queued, std::memory_order_release);
+    }
+    (void)gJobSystem.Enqueue([this, entry]() { DecodeTexture(*entry); });
+}
+
+void AssetRegistry::ReleaseTexture(TextureHandle texture)
+{
+    Entry* entry = Get(AssetType::Texture, texture.id);
+    if (!entry) return;
+    {
+        std::lock_guard<std::mutex> lock(ShardOf(texture.id).mutex);
+        if (entry->users == 0 || --entry->users > 0) return;
+    }
+    // GL objects are freed on the main thread, in UploadTextures.
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    m_released.push_back(texture.id);
+}
+
+unsigned AssetRegistry::GLTexture(TextureHandle texture) const
+{
+    const Entry* entry = Get(AssetType::Texture, texture.id);
+    if (!entry) return 0;
+    if (const uint32_t owner = entry->alias.load(std::memory_order_acquire)) return GLTexture(TextureHandle{owner});
+    return entry->glTexture.load(std::memory_order_acquire);
+}
+
+uint64_t AssetRegistry::ContentHash(TextureHandle texture) const
+{
+    const Entry* entry = Get(AssetType::Texture, texture.id);
+    return entry ? entry->contentHash.load(std::memory_order_relaxed) : 0;
+}
+
+void AssetRegistry::DecodeTexture(Entry& entry)
+{
+    const uint32_t id = entry.id.load(std::memory_order_relaxed);
+    Shard& shard = ShardOf(id);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (entry.users == 0)
+        {
+            entry.state.store(AssetState::Unloaded, std::memory_order_release);
+            return;
+        }
+        entry.state.store(AssetState::Loading, std::memory_order_release);
+    }
+    auto fail = [&](const char* reason) {
+        std::cerr << "Texture load failed: " << entry.path << " (" << reason << ")" << std::endl;
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        entry.state.store(AssetState::Failed, std::memory_order_release);
+    };
+
+    std::vector<unsigned char> bytes;
+    std::ifstream file(entry.path, std::ios::binary | std::ios::ate);
+    if (file)
+    {
+        bytes.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    }
+    if (!file || bytes.empty()) return fail("cannot read file");
+
+    // Identical bytes under another path: share that texture's decode and GL copy.
+    const uint64_t hash = HashBytes(bytes.data(), bytes.size());
+    entry.contentHash.store(hash, std::memory_order_relaxed);
+    uint32_t owner;
+    {
+        std::lock_guard<std::mutex> lock(m_contentMutex);
+        owner = m_byContent.try_emplace(hash, id).first->second;
+    }
+    if (owner != id)
+    {
+        // Referenced before the alias is published, so a concurrent release
+        // of this texture always finds something to let go of.
+        RequestTexture(TextureHandle{owner});
+        bool wanted;
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            wanted = entry.users > 0;
+            if (wanted) entry.alias.store(owner, std::memory_order_release);
+            entry.state.store(wanted ? AssetState::Resident : AssetState::Unloaded, std::memory_order_release);
+        }
+        if (!wanted) ReleaseTexture(TextureHandle{owner});
+        return;
+    }
+
+    int width = 0, height = 0, channels = 0;
+    unsigned char* pixels =
+        stbi_load_from_memory(bytes.data(), static_cast<int>(bytes.size()), &width, &height, &channels, 4);
+    if (!pixels) return fail(stbi_failure_reason());
+    auto decoded = std::make_unique<DecodedTexture>();
+    decoded->id = id;
+    decoded->upload.pixels = pixels;
+    decoded->upload.width = width;
+    decoded->upload.height = height;
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    m_decoded.push_back(std::move(decoded));
+}
+
+void AssetRegistry::DropTexture(Entry& entry)
+{
+    const uint32_t id = entry.id.load(std::memory_order_relaxed);
+    uint32_t owner;
+    unsigned texture;
+    size_t bytes;
+    {
+        std::lock_guard<std::mutex> lock(ShardOf(id).mutex);
+        // Requested again since, or still on its way in (the upload drops it).
+        if (entry.users > 0 || entry.state.load(std::memory_order_relaxed) != AssetState::Resident) return;
+        owner = entry.alias.exchange(0, std::memory_order_acq_rel);
+        texture = entry.glTexture.exchange(0, std::memory_order_acq_rel);
+        bytes = std::exchange(entry.gpuBytes, 0);
+        entry.state.store(AssetState::Unloaded, std::memory_order_release);
+    }
+    if (texture)
+    {
+        RenderResources::DeleteTexture(texture);
+        m_residentTextures.fetch_sub(1, std::memory_order_relaxed);
+        m_residentTextureBytes.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+    if (owner) ReleaseTexture(TextureHandle{owner});
+}
+
+size_t AssetRegistry::UploadTextures(size_t budgetBytes, double budgetMs)
+{
+    std::vector<uint32_t> released;
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        released.swap(m_released);
+        for (auto& decoded : m_decoded) m_uploads.push_back(std::move(decoded));
+        m_decoded.clear();
+    }
+    for (uint32_t id : released)
+        if (Entry* entry = Get(AssetType::Texture, id)) DropTexture(*entry);
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    size_t copied = 0;
+    auto it = m_uploads.begin();
+    while (it != m_uploads.end() && copied < budgetBytes)
+    {
+        const double ms =
+            std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        if (ms >= budgetMs) break;
+        TextureUpload& upload = (*it)->upload;
+        Entry& entry = *Get(AssetType::Texture, (*it)->id);
+        Shard& shard = ShardOf((*it)->id);
+        bool wanted;
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            wanted = entry.users > 0;
+            if (!wanted) entry.state.store(AssetState::Unloaded, std::memory_order_release);
+        }
+        if (wanted)
+        {
+            copied += RenderResources::UploadTexturePart(upload, budgetBytes - copied);
+            if (upload.uploadedRows < upload.height) continue;
+            const size_t bytes = upload.TotalBytes() * 4 / 3;  // with the mip chain
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            // Dropped while the last rows went in, or already uploaded by
+            // a decode that raced an UnloadTextures.
+            wanted = entry.users > 0 && entry.glTexture.load(std::memory_order_relaxed) == 0;
+            if (wanted)
+            {
+                entry.glTexture.store(upload.texture, std::memory_order_release);
+                entry.gpuBytes = bytes;
+                entry.state.store(AssetState::Resident, std::memory_order_release);
+                m_residentTextures.fetch_add(1, std::memory_order_relaxed);
+                m_residentTextureBytes.fetch_add(bytes, std::memory_order_relaxed);
+            }
+        }
+        if (!wanted) RenderResources::DeleteTexture(upload.texture);
+        it = m_uploads.erase(it);
+    }
+    return copied;
+}
+
+void AssetRegistry::UnloadTextures()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_decoded.clear();
+        m_released.clear();
+    }
+    for (auto& decoded : m_uploads) RenderResources::DeleteTexture(decoded->upload.texture);
+    m_uploads.clear();
+
+    for (uint32_t id = 1; id < m_nextId[TypeIndex(AssetType::Texture)].load(std::memory_order_relaxed); ++id)
+    {
+        Entry* entry = Get(AssetType::Texture, id);
+        if (!entry) continue;
+        unsigned texture;
+        {
+            std::lock_guard<std::mutex> lock(ShardOf(id).mutex);
+            texture = entry->glTexture.exchange(0, std::memory_order_acq_rel);
+            entry->alias.store(0, std::memory_order_release);
+            entry->users = 0;
+            entry->gpuBytes = 0;
+            entry->state.store(AssetState::Unloaded, std::memory_order_release);
+        }
+        RenderResources::DeleteTexture(texture);
+    }
+    for (uint32_t id = 1; id < m_nextId[TypeIndex(AssetType::Mesh)].load(std::memory_order_relaxed); ++id)
+    {
+        Entry* entry = Get(AssetType::Mesh, id);
+        if (!entry) continue;
+        std::lock_guard<std::mutex> lock(ShardOf(id).mutex);
+        entry->dependencies.clear();
+    }
+    m_residentTextures.store(0, std::memory_order_relaxed);
+    m_residentTextureBytes.store(0, std::memory_order_relaxed);
+}
+
+size_t AssetRegistry::MeshCount() const
+{
+    return m_nextId[TypeIndex(AssetType::Mesh)].load(std::memory_order_relaxed) - 1;
+}
+
+size_t AssetRegistry::TextureCount() const
+{
+    return m_nextId[TypeIndex(AssetType::Texture)].load(std::memory_order_relaxed) - 1;
+}
+
+size_t AssetRegistry::PendingTextureUploads() const
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    return m_decoded.size() + m_uploads.size();
+}
@@ -0,0 +1,154 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+enum class AssetType : uint8_t
+{
+    Mesh,
+    Texture,
+};
+
+enum class AssetState : uint8_t
+{
+    Unloaded,  // registered, nothing loaded (or unloaded again)
+    Queued,    // requested, waiting for a worker / load slot
+    Loading,   // being read, decoded or uploaded
+    Resident,  // on the GPU
+    Failed,    // missing or undecodable; retried once every user let go
+};
+
+// Per-type id, so a texture id cannot be passed where a mesh id is expected.
+// 0 is "none"; ids are stable for the lifetime of the process.
+template <AssetType Type>
+struct AssetHandle
+{
+    uint32_t id{0};
+
+    explicit operator bool() const { return id != 0; }
+    bool operator==(AssetHandle other) const { return id == other.id; }
+    bool operator!=(AssetHandle other) const { return id != other.id; }
+};
+using MeshHandle = AssetHandle<AssetType::Mesh>;
+using TextureHandle = AssetHandle<AssetType::Texture>;
+
+/**
+ * @brief One registry for every mesh and texture the engine references.
+ * Paths are canonicalized (absolute, normalized, symlinks resolved), so the
+ * same file reached through different relative paths gets one id, and each
+ * asset carries its load state and, for meshes, the textures it depends on.
+ *
+ * Textures are loaded here: RequestTexture reads the file on a gJobSystem
+ * worker, hashes its bytes and decodes it with stb_image; UploadTextures
+ * copies decoded images to GL on the main thread within a byte budget.
+ * Files with identical content share one decode and one GL texture. Meshes
+ * are loaded by RenderResources and the StreamingSystem, which report their
+ * state through SetState.
+ *
+ * Lookups (Find, Register of a known path, State, GLTexture) are lock-free;
+ * writes take one of a few mutexes sharded by path hash or id.
+ */
+class AssetRegistry
+{
+public:
+    AssetRegistry();
+    ~AssetRegistry();
+    AssetRegistry(const AssetRegistry&) = delete;
+    AssetRegistry& operator=(const AssetRegistry&) = delete;
+
+    // Absolute, lexically normal, symlinks resolved as far as the path
+    // exists, '/' separated (and lower case on Windows). Built-in names
+    // ("AARTZE:CUBE") are returned as they are.
+    static std::string CanonicalPath(const std::string& path);
+    static uint64_t HashBytes(const void* data, size_t size, uint64_t seed = 14695981039346656037ull);
+
+    // Id for `path`, registering it on first use. Empty handle for "".
+    MeshHandle RegisterMesh(const std::string& path) { return {Register(AssetType::Mesh, path)}; }
+    TextureHandle RegisterTexture(const std::string& path) { return {Register(AssetType::Texture, path)}; }
+    // Empty handle if `path` was never registered.
+    MeshHandle FindMesh(const std::string& path) const { return {Find(AssetType::Mesh, path)}; }
+    TextureHandle FindTexture(const std::string& path) const { return {Find(AssetType::Texture, path)}; }
+
+    const std::string& Path(MeshHandle mesh) const;
+    const std::string& Path(TextureHandle texture) const;
+    AssetState State(MeshHandle mesh) const;
+    AssetState State(TextureHandle texture) const;
+    // Set by whoever loads the mesh. Leaving Queued/Loading/Resident for
+    // Unloaded or Failed releases the mesh's texture dependencies.
+    void SetState(MeshHandle mesh, AssetState state);
+
+    // Record that `mesh` uses the texture at `texturePath` and request it on
+    // the mesh's behalf, while the mesh is Queued, Loading or Resident
+    // (otherwise nothing is recorded). Safe from any thread.
+    TextureHandle AddDependency(MeshHandle mesh, const std::string& texturePath);
+    std::vector<TextureHandle> Dependencies(MeshHandle mesh) const;
+    // The mesh and every texture it depends on are resident.
+    bool IsFullyResident(MeshHandle mesh) const;
+
+    // Take / drop a reference to a texture. The first reference starts the
+    // decode; after the last one the GL texture is freed by UploadTextures.
+    // Safe from any thread.
+    void RequestTexture(TextureHandle texture);
+    void ReleaseTexture(TextureHandle texture);
+    // GL name, 0 until resident. Lock-free.
+    unsigned GLTexture(TextureHandle texture) const;
+    // Hash of the file's bytes, 0 until it has been read.
+    uint64_t ContentHash(TextureHandle texture) const;
+
+    // Main thread, with the GL context current: free released textures and
+    // copy up to `budgetBytes` of decoded pixels to GL in whole rows,
+    // stopping once `budgetMs` is spent. Returns the bytes copied.
+    size_t UploadTextures(size_t budgetBytes, double budgetMs);
+    // Main thread, for shutdown: delete every GL texture and drop all
+    // texture references and dependencies. Decodes in flight are discarded.
+    void UnloadTextures();
+
+    size_t MeshCount() const;
+    size_t TextureCount() const;
+    size_t ResidentTextureCount() const { return m_residentTextures.load(std::memory_order_relaxed); }
+    size_t ResidentTextureBytes() const { return m_residentTextureBytes.load(std::memory_order_relaxed); }
+    size_t PendingTextureUploads() const;
+
+private:
+    struct Entry;
+    struct Key;
+    struct Table;
+    struct Shard;
+    struct DecodedTexture;
+
+    static constexpr uint32_t SHARD_COUNT = 16;
+    static constexpr uint32_t SEGMENT_SIZE = 1024;
+    static constexpr uint32_t MAX_SEGMENTS = 4096;  // 4M ids per type
+
+    uint32_t Register(AssetType type, const std::string& path);
+    uint32_t Find(AssetType type, const std::string& path) const;
+    const Key* Lookup(AssetType type, const std::string& key) const;
+    Entry* Insert(AssetType type, const std::string& key, Entry* entry);
+    Entry* Get(AssetType type, uint32_t id) const;
+    Shard& ShardOf(uint32_t id) const;
+    void DecodeTexture(Entry& entry);
+    void DropTexture(Entry& entry);
+
+    std::unique_ptr<Shard[]> m_shards;
+    // Entries by id, in segments that never move, so Get needs no lock.
+    std::atomic<Entry*> m_segments[2][MAX_SEGMENTS];
+    std::atomic<uint32_t> m_nextId[2];
+
+    std::mutex m_contentMutex;
+    std::unordered_map<uint64_t, uint32_t> m_byContent;  // texture content hash -> the texture holding it
+
+    mutable std::mutex m_queueMutex;
+    std::vector<std::unique_ptr<DecodedTexture>> m_decoded;  // from workers, awaiting upload
+    std::vector<uint32_t> m_released;                        // textures whose last reference went
+    // Main thread only.
+    std::vector<std::unique_ptr<DecodedTexture>> m_uploads;
+    std::atomic<size_t> m_residentTextures{0};
+    std::atomic<size_t> m_residentTextureBytes{0};
+};
+
+extern AssetRegistry gAssetRegistry;
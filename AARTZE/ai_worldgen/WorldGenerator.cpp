@@ -9,8 +9,8 @@ GeneratedWorld GenerateWorld(const std::string& prompt) {
     // Basic terrain piece using registry templates
     TerrainPiece ground;
     ground.meshPath = "assets/terrain/ground.obj";
-    ground.meshId = RegisterMesh(ground.meshPath);
-    ground.textureId = RegisterTexture("assets/terrain/ground.png");
+    ground.meshId = gAssetRegistry.RegisterMesh(ground.meshPath).id;
+    ground.textureId = gAssetRegistry.RegisterTexture("assets/terrain/ground.png").id;
     world.terrain.push_back(ground);
 
     // Create entities at known zones
@@ -18,7 +18,7 @@ GeneratedWorld GenerateWorld(const std::string& prompt) {
         Entity entity;
         entity.name = zone;
         entity.meshPath = "assets/entities/default.obj";
-        entity.meshId = RegisterMesh(entity.meshPath);
+        entity.meshId = gAssetRegistry.RegisterMesh(entity.meshPath).id;
         entity.position = pos;
         world.entities.push_back(entity);
     }
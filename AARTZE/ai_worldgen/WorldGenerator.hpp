@@ -5,8 +5,7 @@
 
 #include "LearningDB.hpp"
 #include "World/ZoneRegistry.hpp"
-#include "World/MeshRegistry.hpp"
-#include "World/TextureRegistry.hpp"
+#include "World/AssetRegistry.hpp"
 
 namespace AARTZE {
 
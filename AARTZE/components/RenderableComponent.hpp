@@ -9,7 +9,9 @@ struct RenderableComponent
 {
     uint32_t meshId = 0;      // Mesh identifier (linked to GPU buffer)
     uint32_t materialId = 0;  // Material/shader ID
-    int lodLevel = 0;         // Level of detail (0 = highest)
+    int lodLevel = 0;         // Level of detail (0 = highest); chosen by RenderQueue each frame from screen size
+    bool lodLocked = false;   // Keep lodLevel as set instead of selecting it
     bool castShadows = true;
     bool isVisible = true;
+    bool isOccluder = false;  // Large, closed, opaque mesh; its coarsest LOD is drawn into the occlusion buffer
 };
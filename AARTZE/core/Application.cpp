@@ -2,14 +2,61 @@
 #define GLFW_INCLUDE_NONE  // Prevent GLFW from including OpenGL headers
 #include <glad/glad.h>
 
+#include <algorithm>
+#include <cstdlib>
+#include <new>
 #include <stdexcept>
 
 #include "../input/InputHandler.hpp"
 #include "GLFW/glfw3.h"
+#include "MemoryManager.hpp"
 #include "Profiler.hpp"
 
 #include "../scripting/LuaVM.hpp"
 
+#if AARTZE_COUNT_HEAP_ALLOCATIONS && defined(_WIN32)
+#include <malloc.h>
+#endif
+
+#if AARTZE_COUNT_HEAP_ALLOCATIONS
+// Counting replacements for the global allocation functions. Defined here so
+// they are always linked into the application together with Run().
+void* operator new(std::size_t size)
+{
+    gHeapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t align)
+{
+    gHeapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    std::size_t alignment = static_cast<std::size_t>(align);
+#ifdef _WIN32
+    // MSVC has no std::aligned_alloc; its aligned blocks need _aligned_free.
+    if (void* ptr = _aligned_malloc(std::max<std::size_t>(size, 1), alignment)) return ptr;
+#else
+    std::size_t rounded = (std::max<std::size_t>(size, 1) + alignment - 1) & ~(alignment - 1);
+    if (void* ptr = std::aligned_alloc(alignment, rounded)) return ptr;
+#endif
+    throw std::bad_alloc();
+}
+
+static void FreeAligned(void* ptr) noexcept
+{
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { FreeAligned(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { FreeAligned(ptr); }
+#endif
+
 static void FramebufferSizeCallback(GLFWwindow* window, int width, int height)
 {
     glViewport(0, 0, width, height);
@@ -105,10 +152,15 @@ Application::~Application()
 
 void Application::Run()
 {
+    // Transient per-frame memory; see FrameAllocator for the lifetime rules.
+    FrameAllocator frameAllocator;
+    MemoryManager::SetFrameAllocator(&frameAllocator);
+
     double lastTime = glfwGetTime();
     while (!glfwWindowShouldClose(m_window))
     {
         gProfiler.NewFrame();
+        frameAllocator.BeginFrame();
         double currentTime = glfwGetTime();
         float deltaTime = static_cast<float>(currentTime - lastTime);
         lastTime = currentTime;
@@ -119,7 +171,10 @@ void Application::Run()
         // Drive rendering from editor shell; keep camera speed stable
         m_renderingSystem.SetCameraSpeed(2.0f);
         if (gSystemManager)
+        {
+            gSystemManager->streamingSystem.SetViewer(m_renderingSystem.GetCameraPos());
             gSystemManager->Update(deltaTime);
+        }
         {
             ProfileScope _p(gProfiler, "Render");
             m_renderingSystem.Render();
@@ -149,6 +204,8 @@ void Application::Run()
 
     glfwSwapBuffers(m_window);
     }
+
+    MemoryManager::SetFrameAllocator(nullptr);
 }
 
 
@@ -0,0 +1,539 @@
+// File: AARTZE/core/Archetype.hpp
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Entity.hpp"
+#include "PageAllocator.hpp"
+
+// Entities sharing a signature are packed into fixed-size chunks. Each chunk
+// stores one column per component type (structure of arrays), so system loops
+// walk contiguous memory instead of resolving a hash map per component.
+// A chunk is one page from gPageAllocator and is freed as soon as it empties.
+constexpr std::size_t ARCHETYPE_CHUNK_BYTES = PAGE_BYTES;
+constexpr std::size_t ARCHETYPE_CHUNK_ALIGN = 64;
+
+/**
+ * @brief Type-erased description of a registered component type.
+ */
+struct ComponentInfo
+{
+    std::size_t size = 0;  // 0 for empty tag types: they only live in the signature
+    std::size_t align = 1;
+    void (*moveConstruct)(void* dst, void* src) = nullptr;
+    void (*destroy)(void* ptr) = nullptr;
+
+    template <typename T>
+    static ComponentInfo Of()
+    {
+        ComponentInfo info;
+        if constexpr (!std::is_empty_v<T>)
+        {
+            info.size = sizeof(T);
+            info.align = alignof(T);
+            info.moveConstruct = [](void* dst, void* src) {
+                new (dst) T(std::move(*static_cast<T*>(src)));
+            };
+            info.destroy = [](void* ptr) { static_cast<T*>(ptr)->~T(); };
+        }
+        return info;
+    }
+};
+
+/**
+ * @brief Memory held for one component type across every archetype.
+ * `usedBytes` covers live components, `reservedBytes` the column space of all
+ * allocated chunks. Tags only count entities; they occupy no column.
+ */
+struct ComponentMemoryStats
+{
+    std::size_t count = 0;
+    std::size_t chunks = 0;
+    std::size_t usedBytes = 0;
+    std::size_t reservedBytes = 0;
+};
+
+/**
+ * @brief Fixed-size block of memory holding up to `capacity` rows of an archetype.
+ */
+struct ArchetypeChunk
+{
+    std::uint8_t* data = nullptr;
+    std::uint32_t count = 0;
+};
+
+/**
+ * @brief Where an entity's components live inside the archetype storage.
+ */
+struct EntityLocation
+{
+    class Archetype* archetype = nullptr;
+    std::uint32_t chunk = 0;
+    std::uint32_t row = 0;
+};
+
+/**
+ * @brief All entities with one exact signature, stored as chunked columns.
+ */
+class Archetype
+{
+   public:
+    Archetype(const Signature& signature, const std::array<ComponentInfo, MAX_COMPONENTS>& infos)
+        : signature(signature)
+    {
+        columnOf.fill(-1);
+        for (std::size_t type = 0; type < MAX_COMPONENTS; ++type)
+        {
+            if (!signature.test(type) || infos[type].size == 0) continue;
+            columnOf[type] = static_cast<std::int16_t>(columns.size());
+            columns.push_back({static_cast<ComponentType>(type), 0, infos[type]});
+        }
+        ComputeLayout();
+    }
+
+    ~Archetype()
+    {
+        for (std::size_t c = 0; c < chunks.size(); ++c)
+        {
+            for (std::uint32_t row = 0; row < chunks[c].count; ++row) DestroyRow(c, row);
+            FreeChunk(chunks[c]);
+        }
+    }
+
+    Archetype(const Archetype&) = delete;
+    Archetype& operator=(const Archetype&) = delete;
+
+    const Signature& GetSignature() const
+    {
+        return signature;
+    }
+    std::uint32_t ChunkCapacity() const
+    {
+        return capacity;
+    }
+    std::size_t ChunkBytes() const
+    {
+        return chunkBytes;
+    }
+    std::size_t ChunkCount() const
+    {
+        return chunks.size();
+    }
+    std::size_t Size() const
+    {
+        return entityCount;
+    }
+    const ArchetypeChunk& GetChunk(std::size_t index) const
+    {
+        return chunks[index];
+    }
+
+    Entity* Entities(std::size_t chunk)
+    {
+        return reinterpret_cast<Entity*>(chunks[chunk].data);
+    }
+
+    bool HasColumn(ComponentType type) const
+    {
+        return columnOf[type] >= 0;
+    }
+
+    /**
+     * @brief Add this archetype's share of `type` to `stats`.
+     */
+    void AccumulateStats(ComponentType type, ComponentMemoryStats& stats) const
+    {
+        if (!signature.test(type)) return;
+        stats.count += entityCount;
+        stats.chunks += chunks.size();
+        std::int16_t col = columnOf[type];
+        if (col < 0) return;
+        stats.usedBytes += entityCount * columns[col].info.size;
+        stats.reservedBytes += chunks.size() * capacity * columns[col].info.size;
+    }
+
+    /**
+     * @brief Start of the column for `type` in a chunk, or nullptr for tags.
+     */
+    void* Column(std::size_t chunk, ComponentType type)
+    {
+        std::int16_t col = columnOf[type];
+        if (col < 0) return nullptr;
+        return chunks[chunk].data + columns[col].offset;
+    }
+
+    template <typename T>
+    T* Column(std::size_t chunk, ComponentType type)
+    {
+        return static_cast<T*>(Column(chunk, type));
+    }
+
+    void* Get(std::uint32_t chunk, std::uint32_t row, ComponentType type)
+    {
+        std::int16_t col = columnOf[type];
+        if (col < 0) return nullptr;
+        const Col& c = columns[col];
+        return chunks[chunk].data + c.offset + row * c.info.size;
+    }
+
+    /**
+     * @brief Reserve a row for `entity`. Component memory is left uninitialized;
+     * the caller must construct every column before the row is used.
+     */
+    EntityLocation Append(Entity entity)
+    {
+        if (chunks.empty() || chunks.back().count == capacity) chunks.push_back(AllocateChunk());
+        std::uint32_t chunk = static_cast<std::uint32_t>(chunks.size() - 1);
+        std::uint32_t row = chunks[chunk].count++;
+        Entities(chunk)[row] = entity;
+        ++entityCount;
+        return {this, chunk, row};
+    }
+
+    /**
+     * @brief Destroy the components at (chunk,row) and fill the hole with the
+     * archetype's last row so chunks stay dense.
+     * @return The entity that was moved into the freed row, or INVALID_ENTITY if none.
+     */
+    Entity Remove(std::uint32_t chunk, std::uint32_t row)
+    {
+        DestroyRow(chunk, row);
+        std::uint32_t lastChunk = static_cast<std::uint32_t>(chunks.size() - 1);
+        std::uint32_t lastRow = chunks[lastChunk].count - 1;
+
+        Entity moved = INVALID_ENTITY;
+        if (chunk != lastChunk || row != lastRow)
+        {
+            for (const Col& c : columns)
+            {
+                void* dst = chunks[chunk].data + c.offset + row * c.info.size;
+                void* src = chunks[lastChunk].data + c.offset + lastRow * c.info.size;
+                c.info.moveConstruct(dst, src);
+                c.info.destroy(src);
+            }
+            moved = Entities(lastChunk)[lastRow];
+            Entities(chunk)[row] = moved;
+        }
+
+        --entityCount;
+        if (--chunks[lastChunk].count == 0)
+        {
+            FreeChunk(chunks[lastChunk]);
+            chunks.pop_back();
+        }
+        return moved;
+    }
+
+    // Cached transitions to the archetype reached by adding/removing one type.
+    std::unordered_map<ComponentType, Archetype*> addEdges;
+    std::unordered_map<ComponentType, Archetype*> removeEdges;
+
+   private:
+    struct Col
+    {
+        ComponentType type;
+        std::size_t offset;
+        ComponentInfo info;
+    };
+
+    Signature signature;
+    std::vector<Col> columns;
+    std::array<std::int16_t, MAX_COMPONENTS> columnOf{};
+    std::vector<ArchetypeChunk> chunks;
+    std::uint32_t capacity = 0;
+    std::size_t chunkBytes = ARCHETYPE_CHUNK_BYTES;
+    std::size_t entityCount = 0;
+
+    static std::size_t AlignUp(std::size_t v, std::size_t a)
+    {
+        return (v + a - 1) & ~(a - 1);
+    }
+
+    // Lay columns out back to back: [entities][col0 x capacity][col1 x capacity]...
+    std::size_t LayoutFor(std::uint32_t cap)
+    {
+        std::size_t offset = sizeof(Entity) * cap;
+        for (Col& c : columns)
+        {
+            offset = AlignUp(offset, c.info.align);
+            c.offset = offset;
+            offset += c.info.size * cap;
+        }
+        return offset;
+    }
+
+    void ComputeLayout()
+    {
+        std::size_t rowBytes = sizeof(Entity);
+        for (const Col& c : columns) rowBytes += c.info.size;
+        std::uint32_t cap = static_cast<std::uint32_t>(std::max<std::size_t>(1, chunkBytes / rowBytes));
+        while (cap > 1 && LayoutFor(cap) > chunkBytes) --cap;
+        // Components larger than a chunk get a single-row chunk of the required size.
+        chunkBytes = std::max(chunkBytes, AlignUp(LayoutFor(cap), ARCHETYPE_CHUNK_ALIGN));
+        capacity = cap;
+    }
+
+    ArchetypeChunk AllocateChunk()
+    {
+        ArchetypeChunk chunk;
+        chunk.data = static_cast<std::uint8_t*>(gPageAllocator.Allocate(chunkBytes));
+        return chunk;
+    }
+
+    void FreeChunk(ArchetypeChunk& chunk)
+    {
+        gPageAllocator.Free(chunk.data);
+        chunk.data = nullptr;
+    }
+
+    void DestroyRow(std::size_t chunk, std::uint32_t row)
+    {
+        for (const Col& c : columns) c.info.destroy(chunks[chunk].data + c.offset + row * c.info.size);
+    }
+};
+
+/**
+ * @brief Archetypes matching a required signature, kept up to date as new
+ * archetypes appear so queries never rescan the whole storage.
+ */
+struct ArchetypeQuery
+{
+    Signature required;
+    std::vector<Archetype*> matches;
+
+    std::size_t Count() const
+    {
+        std::size_t n = 0;
+        for (const Archetype* archetype : matches) n += archetype->Size();
+        return n;
+    }
+};
+
+/**
+ * @brief Owns every archetype and maps entities to their (archetype, chunk, row).
+ */
+class ArchetypeStorage
+{
+   public:
+    ArchetypeStorage()
+    {
+        emptyArchetype = GetOrCreateArchetype(Signature{});
+    }
+
+    template <typename T>
+    void RegisterComponent(ComponentType type)
+    {
+        infos[type] = ComponentInfo::Of<T>();
+    }
+
+    const ComponentInfo& GetInfo(ComponentType type) const
+    {
+        return infos[type];
+    }
+
+    // Locations are indexed by the handle's slot; the generation is checked
+    // against the handle stored in the entity's row, so a stale handle whose
+    // slot was reused is reported as absent.
+    void AddEntity(Entity entity)
+    {
+        const Entity index = EntityIndex(entity);
+        if (index >= locations.size()) locations.resize(static_cast<std::size_t>(index) + 1);
+        assert(!locations[index].archetype && "Entity slot already present in storage.");
+        locations[index] = emptyArchetype->Append(entity);
+    }
+
+    void RemoveEntity(Entity entity)
+    {
+        if (!Contains(entity)) return;
+        const Entity index = EntityIndex(entity);
+        EntityLocation loc = locations[index];
+        RemoveRow(loc);
+        locations[index] = {};
+    }
+
+    bool Contains(Entity entity) const
+    {
+        const Entity index = EntityIndex(entity);
+        if (index >= locations.size()) return false;
+        const EntityLocation& loc = locations[index];
+        return loc.archetype && loc.archetype->Entities(loc.chunk)[loc.row] == entity;
+    }
+
+    const Signature& GetSignature(Entity entity) const
+    {
+        static const Signature none{};
+        return Contains(entity) ? locations[EntityIndex(entity)].archetype->GetSignature() : none;
+    }
+
+    bool Has(Entity entity, ComponentType type) const
+    {
+        return Contains(entity) && locations[EntityIndex(entity)].archetype->GetSignature().test(type);
+    }
+
+    template <typename T>
+    void Add(Entity entity, ComponentType type, T&& component)
+    {
+        using U = std::decay_t<T>;
+        void* slot = AddSlot(entity, type);
+        if constexpr (!std::is_empty_v<U>) new (slot) U(std::forward<T>(component));
+    }
+
+    /**
+     * @brief Type-erased Add: move-constructs the component from `src`.
+     */
+    void AddErased(Entity entity, ComponentType type, void* src)
+    {
+        void* slot = AddSlot(entity, type);
+        if (slot) infos[type].moveConstruct(slot, src);
+    }
+
+    void Remove(Entity entity, ComponentType type)
+    {
+        assert(Has(entity, type) && "Removing non-existent component.");
+        EntityLocation from = locations[EntityIndex(entity)];
+        Archetype* target = from.archetype->removeEdges[type];
+        if (!target)
+        {
+            Signature sig = from.archetype->GetSignature();
+            sig.reset(type);
+            target = GetOrCreateArchetype(sig);
+            from.archetype->removeEdges[type] = target;
+            target->addEdges[type] = from.archetype;
+        }
+        MoveEntity(entity, from, target);
+    }
+
+    template <typename T>
+    T& Get(Entity entity, ComponentType type)
+    {
+        assert(Has(entity, type) && "Retrieving non-existent component.");
+        if constexpr (std::is_empty_v<T>)
+        {
+            static T tag{};
+            return tag;
+        }
+        else
+        {
+            const EntityLocation& loc = locations[EntityIndex(entity)];
+            return *static_cast<T*>(loc.archetype->Get(loc.chunk, loc.row, type));
+        }
+    }
+
+    /**
+     * @brief Invoke fn(Archetype&) for every archetype whose signature contains `required`.
+     */
+    template <typename Fn>
+    void ForEachArchetype(const Signature& required, Fn&& fn)
+    {
+        for (Archetype* archetype : archetypeList)
+        {
+            if (archetype->Size() == 0) continue;
+            if ((archetype->GetSignature() & required) == required) fn(*archetype);
+        }
+    }
+
+    std::size_t ArchetypeCount() const
+    {
+        return archetypeList.size();
+    }
+
+    ComponentMemoryStats GetComponentStats(ComponentType type) const
+    {
+        ComponentMemoryStats stats;
+        for (const Archetype* archetype : archetypeList) archetype->AccumulateStats(type, stats);
+        return stats;
+    }
+
+    /**
+     * @brief Return the cached match list for `required`, creating it on first use.
+     * The returned pointer stays valid for the lifetime of the storage.
+     */
+    ArchetypeQuery* RegisterQuery(const Signature& required)
+    {
+        auto it = queries.find(required);
+        if (it != queries.end()) return it->second.get();
+        auto query = std::make_unique<ArchetypeQuery>();
+        query->required = required;
+        for (Archetype* archetype : archetypeList)
+            if ((archetype->GetSignature() & required) == required) query->matches.push_back(archetype);
+        ArchetypeQuery* raw = query.get();
+        queries.emplace(required, std::move(query));
+        return raw;
+    }
+
+   private:
+    std::array<ComponentInfo, MAX_COMPONENTS> infos{};
+    std::unordered_map<Signature, std::unique_ptr<Archetype>> archetypes;
+    std::vector<Archetype*> archetypeList;
+    std::vector<EntityLocation> locations;
+    std::unordered_map<Signature, std::unique_ptr<ArchetypeQuery>> queries;
+    Archetype* emptyArchetype = nullptr;
+
+    Archetype* GetOrCreateArchetype(const Signature& signature)
+    {
+        auto it = archetypes.find(signature);
+        if (it != archetypes.end()) return it->second.get();
+        auto archetype = std::make_unique<Archetype>(signature, infos);
+        Archetype* raw = archetype.get();
+        archetypes.emplace(signature, std::move(archetype));
+        archetypeList.push_back(raw);
+        for (auto& [required, query] : queries)
+            if ((signature & required) == required) query->matches.push_back(raw);
+        return raw;
+    }
+
+    // Move `entity` to the archetype with `type` added and return the
+    // uninitialized component slot (nullptr for tags).
+    void* AddSlot(Entity entity, ComponentType type)
+    {
+        if (!Contains(entity)) AddEntity(entity);
+        assert(!Has(entity, type) && "Component added to same entity more than once.");
+
+        EntityLocation from = locations[EntityIndex(entity)];
+        Archetype* target = from.archetype->addEdges[type];
+        if (!target)
+        {
+            Signature sig = from.archetype->GetSignature();
+            sig.set(type);
+            target = GetOrCreateArchetype(sig);
+            from.archetype->addEdges[type] = target;
+            target->removeEdges[type] = from.archetype;
+        }
+
+        EntityLocation to = MoveEntity(entity, from, target);
+        return to.archetype->Get(to.chunk, to.row, type);
+    }
+
+    void RemoveRow(const EntityLocation& loc)
+    {
+        Entity moved = loc.archetype->Remove(loc.chunk, loc.row);
+        if (moved != INVALID_ENTITY) locations[EntityIndex(moved)] = loc;
+    }
+
+    // Move every shared column from `from` into a new row of `target`.
+    EntityLocation MoveEntity(Entity entity, const EntityLocation& from, Archetype* target)
+    {
+        EntityLocation to = target->Append(entity);
+        const Signature shared = from.archetype->GetSignature() & target->GetSignature();
+        for (std::size_t type = 0; type < MAX_COMPONENTS; ++type)
+        {
+            if (!shared.test(type) || infos[type].size == 0) continue;
+            auto t = static_cast<ComponentType>(type);
+            infos[type].moveConstruct(target->Get(to.chunk, to.row, t),
+                                      from.archetype->Get(from.chunk, from.row, t));
+        }
+        RemoveRow(from);
+        locations[EntityIndex(entity)] = to;
+        return to;
+    }
+};
@@ -0,0 +1,170 @@
+// File: AARTZE/core/CommandBuffer.hpp
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Archetype.hpp"
+#include "Entity.hpp"
+
+/**
+ * @brief Records structural ECS changes so they can be applied later at a
+ * sync point instead of mutating storage while systems iterate it.
+ *
+ * Component payloads are placement-constructed into fixed blocks that never
+ * move, so recording is safe for non-trivially-copyable components.
+ */
+class CommandBuffer
+{
+   public:
+    CommandBuffer() = default;
+    CommandBuffer(const CommandBuffer&) = delete;
+    CommandBuffer& operator=(const CommandBuffer&) = delete;
+    CommandBuffer(CommandBuffer&&) = default;
+    CommandBuffer& operator=(CommandBuffer&&) = default;
+
+    ~CommandBuffer()
+    {
+        Clear();
+    }
+
+    void Create(Entity entity)
+    {
+        commands.push_back({Op::Create, 0, entity, nullptr, nullptr});
+    }
+
+    void Destroy(Entity entity)
+    {
+        commands.push_back({Op::Destroy, 0, entity, nullptr, nullptr});
+    }
+
+    template <typename T>
+    void Add(Entity entity, ComponentType type, T&& component)
+    {
+        using U = std::decay_t<T>;
+        Command cmd{Op::Add, type, entity, nullptr, nullptr};
+        if constexpr (!std::is_empty_v<U>)
+        {
+            cmd.payload = new (AllocatePayload(sizeof(U), alignof(U))) U(std::forward<T>(component));
+            cmd.destroy = [](void* ptr) { static_cast<U*>(ptr)->~U(); };
+        }
+        commands.push_back(cmd);
+    }
+
+    void Remove(Entity entity, ComponentType type)
+    {
+        commands.push_back({Op::Remove, type, entity, nullptr, nullptr});
+    }
+
+    bool Empty() const
+    {
+        return commands.empty();
+    }
+
+    std::size_t Size() const
+    {
+        return commands.size();
+    }
+
+    /**
+     * @brief Replay every command in recording order and clear the buffer.
+     * `onDestroy(entity)` is called after an entity has left the storage so
+     * the owner can recycle its ID.
+     */
+    template <typename OnDestroy>
+    void Apply(ArchetypeStorage& storage, OnDestroy&& onDestroy)
+    {
+        for (Command& cmd : commands)
+        {
+            switch (cmd.op)
+            {
+                case Op::Create:
+                    if (!storage.Contains(cmd.entity)) storage.AddEntity(cmd.entity);
+                    break;
+                case Op::Destroy:
+                    if (!storage.Contains(cmd.entity)) break;  // already destroyed
+                    storage.RemoveEntity(cmd.entity);
+                    onDestroy(cmd.entity);
+                    break;
+                case Op::Add:
+                    if (!storage.Contains(cmd.entity) || storage.Has(cmd.entity, cmd.type)) break;
+                    storage.AddErased(cmd.entity, cmd.type, cmd.payload);
+                    break;
+                case Op::Remove:
+                    if (storage.Has(cmd.entity, cmd.type)) storage.Remove(cmd.entity, cmd.type);
+                    break;
+            }
+        }
+        Clear();
+    }
+
+    /**
+     * @brief Drop every recorded command without applying it.
+     */
+    void Clear()
+    {
+        for (Command& cmd : commands)
+            if (cmd.destroy) cmd.destroy(cmd.payload);
+        commands.clear();
+        // Keep one block around so steady-state frames do not reallocate.
+        if (blocks.size() > 1) blocks.resize(1);
+        blockOffset = 0;
+    }
+
+   private:
+    enum class Op : std::uint8_t
+    {
+        Create,
+        Destroy,
+        Add,
+        Remove
+    };
+
+    struct Command
+    {
+        Op op;
+        ComponentType type;
+        Entity entity;
+        void* payload;
+        void (*destroy)(void*);
+    };
+
+    static constexpr std::size_t BLOCK_BYTES = 16 * 1024;
+
+    struct Block
+    {
+        std::unique_ptr<std::byte[]> data;
+        std::size_t size = 0;
+    };
+
+    std::vector<Command> commands;
+    std::vector<Block> blocks;
+    std::size_t blockOffset = 0;
+
+    void* AllocatePayload(std::size_t size, std::size_t align)
+    {
+        if (!blocks.empty())
+        {
+            Block& block = blocks.back();
+            auto base = reinterpret_cast<std::uintptr_t>(block.data.get());
+            std::size_t offset = ((base + blockOffset + align - 1) & ~(align - 1)) - base;
+            if (offset + size <= block.size)
+            {
+                blockOffset = offset + size;
+                return block.data.get() + offset;
+            }
+        }
+        Block block;
+        block.size = std::max(BLOCK_BYTES, size + align);
+        block.data = std::make_unique<std::byte[]>(block.size);
+        blocks.push_back(std::move(block));
+        blockOffset = 0;
+        return AllocatePayload(size, align);
+    }
+};
@@ -1,61 +1,161 @@
 #pragma once
 
-#include <bitset>
+#include <atomic>
 #include <cassert>
+#include <cstdint>
 #include <memory>
 #include <mutex>
-#include <queue>
+#include <thread>
+#include <utility>
 #include <cstddef>
 #include <typeindex>
 #include <unordered_map>
+#include <vector>
 
-#include "ComponentArray.hpp"
+#include "Archetype.hpp"
+#include "CommandBuffer.hpp"
 #include "Entity.hpp"
+#include "EntityPool.hpp"
+#include "JobSystem.hpp"
 #include "MemoryManager.hpp"
-#include "ThreadPool.hpp"
-
-using Signature = std::bitset<MAX_COMPONENTS>;
+#include "Query.hpp"
+#include "SystemAccess.hpp"
 
 class Coordinator
 {
    public:
     Coordinator()
     {
-        for (Entity entity = 0; entity < MAX_ENTITIES; ++entity)
-            availableEntities.push(entity);
-
         // Initialize memory manager
         MemoryManager::Initialize();
     }
 
     ~Coordinator()
     {
-        // Ensure components are destroyed before releasing arena memory
-        componentArrays.clear();
-        entitySignatures.clear();
+        // Ensure components are destroyed before shutting down the memory manager
+        deferred.Clear();
+        commandOrder.clear();
+        threadCommands.clear();
+        queries.clear();
+        storage = ArchetypeStorage{};
         // Shutdown memory manager
         MemoryManager::Shutdown();
     }
 
+    /**
+     * @brief Create an entity. Inside a phase the handle is reserved
+     * immediately but the entity only becomes alive at the next sync point.
+     * Returns INVALID_ENTITY (and asserts) when the capacity is exhausted.
+     */
     Entity CreateEntity()
     {
         std::lock_guard<std::mutex> lock(ecsMutex);
-        assert(livingEntityCount < MAX_ENTITIES && "Too many entities in existence.");
-        Entity id = availableEntities.front();
-        availableEntities.pop();
-        ++livingEntityCount;
+        Entity id = entities.Create();
+        assert(id != INVALID_ENTITY && "Too many entities in existence; raise SetEntityCapacity().");
+        if (id == INVALID_ENTITY) return id;
+        if (deferring.load(std::memory_order_relaxed))
+            deferred.Create(id);
+        else
+            storage.AddEntity(id);
         return id;
     }
 
+    /**
+     * @brief Destroy an entity. Stale handles (already destroyed, slot since
+     * reused) are ignored.
+     */
     void DestroyEntity(Entity entity)
+    {
+        if (deferring.load(std::memory_order_acquire))
+        {
+            LocalCommands().Destroy(entity);
+            return;
+        }
+        std::lock_guard<std::mutex> lock(ecsMutex);
+        if (!entities.IsAlive(entity)) return;
+        storage.RemoveEntity(entity);
+        ReleaseEntity(entity);
+    }
+
+    /**
+     * @brief Maximum number of simultaneously alive entities. May be raised
+     * at any time up to MAX_ENTITY_CAPACITY; slots are only allocated as
+     * entities are created.
+     */
+    void SetEntityCapacity(std::size_t capacity)
+    {
+        std::lock_guard<std::mutex> lock(ecsMutex);
+        entities.SetCapacity(capacity);
+    }
+
+    std::size_t EntityCapacity() const
+    {
+        std::lock_guard<std::mutex> lock(ecsMutex);
+        return entities.Capacity();
+    }
+
+    // Includes handles reserved inside the current phase.
+    std::size_t LivingEntityCount() const
+    {
+        std::lock_guard<std::mutex> lock(ecsMutex);
+        return entities.AliveCount();
+    }
+
+    /**
+     * @brief Invoke fn(entity) for every alive entity. Must not create or
+     * destroy entities from `fn` outside a phase.
+     */
+    template <typename Fn>
+    void ForEachEntity(Fn&& fn) const
+    {
+        entities.ForEach([&](Entity entity) {
+            if (storage.Contains(entity)) fn(entity);
+        });
+    }
+
+    /**
+     * @brief Start a system phase. Until EndPhase(), create/destroy/add/remove
+     * are recorded into command buffers instead of touching storage, so
+     * systems can read components and signatures without locking.
+     *
+     * Destroy/add/remove go to a buffer owned by the calling thread and take
+     * no lock, which keeps them cheap inside ForEachParallel bodies.
+     */
+    void BeginPhase()
+    {
+        std::lock_guard<std::mutex> lock(ecsMutex);
+        deferring.store(true, std::memory_order_release);
+    }
+
+    /**
+     * @brief Sync point between phases: apply the recorded structural changes.
+     * Entity creations are applied first so components added from any thread
+     * find their entity; the threads' buffers then replay one after another,
+     * in the order the threads first recorded into this coordinator (not hash
+     * order, which could differ from run to run), each in the order its
+     * thread issued them. Must not run concurrently with systems.
+     */
+    void EndPhase()
     {
         std::lock_guard<std::mutex> lock(ecsMutex);
-        assert(entity < MAX_ENTITIES && "Entity out of range.");
-        entitySignatures.erase(entity);
-        for (auto const& pair : componentArrays)
-            pair.second->EntityDestroyed(entity);
-        availableEntities.push(entity);
-        --livingEntityCount;
+        deferring.store(false, std::memory_order_release);
+        auto release = [this](Entity entity) { ReleaseEntity(entity); };
+        deferred.Apply(storage, release);
+        for (CommandBuffer* commands : commandOrder) commands->Apply(storage, release);
+    }
+
+    bool IsDeferring() const
+    {
+        return deferring.load(std::memory_order_relaxed);
+    }
+
+    // Only meaningful between systems (e.g. from the frame thread).
+    std::size_t PendingCommandCount() const
+    {
+        std::lock_guard<std::mutex> lock(ecsMutex);
+        std::size_t count = deferred.Size();
+        for (const CommandBuffer* commands : commandOrder) count += commands->Size();
+        return count;
     }
 
     template <typename T>
@@ -66,111 +166,255 @@ class Coordinator
         assert(componentTypes.find(typeIndex) == componentTypes.end() &&
                "Component already registered.");
 
-        void* mem = MemoryManager::Arena().Allocate(sizeof(ComponentArray<T>));
-        auto* array = new (mem) ComponentArray<T>();
-        componentTypes[typeIndex] = nextComponentType++;
-        componentArrays[typeIndex] =
-            std::shared_ptr<IComponentArray>(array, [](IComponentArray* ptr) {
-                ptr->~IComponentArray();
-            });
+        ComponentType type = nextComponentType++;
+        componentTypes[typeIndex] = type;
+        storage.RegisterComponent<T>(type);
     }
 
     template <typename T>
     void AddComponent(Entity entity, T component)
     {
+        AARTZE_CHECK_WRITE(GetComponentType<T>());
+        if (deferring.load(std::memory_order_acquire))
+        {
+            LocalCommands().Add(entity, GetComponentType<T>(), std::move(component));
+            return;
+        }
         std::lock_guard<std::mutex> lock(ecsMutex);
-        GetComponentArray<T>()->InsertData(entity, component);
-        entitySignatures[entity].set(GetComponentType<T>(), true);
+        storage.Add(entity, GetComponentType<T>(), std::move(component));
     }
 
     template <typename T>
     void RemoveComponent(Entity entity)
     {
+        AARTZE_CHECK_WRITE(GetComponentType<T>());
+        if (deferring.load(std::memory_order_acquire))
+        {
+            LocalCommands().Remove(entity, GetComponentType<T>());
+            return;
+        }
         std::lock_guard<std::mutex> lock(ecsMutex);
-        GetComponentArray<T>()->RemoveData(entity);
-        entitySignatures[entity].set(GetComponentType<T>(), false);
+        storage.Remove(entity, GetComponentType<T>());
     }
 
     template <typename T>
     T& GetComponent(Entity entity)
     {
-        return GetComponentArray<T>()->GetData(entity);
+        AARTZE_CHECK_READ(GetComponentType<T>());
+        return storage.Get<T>(entity, GetComponentType<T>());
     }
 
     template <typename T>
-    ComponentType GetComponentType()
+    bool IsComponentRegistered() const
     {
-        ComponentKey typeIndex = std::type_index(typeid(T));
-        assert(componentTypes.find(typeIndex) != componentTypes.end() &&
-               "Component not registered.");
-        return componentTypes[typeIndex];
+        return componentTypes.find(std::type_index(typeid(T))) != componentTypes.end();
     }
 
-    Signature GetSignature(Entity entity)
+    // Component types are registered at startup and never change afterwards,
+    // so the lookup below is a plain read and needs no lock.
+    template <typename T>
+    ComponentType GetComponentType() const
     {
-        std::lock_guard<std::mutex> lock(ecsMutex);
-        return entitySignatures[entity];
+        auto it = componentTypes.find(std::type_index(typeid(T)));
+        assert(it != componentTypes.end() && "Component not registered.");
+        return it != componentTypes.end() ? it->second : ComponentType(0);
+    }
+
+    // Reads below are lock-free. Storage only changes outside phases (from the
+    // main thread) or at the EndPhase() sync point, never while systems run.
+    Signature GetSignature(Entity entity) const
+    {
+        return storage.GetSignature(entity);
     }
 
     template <typename... Components>
     std::vector<Entity> GetEntitiesWithComponents()
     {
-        std::lock_guard<std::mutex> lock(ecsMutex);
         std::vector<Entity> result;
-        Signature required = GetCombinedSignature<Components...>();
-
-        for (const auto& [entity, signature] : entitySignatures)
-        {
-            if ((signature & required) == required)
-                result.push_back(entity);
-        }
+        CollectEntities<Components...>(result);
+        return result;
+    }
 
+    /**
+     * @brief Like GetEntitiesWithComponents(), but the snapshot lives in frame
+     * memory: no heap allocation, valid until the frame after next.
+     */
+    template <typename... Components>
+    FrameVector<Entity> GetFrameEntitiesWithComponents()
+    {
+        FrameVector<Entity> result;
+        CollectEntities<Components...>(result);
         return result;
     }
 
-    bool IsEntityAlive(Entity entity) const
+    /**
+     * @brief Return the persistent query for `Components`, registering it on
+     * first use. Systems should keep the reference and iterate it every frame.
+     */
+    template <typename... Components>
+    Query<Components...>& GetQuery()
     {
         std::lock_guard<std::mutex> lock(ecsMutex);
-        return entitySignatures.find(entity) != entitySignatures.end();
+        return GetQueryLocked<Components...>();
     }
 
+    /**
+     * @brief Invoke fn(entity, components...) for every entity that has all
+     * `Components`, walking archetype chunks column by column.
+     *
+     * Structural changes (create/destroy/add/remove) must not happen inside
+     * `fn`; collect them and apply after the loop, or use
+     * GetEntitiesWithComponents() which returns a snapshot.
+     */
+    template <typename... Components, typename Fn>
+    void ForEach(Fn&& fn)
+    {
+        GetQuery<Components...>().ForEach(std::forward<Fn>(fn));
+    }
+
+    /**
+     * @brief Like ForEach, but spreads the matching chunks over gJobSystem.
+     * `fn` runs concurrently and must only touch its own entity's components;
+     * structural changes from inside it are deferred as in any phase.
+     */
+    template <typename... Components, typename Fn>
+    void ForEachParallel(Fn&& fn)
+    {
+        GetQuery<Components...>().ForEachParallel(std::forward<Fn>(fn));
+    }
+
+    /**
+     * @brief Live versus reserved bytes of component `T` across all archetypes.
+     */
     template <typename T>
-    bool HasComponent(Entity entity) const
+    ComponentMemoryStats GetComponentMemoryStats() const
+    {
+        std::lock_guard<std::mutex> lock(ecsMutex);
+        return storage.GetComponentStats(GetComponentType<T>());
+    }
+
+    /**
+     * @brief Invoke fn(type, stats) for every registered component type.
+     */
+    template <typename Fn>
+    void ForEachComponentMemoryStats(Fn&& fn) const
     {
         std::lock_guard<std::mutex> lock(ecsMutex);
+        for (const auto& [key, type] : componentTypes) fn(key, storage.GetComponentStats(type));
+    }
+
+    /**
+     * @brief Pages held by all archetype chunks, including entity columns and padding.
+     */
+    PageAllocatorStats GetStorageMemoryStats() const
+    {
+        return gPageAllocator.GetStats();
+    }
+
+    bool IsEntityAlive(Entity entity) const
+    {
+        return storage.Contains(entity);
+    }
+
+    template <typename T>
+    bool HasComponent(Entity entity) const
+    {
         ComponentKey typeIndex = std::type_index(typeid(T));
         auto it = componentTypes.find(typeIndex);
         if (it == componentTypes.end()) return false;
 
-        ComponentType type = it->second;
-        auto sigIt = entitySignatures.find(entity);
-        if (sigIt == entitySignatures.end()) return false;
-
-        return sigIt->second.test(type);
+        return storage.Has(entity, it->second);
     }
 
    private:
-    std::queue<Entity> availableEntities;
+    EntityPool entities;
     using ComponentKey = std::type_index;
     std::unordered_map<ComponentKey, ComponentType> componentTypes;
-    std::unordered_map<ComponentKey, std::shared_ptr<IComponentArray>> componentArrays;
-    std::unordered_map<Entity, Signature> entitySignatures;
+    ArchetypeStorage storage;
+    std::unordered_map<ComponentKey, std::unique_ptr<IQuery>> queries;
+    CommandBuffer deferred;  // entity creations recorded during a phase
+    std::unordered_map<std::thread::id, std::unique_ptr<CommandBuffer>> threadCommands;
+    std::vector<CommandBuffer*> commandOrder;  // threadCommands by registration, the replay order
+    std::atomic<bool> deferring{false};
+    const std::uint64_t instanceId = NextInstanceId();
 
     ComponentType nextComponentType = 0;
-    uint32_t livingEntityCount = 0;
     mutable std::mutex ecsMutex;
 
-    template <typename T>
-    std::shared_ptr<ComponentArray<T>> GetComponentArray()
+    static std::uint64_t NextInstanceId()
     {
-        ComponentKey typeIndex = std::type_index(typeid(T));
-        assert(componentArrays.find(typeIndex) != componentArrays.end() &&
-               "Component not registered.");
-        return std::static_pointer_cast<ComponentArray<T>>(componentArrays[typeIndex]);
+        static std::atomic<std::uint64_t> next{1};
+        return next.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // The calling thread's command buffer, created on first use. Each thread
+    // remembers its buffers for the last few coordinators it touched; on a
+    // miss the buffer is looked up by thread, so switching between
+    // coordinators never creates a second buffer for the same pair.
+    CommandBuffer& LocalCommands()
+    {
+        struct Slot
+        {
+            std::uint64_t owner = 0;
+            CommandBuffer* commands = nullptr;
+        };
+        static constexpr std::size_t kCachedOwners = 4;
+        static thread_local Slot cache[kCachedOwners];
+        static thread_local std::size_t nextSlot = 0;
+        for (const Slot& slot : cache)
+            if (slot.owner == instanceId) return *slot.commands;
+
+        std::lock_guard<std::mutex> lock(ecsMutex);
+        std::unique_ptr<CommandBuffer>& commands = threadCommands[std::this_thread::get_id()];
+        if (!commands)
+        {
+            commands = std::make_unique<CommandBuffer>();
+            commandOrder.push_back(commands.get());
+        }
+        cache[nextSlot] = {instanceId, commands.get()};
+        nextSlot = (nextSlot + 1) % kCachedOwners;
+        return *commands;
+    }
+
+    template <typename... Components, typename Vector>
+    void CollectEntities(Vector& result)
+    {
+        std::lock_guard<std::mutex> lock(ecsMutex);
+        const Query<Components...>& query = GetQueryLocked<Components...>();
+        result.reserve(query.Count());
+
+        for (Archetype* archetype : query.Archetypes())
+        {
+            for (std::size_t c = 0; c < archetype->ChunkCount(); ++c)
+            {
+                const Entity* ids = archetype->Entities(c);
+                result.insert(result.end(), ids, ids + archetype->GetChunk(c).count);
+            }
+        }
+    }
+
+    void ReleaseEntity(Entity entity)
+    {
+        entities.Destroy(entity);
+    }
+
+    template <typename... Components>
+    Query<Components...>& GetQueryLocked()
+    {
+        ComponentKey key = std::type_index(typeid(Query<Components...>));
+        auto it = queries.find(key);
+        if (it == queries.end())
+        {
+            auto query = std::make_unique<Query<Components...>>(
+                storage.RegisterQuery(GetCombinedSignature<Components...>()),
+                typename Query<Components...>::TypeArray{GetComponentType<Components>()...});
+            it = queries.emplace(key, std::move(query)).first;
+        }
+        return static_cast<Query<Components...>&>(*it->second);
     }
 
     template <typename... Components>
-    Signature GetCombinedSignature()
+    Signature GetCombinedSignature() const
     {
         Signature sig;
         (sig.set(GetComponentType<Components>()), ...);
@@ -180,4 +424,3 @@ class Coordinator
 
 // === Global Instances ===
 inline Coordinator gCoordinator;
-inline ThreadPool gThreadPool(std::max<unsigned>(1, std::thread::hardware_concurrency()));
@@ -1,15 +1,56 @@
 #pragma once
 
+#include <bitset>
+#include <cstddef>
 #include <cstdint>
 
 /**
  * @brief Defines the type used for entities and components.
+ *
+ * An Entity is a generational handle: the low ENTITY_INDEX_BITS select a slot
+ * and the bits above hold that slot's generation, which is bumped every time
+ * the slot is freed. A handle kept past its entity's destruction therefore
+ * stops matching instead of aliasing whatever reuses the slot.
  */
 using Entity = std::uint32_t;
-constexpr Entity MAX_ENTITIES = 5000;
+
+constexpr unsigned ENTITY_INDEX_BITS = 22;
+// The top bit stays clear so handles survive round-trips through `int`
+// (editor selection, script bindings) where -1 means "none".
+constexpr unsigned ENTITY_GENERATION_BITS = 9;
+constexpr Entity ENTITY_INDEX_MASK = (Entity(1) << ENTITY_INDEX_BITS) - 1;
+constexpr Entity ENTITY_GENERATION_MASK = (Entity(1) << ENTITY_GENERATION_BITS) - 1;
+
+// Hard limit imposed by the handle layout (the all-ones index is reserved).
+constexpr std::size_t MAX_ENTITY_CAPACITY = ENTITY_INDEX_MASK;
+// Capacity the coordinator starts with; see Coordinator::SetEntityCapacity.
+constexpr std::size_t DEFAULT_ENTITY_CAPACITY = std::size_t(1) << 20;
+
+// Sentinel for "no entity"; never handed out by the coordinator.
+constexpr Entity INVALID_ENTITY = ~Entity(0);
+
+constexpr Entity EntityIndex(Entity entity)
+{
+    return entity & ENTITY_INDEX_MASK;
+}
+
+constexpr Entity EntityGeneration(Entity entity)
+{
+    return (entity >> ENTITY_INDEX_BITS) & ENTITY_GENERATION_MASK;
+}
+
+constexpr Entity MakeEntity(Entity index, Entity generation)
+{
+    return ((generation & ENTITY_GENERATION_MASK) << ENTITY_INDEX_BITS) | (index & ENTITY_INDEX_MASK);
+}
 
 using ComponentType = std::uint8_t;
 // Maximum number of component types supported by the engine.
 // Stored separately from ComponentType's underlying type so that
 // the value does not wrap when the limit exceeds 255.
 constexpr std::size_t MAX_COMPONENTS = 256;
+
+/**
+ * @brief Signature defines the set of components attached to an entity.
+ */
+using Signature = std::bitset<MAX_COMPONENTS>;
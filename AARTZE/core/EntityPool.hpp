@@ -0,0 +1,109 @@
+// File: AARTZE/core/EntityPool.hpp
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include "Entity.hpp"
+
+/**
+ * @brief Hands out generational entity handles from a dense slot array.
+ *
+ * A live slot holds its own handle. A free slot holds the index of the next
+ * free slot plus the generation the slot will be reused with, so the free
+ * list lives inside the array: create and destroy are O(1) and nothing is
+ * pre-filled. Slots are only added when the free list is empty, so memory
+ * follows the peak number of live entities rather than the capacity.
+ */
+class EntityPool
+{
+   public:
+    explicit EntityPool(std::size_t capacity = DEFAULT_ENTITY_CAPACITY)
+    {
+        SetCapacity(capacity);
+    }
+
+    /**
+     * @brief Limit the number of slots. Can be raised at any time up to
+     * MAX_ENTITY_CAPACITY; it cannot drop below the slots already in use.
+     */
+    void SetCapacity(std::size_t newCapacity)
+    {
+        assert(newCapacity <= MAX_ENTITY_CAPACITY && "Entity capacity exceeds the handle layout.");
+        assert(newCapacity >= slots.size() && "Entity capacity below slots already in use.");
+        if (newCapacity > MAX_ENTITY_CAPACITY) newCapacity = MAX_ENTITY_CAPACITY;
+        if (newCapacity < slots.size()) newCapacity = slots.size();
+        capacity = newCapacity;
+    }
+
+    std::size_t Capacity() const
+    {
+        return capacity;
+    }
+
+    /**
+     * @brief Allocate a handle, or return INVALID_ENTITY when at capacity.
+     */
+    Entity Create()
+    {
+        if (freeHead != FREE_LIST_END)
+        {
+            const Entity index = freeHead;
+            freeHead = EntityIndex(slots[index]);
+            slots[index] = MakeEntity(index, EntityGeneration(slots[index]));
+            ++aliveCount;
+            return slots[index];
+        }
+        if (slots.size() >= capacity) return INVALID_ENTITY;
+        const Entity entity = MakeEntity(static_cast<Entity>(slots.size()), 0);
+        slots.push_back(entity);
+        ++aliveCount;
+        return entity;
+    }
+
+    /**
+     * @brief Free `entity`'s slot and bump its generation. Stale handles are
+     * ignored.
+     */
+    void Destroy(Entity entity)
+    {
+        if (!IsAlive(entity)) return;
+        const Entity index = EntityIndex(entity);
+        // Generations wrap after 2^ENTITY_GENERATION_BITS reuses of one slot.
+        slots[index] = MakeEntity(freeHead, EntityGeneration(entity) + 1);
+        freeHead = index;
+        --aliveCount;
+    }
+
+    bool IsAlive(Entity entity) const
+    {
+        const Entity index = EntityIndex(entity);
+        return index < slots.size() && slots[index] == entity;
+    }
+
+    std::size_t AliveCount() const
+    {
+        return aliveCount;
+    }
+
+    /**
+     * @brief Invoke fn(entity) for every live handle in slot order.
+     */
+    template <typename Fn>
+    void ForEach(Fn&& fn) const
+    {
+        for (std::size_t i = 0; i < slots.size(); ++i)
+        {
+            if (EntityIndex(slots[i]) == i) fn(slots[i]);
+        }
+    }
+
+   private:
+    static constexpr Entity FREE_LIST_END = ENTITY_INDEX_MASK;
+
+    std::vector<Entity> slots;
+    Entity freeHead = FREE_LIST_END;
+    std::size_t aliveCount = 0;
+    std::size_t capacity = 0;
+};
@@ -0,0 +1,443 @@
+// File: AARTZE/core/JobSystem.hpp
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Fork/join fence: counts jobs that are still running.
+ * Pass it to JobSystem::Run and wait on it with JobSystem::Wait.
+ */
+struct JobCounter
+{
+    std::atomic<std::uint32_t> pending{0};
+
+    bool Done() const
+    {
+        return pending.load(std::memory_order_acquire) == 0;
+    }
+};
+
+/**
+ * @brief A unit of work with its callable stored inline, so submitting a
+ * job never touches the heap.
+ */
+struct alignas(64) Job
+{
+    static constexpr std::size_t STORAGE_BYTES = 96;
+
+    void (*invoke)(void* storage) = nullptr;  // runs and destroys the callable
+    JobCounter* counter = nullptr;
+    std::atomic<bool> inUse{false};
+    alignas(std::max_align_t) unsigned char storage[STORAGE_BYTES];
+};
+
+/**
+ * @brief Chase-Lev work-stealing deque. The owning worker pushes and pops at
+ * the bottom; any other thread steals from the top. Fixed capacity: Push
+ * returns false when full and the caller runs the job inline.
+ */
+class JobDeque
+{
+   public:
+    static constexpr std::int64_t CAPACITY = 4096;  // power of two
+
+    bool Push(Job* job)
+    {
+        std::int64_t b = bottom.load(std::memory_order_relaxed);
+        std::int64_t t = top.load(std::memory_order_acquire);
+        if (b - t >= CAPACITY) return false;
+        buffer[b & (CAPACITY - 1)].store(job, std::memory_order_relaxed);
+        bottom.store(b + 1, std::memory_order_release);  // publishes the job to thieves
+        return true;
+    }
+
+    Job* Pop()
+    {
+        std::int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t t = top.load(std::memory_order_relaxed);
+        if (t > b)
+        {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        Job* job = buffer[b & (CAPACITY - 1)].load(std::memory_order_relaxed);
+        if (t == b)
+        {
+            // Last element: race against thieves for it.
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                job = nullptr;
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    Job* Steal()
+    {
+        std::int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b) return nullptr;
+        Job* job = buffer[t & (CAPACITY - 1)].load(std::memory_order_relaxed);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr;
+        return job;
+    }
+
+   private:
+    alignas(64) std::atomic<std::int64_t> top{0};
+    alignas(64) std::atomic<std::int64_t> bottom{0};
+    std::unique_ptr<std::atomic<Job*>[]> buffer{new std::atomic<Job*>[CAPACITY]};
+};
+
+/**
+ * @brief Work-stealing job scheduler.
+ *
+ * Every worker owns a deque and a ring of job slots. Jobs submitted from a
+ * worker go to its own deque; jobs from other threads (main thread, loaders)
+ * go to a shared injection queue. Idle workers steal from each other, and any
+ * thread blocked in Wait() runs pending jobs instead of sleeping, so nested
+ * fork/join never parks a worker.
+ *
+ * Jobs submitted with Run() must fit Job::STORAGE_BYTES and must not throw.
+ * Enqueue() is for background work that needs a future (asset loading); it
+ * wraps the callable in a packaged_task and allocates like a std::async.
+ */
+class JobSystem
+{
+   public:
+    static constexpr std::size_t RING_SIZE = 4096;
+
+    explicit JobSystem(std::size_t threads)
+        : workers(std::max<std::size_t>(1, threads)), externalRing(new Job[RING_SIZE])
+    {
+        for (Worker& worker : workers) worker.ring.reset(new Job[RING_SIZE]);
+        for (std::size_t i = 0; i < workers.size(); ++i)
+            workers[i].thread = std::thread([this, i]() { WorkerLoop(i); });
+    }
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    ~JobSystem()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stop.store(true, std::memory_order_seq_cst);
+        }
+        sleepCondition.notify_all();
+        for (Worker& worker : workers)
+        {
+            if (worker.thread.joinable()) worker.thread.join();
+        }
+    }
+
+    std::size_t WorkerCount() const
+    {
+        return workers.size();
+    }
+
+    /**
+     * @brief Submit `fn` without allocating. If `counter` is given it is
+     * incremented now and decremented when `fn` returns.
+     */
+    template <typename Fn>
+    void Run(Fn&& fn, JobCounter* counter = nullptr)
+    {
+        using F = std::decay_t<Fn>;
+        static_assert(sizeof(F) <= Job::STORAGE_BYTES, "Job callable too large; capture by reference");
+        static_assert(alignof(F) <= alignof(std::max_align_t), "Job callable over-aligned");
+
+        if (counter) counter->pending.fetch_add(1, std::memory_order_relaxed);
+        // Count before publishing so a thief can never drive `queued` negative.
+        queued.fetch_add(1, std::memory_order_seq_cst);
+
+        const int self = CurrentWorker();
+        if (self < 0)
+        {
+            std::unique_lock<std::mutex> lock(injectionMutex);
+            Job* job = AcquireSlot(externalRing.get(), externalCursor, &lock);
+            Prepare(*job, std::forward<Fn>(fn), counter);
+            injection.push_back(job);
+            injectionSize.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            Worker& worker = workers[self];
+            Job* job = AcquireSlot(worker.ring.get(), worker.cursor, nullptr);
+            Prepare(*job, std::forward<Fn>(fn), counter);
+            if (!worker.deque.Push(job))
+            {
+                queued.fetch_sub(1, std::memory_order_relaxed);
+                Execute(job);  // deque full: run inline
+                return;
+            }
+        }
+        WakeOne();
+    }
+
+    /**
+     * @brief Submit a long-running background task (file IO, decoding) and
+     * get its result through a future. Background tasks only run on workers
+     * once no frame jobs are left, and are never picked up by a thread
+     * helping inside Wait(), so a slow load cannot stall a fork/join.
+     */
+    template <typename Fn>
+    auto Enqueue(Fn&& fn) -> std::future<std::invoke_result_t<Fn>>
+    {
+        using R = std::invoke_result_t<Fn>;
+        auto task = std::make_shared<std::packaged_task<R()>>(std::forward<Fn>(fn));
+        std::future<R> result = task->get_future();
+        queued.fetch_add(1, std::memory_order_seq_cst);
+        {
+            std::lock_guard<std::mutex> lock(injectionMutex);
+            background.emplace_back([task]() { (*task)(); });
+        }
+        WakeOne();
+        return result;
+    }
+
+    /**
+     * @brief Block until `counter` drops to zero, running other jobs meanwhile.
+     */
+    void Wait(const JobCounter& counter)
+    {
+        while (!counter.Done())
+        {
+            if (!TryRunOne()) std::this_thread::yield();
+        }
+    }
+
+    /**
+     * @brief Run one pending job on the calling thread if there is one.
+     */
+    bool TryRunOne()
+    {
+        Job* job = FindJob(CurrentWorker());
+        if (!job) return false;
+        Execute(job);
+        return true;
+    }
+
+    /**
+     * @brief Call fn(first, last) over sub-ranges of [begin, end) no larger
+     * than `grain`, in parallel, and return when all have finished. The
+     * range is split recursively so idle workers steal large halves first.
+     */
+    template <typename Fn>
+    void ParallelFor(std::size_t begin, std::size_t end, std::size_t grain, Fn&& fn)
+    {
+        if (end <= begin) return;
+        grain = std::max<std::size_t>(1, grain);
+        JobCounter counter;
+        Split(begin, end, grain, fn, counter);
+        Wait(counter);
+    }
+
+   private:
+    struct Worker
+    {
+        JobDeque deque;
+        std::unique_ptr<Job[]> ring;
+        std::size_t cursor = 0;
+        std::thread thread;
+    };
+
+    struct ThreadContext
+    {
+        const JobSystem* system = nullptr;
+        int index = -1;
+    };
+
+    std::vector<Worker> workers;
+
+    std::mutex injectionMutex;
+    std::deque<Job*> injection;
+    std::deque<std::function<void()>> background;
+    std::atomic<std::size_t> injectionSize{0};
+    std::unique_ptr<Job[]> externalRing;
+    std::size_t externalCursor = 0;
+
+    std::atomic<std::int64_t> queued{0};
+    std::atomic<int> sleeping{0};
+    std::atomic<bool> stop{false};
+    std::mutex sleepMutex;
+    std::condition_variable sleepCondition;
+
+    static ThreadContext& Context()
+    {
+        static thread_local ThreadContext context;
+        return context;
+    }
+
+    int CurrentWorker() const
+    {
+        const ThreadContext& context = Context();
+        return context.system == this ? context.index : -1;
+    }
+
+    template <typename Fn>
+    static void Prepare(Job& job, Fn&& fn, JobCounter* counter)
+    {
+        using F = std::decay_t<Fn>;
+        new (job.storage) F(std::forward<Fn>(fn));
+        job.invoke = [](void* storage) {
+            F* callable = static_cast<F*>(storage);
+            (*callable)();
+            callable->~F();
+        };
+        job.counter = counter;
+    }
+
+    // Find a free slot in `ring`. Slots are reused round-robin; if every slot
+    // is still in flight, help run jobs until one frees up.
+    Job* AcquireSlot(Job* ring, std::size_t& cursor, std::unique_lock<std::mutex>* lock)
+    {
+        for (;;)
+        {
+            for (std::size_t n = 0; n < RING_SIZE; ++n)
+            {
+                Job& job = ring[cursor++ & (RING_SIZE - 1)];
+                bool expected = false;
+                if (job.inUse.compare_exchange_strong(expected, true, std::memory_order_acquire))
+                    return &job;
+            }
+            if (lock) lock->unlock();
+            if (!TryRunOne()) std::this_thread::yield();
+            if (lock) lock->lock();
+        }
+    }
+
+    void Execute(Job* job)
+    {
+        JobCounter* counter = job->counter;
+        job->invoke(job->storage);
+        job->inUse.store(false, std::memory_order_release);
+        if (counter) counter->pending.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    Job* FindJob(int self)
+    {
+        Job* job = nullptr;
+        if (self >= 0) job = workers[self].deque.Pop();
+        if (!job && injectionSize.load(std::memory_order_relaxed) > 0)
+        {
+            std::lock_guard<std::mutex> lock(injectionMutex);
+            if (!injection.empty())
+            {
+                job = injection.front();
+                injection.pop_front();
+                injectionSize.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+        if (!job)
+        {
+            const std::size_t count = workers.size();
+            const std::size_t start = self >= 0 ? std::size_t(self) + 1 : NextVictim();
+            for (std::size_t n = 0; n < count && !job; ++n)
+            {
+                std::size_t victim = (start + n) % count;
+                if (int(victim) != self) job = workers[victim].deque.Steal();
+            }
+        }
+        if (job) queued.fetch_sub(1, std::memory_order_relaxed);
+        return job;
+    }
+
+    static std::size_t NextVictim()
+    {
+        static thread_local std::uint32_t state = 0x9E3779B9u ^
+            static_cast<std::uint32_t>(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    bool RunBackground()
+    {
+        std::function<void()> task;
+        {
+            std::lock_guard<std::mutex> lock(injectionMutex);
+            if (background.empty()) return false;
+            task = std::move(background.front());
+            background.pop_front();
+        }
+        queued.fetch_sub(1, std::memory_order_relaxed);
+        task();
+        return true;
+    }
+
+    void WakeOne()
+    {
+        if (sleeping.load(std::memory_order_seq_cst) == 0) return;
+        { std::lock_guard<std::mutex> lock(sleepMutex); }
+        sleepCondition.notify_one();
+    }
+
+    void WorkerLoop(std::size_t index)
+    {
+        Context() = {this, static_cast<int>(index)};
+        int idleSpins = 0;
+        for (;;)
+        {
+            if (Job* job = FindJob(static_cast<int>(index)))
+            {
+                Execute(job);
+                idleSpins = 0;
+                continue;
+            }
+            if (RunBackground())
+            {
+                idleSpins = 0;
+                continue;
+            }
+            if (stop.load(std::memory_order_acquire) && queued.load(std::memory_order_seq_cst) <= 0) return;
+            if (++idleSpins < 64)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            sleeping.fetch_add(1, std::memory_order_seq_cst);
+            {
+                std::unique_lock<std::mutex> lock(sleepMutex);
+                sleepCondition.wait(lock, [this]() {
+                    return stop.load(std::memory_order_relaxed) ||
+                           queued.load(std::memory_order_seq_cst) > 0;
+                });
+            }
+            sleeping.fetch_sub(1, std::memory_order_seq_cst);
+            idleSpins = 0;
+        }
+    }
+
+    template <typename Fn>
+    void Split(std::size_t begin, std::size_t end, std::size_t grain, Fn& fn, JobCounter& counter)
+    {
+        while (end - begin > grain)
+        {
+            std::size_t mid = begin + (end - begin) / 2;
+            Run([this, mid, end, grain, &fn, &counter]() { Split(mid, end, grain, fn, counter); }, &counter);
+            end = mid;
+        }
+        fn(begin, end);
+    }
+};
+
+// The frame thread helps out while it waits on jobs, so leave it a core.
+inline JobSystem gJobSystem(std::max<unsigned>(2, std::thread::hardware_concurrency()) - 1);
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
@@ -8,184 +10,600 @@
 #include <cstring>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <new>
 #include <string>
+#include <thread>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
 // === MemoryArena ===
+// Linear allocator for transient data. Not thread-safe: every thread gets its
+// own frame arena from MemoryManager::FrameArena(). When a frame outgrows the
+// current block another one is chained on, and the next Reset() merges them
+// into a single block so steady-state frames never hit malloc.
 class MemoryArena
 {
    public:
-    MemoryArena(size_t sizeBytes = 64 * 1024 * 1024) : m_size(sizeBytes), m_offset(0)
+    explicit MemoryArena(size_t sizeBytes = 1024 * 1024) : m_blockSize(std::max<size_t>(sizeBytes, 64))
     {
-        m_buffer = static_cast<uint8_t*>(std::malloc(sizeBytes));
-        if (!m_buffer)
-        {
-            throw std::bad_alloc();
-        }
+        m_blocks.push_back(NewBlock(m_blockSize));
     }
 
     ~MemoryArena()
     {
-        std::free(m_buffer);
+        for (Block& block : m_blocks) std::free(block.data);
     }
 
+    MemoryArena(const MemoryArena&) = delete;
+    MemoryArena& operator=(const MemoryArena&) = delete;
+
     void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t))
     {
-        size_t current = reinterpret_cast<size_t>(m_buffer) + m_offset;
+        Block& block = m_blocks.back();
+        size_t current = reinterpret_cast<size_t>(block.data) + m_offset;
         size_t aligned = (current + alignment - 1) & ~(alignment - 1);
-        size_t offset = aligned - reinterpret_cast<size_t>(m_buffer);
+        size_t offset = aligned - reinterpret_cast<size_t>(block.data);
 
-        if (offset + size > m_size)
+        if (offset + size > block.size)
         {
-            throw std::bad_alloc();
+            m_blocks.push_back(NewBlock(std::max(m_blockSize, size + alignment)));
+            m_offset = 0;
+            return Allocate(size, alignment);
         }
 
-        void* ptr = m_buffer + offset;
         m_offset = offset + size;
-        return ptr;
+        m_used += size;
+        m_highWater = std::max(m_highWater, m_used);
+        return block.data + offset;
+    }
+
+    /**
+     * @brief Uninitialized storage for `count` objects of trivially destructible T.
+     */
+    template <typename T>
+    T* AllocateArray(size_t count)
+    {
+        static_assert(std::is_trivially_destructible_v<T>, "Arena memory is released without running destructors.");
+        return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
     }
 
     void Reset()
     {
+        if (m_blocks.size() > 1)
+        {
+            size_t total = 0;
+            for (Block& block : m_blocks)
+            {
+                total += block.size;
+                std::free(block.data);
+            }
+            m_blocks.clear();
+            m_blockSize = total;
+            m_blocks.push_back(NewBlock(total));
+        }
         m_offset = 0;
+        m_used = 0;
+    }
+
+    size_t Used() const
+    {
+        return m_used;
+    }
+
+    size_t Capacity() const
+    {
+        size_t total = 0;
+        for (const Block& block : m_blocks) total += block.size;
+        return total;
+    }
+
+    size_t HighWater() const
+    {
+        return m_highWater;
     }
 
    private:
-    uint8_t* m_buffer = nullptr;
+    struct Block
+    {
+        uint8_t* data = nullptr;
+        size_t size = 0;
+    };
+
+    std::vector<Block> m_blocks;
+    size_t m_blockSize = 0;
     size_t m_offset = 0;
-    size_t m_size = 0;
+    size_t m_used = 0;
+    size_t m_highWater = 0;
+
+    static Block NewBlock(size_t size)
+    {
+        Block block{static_cast<uint8_t*>(std::malloc(size)), size};
+        if (!block.data)
+        {
+            throw std::bad_alloc();
+        }
+        return block;
+    }
 };
 
 // === PoolAllocator ===
+// Size-classed free lists for small objects. Each thread allocates from and
+// frees into its own cache without locking; caches exchange fixed batches with
+// a per-class central list, which grows by whole chunks when it runs dry.
+// Requests above the largest class go straight to malloc.
+constexpr std::array<size_t, 14> POOL_SIZE_CLASSES = {16,  32,  48,  64,  96,   128,  192,
+                                                      256, 384, 512, 768, 1024, 1536, 2048};
+constexpr size_t POOL_MAX_SMALL_SIZE = POOL_SIZE_CLASSES.back();
+
 class PoolAllocator
 {
    public:
-    PoolAllocator(size_t elementSize = 64, size_t elementCount = 1024)
-        : m_elementSize(std::max(elementSize, sizeof(void*))), m_elementCount(elementCount)
+    static constexpr size_t CHUNK_BYTES = 64 * 1024;
+    static constexpr uint32_t BATCH = 32;
+
+    PoolAllocator() = default;
+    PoolAllocator(const PoolAllocator&) = delete;
+    PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+    ~PoolAllocator()
+    {
+        for (void* chunk : m_chunks) std::free(chunk);
+    }
+
+    void* Allocate(size_t size)
     {
-        m_pool = static_cast<uint8_t*>(std::malloc(m_elementSize * m_elementCount));
-        if (!m_pool)
+        if (size > POOL_MAX_SMALL_SIZE)
         {
-            throw std::bad_alloc();
+            void* ptr = std::malloc(size);
+            if (!ptr)
+            {
+                throw std::bad_alloc();
+            }
+            return ptr;
         }
 
-        m_freeList = reinterpret_cast<void**>(m_pool);
-        for (size_t i = 0; i < m_elementCount - 1; ++i)
+        size_t sizeClass = ClassOf(size);
+        FreeList& list = LocalCache().lists[sizeClass];
+        if (!list.head) Refill(sizeClass, list);
+        void* head = list.head;
+        list.head = *static_cast<void**>(head);
+        --list.count;
+        return head;
+    }
+
+    /**
+     * @brief Return memory from Allocate(). `size` must match the request.
+     */
+    void Free(void* ptr, size_t size)
+    {
+        if (!ptr) return;
+        if (size > POOL_MAX_SMALL_SIZE)
         {
-            void* current = m_pool + i * m_elementSize;
-            void* next = m_pool + (i + 1) * m_elementSize;
-            *reinterpret_cast<void**>(current) = next;
+            std::free(ptr);
+            return;
         }
-        *reinterpret_cast<void**>(m_pool + (m_elementCount - 1) * m_elementSize) = nullptr;
+
+        size_t sizeClass = ClassOf(size);
+        FreeList& list = LocalCache().lists[sizeClass];
+        *static_cast<void**>(ptr) = list.head;
+        list.head = ptr;
+        if (++list.count > 2 * BATCH) Drain(sizeClass, list);
     }
 
-    ~PoolAllocator()
+    size_t ReservedBytes() const
+    {
+        return m_reservedBytes.load(std::memory_order_relaxed);
+    }
+
+   private:
+    struct FreeList
+    {
+        void* head = nullptr;
+        uint32_t count = 0;
+    };
+
+    struct ThreadCache
+    {
+        std::array<FreeList, POOL_SIZE_CLASSES.size()> lists{};
+    };
+
+    struct Central
+    {
+        std::mutex mutex;
+        FreeList list;
+    };
+
+    std::array<Central, POOL_SIZE_CLASSES.size()> m_central;
+    std::mutex m_mutex;  // guards m_caches and m_chunks
+    std::unordered_map<std::thread::id, std::unique_ptr<ThreadCache>> m_caches;
+    std::vector<void*> m_chunks;
+    std::atomic<size_t> m_reservedBytes{0};
+    const uint64_t m_instanceId = NextInstanceId();
+
+    static uint64_t NextInstanceId()
     {
-        std::free(m_pool);
+        static std::atomic<uint64_t> next{1};
+        return next.fetch_add(1, std::memory_order_relaxed);
     }
 
-    void* Allocate()
+    static size_t ClassOf(size_t size)
     {
-        if (!m_freeList)
+        size_t sizeClass = 0;
+        while (POOL_SIZE_CLASSES[sizeClass] < size) ++sizeClass;
+        return sizeClass;
+    }
+
+    // The calling thread's cache, created on first use. Caches belong to the
+    // allocator, so blocks held by a thread that exits stay reserved until
+    // the allocator is destroyed. A thread remembers its caches in the last
+    // few allocators it used and otherwise finds its existing one by thread
+    // id, so moving between allocators does not create a cache per switch.
+    ThreadCache& LocalCache()
+    {
+        struct Slot
         {
-            throw std::bad_alloc();
-        }
+            uint64_t owner = 0;
+            ThreadCache* cache = nullptr;
+        };
+        static constexpr size_t CACHED_OWNERS = 4;
+        static thread_local Slot slots[CACHED_OWNERS];
+        static thread_local size_t nextSlot = 0;
+        for (const Slot& slot : slots)
+            if (slot.owner == m_instanceId) return *slot.cache;
 
-        void* head = m_freeList;
-        m_freeList = reinterpret_cast<void**>(*m_freeList);
-        return head;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::unique_ptr<ThreadCache>& cache = m_caches[std::this_thread::get_id()];
+        if (!cache) cache = std::make_unique<ThreadCache>();
+        slots[nextSlot] = {m_instanceId, cache.get()};
+        nextSlot = (nextSlot + 1) % CACHED_OWNERS;
+        return *cache;
     }
 
-    void Free(void* ptr)
+    void Refill(size_t sizeClass, FreeList& list)
     {
-        *reinterpret_cast<void**>(ptr) = m_freeList;
-        m_freeList = reinterpret_cast<void**>(ptr);
+        Central& central = m_central[sizeClass];
+        std::lock_guard<std::mutex> lock(central.mutex);
+        if (!central.list.head) Grow(sizeClass, central.list);
+        while (central.list.head && list.count < BATCH)
+        {
+            void* node = central.list.head;
+            central.list.head = *static_cast<void**>(node);
+            --central.list.count;
+            *static_cast<void**>(node) = list.head;
+            list.head = node;
+            ++list.count;
+        }
     }
 
-   private:
-    uint8_t* m_pool = nullptr;
-    void** m_freeList = nullptr;
-    size_t m_elementSize = 0;
-    size_t m_elementCount = 0;
+    void Drain(size_t sizeClass, FreeList& list)
+    {
+        // Detach the first BATCH nodes and splice them onto the central list.
+        void* first = list.head;
+        void* last = first;
+        for (uint32_t i = 1; i < BATCH; ++i) last = *static_cast<void**>(last);
+        list.head = *static_cast<void**>(last);
+        list.count -= BATCH;
+
+        Central& central = m_central[sizeClass];
+        std::lock_guard<std::mutex> lock(central.mutex);
+        *static_cast<void**>(last) = central.list.head;
+        central.list.head = first;
+        central.list.count += BATCH;
+    }
+
+    // Called with the class's central mutex held.
+    void Grow(size_t sizeClass, FreeList& list)
+    {
+        const size_t elementSize = POOL_SIZE_CLASSES[sizeClass];
+        const size_t chunkBytes = std::max(CHUNK_BYTES, elementSize * BATCH);
+        auto* chunk = static_cast<uint8_t*>(std::malloc(chunkBytes));
+        if (!chunk)
+        {
+            throw std::bad_alloc();
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_chunks.push_back(chunk);
+        }
+        m_reservedBytes.fetch_add(chunkBytes, std::memory_order_relaxed);
+
+        for (size_t offset = 0; offset + elementSize <= chunkBytes; offset += elementSize)
+        {
+            void* node = chunk + offset;
+            *static_cast<void**>(node) = list.head;
+            list.head = node;
+            ++list.count;
+        }
+    }
 };
 
 // === TrackingAllocator ===
+// Tagged allocations on top of the pool. Tags are small integers registered
+// once at startup; every allocation only bumps the tag's atomic counters.
+using MemoryTag = uint16_t;
+constexpr size_t MAX_MEMORY_TAGS = 64;
+constexpr MemoryTag MEMORY_TAG_UNTAGGED = 0;
+
+struct MemoryTagStats
+{
+    size_t bytes = 0;        // currently allocated
+    size_t peakBytes = 0;
+    size_t allocations = 0;  // lifetime count
+    size_t frees = 0;
+};
+
 class TrackingAllocator
 {
    public:
-    void* Allocate(size_t size, const std::string& tag)
+    explicit TrackingAllocator(PoolAllocator& pool) : m_pool(pool)
     {
-        void* ptr = std::malloc(size);
-        if (!ptr)
-        {
-            throw std::bad_alloc();
-        }
+        m_names[MEMORY_TAG_UNTAGGED] = "Untagged";
+        m_tagCount = 1;
+    }
 
-        m_allocations[ptr] = {size, tag};
-        return ptr;
+    /**
+     * @brief Register a tag name and return its ID. Registering an existing
+     * name returns the same ID.
+     */
+    MemoryTag RegisterTag(const std::string& name)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (size_t i = 0; i < m_tagCount; ++i)
+            if (m_names[i] == name) return static_cast<MemoryTag>(i);
+        assert(m_tagCount < MAX_MEMORY_TAGS && "Too many memory tags.");
+        if (m_tagCount == MAX_MEMORY_TAGS) return MEMORY_TAG_UNTAGGED;
+        m_names[m_tagCount] = name;
+        return static_cast<MemoryTag>(m_tagCount++);
+    }
+
+    void* Allocate(size_t size, MemoryTag tag = MEMORY_TAG_UNTAGGED)
+    {
+        auto* header = static_cast<Header*>(m_pool.Allocate(size + sizeof(Header)));
+        header->size = size;
+        header->tag = tag;
+        Record(tag, size);
+        return header + 1;
     }
 
     void Free(void* ptr)
     {
-        auto it = m_allocations.find(ptr);
-        if (it != m_allocations.end())
-        {
-            m_allocations.erase(it);
-        }
-        std::free(ptr);
+        if (!ptr) return;
+        Header* header = static_cast<Header*>(ptr) - 1;
+        Release(header->tag, header->size);
+        m_pool.Free(header, header->size + sizeof(Header));
     }
 
-    void ReportLeaks() const
+    /**
+     * @brief Count `size` bytes against `tag` for memory allocated elsewhere.
+     */
+    void Record(MemoryTag tag, size_t size)
     {
-        if (m_allocations.empty())
+        Counters& c = m_counters[tag];
+        size_t now = c.bytes.fetch_add(size, std::memory_order_relaxed) + size;
+        c.allocations.fetch_add(1, std::memory_order_relaxed);
+        size_t peak = c.peakBytes.load(std::memory_order_relaxed);
+        while (now > peak && !c.peakBytes.compare_exchange_weak(peak, now, std::memory_order_relaxed))
         {
-            std::cout << "[MEMORY] No leaks detected.\n";
-            return;
         }
+    }
+
+    void Release(MemoryTag tag, size_t size)
+    {
+        Counters& c = m_counters[tag];
+        c.bytes.fetch_sub(size, std::memory_order_relaxed);
+        c.frees.fetch_add(1, std::memory_order_relaxed);
+    }
 
-        std::cout << "[MEMORY] Leak Report:\n";
-        for (const auto& [ptr, info] : m_allocations)
+    MemoryTagStats GetStats(MemoryTag tag) const
+    {
+        const Counters& c = m_counters[tag];
+        return {c.bytes.load(std::memory_order_relaxed), c.peakBytes.load(std::memory_order_relaxed),
+                c.allocations.load(std::memory_order_relaxed), c.frees.load(std::memory_order_relaxed)};
+    }
+
+    const std::string& TagName(MemoryTag tag) const
+    {
+        return m_names[tag];
+    }
+
+    size_t TagCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_tagCount;
+    }
+
+    void ReportLeaks() const
+    {
+        bool leaked = false;
+        for (size_t tag = 0; tag < TagCount(); ++tag)
         {
-            std::cout << " - Leak at " << ptr << " | Size: " << info.size << " | Tag: " << info.tag
-                      << "\n";
+            MemoryTagStats stats = GetStats(static_cast<MemoryTag>(tag));
+            if (stats.bytes == 0 && stats.allocations == stats.frees) continue;
+            if (!leaked) std::cout << "[MEMORY] Leak Report:\n";
+            leaked = true;
+            std::cout << " - Tag: " << m_names[tag] << " | Bytes: " << stats.bytes
+                      << " | Outstanding: " << (stats.allocations - stats.frees) << "\n";
         }
+        if (!leaked) std::cout << "[MEMORY] No leaks detected.\n";
     }
 
    private:
-    struct AllocationInfo
+    // Keeps the payload 16-byte aligned like the pool's size classes.
+    struct alignas(16) Header
     {
         size_t size;
-        std::string tag;
+        MemoryTag tag;
     };
 
-    std::unordered_map<void*, AllocationInfo> m_allocations;
+    struct Counters
+    {
+        std::atomic<size_t> bytes{0};
+        std::atomic<size_t> peakBytes{0};
+        std::atomic<size_t> allocations{0};
+        std::atomic<size_t> frees{0};
+    };
+
+    PoolAllocator& m_pool;
+    std::array<Counters, MAX_MEMORY_TAGS> m_counters;
+    std::array<std::string, MAX_MEMORY_TAGS> m_names;
+    size_t m_tagCount = 0;
+    mutable std::mutex m_mutex;
+};
+
+// === FrameAllocator ===
+// Double-buffered per-thread frame arenas. BeginFrame() flips to the other
+// buffer and rewinds it, so memory handed out during frame N stays valid
+// through frame N+1 (long enough for data consumed by the next frame or
+// still referenced by an in-flight upload) and is reclaimed in frame N+2.
+class FrameAllocator
+{
+   public:
+    explicit FrameAllocator(size_t arenaBytes = 1024 * 1024) : m_arenaBytes(arenaBytes) {}
+    FrameAllocator(const FrameAllocator&) = delete;
+    FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+    /**
+     * @brief Start a new frame. Call from the frame's driving thread while
+     * no jobs are running.
+     */
+    void BeginFrame()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        unsigned next = m_current.load(std::memory_order_relaxed) ^ 1u;
+        for (auto& [thread, arenas] : m_threads) arenas->buffers[next].Reset();
+        m_current.store(next, std::memory_order_relaxed);
+        ++m_frame;
+    }
+
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t))
+    {
+        return ThreadArena().Allocate(size, alignment);
+    }
+
+    template <typename T>
+    T* AllocateArray(size_t count)
+    {
+        return ThreadArena().AllocateArray<T>(count);
+    }
+
+    /**
+     * @brief The calling thread's arena for the current frame.
+     */
+    MemoryArena& ThreadArena()
+    {
+        return LocalArenas().buffers[m_current.load(std::memory_order_relaxed)];
+    }
+
+    /**
+     * @brief Bytes handed out on all threads since the last BeginFrame().
+     */
+    size_t BytesThisFrame() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        size_t total = 0;
+        unsigned current = m_current.load(std::memory_order_relaxed);
+        for (const auto& [thread, arenas] : m_threads) total += arenas->buffers[current].Used();
+        return total;
+    }
+
+    uint64_t FrameIndex() const
+    {
+        return m_frame;
+    }
+
+   private:
+    struct ThreadArenas
+    {
+        explicit ThreadArenas(size_t bytes) : buffers{MemoryArena(bytes), MemoryArena(bytes)} {}
+        MemoryArena buffers[2];
+    };
+
+    size_t m_arenaBytes;
+    std::atomic<unsigned> m_current{0};
+    uint64_t m_frame = 0;
+    mutable std::mutex m_mutex;  // guards m_threads
+    std::unordered_map<std::thread::id, std::unique_ptr<ThreadArenas>> m_threads;
+    const uint64_t m_instanceId = NextInstanceId();
+
+    static uint64_t NextInstanceId()
+    {
+        static std::atomic<uint64_t> next{1};
+        return next.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // The calling thread's pair of arenas, created on first use; looked up the
+    // same way as PoolAllocator::LocalCache().
+    ThreadArenas& LocalArenas()
+    {
+        struct Slot
+        {
+            uint64_t owner = 0;
+            ThreadArenas* arenas = nullptr;
+        };
+        static constexpr size_t CACHED_OWNERS = 4;
+        static thread_local Slot slots[CACHED_OWNERS];
+        static thread_local size_t nextSlot = 0;
+        for (const Slot& slot : slots)
+            if (slot.owner == m_instanceId) return *slot.arenas;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::unique_ptr<ThreadArenas>& arenas = m_threads[std::this_thread::get_id()];
+        if (!arenas) arenas = std::make_unique<ThreadArenas>(m_arenaBytes);
+        slots[nextSlot] = {m_instanceId, arenas.get()};
+        nextSlot = (nextSlot + 1) % CACHED_OWNERS;
+        return *arenas;
+    }
 };
 
 // === MemoryManager ===
 class MemoryManager
 {
    public:
-    static void Initialize(size_t arenaSizeBytes = 64 * 1024 * 1024)
+    // Nested Initialize/Shutdown pairs are reference counted; only the
+    // outermost pair creates and destroys the allocators.
+    static void Initialize(size_t frameArenaBytes = 1024 * 1024)
     {
-        memoryArena = std::make_unique<MemoryArena>(arenaSizeBytes);
+        if (initCount++ > 0) return;
         poolAllocator = std::make_unique<PoolAllocator>();
-        trackingAllocator = std::make_unique<TrackingAllocator>();
+        trackingAllocator = std::make_unique<TrackingAllocator>(*poolAllocator);
+        defaultFrameAllocator = std::make_unique<FrameAllocator>(frameArenaBytes);
     }
 
     static void Shutdown()
     {
+        if (initCount == 0 || --initCount > 0) return;
         trackingAllocator->ReportLeaks();
-        memoryArena.reset();
-        poolAllocator.reset();
+        activeFrameAllocator = nullptr;
+        defaultFrameAllocator.reset();
         trackingAllocator.reset();
+        poolAllocator.reset();
+    }
+
+    /**
+     * @brief Make `allocator` the target of Frame() (nullptr restores the
+     * default). Application::Run installs the allocator it resets each frame;
+     * code running without it must call Frame().BeginFrame() itself.
+     */
+    static void SetFrameAllocator(FrameAllocator* allocator)
+    {
+        activeFrameAllocator = allocator;
+    }
+
+    static FrameAllocator& Frame()
+    {
+        return activeFrameAllocator ? *activeFrameAllocator : *defaultFrameAllocator;
     }
 
-    static MemoryArena& Arena()
+    /**
+     * @brief The calling thread's arena for the current frame.
+     */
+    static MemoryArena& FrameArena()
     {
-        return *memoryArena;
+        return Frame().ThreadArena();
     }
+
     static PoolAllocator& Pool()
     {
         return *poolAllocator;
@@ -196,7 +614,53 @@ class MemoryManager
     }
 
    private:
-    inline static std::unique_ptr<MemoryArena> memoryArena;
     inline static std::unique_ptr<PoolAllocator> poolAllocator;
     inline static std::unique_ptr<TrackingAllocator> trackingAllocator;
+    inline static std::unique_ptr<FrameAllocator> defaultFrameAllocator;
+    inline static FrameAllocator* activeFrameAllocator = nullptr;
+    inline static int initCount = 0;
+};
+
+// === FrameStlAllocator ===
+// Lets standard containers live in frame memory. deallocate() is a no-op:
+// the memory comes back when the frame buffer is rewound, so a container
+// must not outlive the frame after the one it was filled in.
+template <typename T>
+class FrameStlAllocator
+{
+   public:
+    using value_type = T;
+
+    FrameStlAllocator() : m_frame(&MemoryManager::Frame()) {}
+    explicit FrameStlAllocator(FrameAllocator& frame) : m_frame(&frame) {}
+    template <typename U>
+    FrameStlAllocator(const FrameStlAllocator<U>& other) : m_frame(other.m_frame)
+    {
+    }
+
+    T* allocate(size_t count)
+    {
+        return static_cast<T*>(m_frame->Allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    void deallocate(T*, size_t) {}
+
+    template <typename U>
+    bool operator==(const FrameStlAllocator<U>& other) const
+    {
+        return m_frame == other.m_frame;
+    }
+    template <typename U>
+    bool operator!=(const FrameStlAllocator<U>& other) const
+    {
+        return m_frame != other.m_frame;
+    }
+
+   private:
+    template <typename U>
+    friend class FrameStlAllocator;
+    FrameAllocator* m_frame;
 };
+
+template <typename T>
+using FrameVector = std::vector<T, FrameStlAllocator<T>>;
@@ -0,0 +1,169 @@
+// File: AARTZE/core/PageAllocator.hpp
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+// Component storage is carved from fixed-size pages. Pages come from larger
+// blocks reserved on demand; a block is returned to the system as soon as its
+// last page is freed, so memory follows the live entity count instead of a
+// worst-case reservation.
+constexpr std::size_t PAGE_BYTES = 16 * 1024;
+constexpr std::size_t PAGES_PER_BLOCK = 64;
+constexpr std::size_t PAGE_BLOCK_BYTES = PAGE_BYTES * PAGES_PER_BLOCK;
+
+/**
+ * @brief Snapshot of a PageAllocator's usage.
+ */
+struct PageAllocatorStats
+{
+    std::size_t pagesInUse = 0;
+    std::size_t blocks = 0;
+    std::size_t largeAllocations = 0;  // requests bigger than a page, served directly
+    std::size_t usedBytes = 0;         // pages in use plus large allocations
+    std::size_t reservedBytes = 0;     // blocks held from the system plus large allocations
+};
+
+/**
+ * @brief Hands out PAGE_BYTES-sized, page-aligned memory from 1 MB blocks.
+ *
+ * Requests larger than a page fall back to a dedicated aligned allocation.
+ * All entry points are serialized by an internal mutex; allocation only
+ * happens when an archetype grows or shrinks by a whole chunk.
+ */
+class PageAllocator
+{
+   public:
+    PageAllocator() = default;
+    PageAllocator(const PageAllocator&) = delete;
+    PageAllocator& operator=(const PageAllocator&) = delete;
+
+    ~PageAllocator()
+    {
+        assert(large.empty() && "Large page allocations leaked.");
+        for (Block& block : blocks) ReleaseBlock(block);
+    }
+
+    void* Allocate(std::size_t bytes)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (bytes > PAGE_BYTES)
+        {
+            void* ptr = ::operator new(bytes, std::align_val_t(PAGE_BYTES));
+            large.emplace(ptr, bytes);
+            largeBytes += bytes;
+            return ptr;
+        }
+
+        Block* block = nullptr;
+        for (Block& candidate : blocks)
+        {
+            if (candidate.freeMask != 0)
+            {
+                block = &candidate;
+                break;
+            }
+        }
+        if (!block)
+        {
+            Block fresh;
+            fresh.base = static_cast<std::uint8_t*>(
+                ::operator new(PAGE_BLOCK_BYTES, std::align_val_t(PAGE_BLOCK_BYTES)));
+            fresh.freeMask = ~std::uint64_t{0};
+            blocks.push_back(fresh);
+            block = &blocks.back();
+        }
+
+        unsigned page = LowestBit(block->freeMask);
+        block->freeMask &= ~(std::uint64_t{1} << page);
+        ++pagesInUse;
+        return block->base + page * PAGE_BYTES;
+    }
+
+    void Free(void* ptr)
+    {
+        if (!ptr) return;
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = large.find(ptr);
+        if (it != large.end())
+        {
+            largeBytes -= it->second;
+            large.erase(it);
+            ::operator delete(ptr, std::align_val_t(PAGE_BYTES));
+            return;
+        }
+
+        // Blocks are aligned to their size, so the owning block is found by masking.
+        auto* base = reinterpret_cast<std::uint8_t*>(reinterpret_cast<std::uintptr_t>(ptr) &
+                                                     ~static_cast<std::uintptr_t>(PAGE_BLOCK_BYTES - 1));
+        for (std::size_t i = 0; i < blocks.size(); ++i)
+        {
+            Block& block = blocks[i];
+            if (block.base != base) continue;
+            std::size_t page = (static_cast<std::uint8_t*>(ptr) - base) / PAGE_BYTES;
+            assert(!(block.freeMask & (std::uint64_t{1} << page)) && "Page freed twice.");
+            block.freeMask |= std::uint64_t{1} << page;
+            --pagesInUse;
+            if (block.freeMask == ~std::uint64_t{0})
+            {
+                ReleaseBlock(block);
+                blocks[i] = blocks.back();
+                blocks.pop_back();
+            }
+            return;
+        }
+        assert(false && "Pointer was not allocated by this PageAllocator.");
+    }
+
+    PageAllocatorStats GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        PageAllocatorStats stats;
+        stats.pagesInUse = pagesInUse;
+        stats.blocks = blocks.size();
+        stats.largeAllocations = large.size();
+        stats.usedBytes = pagesInUse * PAGE_BYTES + largeBytes;
+        stats.reservedBytes = blocks.size() * PAGE_BLOCK_BYTES + largeBytes;
+        return stats;
+    }
+
+   private:
+    struct Block
+    {
+        std::uint8_t* base = nullptr;
+        std::uint64_t freeMask = 0;  // bit set = page free
+    };
+
+    static_assert(PAGES_PER_BLOCK == 64, "Block free mask holds exactly 64 pages.");
+
+    mutable std::mutex mutex;
+    std::vector<Block> blocks;
+    std::unordered_map<void*, std::size_t> large;
+    std::size_t pagesInUse = 0;
+    std::size_t largeBytes = 0;
+
+    static unsigned LowestBit(std::uint64_t mask)
+    {
+        unsigned bit = 0;
+        while (!(mask & 1))
+        {
+            mask >>= 1;
+            ++bit;
+        }
+        return bit;
+    }
+
+    static void ReleaseBlock(Block& block)
+    {
+        ::operator delete(block.base, std::align_val_t(PAGE_BLOCK_BYTES));
+        block.base = nullptr;
+    }
+};
+
+// Shared by every archetype chunk in the process.
+inline PageAllocator gPageAllocator;
@@ -1,18 +1,43 @@
 #pragma once
+#include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <mutex>
 #include <string>
 #include <vector>
 
 struct ProfileEvent { std::string name; double ms; };
+struct ProfileCounter { std::string name; std::uint64_t value; };
+
+// Bumped by the counting operator new when built with AARTZE_COUNT_HEAP_ALLOCATIONS.
+inline std::atomic<std::uint64_t> gHeapAllocationCount{0};
 
 class Profiler
 {
 public:
-    void NewFrame() { lastFrame.clear(); }
-    void Add(const std::string& name, double ms) { lastFrame.push_back({name, ms}); }
+    void NewFrame()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        lastFrame.clear();
+        lastCounters.clear();
+        std::uint64_t now = gHeapAllocationCount.load(std::memory_order_relaxed);
+        lastFrameAllocations = now - frameStartAllocations;
+        frameStartAllocations = now;
+    }
+    // Systems may finish on worker threads, so events are appended under a lock.
+    void Add(const std::string& name, double ms) { std::lock_guard<std::mutex> lock(mutex); lastFrame.push_back({name, ms}); }
     const std::vector<ProfileEvent>& GetLastFrame() const { return lastFrame; }
+    // Per-frame values (draw counts, culling results) reported alongside timings.
+    void AddCounter(const std::string& name, std::uint64_t value) { std::lock_guard<std::mutex> lock(mutex); lastCounters.push_back({name, value}); }
+    const std::vector<ProfileCounter>& GetLastFrameCounters() const { return lastCounters; }
+    // Heap allocations made between the last two NewFrame() calls, on any thread.
+    std::uint64_t GetLastFrameAllocations() const { return lastFrameAllocations; }
 private:
     std::vector<ProfileEvent> lastFrame;
+    std::vector<ProfileCounter> lastCounters;
+    std::uint64_t frameStartAllocations = 0;
+    std::uint64_t lastFrameAllocations = 0;
+    std::mutex mutex;
 };
 
 struct ProfileScope
@@ -0,0 +1,176 @@
+// File: AARTZE/core/Query.hpp
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Archetype.hpp"
+#include "Entity.hpp"
+#include "JobSystem.hpp"
+#include "SystemAccess.hpp"
+
+/**
+ * @brief Interface for cached queries (used internally by Coordinator).
+ */
+class IQuery
+{
+   public:
+    virtual ~IQuery() = default;
+};
+
+/**
+ * @brief Persistent view over every entity that has all `Components`.
+ *
+ * Obtain one through Coordinator::GetQuery and keep it: the set of matching
+ * archetypes is maintained by the storage as entities change signature, so
+ * iterating takes no lock and allocates nothing. Structural changes
+ * (create/destroy/add/remove) must not happen while iterating.
+ */
+template <typename... Components>
+class Query : public IQuery
+{
+   public:
+    using TypeArray = std::array<ComponentType, sizeof...(Components)>;
+
+    Query(const ArchetypeQuery* state, const TypeArray& types) : state(state), types(types) {}
+
+    /**
+     * @brief Invoke fn(entity, components...) for every matching entity.
+     */
+    template <typename Fn>
+    void ForEach(Fn&& fn) const
+    {
+#if AARTZE_ECS_ACCESS_CHECKS
+        for (ComponentType type : types) AARTZE_CHECK_READ(type);
+#endif
+        for (Archetype* archetype : state->matches)
+        {
+            for (std::size_t c = 0; c < archetype->ChunkCount(); ++c)
+                ForEachInChunk(*archetype, c, 0, archetype->GetChunk(c).count, fn,
+                               std::index_sequence_for<Components...>{});
+        }
+    }
+
+    /**
+     * @brief Invoke fn(entity, components...) for every matching entity,
+     * spreading the work over `jobs`, and return when all of it is done.
+     *
+     * The matching rows are cut into jobs of `grainRows` entities. By default
+     * the grain gives every worker a few jobs for load balancing but never
+     * exceeds one storage chunk (16 KB), so a job's working set stays in
+     * cache. `fn` runs concurrently and must only write the components it is
+     * handed.
+     */
+    template <typename Fn>
+    void ForEachParallel(JobSystem& jobs, Fn&& fn, std::size_t grainRows = 0) const
+    {
+#if AARTZE_ECS_ACCESS_CHECKS
+        for (ComponentType type : types) AARTZE_CHECK_READ(type);
+#endif
+        const std::size_t total = state->Count();
+        if (total == 0) return;
+        if (grainRows == 0)
+        {
+            std::size_t chunkRows = total;
+            for (Archetype* archetype : state->matches)
+                chunkRows = std::min<std::size_t>(chunkRows, archetype->ChunkCapacity());
+            const std::size_t perJob = total / (4 * (jobs.WorkerCount() + 1));
+            grainRows = std::clamp<std::size_t>(perJob, std::min<std::size_t>(16, chunkRows), chunkRows);
+        }
+
+        const SystemAccess* access = SystemAccessScope::current;
+        const char* system = SystemAccessScope::currentName;
+        jobs.ParallelFor(0, total, grainRows, [&](std::size_t first, std::size_t last) {
+            SystemAccessScope scope(access, system);
+            ForEachRowInRange(first, last, fn);
+        });
+    }
+
+    template <typename Fn>
+    void ForEachParallel(Fn&& fn, std::size_t grainRows = 0) const
+    {
+        ForEachParallel(gJobSystem, std::forward<Fn>(fn), grainRows);
+    }
+
+    /**
+     * @brief Number of entities currently matching the query.
+     */
+    std::size_t Count() const
+    {
+        return state->Count();
+    }
+
+    const std::vector<Archetype*>& Archetypes() const
+    {
+        return state->matches;
+    }
+
+    const TypeArray& Types() const
+    {
+        return types;
+    }
+
+   private:
+    const ArchetypeQuery* state;
+    TypeArray types;
+
+    // Visit rows [first, last) of the concatenation of all matching
+    // archetypes. Every chunk but an archetype's last is full, so a row index
+    // maps straight to (chunk, row).
+    template <typename Fn>
+    void ForEachRowInRange(std::size_t first, std::size_t last, Fn& fn) const
+    {
+        std::size_t base = 0;
+        for (Archetype* archetype : state->matches)
+        {
+            const std::size_t size = archetype->Size();
+            if (first < base + size)
+            {
+                const std::size_t capacity = archetype->ChunkCapacity();
+                const std::size_t end = std::min(last, base + size);
+                for (std::size_t row = first - base; row < end - base;)
+                {
+                    const std::size_t chunk = row / capacity;
+                    const std::size_t chunkEnd = std::min(end - base, (chunk + 1) * capacity);
+                    ForEachInChunk(*archetype, chunk, static_cast<std::uint32_t>(row - chunk * capacity),
+                                   static_cast<std::uint32_t>(chunkEnd - chunk * capacity), fn,
+                                   std::index_sequence_for<Components...>{});
+                    row = chunkEnd;
+                }
+                first = end;
+                if (first >= last) return;
+            }
+            base += size;
+        }
+    }
+
+    template <typename Fn, std::size_t... I>
+    void ForEachInChunk(Archetype& archetype, std::size_t chunk, std::uint32_t begin, std::uint32_t end,
+                        Fn& fn, std::index_sequence<I...>) const
+    {
+        const Entity* ids = archetype.Entities(chunk);
+        std::tuple<Components*...> cols{archetype.Column<Components>(chunk, types[I])...};
+        for (std::uint32_t row = begin; row < end; ++row)
+            fn(ids[row], ColumnAt<Components>(std::get<I>(cols), row)...);
+    }
+
+    template <typename T>
+    static T& ColumnAt(T* column, std::uint32_t row)
+    {
+        if constexpr (std::is_empty_v<T>)
+        {
+            static T tag{};
+            return tag;
+        }
+        else
+        {
+            return column[row];
+        }
+    }
+};
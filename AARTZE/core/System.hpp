@@ -1,5 +1,7 @@
 #pragma once
 
+class SystemAccessBuilder;
+
 /**
  * @brief Base class for all systems in the ECS architecture.
  * Systems operate on entities with specific component sets.
@@ -20,4 +22,11 @@ class System
     {
         return "UnnamedSystem";
     }
+
+    /**
+     * @brief Declare the components Update() reads and writes so the
+     * scheduler can run it alongside non-conflicting systems. Systems that
+     * declare nothing run exclusively.
+     */
+    virtual void DeclareAccess(SystemAccessBuilder& /*access*/) const {}
 };
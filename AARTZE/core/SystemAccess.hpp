@@ -0,0 +1,102 @@
+// File: AARTZE/core/SystemAccess.hpp
+#pragma once
+
+#include <cassert>
+#include <iostream>
+
+#include "Entity.hpp"
+
+// Undeclared-access detection is on in debug builds unless overridden.
+#ifndef AARTZE_ECS_ACCESS_CHECKS
+#ifdef NDEBUG
+#define AARTZE_ECS_ACCESS_CHECKS 0
+#else
+#define AARTZE_ECS_ACCESS_CHECKS 1
+#endif
+#endif
+
+/**
+ * @brief Components a system reads and writes during its update.
+ *
+ * A system that declares nothing is treated as exclusive and never overlaps
+ * with another system. `mainThread` pins the system to the thread that drives
+ * the frame (for GL uploads and other thread-affine work).
+ */
+struct SystemAccess
+{
+    Signature reads;
+    Signature writes;
+    bool exclusive = true;
+    bool mainThread = false;
+
+    bool CanRead(ComponentType type) const
+    {
+        return exclusive || reads.test(type) || writes.test(type);
+    }
+
+    bool CanWrite(ComponentType type) const
+    {
+        return exclusive || writes.test(type);
+    }
+
+    /**
+     * @brief True when the two systems may not run at the same time.
+     */
+    bool ConflictsWith(const SystemAccess& other) const
+    {
+        if (exclusive || other.exclusive) return true;
+        if ((writes & (other.reads | other.writes)).any()) return true;
+        return (other.writes & reads).any();
+    }
+};
+
+/**
+ * @brief Access declaration of the system running on the calling thread.
+ * Set by SystemScheduler around each update; null outside systems.
+ */
+struct SystemAccessScope
+{
+    inline static thread_local const SystemAccess* current = nullptr;
+    inline static thread_local const char* currentName = nullptr;
+
+    SystemAccessScope(const SystemAccess& access, const char* name) : SystemAccessScope(&access, name) {}
+
+    // Re-establishes a captured scope on a worker running part of a system.
+    SystemAccessScope(const SystemAccess* access, const char* name)
+        : prevAccess(current), prevName(currentName)
+    {
+        current = access;
+        currentName = name;
+    }
+
+    ~SystemAccessScope()
+    {
+        current = prevAccess;
+        currentName = prevName;
+    }
+
+    SystemAccessScope(const SystemAccessScope&) = delete;
+    SystemAccessScope& operator=(const SystemAccessScope&) = delete;
+
+   private:
+    const SystemAccess* prevAccess;
+    const char* prevName;
+};
+
+#if AARTZE_ECS_ACCESS_CHECKS
+inline void CheckComponentAccess(ComponentType type, bool write)
+{
+    const SystemAccess* access = SystemAccessScope::current;
+    if (!access) return;
+    bool allowed = write ? access->CanWrite(type) : access->CanRead(type);
+    if (allowed) return;
+    std::cerr << "[ECS] " << (SystemAccessScope::currentName ? SystemAccessScope::currentName : "system")
+              << (write ? " writes" : " reads") << " undeclared component type " << static_cast<int>(type) << "\n";
+    assert(false && "Undeclared component access; update the system's DeclareAccess().");
+}
+#define AARTZE_CHECK_READ(type) CheckComponentAccess((type), false)
+#define AARTZE_CHECK_WRITE(type) CheckComponentAccess((type), true)
+#else
+#define AARTZE_CHECK_READ(type) ((void)0)
+#define AARTZE_CHECK_WRITE(type) ((void)0)
+#endif
@@ -20,19 +20,23 @@
 #include "../../AARTZE/systems/AnimationSystem/AnimationSystem.hpp"
 #include "../../AARTZE/systems/StreamingSystem/StreamingSystem.hpp"
 #include "core/Profiler.hpp"
+#include "core/SystemScheduler.hpp"
 
 /*
  * Thread Safety Design Notes
  * --------------------------
- * The ECS coordinator (`gCoordinator`) protects entity creation and component
- * registration with a mutex, but `GetComponent` accesses are unsynchronized.
- * Running system updates in parallel previously caused data races when multiple
- * systems modified the same components. See docs/ThreadSafetyAudit.md for the
- * components each system touches.
+ * `Update()` runs the systems inside a coordinator phase. While the phase is
+ * open, create/destroy/add/remove are recorded into a command buffer and
+ * applied at the `EndPhase()` sync point, so signature and component reads
+ * (`HasComponent`, `GetSignature`, `IsEntityAlive`, `GetComponent`) are
+ * lock-free and storage never changes underneath a running system.
  *
- * To avoid corruption we now execute systems serially inside `Update()`.
- * Systems can be grouped into parallel batches in the future once their
- * interactions are verified to be read‑only or otherwise safe.
+ * Each system declares the components it reads and writes
+ * (`System::DeclareAccess`). The scheduler orders systems that conflict on a
+ * component by registration order and runs the rest concurrently on
+ * `gJobSystem`. Debug builds (AARTZE_ECS_ACCESS_CHECKS) assert when a system
+ * touches a component it did not declare. Streaming uploads to GL and is
+ * pinned to the main thread.
  */
 
 class SystemManager
@@ -51,21 +55,43 @@ class SystemManager
     AnimationSystem animationSystem;
     StreamingSystem streamingSystem;
 
+    SystemManager()
+    {
+        // Registration order is the execution order for conflicting systems
+        scheduler.Add(streamingSystem, "Streaming");
+        scheduler.Add(trailEffectSystem, "TrailEffect");
+        scheduler.Add(stealthSystem, "Stealth");
+        scheduler.Add(aimingSystem, "Aiming");
+        scheduler.Add(decalSystem, "Decal");
+        scheduler.Add(vehicleSystem, "Vehicle");
+        scheduler.Add(weatherSystem, "Weather");
+        scheduler.Add(animationSystem, "Animation");
+        scheduler.Add(navigationSystem, "Navigation");
+        scheduler.Add(physicsSystem, "Physics");
+    }
+
+    SystemManager(const SystemManager&) = delete;
+    SystemManager& operator=(const SystemManager&) = delete;
+
     void Update(float deltaTime)
     {
-        // Serial updates to avoid data races; profile each
-        { ProfileScope _p(gProfiler, "Streaming");  streamingSystem.Update(deltaTime); }
-        { ProfileScope _p(gProfiler, "TrailEffect"); trailEffectSystem.Update(deltaTime); }
-        { ProfileScope _p(gProfiler, "Stealth");     stealthSystem.Update(deltaTime); }
-        { ProfileScope _p(gProfiler, "Aiming");      aimingSystem.Update(deltaTime); }
-        { ProfileScope _p(gProfiler, "Decal");       decalSystem.Update(deltaTime); }
-        { ProfileScope _p(gProfiler, "Vehicle");     vehicleSystem.Update(deltaTime); }
-        { ProfileScope _p(gProfiler, "Weather");     weatherSystem.Update(deltaTime); }
-        { ProfileScope _p(gProfiler, "Animation");   animationSystem.Update(deltaTime); }
-        { ProfileScope _p(gProfiler, "Navigation");  navigationSystem.Update(deltaTime); }
-        { ProfileScope _p(gProfiler, "Physics");     physicsSystem.Update(deltaTime); }
+        gCoordinator.BeginPhase();
+        scheduler.Run(deltaTime);
+        { ProfileScope _p(gProfiler, "ECS Sync"); gCoordinator.EndPhase(); }
         // textRenderingSystem: drawn in Application after render pass
     }
+
+    /**
+     * @brief Disable to run systems one after another on the calling thread
+     * (useful when bisecting a suspected race).
+     */
+    void SetParallelUpdates(bool enabled)
+    {
+        scheduler.SetParallel(enabled);
+    }
+
+   private:
+    SystemScheduler scheduler;
 };
 
 extern std::unique_ptr<SystemManager> gSystemManager;
@@ -0,0 +1,238 @@
+// File: AARTZE/core/SystemScheduler.hpp
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Coordinator.hpp"
+#include "Profiler.hpp"
+#include "System.hpp"
+#include "SystemAccess.hpp"
+
+/**
+ * @brief Passed to System::DeclareAccess() to list the components a system
+ * touches. Declaring anything makes the system eligible to run in parallel.
+ */
+class SystemAccessBuilder
+{
+   public:
+    SystemAccessBuilder(const Coordinator& coordinator, SystemAccess& access)
+        : coordinator(coordinator), access(access)
+    {
+    }
+
+    template <typename... Components>
+    SystemAccessBuilder& Read()
+    {
+        access.exclusive = false;
+        (Declare<Components>(access.reads), ...);
+        return *this;
+    }
+
+    template <typename... Components>
+    SystemAccessBuilder& Write()
+    {
+        access.exclusive = false;
+        (Declare<Components>(access.writes), ...);
+        return *this;
+    }
+
+    /**
+     * @brief Run this system on the thread that calls SystemScheduler::Run.
+     */
+    SystemAccessBuilder& MainThread()
+    {
+        access.exclusive = false;
+        access.mainThread = true;
+        return *this;
+    }
+
+   private:
+    const Coordinator& coordinator;
+    SystemAccess& access;
+
+    template <typename T>
+    void Declare(Signature& sig)
+    {
+        // Unregistered components cannot be stored, so there is nothing to guard.
+        if (coordinator.IsComponentRegistered<T>()) sig.set(coordinator.GetComponentType<T>());
+    }
+};
+
+/**
+ * @brief Runs systems as a dependency graph on gJobSystem.
+ *
+ * Two systems conflict when one writes a component the other reads or
+ * writes; conflicting systems keep their registration order, everything else
+ * may overlap. The graph is built on the first Run() (components must be
+ * registered by then) and rebuilt after Add(). The calling thread runs
+ * main-thread systems and helps with other jobs while it waits.
+ */
+class SystemScheduler
+{
+   public:
+    SystemScheduler() = default;
+    SystemScheduler(const SystemScheduler&) = delete;
+    SystemScheduler& operator=(const SystemScheduler&) = delete;
+
+    void Add(System& system, const char* label)
+    {
+        nodes.push_back({&system, label, {}, {}, 0});
+        built = false;
+    }
+
+    /**
+     * @brief Resolve every system's access declaration and link conflicting
+     * systems in registration order.
+     */
+    void Build(const Coordinator& coordinator)
+    {
+        for (Node& node : nodes)
+        {
+            node.access = SystemAccess{};
+            node.successors.clear();
+            node.dependencyCount = 0;
+            SystemAccessBuilder builder(coordinator, node.access);
+            node.system->DeclareAccess(builder);
+        }
+        for (std::size_t i = 0; i < nodes.size(); ++i)
+        {
+            for (std::size_t j = i + 1; j < nodes.size(); ++j)
+            {
+                if (!nodes[i].access.ConflictsWith(nodes[j].access)) continue;
+                nodes[i].successors.push_back(j);
+                ++nodes[j].dependencyCount;
+            }
+        }
+        pending.reset(new std::atomic<std::size_t>[nodes.size()]);
+        built = true;
+    }
+
+    /**
+     * @brief Update every system once and return when all have finished.
+     * With parallel execution disabled, systems run in registration order.
+     */
+    void Run(float deltaTime)
+    {
+        if (!built) Build(gCoordinator);
+
+        if (!parallel)
+        {
+            for (Node& node : nodes) Execute(node, deltaTime);
+            return;
+        }
+
+        frameDeltaTime = deltaTime;
+        error = nullptr;
+        remaining.store(nodes.size(), std::memory_order_relaxed);
+        for (std::size_t i = 0; i < nodes.size(); ++i)
+            pending[i].store(nodes[i].dependencyCount, std::memory_order_relaxed);
+        for (std::size_t i = 0; i < nodes.size(); ++i)
+        {
+            if (nodes[i].dependencyCount == 0) MarkReady(i);
+        }
+
+        while (remaining.load(std::memory_order_acquire) > 0)
+        {
+            std::size_t index;
+            if (PopMainThread(index))
+                RunNode(index);
+            else if (!gJobSystem.TryRunOne())
+                std::this_thread::yield();
+        }
+
+        if (error)
+        {
+            std::exception_ptr rethrow = error;
+            error = nullptr;
+            std::rethrow_exception(rethrow);
+        }
+    }
+
+    void SetParallel(bool enabled)
+    {
+        parallel = enabled;
+    }
+
+    bool IsParallel() const
+    {
+        return parallel;
+    }
+
+    std::size_t SystemCount() const
+    {
+        return nodes.size();
+    }
+
+   private:
+    struct Node
+    {
+        System* system;
+        const char* label;
+        SystemAccess access;
+        std::vector<std::size_t> successors;
+        std::size_t dependencyCount;
+    };
+
+    std::vector<Node> nodes;
+    std::unique_ptr<std::atomic<std::size_t>[]> pending;
+    std::atomic<std::size_t> remaining{0};
+    float frameDeltaTime = 0.0f;
+    bool built = false;
+    bool parallel = true;
+
+    std::mutex mutex;  // guards mainThreadReady and error
+    std::vector<std::size_t> mainThreadReady;
+    std::exception_ptr error;
+
+    void Execute(Node& node, float deltaTime)
+    {
+        SystemAccessScope scope(node.access, node.label);
+        ProfileScope _p(gProfiler, node.label);
+        node.system->Update(deltaTime);
+    }
+
+    void MarkReady(std::size_t index)
+    {
+        if (nodes[index].access.mainThread)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            mainThreadReady.push_back(index);
+            return;
+        }
+        gJobSystem.Run([this, index]() { RunNode(index); });
+    }
+
+    bool PopMainThread(std::size_t& index)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (mainThreadReady.empty()) return false;
+        index = mainThreadReady.back();
+        mainThreadReady.pop_back();
+        return true;
+    }
+
+    void RunNode(std::size_t index)
+    {
+        try
+        {
+            Execute(nodes[index], frameDeltaTime);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error) error = std::current_exception();
+        }
+
+        for (std::size_t next : nodes[index].successors)
+        {
+            if (pending[next].fetch_sub(1, std::memory_order_acq_rel) == 1) MarkReady(next);
+        }
+        remaining.fetch_sub(1, std::memory_order_acq_rel);
+    }
+};
@@ -4,6 +4,7 @@
 #include <vector>
 
 #include "EditorActions.hpp"
+#include "ai_worldgen/WorldGenerator.hpp"
 #include "save/SaveSystem.hpp"
 
 namespace {
@@ -23,7 +24,7 @@ void Exec(const std::string& line)
     std::string cmd; iss >> cmd;
     if (cmd == "help")
     {
-        gLog.push_back("Commands: help, save [file], load [file], cube, physics");
+        gLog.push_back("Commands: help, save [file], load [file], cube, physics, worldgen <prompt>");
         return;
     }
     else if (cmd == "save")
@@ -44,6 +45,11 @@ void Exec(const std::string& line)
     {
         EditorActions::CreatePhysicsDemo(); gLog.push_back("Created physics demo"); return;
     }
+    else if (cmd == "worldgen")
+    {
+        std::string prompt; std::getline(iss >> std::ws, prompt);
+        EditorActions::SpawnGeneratedWorld(AARTZE::GenerateWorld(prompt)); gLog.push_back("Generated world"); return;
+    }
     gLog.push_back("Unknown command. Try 'help'.");
 }
 }
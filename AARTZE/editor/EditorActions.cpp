@@ -5,15 +5,17 @@
 #include <string>
 #include <vector>
 
-#include "World/MeshRegistry.hpp"
+#include "World/AssetRegistry.hpp"
 #include "components/RenderableComponent.hpp"
 #include "components/TransformComponent.hpp"
 #include "components/MaterialComponent.hpp"
 #include "components/physics/RigidBodyComponent.hpp"
 #include "components/physics/BoxColliderComponent.hpp"
 #include "systems/RenderingSystem/RenderResources.hpp"
+#include "utils/CookedMesh.hpp"
 #include "utils/MeshUtils.hpp"
 #include "EditorState.hpp"
+#include "ai_worldgen/WorldGenerator.hpp"
 #include "core/SystemManager.hpp"
 
 static MeshData MakeUnitCube()
@@ -49,12 +51,18 @@ static std::string toLowerExt(const std::string& p){ auto e = std::filesystem::p
 
 uint32_t ImportMeshAndUpload(const std::string& path)
 {
+    const std::string cooked = ResolveCookedMesh(path);
+    if (!cooked.empty())
+    {
+        uint32_t meshId = gAssetRegistry.RegisterMesh(path).id;
+        if (RenderResources::UploadCookedMesh(meshId, cooked)) return meshId;
+    }
     MeshData md;
     std::string ext = toLowerExt(path);
     if (ext == ".gltf" || ext == ".glb") md = LoadGltfModel(path, true, 1.0f);
     else md = LoadMeshAny(path, true, 1.0f);
     if (md.vertices.empty()) return 0;
-    uint32_t meshId = RegisterMesh(path);
+    uint32_t meshId = gAssetRegistry.RegisterMesh(path).id;
     RenderResources::UploadMesh(meshId, md);
     return meshId;
 }
@@ -74,10 +82,34 @@ int CreateEntityFromMeshPath(const std::string& path)
     return (int)e;
 }
 
+int SpawnWorldMesh(const std::string& path, const std::array<float, 3>& position)
+{
+    uint32_t meshId = gAssetRegistry.RegisterMesh(path).id;
+    if (meshId == 0) return -1;
+    // Without the streaming system (tools), load it here as imports do.
+    if (gSystemManager) gSystemManager->streamingSystem.AddWorldAsset(position.data(), meshId, path);
+    else if (ImportMeshAndUpload(path) == 0) return -1;
+
+    auto e = gCoordinator.CreateEntity();
+    TransformComponent tr; tr.position = position;
+    RenderableComponent rc; rc.meshId = meshId; rc.isVisible = true;
+    MaterialComponent mc; mc.baseColor[0]=0.8f; mc.baseColor[1]=0.8f; mc.baseColor[2]=0.8f;
+    gCoordinator.AddComponent(e, tr);
+    gCoordinator.AddComponent(e, rc);
+    gCoordinator.AddComponent(e, mc);
+    return (int)e;
+}
+
+void SpawnGeneratedWorld(const AARTZE::GeneratedWorld& world)
+{
+    for (const auto& piece : world.terrain) SpawnWorldMesh(piece.meshPath, {0.0f,0.0f,0.0f});
+    for (const auto& entity : world.entities) SpawnWorldMesh(entity.meshPath, entity.position);
+}
+
 int CreateDemoCubeEntity()
 {
     MeshData md = MakeUnitCube();
-    uint32_t meshId = RegisterMesh("AARTZE:CUBE");
+    uint32_t meshId = gAssetRegistry.RegisterMesh("AARTZE:CUBE").id;
     RenderResources::UploadMesh(meshId, md);
     auto e = gCoordinator.CreateEntity();
     TransformComponent tr; tr.position = {0.0f,0.0f,0.0f};
@@ -95,7 +127,7 @@ void CreatePhysicsDemo()
     {
         auto e = gCoordinator.CreateEntity();
         TransformComponent tr; tr.position = {0.0f,-1.0f,0.0f}; tr.scale={20.0f,1.0f,20.0f};
-        RenderableComponent rc; rc.meshId = RegisterMesh("AARTZE:GROUND");
+        RenderableComponent rc; rc.meshId = gAssetRegistry.RegisterMesh("AARTZE:GROUND").id;
         MaterialComponent mc; mc.baseColor[0]=0.2f; mc.baseColor[1]=0.8f; mc.baseColor[2]=0.2f; mc.roughness=1.0f;
         gCoordinator.AddComponent(e,tr); gCoordinator.AddComponent(e,rc); gCoordinator.AddComponent(e,mc);
         // physics
@@ -109,7 +141,7 @@ void CreatePhysicsDemo()
     {
         auto e = gCoordinator.CreateEntity();
         TransformComponent tr; tr.position = {0.0f,3.0f,0.0f};
-        RenderableComponent rc; rc.meshId = RegisterMesh("AARTZE:CUBE");
+        RenderableComponent rc; rc.meshId = gAssetRegistry.RegisterMesh("AARTZE:CUBE").id;
         MaterialComponent mc; mc.baseColor[0]=0.8f; mc.baseColor[1]=0.2f; mc.baseColor[2]=0.2f;
         gCoordinator.AddComponent(e,tr); gCoordinator.AddComponent(e,rc); gCoordinator.AddComponent(e,mc);
         RigidBodyComponent rb; rb.type=RigidBodyType::Dynamic; rb.mass=1.0f; gCoordinator.AddComponent(e,rb);
@@ -1,7 +1,10 @@
 #pragma once
+#include <array>
 #include <string>
 #include "core/Coordinator.hpp"
 
+namespace AARTZE { struct GeneratedWorld; }
+
 namespace EditorActions
 {
 // Loads mesh from path (gltf/obj/fbx), uploads to GPU, and creates an entity.
@@ -10,6 +13,13 @@ int CreateEntityFromMeshPath(const std::string& path);
 // Import helper that chooses correct loader based on extension and uploads
 // Returns meshId (0 on failure)
 uint32_t ImportMeshAndUpload(const std::string& path);
+// Creates an entity for a mesh placed in the world at `position` and hands
+// the mesh to world streaming, which loads it once the viewer comes near.
+// Returns entity id or -1 on failure.
+int SpawnWorldMesh(const std::string& path, const std::array<float, 3>& position);
+// Spawns a generated world: terrain at the origin and entities at their
+// positions, each through SpawnWorldMesh.
+void SpawnGeneratedWorld(const AARTZE::GeneratedWorld& world);
 
 // Creates a unit cube entity as a fallback/demo.
 int CreateDemoCubeEntity();
@@ -12,7 +12,7 @@ static glm::vec2 to2(const aiVector3D& v){ return {v.x, v.y}; }
 bool Importer::Load(const std::string& path, ImportedModel& out, std::string& err){
     Assimp::Importer imp;
     const unsigned flags = aiProcess_Triangulate | aiProcess_GenNormals | aiProcess_CalcTangentSpace |
-                           aiProcess_JoinIdenticalVertices | aiProcess_ImproveCacheLocality |
+                           aiProcess_JoinIdenticalVertices |
                            aiProcess_SortByPType | aiProcess_RemoveRedundantMaterials |
                            aiProcess_OptimizeMeshes | aiProcess_FlipUVs;
 
@@ -54,6 +54,7 @@ bool Importer::Load(const std::string& path, ImportedModel& out, std::string& er
         m.indices.reserve(am->mNumFaces*3);
         for(unsigned f=0; f<am->mNumFaces; ++f){ const aiFace& face = am->mFaces[f]; for(unsigned k=0;k<face.mNumIndices;k++) m.indices.push_back(face.mIndices[k]); }
         Submesh sm; sm.firstIndex=0; sm.indexCount=(uint32_t)m.indices.size(); sm.materialIndex=(int)am->mMaterialIndex; m.submeshes.push_back(sm);
+        if(am->mPrimitiveTypes == aiPrimitiveType_TRIANGLE) OptimizeMesh(m);
         out.meshes.push_back(std::move(m));
     }
     (void)err; return true;
@@ -1,2 +1,51 @@
 #include "Mesh.h"
+#include "aartze/geometry/MeshOps.h"
 
+namespace aartze {
+
+using geometry::MeshOps;
+
+template<class T>
+static void RemapStream(std::vector<T>& stream, const std::vector<uint32_t>& remap, size_t newCount){
+    if(stream.empty()) return;
+    std::vector<T> out(newCount);
+    MeshOps::RemapVertexBuffer(out.data(), stream.data(), stream.size(), sizeof(T), remap.data());
+    stream.swap(out);
+}
+
+static void RemapVertices(Mesh& m, const std::vector<uint32_t>& remap, size_t newCount){
+    RemapStream(m.positions, remap, newCount); RemapStream(m.normals, remap, newCount);
+    RemapStream(m.tangents, remap, newCount);  RemapStream(m.uvs0, remap, newCount);
+    MeshOps::RemapIndexBuffer(m.indices.data(), m.indices.data(), m.indices.size(), remap.data());
+}
+
+void OptimizeMesh(Mesh& m){
+    const size_t vcount = m.positions.size();
+    if(vcount == 0 || m.indices.size() < 3) return;
+
+    std::vector<geometry::VertexStream> streams;
+    auto add = [&](auto& s){
+        // A stream that doesn't cover every vertex can't follow the remap.
+        if(s.size() == vcount) streams.push_back({s.data(), sizeof(s[0]), sizeof(s[0])}); else s.clear();
+    };
+    add(m.positions); add(m.normals); add(m.tangents); add(m.uvs0);
+
+    std::vector<uint32_t> remap(vcount);
+    size_t unique = MeshOps::Weld(remap.data(), m.indices.data(), m.indices.size(), vcount, streams.data(), streams.size());
+    RemapVertices(m, remap, unique);
+
+    // Submeshes are drawn separately, so each range is optimized on its own.
+    std::vector<Submesh> ranges = m.submeshes;
+    if(ranges.empty()) ranges.push_back({0, (uint32_t)m.indices.size(), -1});
+    for(const Submesh& sm : ranges){
+        uint32_t* idx = m.indices.data() + sm.firstIndex;
+        MeshOps::OptimizeVertexCache(idx, idx, sm.indexCount, unique);
+        MeshOps::OptimizeOverdraw(idx, idx, sm.indexCount, &m.positions[0].x, unique, sizeof(glm::vec3));
+    }
+
+    size_t used = MeshOps::OptimizeVertexFetch(remap.data(), m.indices.data(), m.indices.size(), unique);
+    remap.resize(unique);
+    RemapVertices(m, remap, used);
+}
+
+} // namespace aartze
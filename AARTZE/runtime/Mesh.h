@@ -29,5 +29,9 @@ struct Material {
     float       metallic  = 0.0f;
 };
 
+// Weld identical vertices, reorder each submesh's triangles for the vertex
+// cache and overdraw, then lay vertices out in fetch order. Triangle lists only.
+void OptimizeMesh(Mesh& mesh);
+
 } // namespace aartze
 
@@ -1,8 +1,12 @@
 #include "SaveSystem.hpp"
+#include <array>
 #include <fstream>
+#include <vector>
 #include <nlohmann/json.hpp>
 
 #include "core/Coordinator.hpp"
+#include "core/SystemManager.hpp"
+#include "World/AssetRegistry.hpp"
 #include "components/TransformComponent.hpp"
 #include "components/RenderableComponent.hpp"
 #include "components/MaterialComponent.hpp"
@@ -18,9 +22,8 @@ bool SaveWorld(const std::string& path)
 {
     json j;
     j["entities"] = json::array();
-    for (unsigned e = 0; e < MAX_ENTITIES; ++e)
+    gCoordinator.ForEachEntity([&](Entity e)
     {
-        if (!gCoordinator.IsEntityAlive(e)) continue;
         json je; je["id"] = e;
         if (gCoordinator.HasComponent<TransformComponent>(e))
         {
@@ -32,7 +35,9 @@ bool SaveWorld(const std::string& path)
         if (gCoordinator.HasComponent<RenderableComponent>(e))
         {
             auto& rc = gCoordinator.GetComponent<RenderableComponent>(e);
-            je["Renderable"] = { {"meshId", rc.meshId}, {"visible", rc.isVisible} };
+            // Ids are per session; the path finds the mesh again on load.
+            je["Renderable"] = { {"meshId", rc.meshId}, {"visible", rc.isVisible},
+                                 {"mesh", gAssetRegistry.Path(MeshHandle{rc.meshId})} };
         }
         if (gCoordinator.HasComponent<MaterialComponent>(e))
         {
@@ -56,7 +61,7 @@ bool SaveWorld(const std::string& path)
             je["SphereCollider"] = { {"radius", sph.radius} };
         }
         j["entities"].push_back(std::move(je));
-    }
+    });
     std::ofstream f(path, std::ios::binary); if(!f.is_open()) return false; f << j.dump(2); return true;
 }
 
@@ -64,17 +69,27 @@ bool LoadWorld(const std::string& path)
 {
     std::ifstream f(path, std::ios::binary); if(!f.is_open()) return false; json j; f >> j;
     // Clear all entities (simple approach)
-    for (unsigned e = 0; e < MAX_ENTITIES; ++e) if (gCoordinator.IsEntityAlive(e)) gCoordinator.DestroyEntity(e);
+    std::vector<Entity> existing; gCoordinator.ForEachEntity([&](Entity e){ existing.push_back(e); });
+    for (Entity e : existing) gCoordinator.DestroyEntity(e);
+    if (gSystemManager) gSystemManager->streamingSystem.ClearWorldAssets();
     for (auto& je : j["entities"])
     {
         auto e = gCoordinator.CreateEntity();
+        std::array<float,3> position{0.0f,0.0f,0.0f};
         if (je.contains("Transform"))
         {
             TransformComponent tr; auto t = je["Transform"]; auto p = t["pos"]; auto r=t["rot"]; auto s=t["scl"]; tr.position = {p[0],p[1],p[2]}; tr.rotation = {r[0],r[1],r[2]}; tr.scale={s[0],s[1],s[2]}; gCoordinator.AddComponent(e,tr);
+            position = tr.position;
         }
         if (je.contains("Renderable"))
         {
-            RenderableComponent rc; rc.meshId = je["Renderable"]["meshId"]; rc.isVisible = je["Renderable"]["visible"]; gCoordinator.AddComponent(e,rc);
+            RenderableComponent rc; rc.meshId = je["Renderable"]["meshId"]; rc.isVisible = je["Renderable"]["visible"];
+            const std::string mesh = je["Renderable"].value("mesh", std::string());
+            if (!mesh.empty()) rc.meshId = gAssetRegistry.RegisterMesh(mesh).id;
+            // Mesh files stream in with the world; built-in meshes are uploaded by whoever made them.
+            if (!mesh.empty() && mesh.rfind("AARTZE:", 0) != 0 && gSystemManager)
+                gSystemManager->streamingSystem.AddWorldAsset(position.data(), rc.meshId, mesh);
+            gCoordinator.AddComponent(e,rc);
         }
         if (je.contains("Material"))
         {
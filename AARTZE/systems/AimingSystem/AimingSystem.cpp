@@ -2,13 +2,12 @@
 
 #include "AimingComponent.hpp"
 #include "Coordinator.hpp"
+#include "SystemScheduler.hpp"
 
 void AimingSystem::Update(float deltaTime)
 {
-    auto entities = gCoordinator.GetEntitiesWithComponents<AimingComponent>();
-    for (auto entity : entities)
-    {
-        auto& aim = gCoordinator.GetComponent<AimingComponent>(entity);
+    if (!m_query) m_query = &gCoordinator.GetQuery<AimingComponent>();
+    m_query->ForEach([](Entity, AimingComponent& aim) {
         if (aim.isAiming)
         {
             aim.aimZoomLevel += (1.5f - aim.aimZoomLevel) * 0.1f;
@@ -19,5 +18,10 @@ void AimingSystem::Update(float deltaTime)
             aim.aimZoomLevel += (1.0f - aim.aimZoomLevel) * 0.1f;
             aim.aimSensitivity = 0.75f;
         }
-    }
+    });
+}
+
+void AimingSystem::DeclareAccess(SystemAccessBuilder& access) const
+{
+    access.Write<AimingComponent>();
 }
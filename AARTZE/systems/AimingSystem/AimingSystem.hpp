@@ -1,12 +1,19 @@
 #pragma once
+#include "Query.hpp"
 #include "System.hpp"
 
+struct AimingComponent;
+
 class AimingSystem : public System
 {
    public:
     void Update(float deltaTime) override;
+    void DeclareAccess(SystemAccessBuilder& access) const override;
     const char* GetName() const override
     {
         return "AimingSystem";
     }
+
+   private:
+    Query<AimingComponent>* m_query = nullptr;
 };
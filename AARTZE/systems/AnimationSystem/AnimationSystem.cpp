@@ -3,6 +3,7 @@
 #include <glm/gtx/compatibility.hpp>
 
 #include "core/Coordinator.hpp"
+#include "core/SystemScheduler.hpp"
 #include "components/animation/AnimationBlendComponent.hpp"
 #include "components/AnimationComponent.hpp"
 #include "components/SkeletonComponent.hpp"
@@ -41,14 +42,11 @@ static glm::quat sampleQuat(const std::vector<Keyframe<glm::quat>>& keys, float
 
 void AnimationSystem::Update(float dt)
 {
-    auto entities = gCoordinator.GetEntitiesWithComponents<AnimationComponent, SkeletonComponent, AnimationBlendComponent>();
-    for (auto e : entities)
+    if (!m_query) m_query = &gCoordinator.GetQuery<AnimationComponent, SkeletonComponent, AnimationBlendComponent>();
+    m_query->ForEachParallel(
+        [dt](Entity, AnimationComponent& anim, SkeletonComponent& skel, AnimationBlendComponent& blend)
     {
-        auto& anim = gCoordinator.GetComponent<AnimationComponent>(e);
-        auto& blend = gCoordinator.GetComponent<AnimationBlendComponent>(e);
-        auto& skel = gCoordinator.GetComponent<SkeletonComponent>(e);
-
-        if (blend.clipA < 0 && blend.clipB < 0) continue;
+        if (blend.clipA < 0 && blend.clipB < 0) return;
         blend.time += dt * blend.speed;
 
         const AnimationClip* A = nullptr; const AnimationClip* B = nullptr;
@@ -89,6 +87,10 @@ void AnimationSystem::Update(float dt)
             glm::mat4 S(1.0f); S[0][0]=scl.x; S[1][1]=scl.y; S[2][2]=scl.z;
             skel.poseMatrices[i] = T * R * S;
         }
-    }
+    });
 }
 
+void AnimationSystem::DeclareAccess(SystemAccessBuilder& access) const
+{
+    access.Read<AnimationComponent>().Write<SkeletonComponent, AnimationBlendComponent>();
+}
@@ -1,10 +1,19 @@
 #pragma once
+#include "core/Query.hpp"
 #include "core/System.hpp"
 
+struct AnimationComponent;
+struct SkeletonComponent;
+struct AnimationBlendComponent;
+
 class AnimationSystem : public System
 {
 public:
     void Update(float deltaTime) override;
+    void DeclareAccess(SystemAccessBuilder& access) const override;
     const char* GetName() const override { return "AnimationSystem"; }
+
+private:
+    Query<AnimationComponent, SkeletonComponent, AnimationBlendComponent>* m_query{nullptr};
 };
 
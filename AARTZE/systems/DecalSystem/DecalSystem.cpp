@@ -1,14 +1,16 @@
 #include "DecalSystem.hpp"
 
 #include "Coordinator.hpp"
+#include "SystemScheduler.hpp"
 #include "DecalComponent.hpp"
 
 void DecalSystem::Update(float deltaTime)
 {
-    auto entities = gCoordinator.GetEntitiesWithComponents<DecalComponent>();
-    for (auto entity : entities)
-    {
-        auto& decal = gCoordinator.GetComponent<DecalComponent>(entity);
+    // Runs inside SystemManager's phase: the removal below goes to the
+    // worker's command buffer and is applied at the sync point, so it is
+    // safe from the parallel loop.
+    if (!m_query) m_query = &gCoordinator.GetQuery<DecalComponent>();
+    m_query->ForEachParallel([deltaTime](Entity entity, DecalComponent& decal) {
         if (decal.fadeOverTime)
         {
             decal.lifetime -= deltaTime;
@@ -17,5 +19,10 @@ void DecalSystem::Update(float deltaTime)
                 gCoordinator.RemoveComponent<DecalComponent>(entity);
             }
         }
-    }
+    });
+}
+
+void DecalSystem::DeclareAccess(SystemAccessBuilder& access) const
+{
+    access.Write<DecalComponent>();
 }
@@ -1,12 +1,19 @@
 #pragma once
+#include "Query.hpp"
 #include "System.hpp"
 
+struct DecalComponent;
+
 class DecalSystem : public System
 {
    public:
     void Update(float deltaTime) override;
+    void DeclareAccess(SystemAccessBuilder& access) const override;
     const char* GetName() const override
     {
         return "DecalSystem";
     }
+
+   private:
+    Query<DecalComponent>* m_query = nullptr;
 };
@@ -2,6 +2,7 @@
 #include <cmath>
 
 #include "core/Coordinator.hpp"
+#include "core/SystemScheduler.hpp"
 #include "components/navigation/NavAgentComponent.hpp"
 #include "components/TransformComponent.hpp"
 
@@ -13,11 +14,10 @@ bool NavigationSystem::Initialize()
 
 void NavigationSystem::Update(float dt)
 {
-    auto agents = gCoordinator.GetEntitiesWithComponents<NavAgentComponent, TransformComponent>();
-    for (auto e : agents)
+    if (!m_agents) m_agents = &gCoordinator.GetQuery<NavAgentComponent, TransformComponent>();
+    m_agents->ForEachParallel(
+        [this, dt](Entity, NavAgentComponent& agent, TransformComponent& tr)
     {
-        auto& agent = gCoordinator.GetComponent<NavAgentComponent>(e);
-        auto& tr = gCoordinator.GetComponent<TransformComponent>(e);
         auto start = m_grid.ToCell(tr.position[0], tr.position[2]);
         auto goal  = m_grid.ToCell(agent.target[0], agent.target[2]);
 
@@ -46,6 +46,10 @@ void NavigationSystem::Update(float dt)
                 tr.position[2] += dz / dist * step;
             }
         }
-    }
+    });
 }
 
+void NavigationSystem::DeclareAccess(SystemAccessBuilder& access) const
+{
+    access.Write<NavAgentComponent, TransformComponent>();
+}
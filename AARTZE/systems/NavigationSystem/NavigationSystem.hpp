@@ -1,16 +1,22 @@
 #pragma once
+#include "core/Query.hpp"
 #include "core/System.hpp"
 #include "navigation/GridNav.hpp"
 
+struct NavAgentComponent;
+struct TransformComponent;
+
 class NavigationSystem : public System
 {
 public:
     bool Initialize();
     void Shutdown() override {}
     void Update(float deltaTime) override;
+    void DeclareAccess(SystemAccessBuilder& access) const override;
     const char* GetName() const override { return "NavigationSystem"; }
 
 private:
     GridNav m_grid;
+    Query<NavAgentComponent, TransformComponent>* m_agents{nullptr};
 };
 
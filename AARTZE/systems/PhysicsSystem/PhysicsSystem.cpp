@@ -3,6 +3,7 @@
 #include <btBulletDynamicsCommon.h>
 
 #include "core/Coordinator.hpp"
+#include "core/SystemScheduler.hpp"
 #include "components/TransformComponent.hpp"
 #include "components/physics/RigidBodyComponent.hpp"
 #include "components/physics/BoxColliderComponent.hpp"
@@ -84,42 +85,38 @@ void PhysicsSystem::EnsureBody(unsigned entity)
 
 void PhysicsSystem::Update(float deltaTime)
 {
-    // create bodies for new entities
-    auto entities = gCoordinator.GetEntitiesWithComponents<RigidBodyComponent, TransformComponent>();
-    for (auto e : entities) EnsureBody(e);
+    if (!m_bodiesQuery) m_bodiesQuery = &gCoordinator.GetQuery<RigidBodyComponent, TransformComponent>();
 
-    // sync kinematics from transforms
-    for (auto e : entities)
-    {
-        auto& rb = gCoordinator.GetComponent<RigidBodyComponent>(e);
-        if (rb.type == RigidBodyType::Kinematic)
-        {
-            auto& tr = gCoordinator.GetComponent<TransformComponent>(e);
+    // create bodies for new entities and sync kinematics from transforms
+    m_bodiesQuery->ForEach(
+        [this](Entity e, RigidBodyComponent& rb, TransformComponent& tr) {
+            EnsureBody(e);
+            if (rb.type != RigidBodyType::Kinematic) return;
             if (auto it = m_bodies.find(e); it != m_bodies.end())
             {
                 btTransform t; t.setIdentity(); t.setOrigin(btVector3(tr.position[0], tr.position[1], tr.position[2]));
                 it->second->getMotionState()->setWorldTransform(t);
                 it->second->setWorldTransform(t);
             }
-        }
-    }
+        });
 
     m_world->stepSimulation(deltaTime, 4);
 
     // write back dynamic transforms
-    for (auto e : entities)
-    {
-        auto& rb = gCoordinator.GetComponent<RigidBodyComponent>(e);
-        if (rb.type == RigidBodyType::Dynamic)
-        {
+    m_bodiesQuery->ForEach(
+        [this](Entity e, RigidBodyComponent& rb, TransformComponent& tr) {
+            if (rb.type != RigidBodyType::Dynamic) return;
             if (auto it = m_bodies.find(e); it != m_bodies.end())
             {
                 btTransform t; it->second->getMotionState()->getWorldTransform(t);
-                auto& tr = gCoordinator.GetComponent<TransformComponent>(e);
                 auto o = t.getOrigin();
                 tr.position = { (float)o.x(), (float)o.y(), (float)o.z() };
             }
-        }
-    }
+        });
 }
 
+void PhysicsSystem::DeclareAccess(SystemAccessBuilder& access) const
+{
+    access.Write<RigidBodyComponent, TransformComponent>()
+        .Read<BoxColliderComponent, SphereColliderComponent>();
+}
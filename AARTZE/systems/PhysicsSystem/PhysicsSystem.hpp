@@ -1,6 +1,8 @@
 #pragma once
+#include "core/Query.hpp"
 #include "core/System.hpp"
 #include <unordered_map>
+struct RigidBodyComponent; struct TransformComponent;
 class btDiscreteDynamicsWorld; class btBroadphaseInterface; class btDefaultCollisionConfiguration; class btCollisionDispatcher; class btSequentialImpulseConstraintSolver; class btRigidBody; class btCollisionShape;
 
 class PhysicsSystem : public System
@@ -9,6 +11,7 @@ public:
     bool Initialize();
     void Shutdown() override;
     void Update(float deltaTime) override;
+    void DeclareAccess(SystemAccessBuilder& access) const override;
     const char* GetName() const override { return "PhysicsSystem"; }
 
 private:
@@ -20,6 +23,7 @@ private:
 
     std::unordered_map<unsigned, btRigidBody*> m_bodies; // entity -> body
     std::unordered_map<unsigned, btCollisionShape*> m_shapes; // entity -> shape
+    Query<RigidBodyComponent, TransformComponent>* m_bodiesQuery{nullptr};
 
     void EnsureBody(unsigned entity);
 };
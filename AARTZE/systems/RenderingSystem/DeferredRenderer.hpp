@@ -5,13 +5,15 @@
 #include "GBuffer.hpp"
 #include "Fullscreen.hpp"
 
+class RenderQueue;
+
 class DeferredRenderer
 {
 public:
     bool Initialize();
     void Shutdown();
     void Resize(int w, int h);
-    void GeometryPass(const float* Proj, const float* View);
+    void GeometryPass(const float* Proj, const float* View, RenderQueue& queue);
     void LightingPass(const float* Proj, const float* View, const float* CamPos);
 
     // toggles
@@ -24,6 +26,8 @@ private:
     Fullscreen m_fs;
     GLuint m_geomProg{0};
     GLuint m_lightProg{0};
+    GLint m_locProj{-1}, m_locView{-1};
+    GLint m_locAlbedo{-1}, m_locNormal{-1}, m_locCamPos{-1};
 
     void ensurePrograms();
 };
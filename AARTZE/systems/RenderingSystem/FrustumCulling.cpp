@@ -0,0 +1,93 @@
+#include "FrustumCulling.hpp"
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define AARTZE_CULL_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AARTZE_CULL_SSE 1
+#endif
+
+Frustum ExtractFrustum(const float proj[16], const float view[16])
+{
+    // m = proj * view, column-major: m[c*4 + r].
+    Frustum f;
+    float* m = f.viewProj;
+    for (int c = 0; c < 4; ++c)
+        for (int r = 0; r < 4; ++r)
+            m[c*4+r] = proj[0*4+r]*view[c*4+0] + proj[1*4+r]*view[c*4+1] + proj[2*4+r]*view[c*4+2] + proj[3*4+r]*view[c*4+3];
+
+    // Gribb/Hartmann: each plane is row 3 +/- row 0..2 of the clip matrix.
+    const int rows[6] = {0, 0, 1, 1, 2, 2};
+    const float signs[6] = {1.f, -1.f, 1.f, -1.f, 1.f, -1.f};
+    for (int p = 0; p < 6; ++p)
+    {
+        for (int c = 0; c < 4; ++c) f.planes[p][c] = m[c*4+3] + signs[p] * m[c*4+rows[p]];
+        float len = std::sqrt(f.planes[p][0]*f.planes[p][0] + f.planes[p][1]*f.planes[p][1] + f.planes[p][2]*f.planes[p][2]);
+        if (len > 0.f) for (float& v : f.planes[p]) v /= len;
+    }
+    return f;
+}
+
+namespace
+{
+bool SphereVisible(const Frustum& f, float x, float y, float z, float r)
+{
+    for (const auto& p : f.planes)
+        if (p[0]*x + p[1]*y + p[2]*z + p[3] < -r) return false;
+    return true;
+}
+}
+
+size_t CullSpheres(const Frustum& f, const float* x, const float* y, const float* z, const float* radius,
+                   uint8_t* visible, size_t count)
+{
+    size_t i = 0, visibleCount = 0;
+#if AARTZE_CULL_AVX
+    // A lane stays visible while distance + radius >= 0 for every plane.
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 px = _mm256_loadu_ps(x + i), py = _mm256_loadu_ps(y + i), pz = _mm256_loadu_ps(z + i);
+        __m256 nr = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(radius + i));
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (const auto& p : f.planes)
+        {
+            __m256 d = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(px, _mm256_set1_ps(p[0])), _mm256_mul_ps(py, _mm256_set1_ps(p[1]))),
+                                     _mm256_add_ps(_mm256_mul_ps(pz, _mm256_set1_ps(p[2])), _mm256_set1_ps(p[3])));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(d, nr, _CMP_GE_OQ));
+        }
+        int mask = _mm256_movemask_ps(inside);
+        for (int lane = 0; lane < 8; ++lane)
+        {
+            visible[i + lane] = uint8_t((mask >> lane) & 1);
+            visibleCount += visible[i + lane];
+        }
+    }
+#elif AARTZE_CULL_SSE
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 px = _mm_loadu_ps(x + i), py = _mm_loadu_ps(y + i), pz = _mm_loadu_ps(z + i);
+        __m128 nr = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius + i));
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (const auto& p : f.planes)
+        {
+            __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, _mm_set1_ps(p[0])), _mm_mul_ps(py, _mm_set1_ps(p[1]))),
+                                  _mm_add_ps(_mm_mul_ps(pz, _mm_set1_ps(p[2])), _mm_set1_ps(p[3])));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(d, nr));
+        }
+        int mask = _mm_movemask_ps(inside);
+        for (int lane = 0; lane < 4; ++lane)
+        {
+            visible[i + lane] = uint8_t((mask >> lane) & 1);
+            visibleCount += visible[i + lane];
+        }
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        visible[i] = SphereVisible(f, x[i], y[i], z[i], radius[i]) ? 1 : 0;
+        visibleCount += visible[i];
+    }
+    return visibleCount;
+}
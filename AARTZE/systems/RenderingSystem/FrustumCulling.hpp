@@ -0,0 +1,27 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// World-space view frustum as six normalized planes (a, b, c, d); a point p is
+// inside a plane when a*p.x + b*p.y + c*p.z + d >= 0. Order: left, right,
+// bottom, top, near, far.
+struct Frustum
+{
+    float planes[6][4];
+    float viewProj[16];  // proj * view, kept for stages that project bounds
+};
+
+// Planes of clip = proj * view * world, both matrices column-major as passed
+// to the shaders.
+Frustum ExtractFrustum(const float proj[16], const float view[16]);
+
+/**
+ * @brief Test `count` bounding spheres stored as separate x/y/z/radius arrays
+ * against the frustum and write 1 (intersecting) or 0 (outside) per sphere.
+ *
+ * Spheres are tested 8 at a time with AVX, 4 at a time with SSE, otherwise one
+ * by one. The arrays need no particular alignment. Returns the number of
+ * visible spheres.
+ */
+size_t CullSpheres(const Frustum& frustum, const float* x, const float* y, const float* z, const float* radius,
+                   uint8_t* visible, size_t count);
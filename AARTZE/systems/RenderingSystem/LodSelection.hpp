@@ -0,0 +1,30 @@
+#pragma once
+#include <algorithm>
+
+#include "aartze/geometry/Simplify.h"
+
+/**
+ * @brief Picks a level of detail from its projected error, with hysteresis.
+ *
+ * Each level records how far (object space) its surface strays from level 0;
+ * at `pixelsPerUnit` that is error * pixelsPerUnit pixels on screen. The
+ * wanted level is the coarsest whose projected error fits in `pixelError`.
+ * So that objects sitting near a threshold don't flicker between levels, the
+ * current level is only refined once its error exceeds the budget by the
+ * `hysteresis` fraction, and only coarsened once the coarser level fits in
+ * the budget shrunk by that fraction. Level errors must be non-decreasing,
+ * which the simplifier's chains are.
+ */
+inline int SelectLod(const aartze::geometry::LodLevel* lods, int lodCount, float pixelsPerUnit, int current,
+                     float pixelError, float hysteresis)
+{
+    if (lodCount <= 1) return 0;
+    current = std::clamp(current, 0, lodCount - 1);
+    auto coarsestWithin = [&](float budget) {
+        int level = 0;
+        while (level + 1 < lodCount && lods[level + 1].error * pixelsPerUnit <= budget) ++level;
+        return level;
+    };
+    if (lods[current].error * pixelsPerUnit > pixelError * (1.0f + hysteresis)) return coarsestWithin(pixelError);
+    return std::max(current, coarsestWithin(pixelError * (1.0f - hysteresis)));
+}
@@ -0,0 +1,244 @@
+#include "OcclusionCulling.hpp"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AARTZE_OCCLUSION_SSE 1
+#endif
+
+namespace
+{
+void TransformPoint(const float m[16], const float p[3], float out[4])
+{
+    for (int r = 0; r < 4; ++r) out[r] = m[r] * p[0] + m[4 + r] * p[1] + m[8 + r] * p[2] + m[12 + r];
+}
+
+// Signed distance to the GL near plane (z = -w); >= 0 is in front of it.
+float NearDistance(const float v[4]) { return v[2] + v[3]; }
+
+const uint32_t BOX_INDICES[36] = {
+    0, 1, 3, 0, 3, 2,  4, 6, 7, 4, 7, 5,  0, 4, 5, 0, 5, 1,
+    2, 3, 7, 2, 7, 6,  0, 2, 6, 0, 6, 4,  1, 5, 7, 1, 7, 3,
+};
+
+void BoxCorners(const float mn[3], const float mx[3], float out[24])
+{
+    for (int i = 0; i < 8; ++i)
+    {
+        out[i * 3 + 0] = (i & 4) ? mx[0] : mn[0];
+        out[i * 3 + 1] = (i & 2) ? mx[1] : mn[1];
+        out[i * 3 + 2] = (i & 1) ? mx[2] : mn[2];
+    }
+}
+}
+
+OcclusionBuffer::OcclusionBuffer(int width, int height)
+    : m_width((std::max(width, 4) + 3) & ~3), m_height(std::max(height, 1))
+{
+    m_depth.assign(size_t(m_width) * m_height, 1.0f);
+    int w = m_width, h = m_height;
+    for (;;)
+    {
+        Level level;
+        level.width = w; level.height = h;
+        level.minDepth.assign(size_t(w) * h, 1.0f);
+        level.maxDepth.assign(size_t(w) * h, 1.0f);
+        m_levels.push_back(std::move(level));
+        if (w == 1 && h == 1) break;
+        w = std::max(1, (w + 1) / 2); h = std::max(1, (h + 1) / 2);
+    }
+}
+
+void OcclusionBuffer::Clear()
+{
+    std::fill(m_depth.begin(), m_depth.end(), 1.0f);
+}
+
+void OcclusionBuffer::RasterizeBox(const float mvp[16], const float boundsMin[3], const float boundsMax[3])
+{
+    float corners[24];
+    BoxCorners(boundsMin, boundsMax, corners);
+    RasterizeTriangles(mvp, corners, BOX_INDICES, 12);
+}
+
+void OcclusionBuffer::RasterizeTriangles(const float mvp[16], const float* positions, const uint32_t* indices, size_t triangleCount)
+{
+    for (size_t t = 0; t < triangleCount; ++t)
+    {
+        float v[3][4];
+        for (int k = 0; k < 3; ++k) TransformPoint(mvp, positions + size_t(indices[t * 3 + k]) * 3, v[k]);
+        RasterizeClipTriangle(v[0], v[1], v[2]);
+    }
+}
+
+void OcclusionBuffer::RasterizeClipTriangle(const float a[4], const float b[4], const float c[4])
+{
+    // Clip against the near plane (Sutherland-Hodgman); a triangle becomes at
+    // most a quad. Everything left has w >= near > 0.
+    const float* in[3] = {a, b, c};
+    float poly[4][4];
+    int count = 0;
+    for (int i = 0; i < 3; ++i)
+    {
+        const float* p = in[i];
+        const float* q = in[(i + 1) % 3];
+        float dp = NearDistance(p), dq = NearDistance(q);
+        if (dp >= 0.0f) { std::copy(p, p + 4, poly[count]); ++count; }
+        if ((dp >= 0.0f) != (dq >= 0.0f))
+        {
+            float t = dp / (dp - dq);
+            for (int k = 0; k < 4; ++k) poly[count][k] = p[k] + t * (q[k] - p[k]);
+            ++count;
+        }
+    }
+    if (count < 3) return;
+
+    float screen[4][3];
+    for (int i = 0; i < count; ++i)
+    {
+        float invW = 1.0f / poly[i][3];
+        screen[i][0] = (poly[i][0] * invW * 0.5f + 0.5f) * m_width;
+        screen[i][1] = (poly[i][1] * invW * 0.5f + 0.5f) * m_height;
+        screen[i][2] = poly[i][2] * invW * 0.5f + 0.5f;
+    }
+    for (int i = 1; i + 1 < count; ++i) RasterizeScreenTriangle(screen[0], screen[i], screen[i + 1]);
+}
+
+void OcclusionBuffer::RasterizeScreenTriangle(const float a[3], const float b[3], const float c[3])
+{
+    float area = (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+    if (std::fabs(area) < 1e-8f) return;
+
+    int minX = std::max(0, int(std::floor(std::min({a[0], b[0], c[0]}))));
+    int maxX = std::min(m_width - 1, int(std::ceil(std::max({a[0], b[0], c[0]}))));
+    int minY = std::max(0, int(std::floor(std::min({a[1], b[1], c[1]}))));
+    int maxY = std::min(m_height - 1, int(std::ceil(std::max({a[1], b[1], c[1]}))));
+    if (minX > maxX || minY > maxY) return;
+
+    // Edge functions e(x, y) = A*x + B*y + C, flipped so the inside is
+    // positive for either winding. Depth is affine in screen space.
+    const float s = area > 0.0f ? 1.0f : -1.0f;
+    const float* v[3] = {a, b, c};
+    float A[3], B[3], C[3];
+    for (int i = 0; i < 3; ++i)
+    {
+        const float* p = v[(i + 1) % 3];
+        const float* q = v[(i + 2) % 3];
+        A[i] = s * (p[1] - q[1]);
+        B[i] = s * (q[0] - p[0]);
+        C[i] = s * (p[0] * q[1] - p[1] * q[0]);
+    }
+    const float invArea = 1.0f / (s * area);
+    const float zA = (A[0] * a[2] + A[1] * b[2] + A[2] * c[2]) * invArea;
+    const float zB = (B[0] * a[2] + B[1] * b[2] + B[2] * c[2]) * invArea;
+    const float zC = (C[0] * a[2] + C[1] * b[2] + C[2] * c[2]) * invArea;
+
+    minX &= ~3;
+    for (int y = minY; y <= maxY; ++y)
+    {
+        const float py = y + 0.5f;
+        float* row = m_depth.data() + size_t(y) * m_width;
+        int x = minX;
+#if AARTZE_OCCLUSION_SSE
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 laneX = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+        // Rows are a multiple of 4 wide and x starts aligned, so a block never
+        // runs past the row; lanes outside the triangle fail the edge test.
+        for (; x <= maxX; x += 4)
+        {
+            __m128 px = _mm_add_ps(_mm_set1_ps(float(x)), laneX);
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (int e = 0; e < 3; ++e)
+            {
+                __m128 ev = _mm_add_ps(_mm_mul_ps(px, _mm_set1_ps(A[e])), _mm_set1_ps(B[e] * py + C[e]));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(ev, zero));
+            }
+            if (_mm_movemask_ps(inside) == 0) continue;
+            __m128 z = _mm_add_ps(_mm_mul_ps(px, _mm_set1_ps(zA)), _mm_set1_ps(zB * py + zC));
+            __m128 old = _mm_loadu_ps(row + x);
+            __m128 nearer = _mm_min_ps(old, z);
+            _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, old)));
+        }
+#endif
+        for (; x <= maxX; ++x)
+        {
+            const float px = x + 0.5f;
+            if (A[0] * px + B[0] * py + C[0] < 0.0f || A[1] * px + B[1] * py + C[1] < 0.0f ||
+                A[2] * px + B[2] * py + C[2] < 0.0f)
+                continue;
+            row[x] = std::min(row[x], zA * px + zB * py + zC);
+        }
+    }
+}
+
+void OcclusionBuffer::BuildPyramid()
+{
+    Level& base = m_levels[0];
+    std::copy(m_depth.begin(), m_depth.end(), base.minDepth.begin());
+    std::copy(m_depth.begin(), m_depth.end(), base.maxDepth.begin());
+    for (size_t l = 1; l < m_levels.size(); ++l)
+    {
+        const Level& src = m_levels[l - 1];
+        Level& dst = m_levels[l];
+        for (int y = 0; y < dst.height; ++y)
+            for (int x = 0; x < dst.width; ++x)
+            {
+                float lo = 1.0f, hi = 0.0f;
+                for (int sy = 2 * y; sy < std::min(2 * y + 2, src.height); ++sy)
+                    for (int sx = 2 * x; sx < std::min(2 * x + 2, src.width); ++sx)
+                    {
+                        lo = std::min(lo, src.minDepth[size_t(sy) * src.width + sx]);
+                        hi = std::max(hi, src.maxDepth[size_t(sy) * src.width + sx]);
+                    }
+                dst.minDepth[size_t(y) * dst.width + x] = lo;
+                dst.maxDepth[size_t(y) * dst.width + x] = hi;
+            }
+    }
+}
+
+bool OcclusionBuffer::IsVisible(const float mvp[16], const float boundsMin[3], const float boundsMax[3]) const
+{
+    float corners[24];
+    BoxCorners(boundsMin, boundsMax, corners);
+    float minX = 1e30f, minY = 1e30f, maxX = -1e30f, maxY = -1e30f, nearest = 1.0f;
+    for (int i = 0; i < 8; ++i)
+    {
+        float v[4];
+        TransformPoint(mvp, corners + i * 3, v);
+        if (NearDistance(v) <= 0.0f) return true;
+        float invW = 1.0f / v[3];
+        float sx = (v[0] * invW * 0.5f + 0.5f) * m_width;
+        float sy = (v[1] * invW * 0.5f + 0.5f) * m_height;
+        minX = std::min(minX, sx); maxX = std::max(maxX, sx);
+        minY = std::min(minY, sy); maxY = std::max(maxY, sy);
+        nearest = std::min(nearest, v[2] * invW * 0.5f + 0.5f);
+    }
+    // Only the on-screen part can be seen, so the rectangle is clamped.
+    int x0 = std::max(0, int(std::floor(minX))), y0 = std::max(0, int(std::floor(minY)));
+    int x1 = std::min(m_width - 1, int(std::floor(maxX))), y1 = std::min(m_height - 1, int(std::floor(maxY)));
+    if (x0 > x1 || y0 > y1) return true;
+
+    // Start at the level where the rectangle spans at most 2x2 texels and
+    // refine only where the coarse min/max do not decide.
+    int level = 0;
+    while (level + 1 < LevelCount() && ((x1 >> level) - (x0 >> level) > 1 || (y1 >> level) - (y0 >> level) > 1)) ++level;
+    return TestRegion(level, x0, y0, x1, y1, nearest);
+}
+
+bool OcclusionBuffer::TestRegion(int level, int x0, int y0, int x1, int y1, float nearestDepth) const
+{
+    const Level& l = m_levels[level];
+    for (int ty = y0 >> level; ty <= (y1 >> level); ++ty)
+        for (int tx = x0 >> level; tx <= (x1 >> level); ++tx)
+        {
+            size_t i = size_t(ty) * l.width + tx;
+            if (nearestDepth > l.maxDepth[i]) continue;  // hidden in this texel
+            if (level == 0 || nearestDepth <= l.minDepth[i]) return true;
+            // Partially covered: look at the finer texels inside both rects.
+            int cx0 = std::max(x0, tx << level), cy0 = std::max(y0, ty << level);
+            int cx1 = std::min(x1, ((tx + 1) << level) - 1), cy1 = std::min(y1, ((ty + 1) << level) - 1);
+            if (TestRegion(level - 1, cx0, cy0, cx1, cy1, nearestDepth)) return true;
+        }
+    return false;
+}
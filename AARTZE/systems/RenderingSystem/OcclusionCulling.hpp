@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Low-resolution CPU depth buffer for occlusion culling.
+ *
+ * A frame clears it, rasterizes a handful of large occluders, builds a min/max
+ * depth pyramid and then tests object bounds against the pyramid. Depth is
+ * window-space [0, 1], cleared to 1 (far). Everything here is plain memory, so
+ * the stage runs and can be measured without a GPU.
+ *
+ * Rasterization is single-threaded; IsVisible() only reads and may be called
+ * from many threads once BuildPyramid() has returned.
+ */
+class OcclusionBuffer
+{
+public:
+    // Width is rounded up to a multiple of 4 for the SIMD row loop.
+    explicit OcclusionBuffer(int width = 256, int height = 128);
+
+    void Clear();
+
+    // Indexed triangles in object space, transformed by `mvp` (column-major
+    // proj * view * model). Triangles crossing the near plane are clipped.
+    void RasterizeTriangles(const float mvp[16], const float* positions, const uint32_t* indices, size_t triangleCount);
+    void RasterizeBox(const float mvp[16], const float boundsMin[3], const float boundsMax[3]);
+
+    void BuildPyramid();
+
+    // False only when the box is certainly behind the rasterized occluders.
+    // Boxes crossing the near plane or the screen edge count as visible.
+    bool IsVisible(const float mvp[16], const float boundsMin[3], const float boundsMax[3]) const;
+
+    int Width() const { return m_width; }
+    int Height() const { return m_height; }
+    int LevelCount() const { return static_cast<int>(m_levels.size()); }
+    const float* MinDepth(int level) const { return m_levels[level].minDepth.data(); }
+    const float* MaxDepth(int level) const { return m_levels[level].maxDepth.data(); }
+    int LevelWidth(int level) const { return m_levels[level].width; }
+    int LevelHeight(int level) const { return m_levels[level].height; }
+
+private:
+    struct Level
+    {
+        int width{0}, height{0};
+        std::vector<float> minDepth;  // nearest occluder depth under each texel
+        std::vector<float> maxDepth;  // farthest; an object behind this is hidden
+    };
+
+    int m_width;
+    int m_height;
+    std::vector<float> m_depth;  // level 0, row-major, m_width * m_height
+    std::vector<Level> m_levels;
+
+    void RasterizeClipTriangle(const float a[4], const float b[4], const float c[4]);
+    void RasterizeScreenTriangle(const float a[3], const float b[3], const float c[3]);
+    bool TestRegion(int level, int x0, int y0, int x1, int y1, float nearestDepth) const;
+};
@@ -0,0 +1,363 @@
+#include "RenderQueue.hpp"
+#include <glad/glad.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include "RenderResources.hpp"
+#include "FrustumCulling.hpp"
+#include "OcclusionCulling.hpp"
+#include "LodSelection.hpp"
+#include "RenderSettings.hpp"
+#include "core/JobSystem.hpp"
+#include "core/Profiler.hpp"
+#include "core/Coordinator.hpp"
+#include "components/RenderableComponent.hpp"
+#include "components/TransformComponent.hpp"
+#include "components/MaterialComponent.hpp"
+
+namespace
+{
+struct DrawItem
+{
+    Entity entity;
+    const TransformComponent* transform;
+    RenderableComponent* renderable;
+    const MeshGPU* mesh;
+    uint32_t meshId;
+    uint32_t materialId;
+    bool occluder;
+    uint8_t lod;
+};
+
+// Transform and cull ranges of this many items per job.
+constexpr size_t CULL_GRAIN = 1024;
+
+// Occluders rasterized per frame, largest on screen first. Past a few dozen
+// the extra coverage rarely pays for the raster time.
+constexpr uint32_t MAX_OCCLUDERS = 48;
+
+// An occluder without CPU triangles (coarsest level too big) stands in as its
+// bounding box shrunk by this much about the center. Not exact for every
+// shape, but it no longer fills whole corners of an L-shaped building.
+constexpr float OCCLUDER_INNER_BOX_SCALE = 0.5f;
+
+// out = a * b, column-major.
+void MultiplyMatrix(const float a[16], const float b[16], float out[16])
+{
+    for (int c = 0; c < 4; ++c)
+        for (int r = 0; r < 4; ++r)
+            out[c * 4 + r] = a[r] * b[c * 4] + a[4 + r] * b[c * 4 + 1] + a[8 + r] * b[c * 4 + 2] + a[12 + r] * b[c * 4 + 3];
+}
+
+constexpr uint64_t KEY_MESH_MASK = (1ull << 26) - 1;
+constexpr uint64_t KEY_MATERIAL_MASK = (1ull << 28) - 1;
+static_assert(MAX_MESH_LODS <= 4, "the draw key holds the level in 2 bits");
+
+uint64_t MakeDrawKey(uint8_t program, uint32_t meshId, uint32_t lod, uint32_t materialId)
+{
+    return (uint64_t(program) << 56) | ((uint64_t(meshId) & KEY_MESH_MASK) << 30) | (uint64_t(lod & 3) << 28) |
+           (uint64_t(materialId) & KEY_MATERIAL_MASK);
+}
+
+// LSD radix sort of (key, value) pairs, 8 bits per pass. Passes where every
+// key has the same digit are skipped, so a frame with one program and a few
+// dozen meshes sorts in two or three passes.
+void RadixSort(uint64_t* keys, uint32_t* values, size_t n, uint64_t* keyTmp, uint32_t* valueTmp)
+{
+    for (unsigned shift = 0; shift < 64; shift += 8)
+    {
+        size_t count[256] = {};
+        for (size_t i = 0; i < n; ++i) ++count[(keys[i] >> shift) & 0xFF];
+        if (count[(keys[0] >> shift) & 0xFF] == n) continue;
+
+        size_t offset = 0;
+        for (size_t& c : count) { size_t next = offset + c; c = offset; offset = next; }
+        for (size_t i = 0; i < n; ++i)
+        {
+            size_t dst = count[(keys[i] >> shift) & 0xFF]++;
+            keyTmp[dst] = keys[i];
+            valueTmp[dst] = values[i];
+        }
+        std::memcpy(keys, keyTmp, n * sizeof(uint64_t));
+        std::memcpy(values, valueTmp, n * sizeof(uint32_t));
+    }
+}
+}
+
+void ComposeModelMatrix(const TransformComponent& tr, float out[16])
+{
+    // Same rotation convention as the former rotateX/Y/Z helpers, expanded to
+    // 3x3 products instead of four full 4x4 multiplies.
+    const float d2r = 3.1415926f / 180.f;
+    float cx = cosf(tr.rotation[0] * d2r), sx = sinf(tr.rotation[0] * d2r);
+    float cy = cosf(tr.rotation[1] * d2r), sy = sinf(tr.rotation[1] * d2r);
+    float cz = cosf(tr.rotation[2] * d2r), sz = sinf(tr.rotation[2] * d2r);
+    const float Ry[3][3] = {{cy, 0, -sy}, {0, 1, 0}, {sy, 0, cy}};
+    const float Rx[3][3] = {{1, 0, 0}, {0, cx, sx}, {0, -sx, cx}};
+    const float Rz[3][3] = {{cz, sz, 0}, {-sz, cz, 0}, {0, 0, 1}};
+    float Ryx[3][3], R[3][3];
+    for (int r = 0; r < 3; ++r)
+        for (int c = 0; c < 3; ++c) Ryx[r][c] = Ry[r][0] * Rx[0][c] + Ry[r][1] * Rx[1][c] + Ry[r][2] * Rx[2][c];
+    for (int r = 0; r < 3; ++r)
+        for (int c = 0; c < 3; ++c) R[r][c] = Ryx[r][0] * Rz[0][c] + Ryx[r][1] * Rz[1][c] + Ryx[r][2] * Rz[2][c];
+    for (int c = 0; c < 3; ++c)
+    {
+        for (int r = 0; r < 3; ++r) out[c * 4 + r] = R[r][c] * tr.scale[c];
+        out[c * 4 + 3] = 0.0f;
+    }
+    out[12] = tr.position[0]; out[13] = tr.position[1]; out[14] = tr.position[2]; out[15] = 1.0f;
+}
+
+void RenderQueue::Shutdown()
+{
+    if (m_instanceVbo) glDeleteBuffers(1, &m_instanceVbo);
+    m_instanceVbo = 0;
+    m_capacityBytes = 0;
+}
+
+void RenderQueue::Build(Query<RenderableComponent, TransformComponent>& query, const Frustum* frustum,
+                        OcclusionBuffer* occlusion, uint8_t program, float lodPixelScale)
+{
+    // Fresh containers bind to the frame allocator that is current this frame.
+    m_instances = FrameVector<InstanceData>();
+    m_batches = FrameVector<DrawBatch>();
+    m_stats = {};
+
+    const size_t capacity = query.Count();
+    if (capacity == 0) return;
+    MemoryArena& arena = MemoryManager::FrameArena();
+    DrawItem* items = arena.AllocateArray<DrawItem>(capacity);
+
+    // Gather: only renderables that are switched on and have an uploaded mesh.
+    uint32_t n = 0;
+    query.ForEach([&](Entity e, RenderableComponent& rend, TransformComponent& tr) {
+        if (!rend.isVisible) return;
+        const MeshGPU* mesh = RenderResources::GetMesh(rend.meshId);
+        if (!mesh) return;
+        items[n++] = {e, &tr, &rend, mesh, rend.meshId, rend.materialId, rend.isOccluder, 0};
+    });
+    m_stats.tested = n;
+    if (n == 0) return;
+
+    // Transform + cull in parallel chunks: each job writes the model matrices
+    // and world-space spheres of its range, then tests the range with SIMD.
+    InstanceData* unsorted = arena.AllocateArray<InstanceData>(n);
+    float* sx = arena.AllocateArray<float>(n);
+    float* sy = arena.AllocateArray<float>(n);
+    float* sz = arena.AllocateArray<float>(n);
+    float* sr = arena.AllocateArray<float>(n);
+    uint8_t* visible = arena.AllocateArray<uint8_t>(n);
+    std::atomic<uint32_t> visibleCount{0};
+    const bool selectLod = frustum && lodPixelScale > 0.0f;
+    gJobSystem.ParallelFor(0, n, CULL_GRAIN, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i)
+        {
+            const TransformComponent& tr = *items[i].transform;
+            const MeshGPU& mesh = *items[i].mesh;
+            ComposeModelMatrix(tr, unsorted[i].model);
+            const float* m = unsorted[i].model;
+            const float* c = mesh.boundsCenter;
+            sx[i] = m[0] * c[0] + m[4] * c[1] + m[8] * c[2] + m[12];
+            sy[i] = m[1] * c[0] + m[5] * c[1] + m[9] * c[2] + m[13];
+            sz[i] = m[2] * c[0] + m[6] * c[1] + m[10] * c[2] + m[14];
+            float s = std::max(std::fabs(tr.scale[0]), std::max(std::fabs(tr.scale[1]), std::fabs(tr.scale[2])));
+            sr[i] = mesh.boundsRadius * s;
+        }
+        size_t count = last - first;
+        if (frustum)
+            count = CullSpheres(*frustum, sx + first, sy + first, sz + first, sr + first, visible + first, count);
+        else
+            std::memset(visible + first, 1, count);
+        visibleCount.fetch_add(static_cast<uint32_t>(count), std::memory_order_relaxed);
+
+        // Level of detail from the sphere's depth: an object-space unit covers
+        // lodPixelScale * scale / w pixels. Each item owns its renderable, so
+        // writing lodLevel back needs no locking.
+        for (size_t i = first; i < last; ++i)
+        {
+            if (!visible[i]) continue;
+            RenderableComponent& rend = *items[i].renderable;
+            const MeshGPU& mesh = *items[i].mesh;
+            const int current = std::clamp(rend.lodLevel, 0, mesh.lodCount - 1);
+            int lod = rend.lodLocked ? current : 0;
+            if (selectLod && !rend.lodLocked)
+            {
+                const float* vp = frustum->viewProj;
+                float w = vp[3] * sx[i] + vp[7] * sy[i] + vp[11] * sz[i] + vp[15];
+                const auto& s = items[i].transform->scale;
+                float scale = std::max(std::fabs(s[0]), std::max(std::fabs(s[1]), std::fabs(s[2])));
+                float pixelsPerUnit = lodPixelScale * scale / std::max(w, 0.1f);
+                lod = SelectLod(mesh.lods, mesh.lodCount, pixelsPerUnit, current, gLodPixelError, gLodHysteresis);
+                rend.lodLevel = lod;
+            }
+            items[i].lod = static_cast<uint8_t>(lod);
+        }
+    });
+    m_stats.visible = visibleCount.load(std::memory_order_relaxed);
+
+    // Occlusion: rasterize the biggest on-screen occluders, build the depth
+    // pyramid, then test every other survivor's box against it in parallel.
+    if (frustum && occlusion && m_stats.visible > 0)
+    {
+        uint32_t* occluders = arena.AllocateArray<uint32_t>(n);
+        float* score = arena.AllocateArray<float>(n);
+        uint32_t occluderCount = 0;
+        const float* vp = frustum->viewProj;
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            if (!visible[i] || !items[i].occluder) continue;
+            float w = vp[3] * sx[i] + vp[7] * sy[i] + vp[11] * sz[i] + vp[15];
+            score[i] = sr[i] / std::max(w, 0.1f);
+            occluders[occluderCount++] = i;
+        }
+        if (occluderCount > MAX_OCCLUDERS)
+        {
+            std::nth_element(occluders, occluders + MAX_OCCLUDERS, occluders + occluderCount,
+                             [&](uint32_t a, uint32_t b) { return score[a] > score[b]; });
+            occluderCount = MAX_OCCLUDERS;
+        }
+
+        occlusion->Clear();
+        for (uint32_t k = 0; k < occluderCount; ++k)
+        {
+            const MeshGPU& mesh = *items[occluders[k]].mesh;
+            float mvp[16];
+            MultiplyMatrix(vp, unsorted[occluders[k]].model, mvp);
+            // The mesh's own surface at its coarsest level: a box would fill
+            // openings and concave corners with depth and hide what is behind them.
+            if (!mesh.occluderIndices.empty())
+            {
+                occlusion->RasterizeTriangles(mvp, mesh.occluderPositions.data(), mesh.occluderIndices.data(),
+                                              mesh.occluderIndices.size() / 3);
+                continue;
+            }
+            float innerMin[3], innerMax[3];
+            for (int a = 0; a < 3; ++a)
+            {
+                const float center = 0.5f * (mesh.boundsMin[a] + mesh.boundsMax[a]);
+                const float half = 0.5f * (mesh.boundsMax[a] - mesh.boundsMin[a]) * OCCLUDER_INNER_BOX_SCALE;
+                innerMin[a] = center - half;
+                innerMax[a] = center + half;
+            }
+            occlusion->RasterizeBox(mvp, innerMin, innerMax);
+        }
+        occlusion->BuildPyramid();
+
+        if (occluderCount > 0)
+        {
+            std::atomic<uint32_t> occludedCount{0};
+            gJobSystem.ParallelFor(0, n, CULL_GRAIN, [&](size_t first, size_t last) {
+                uint32_t occluded = 0;
+                for (size_t i = first; i < last; ++i)
+                {
+                    if (!visible[i] || items[i].occluder) continue;
+                    float mvp[16];
+                    MultiplyMatrix(vp, unsorted[i].model, mvp);
+                    if (occlusion->IsVisible(mvp, items[i].mesh->boundsMin, items[i].mesh->boundsMax)) continue;
+                    visible[i] = 0;
+                    ++occluded;
+                }
+                occludedCount.fetch_add(occluded, std::memory_order_relaxed);
+            });
+            m_stats.occluded = occludedCount.load(std::memory_order_relaxed);
+            m_stats.visible -= m_stats.occluded;
+        }
+    }
+    gProfiler.AddCounter("Cull Tested", m_stats.tested);
+    gProfiler.AddCounter("Cull Occluded", m_stats.occluded);
+    gProfiler.AddCounter("Cull Visible", m_stats.visible);
+    if (m_stats.visible == 0) return;
+
+    // Compact the survivors into sortable keys; materials are looked up only
+    // for what will actually be drawn.
+    const uint32_t drawn = m_stats.visible;
+    uint64_t* keys = arena.AllocateArray<uint64_t>(drawn);
+    uint32_t* order = arena.AllocateArray<uint32_t>(drawn);
+    uint32_t k = 0;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        if (!visible[i]) continue;
+        InstanceData& inst = unsorted[i];
+        inst.baseColor[0] = 0.8f; inst.baseColor[1] = 0.8f; inst.baseColor[2] = 0.8f;
+        inst.metallic = 0.0f; inst.roughness = 0.8f;
+        if (gCoordinator.HasComponent<MaterialComponent>(items[i].entity))
+        {
+            const auto& mat = gCoordinator.GetComponent<MaterialComponent>(items[i].entity);
+            std::memcpy(inst.baseColor, mat.baseColor, sizeof(inst.baseColor));
+            inst.metallic = mat.metallic; inst.roughness = mat.roughness;
+        }
+        keys[k] = MakeDrawKey(program, items[i].meshId, items[i].lod, items[i].materialId);
+        order[k] = i;
+        ++k;
+    }
+
+    RadixSort(keys, order, drawn, arena.AllocateArray<uint64_t>(drawn), arena.AllocateArray<uint32_t>(drawn));
+
+    m_instances.resize(drawn);
+    for (uint32_t i = 0; i < drawn; ++i)
+    {
+        const DrawItem& item = items[order[i]];
+        m_instances[i] = unsorted[order[i]];
+
+        // Key fields are truncated, so runs are split on the full ids.
+        const DrawItem* prev = i > 0 ? &items[order[i - 1]] : nullptr;
+        if (prev && prev->meshId == item.meshId && prev->lod == item.lod && prev->materialId == item.materialId)
+            ++m_batches.back().instanceCount;
+        else
+            m_batches.push_back({item.mesh, item.lod, i, 1});
+        m_stats.triangles += item.mesh->lods[item.lod].indexCount / 3;
+        m_stats.fullTriangles += item.mesh->lods[0].indexCount / 3;
+    }
+    m_stats.drawCalls = static_cast<uint32_t>(m_batches.size());
+    gProfiler.AddCounter("LOD Triangles", m_stats.triangles);
+    gProfiler.AddCounter("LOD Full Triangles", m_stats.fullTriangles);
+}
+
+void RenderQueue::BindInstanceAttributes(size_t byteOffset) const
+{
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceVbo);
+    const GLsizei stride = sizeof(InstanceData);
+    for (unsigned col = 0; col < 4; ++col)
+    {
+        glEnableVertexAttribArray(INSTANCE_ATTRIB_MODEL + col);
+        glVertexAttribPointer(INSTANCE_ATTRIB_MODEL + col, 4, GL_FLOAT, GL_FALSE, stride, (void*)(byteOffset + col * 4 * sizeof(float)));
+        glVertexAttribDivisor(INSTANCE_ATTRIB_MODEL + col, 1);
+    }
+    glEnableVertexAttribArray(INSTANCE_ATTRIB_BASE_METAL);
+    glVertexAttribPointer(INSTANCE_ATTRIB_BASE_METAL, 4, GL_FLOAT, GL_FALSE, stride, (void*)(byteOffset + offsetof(InstanceData, baseColor)));
+    glVertexAttribDivisor(INSTANCE_ATTRIB_BASE_METAL, 1);
+    glEnableVertexAttribArray(INSTANCE_ATTRIB_ROUGHNESS);
+    glVertexAttribPointer(INSTANCE_ATTRIB_ROUGHNESS, 1, GL_FLOAT, GL_FALSE, stride, (void*)(byteOffset + offsetof(InstanceData, roughness)));
+    glVertexAttribDivisor(INSTANCE_ATTRIB_ROUGHNESS, 1);
+}
+
+void RenderQueue::Submit()
+{
+    if (m_batches.empty()) return;
+
+    // One buffer for the renderer's lifetime: grown geometrically, orphaned
+    // each frame so the driver never stalls on last frame's draws.
+    const size_t bytes = m_instances.size() * sizeof(InstanceData);
+    if (!m_instanceVbo) glGenBuffers(1, &m_instanceVbo);
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceVbo);
+    if (bytes > m_capacityBytes) m_capacityBytes = bytes + bytes / 2;
+    glBufferData(GL_ARRAY_BUFFER, m_capacityBytes, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, m_instances.data());
+
+    // GL 3.3 has no base-instance draw, so each batch re-points the instance
+    // attributes at its slice of the buffer. Levels of detail are ranges of
+    // the mesh's one index buffer.
+    for (const DrawBatch& batch : m_batches)
+    {
+        const MeshGPU& mesh = *batch.mesh;
+        const auto& lod = mesh.lods[batch.lod];
+        const size_t indexSize = mesh.indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+        glBindVertexArray(mesh.vao);
+        BindInstanceAttributes(batch.firstInstance * sizeof(InstanceData));
+        glDrawElementsInstanced(GL_TRIANGLES, lod.indexCount, mesh.indexType, (void*)(lod.firstIndex * indexSize),
+                                batch.instanceCount);
+    }
+    glBindVertexArray(0);
+}
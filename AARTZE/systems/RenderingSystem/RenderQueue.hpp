@@ -0,0 +1,89 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "core/MemoryManager.hpp"
+#include "core/Query.hpp"
+
+struct Frustum;
+struct MeshGPU;
+class OcclusionBuffer;
+struct RenderableComponent;
+struct TransformComponent;
+
+// Per-instance vertex stream: model matrix at locations 4-7, base color +
+// metallic at 8, roughness at 9. Shaders drawing from a RenderQueue must
+// declare these inputs instead of the matching uniforms.
+constexpr unsigned INSTANCE_ATTRIB_MODEL = 4;
+constexpr unsigned INSTANCE_ATTRIB_BASE_METAL = 8;
+constexpr unsigned INSTANCE_ATTRIB_ROUGHNESS = 9;
+
+struct InstanceData
+{
+    float model[16];     // column-major
+    float baseColor[3];
+    float metallic;
+    float roughness;
+    float pad[3];
+};
+
+struct DrawBatch
+{
+    const MeshGPU* mesh;
+    uint32_t lod;  // index into mesh->lods
+    uint32_t firstInstance;
+    uint32_t instanceCount;
+};
+
+struct RenderQueueStats
+{
+    uint32_t tested{0};     // visible-flagged renderables with a mesh
+    uint32_t visible{0};    // of those, inside the frustum and not occluded
+    uint32_t occluded{0};   // inside the frustum but hidden behind occluders
+    uint32_t drawCalls{0};
+    uint64_t triangles{0};      // submitted, at the selected levels of detail
+    uint64_t fullTriangles{0};  // the same instances drawn at level 0
+};
+
+/**
+ * @brief Per-frame list of visible renderables turned into instanced draws.
+ *
+ * Build() gathers the renderables, culls their bounding spheres against the
+ * frustum in parallel chunks, optionally tests the survivors' boxes against an
+ * occlusion buffer filled from the largest visible occluders, picks each
+ * survivor's level of detail from its projected size (see SelectLod), gives
+ * it a 64-bit key [program:8 | mesh:26 | lod:2 | material:28], radix-sorts
+ * the keys and merges runs of the same mesh, level and material into one
+ * batch. Submit() streams the instance
+ * data into a long-lived buffer and issues one glDrawElementsInstanced per
+ * batch. Item and instance arrays live in frame memory.
+ */
+class RenderQueue
+{
+public:
+    RenderQueue() = default;
+    RenderQueue(const RenderQueue&) = delete;
+    RenderQueue& operator=(const RenderQueue&) = delete;
+
+    void Shutdown();
+    // A null frustum disables culling; a null occlusion buffer skips the
+    // occlusion stage (it also needs a frustum). lodPixelScale is the
+    // projected size in pixels of one unit at unit depth, Proj[5] * height / 2;
+    // 0 (or no frustum) draws every mesh at level 0.
+    void Build(Query<RenderableComponent, TransformComponent>& query, const Frustum* frustum,
+               OcclusionBuffer* occlusion = nullptr, uint8_t program = 0, float lodPixelScale = 0.0f);
+    void Submit();
+
+    const RenderQueueStats& GetStats() const { return m_stats; }
+
+private:
+    unsigned m_instanceVbo{0};
+    size_t m_capacityBytes{0};
+    FrameVector<InstanceData> m_instances;
+    FrameVector<DrawBatch> m_batches;
+    RenderQueueStats m_stats;
+
+    void BindInstanceAttributes(size_t byteOffset) const;
+};
+
+// Model matrix T * Ry * Rx * Rz * S for a TransformComponent (degrees).
+void ComposeModelMatrix(const TransformComponent& tr, float out[16]);
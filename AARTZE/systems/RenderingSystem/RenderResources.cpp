@@ -1,92 +1,266 @@
 #include "RenderResources.hpp"
 #include <glad/glad.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <cstring>
+#include <iostream>
 
+#include "core/MemoryManager.hpp"
+#include "utils/CookedMesh.hpp"
 #include "utils/MeshUtils.hpp"
+#include "World/AssetRegistry.hpp"
+#include "VertexFormat.hpp"
+#include "aartze/geometry/BVH.h"
 
 namespace
 {
 std::unordered_map<uint32_t, MeshGPU> gMeshes;
-}
+std::unordered_map<uint32_t, aartze::geometry::BVH> gMeshBVHs;
+// Meshes part-way through UploadMeshPart; invisible to GetMesh until complete.
+std::unordered_map<uint32_t, MeshGPU> gPendingMeshes;
+unsigned gStagingBuffer = 0;
+// Largest slice staged at once. Every slice orphans the staging buffer, so
+// the driver hands out fresh storage instead of waiting for the last copy.
+constexpr size_t STAGING_BYTES = size_t(1) << 20;
 
-namespace RenderResources
+void DeleteBuffers(MeshGPU& m)
 {
-void UploadMesh(uint32_t meshId, const MeshData& data)
+    if (m.vbo) glDeleteBuffers(1, &m.vbo);
+    if (m.ebo) glDeleteBuffers(1, &m.ebo);
+    if (m.vao) glDeleteVertexArrays(1, &m.vao);
+    m.vbo = m.ebo = m.vao = 0;
+}
+
+// Create the buffers on first use and fill them with GPU-ready blobs: packed
+// vertices and indices of every level, either built by UploadMesh or mapped
+// straight from an .amesh file. Null data only allocates, for UploadMeshPart.
+void UploadBuffers(MeshGPU& gpu, const void* vertices, size_t vertexCount, const void* indices, size_t indexCount,
+                   size_t indexSize)
 {
-    if (data.vertices.empty()) return;
-    MeshGPU& gpu = gMeshes[meshId];
     if (gpu.vao == 0)
     {
         glGenVertexArrays(1, &gpu.vao);
         glGenBuffers(1, &gpu.vbo);
+        glGenBuffers(1, &gpu.ebo);
     }
     glBindVertexArray(gpu.vao);
     glBindBuffer(GL_ARRAY_BUFFER, gpu.vbo);
+    gpu.stride = sizeof(PackedVertex);
+    gpu.vertexCount = static_cast<int>(vertexCount);
+    gpu.vertexBytes = vertexCount * sizeof(PackedVertex);
+    glBufferData(GL_ARRAY_BUFFER, gpu.vertexBytes, vertices, GL_STATIC_DRAW);
 
-    // Interleave attributes: pos(3), normal(3), color(3), uv(2)
-    const size_t vcount = data.vertices.size() / 3;
-    std::vector<float> interleaved;
-    interleaved.reserve(vcount * 11);
-    for (size_t i = 0; i < vcount; ++i)
-    {
-        // position
-        interleaved.push_back(data.vertices[i * 3 + 0]);
-        interleaved.push_back(data.vertices[i * 3 + 1]);
-        interleaved.push_back(data.vertices[i * 3 + 2]);
-        // normal
-        if (data.normals.size() >= (i + 1) * 3)
-        {
-            interleaved.push_back(data.normals[i * 3 + 0]);
-            interleaved.push_back(data.normals[i * 3 + 1]);
-            interleaved.push_back(data.normals[i * 3 + 2]);
-        }
-        else
-        {
-            interleaved.push_back(0.0f);
-            interleaved.push_back(0.0f);
-            interleaved.push_back(1.0f);
-        }
-        // color
-        if (data.colors.size() >= (i + 1) * 3)
-        {
-            interleaved.push_back(data.colors[i * 3 + 0]);
-            interleaved.push_back(data.colors[i * 3 + 1]);
-            interleaved.push_back(data.colors[i * 3 + 2]);
-        }
-        else
-        {
-            interleaved.push_back(1.0f);
-            interleaved.push_back(1.0f);
-            interleaved.push_back(1.0f);
-        }
-        // uv
-        if (data.texCoords.size() >= (i + 1) * 2)
-        {
-            interleaved.push_back(data.texCoords[i * 2 + 0]);
-            interleaved.push_back(data.texCoords[i * 2 + 1]);
-        }
-        else
-        {
-            interleaved.push_back(0.0f);
-            interleaved.push_back(0.0f);
-        }
-    }
-    gpu.stride = 11 * sizeof(float);
-    gpu.vertexCount = static_cast<int>(vcount);
-    glBufferData(GL_ARRAY_BUFFER, interleaved.size() * sizeof(float), interleaved.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gpu.ebo);
+    gpu.indexType = indexSize == sizeof(uint16_t) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    gpu.indexBytes = indexCount * indexSize;
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, gpu.indexBytes, indices, GL_STATIC_DRAW);
 
+    const GLsizei stride = gpu.stride;
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, gpu.stride, (void*)0);
+    glVertexAttribPointer(0, 3, GL_HALF_FLOAT, GL_FALSE, stride, (void*)offsetof(PackedVertex, position));
     glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, gpu.stride, (void*)(3 * sizeof(float)));
+    glVertexAttribPointer(1, 2, GL_BYTE, GL_TRUE, stride, (void*)offsetof(PackedVertex, normal));
     glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, gpu.stride, (void*)(6 * sizeof(float)));
+    glVertexAttribPointer(2, 3, GL_UNSIGNED_BYTE, GL_TRUE, stride, (void*)offsetof(PackedVertex, color));
     glEnableVertexAttribArray(3);
-    glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, gpu.stride, (void*)(9 * sizeof(float)));
+    glVertexAttribPointer(3, 2, GL_HALF_FLOAT, GL_FALSE, stride, (void*)offsetof(PackedVertex, uv));
 
     glBindVertexArray(0);
 }
 
+void SetLods(MeshGPU& gpu, const aartze::geometry::LodLevel* lods, size_t lodCount, size_t indexCount)
+{
+    gpu.lodCount = std::max(1, std::min(MAX_MESH_LODS, static_cast<int>(lodCount)));
+    if (lodCount == 0)
+        gpu.lods[0] = {0, static_cast<uint32_t>(indexCount - indexCount % 3), 0.0f};
+    else
+        std::copy(lods, lods + gpu.lodCount, gpu.lods);
+    gpu.indexCount = static_cast<int>(gpu.lods[0].indexCount);
+}
+
+// Triangles of `lod` with their own compact vertex list, for MeshGPU's
+// occluder geometry. Left empty when the level is too big to rasterize.
+template <class Index>
+void ExtractOccluder(const float* positions, const Index* indices, const aartze::geometry::LodLevel& lod,
+                     std::vector<float>& occluderPositions, std::vector<uint32_t>& occluderIndices)
+{
+    occluderPositions.clear();
+    occluderIndices.clear();
+    if (lod.indexCount / 3 > MAX_OCCLUDER_TRIANGLES) return;
+    const Index* first = indices + lod.firstIndex;
+    std::vector<uint32_t> used(first, first + lod.indexCount - lod.indexCount % 3);
+    std::sort(used.begin(), used.end());
+    used.erase(std::unique(used.begin(), used.end()), used.end());
+    occluderPositions.resize(used.size() * 3);
+    for (size_t v = 0; v < used.size(); ++v)
+        std::memcpy(&occluderPositions[v * 3], positions + size_t(used[v]) * 3, 3 * sizeof(float));
+    occluderIndices.resize(lod.indexCount - lod.indexCount % 3);
+    for (size_t i = 0; i < occluderIndices.size(); ++i)
+        occluderIndices[i] = static_cast<uint32_t>(std::lower_bound(used.begin(), used.end(), uint32_t(first[i])) - used.begin());
+}
+
+// The registry learns what is on the GPU; a resident mesh holds its textures.
+void MarkResident(uint32_t meshId)
+{
+    gAssetRegistry.SetState(MeshHandle{meshId}, AssetState::Resident);
+}
+
+void ApplyUploadHeader(MeshGPU& gpu, const MeshUpload& upload)
+{
+    std::copy(upload.boundsMin, upload.boundsMin + 3, gpu.boundsMin);
+    std::copy(upload.boundsMax, upload.boundsMax + 3, gpu.boundsMax);
+    std::copy(upload.boundsCenter, upload.boundsCenter + 3, gpu.boundsCenter);
+    gpu.boundsRadius = upload.boundsRadius;
+    SetLods(gpu, upload.lods, upload.lodCount, upload.indexCount);
+}
+}
+
+namespace RenderResources
+{
+void UploadMesh(uint32_t meshId, const MeshData& data)
+{
+    if (data.vertices.size() < 3) return;
+    if (data.indices.empty())
+    {
+        // Meshes built in code arrive as triangle lists; weld them here so
+        // every mesh takes the indexed path.
+        MeshData welded = data;
+        WeldVertices(welded);
+        UploadMesh(meshId, welded);
+        return;
+    }
+
+    // Pack attributes into 16-byte vertices (see VertexFormat.hpp). The
+    // staging copies are consumed by glBufferData, so they live in frame memory.
+    MeshGPU& gpu = gMeshes[meshId];
+    const size_t vcount = data.vertices.size() / 3;
+    FrameVector<PackedVertex> packed(vcount);
+    PackMeshVertices(data, packed.data());
+    ComputeMeshBounds(data.vertices.data(), vcount, gpu.boundsMin, gpu.boundsMax, gpu.boundsCenter, gpu.boundsRadius);
+
+    // All levels go into one ebo; a mesh without a LOD chain is its own level 0.
+    SetLods(gpu, data.lods.data(), data.lods.size(), data.indices.size());
+    // Ray queries answer against the full-detail surface.
+    gMeshBVHs[meshId].Build(data.vertices.data(), 3 * sizeof(float), data.indices.data() + gpu.lods[0].firstIndex,
+                            gpu.lods[0].indexCount / 3);
+    ExtractOccluder(data.vertices.data(), data.indices.data(), gpu.lods[gpu.lodCount - 1], gpu.occluderPositions,
+                    gpu.occluderIndices);
+
+    // 16-bit indices whenever every vertex is addressable with them.
+    if (vcount <= 0x10000)
+    {
+        FrameVector<uint16_t> shortIndices(data.indices.begin(), data.indices.end());
+        UploadBuffers(gpu, packed.data(), vcount, shortIndices.data(), shortIndices.size(), sizeof(uint16_t));
+    }
+    else
+        UploadBuffers(gpu, packed.data(), vcount, data.indices.data(), data.indices.size(), sizeof(uint32_t));
+
+    MarkResident(meshId);
+    for (const std::string& texture : data.texturePaths)
+        if (!texture.empty()) gAssetRegistry.AddDependency(MeshHandle{meshId}, texture);
+}
+
+bool PrepareMeshUpload(const MeshData& data, std::vector<unsigned char>& storage, MeshUpload& upload)
+{
+    if (data.vertices.size() < 3) return false;
+    if (data.indices.empty())
+    {
+        MeshData welded = data;
+        WeldVertices(welded);
+        return PrepareMeshUpload(welded, storage, upload);
+    }
+    const size_t vcount = data.vertices.size() / 3;
+    const size_t icount = data.indices.size();
+    const size_t vertexBytes = vcount * sizeof(PackedVertex);
+    upload.vertexCount = vcount;
+    upload.indexCount = icount;
+    upload.indexSize = vcount <= 0x10000 ? sizeof(uint16_t) : sizeof(uint32_t);
+    storage.resize(vertexBytes + icount * upload.indexSize);
+    PackMeshVertices(data, reinterpret_cast<PackedVertex*>(storage.data()));
+    if (upload.indexSize == sizeof(uint16_t))
+    {
+        uint16_t* out = reinterpret_cast<uint16_t*>(storage.data() + vertexBytes);
+        for (size_t i = 0; i < icount; ++i) out[i] = static_cast<uint16_t>(data.indices[i]);
+    }
+    else
+        std::memcpy(storage.data() + vertexBytes, data.indices.data(), icount * sizeof(uint32_t));
+    upload.vertices = storage.data();
+    upload.indices = storage.data() + vertexBytes;
+
+    ComputeMeshBounds(data.vertices.data(), vcount, upload.boundsMin, upload.boundsMax, upload.boundsCenter,
+                      upload.boundsRadius);
+    upload.lodCount = std::max(1, std::min(MAX_MESH_LODS, static_cast<int>(data.lods.size())));
+    if (data.lods.empty())
+        upload.lods[0] = {0, static_cast<uint32_t>(icount - icount % 3), 0.0f};
+    else
+        std::copy(data.lods.begin(), data.lods.begin() + upload.lodCount, upload.lods);
+    upload.bvh.Build(data.vertices.data(), 3 * sizeof(float), data.indices.data() + upload.lods[0].firstIndex,
+                     upload.lods[0].indexCount / 3);
+    ExtractOccluder(data.vertices.data(), data.indices.data(), upload.lods[upload.lodCount - 1], upload.occluderPositions,
+                    upload.occluderIndices);
+    upload.uploadedBytes = 0;
+    return true;
+}
+
+void PrepareMeshUpload(const CookedMeshView& view, MeshUpload& upload)
+{
+    const AmeshHeader& h = *view.header;
+    upload.vertices = view.vertices;
+    upload.vertexCount = h.vertexCount;
+    upload.indices = view.indices;
+    upload.indexCount = h.indexCount;
+    upload.indexSize = h.indexSize;
+    std::copy(h.boundsMin, h.boundsMin + 3, upload.boundsMin);
+    std::copy(h.boundsMax, h.boundsMax + 3, upload.boundsMax);
+    std::copy(h.boundsCenter, h.boundsCenter + 3, upload.boundsCenter);
+    upload.boundsRadius = h.boundsRadius;
+    upload.lodCount = std::min(MAX_MESH_LODS, static_cast<int>(h.lodCount));
+    std::copy(view.lods, view.lods + upload.lodCount, upload.lods);
+    upload.uploadedBytes = 0;
+
+    // The BVH and the occluder are built over the float positions the file
+    // carries for them; 16-bit level-0 indices are widened first.
+    const aartze::geometry::LodLevel& lod0 = upload.lods[0];
+    const aartze::geometry::LodLevel& coarsest = upload.lods[upload.lodCount - 1];
+    if (h.indexSize == sizeof(uint32_t))
+    {
+        const uint32_t* indices = static_cast<const uint32_t*>(view.indices);
+        upload.bvh.Build(view.positions, 3 * sizeof(float), indices + lod0.firstIndex, lod0.indexCount / 3);
+        ExtractOccluder(view.positions, indices, coarsest, upload.occluderPositions, upload.occluderIndices);
+    }
+    else
+    {
+        const uint16_t* shortIndices = static_cast<const uint16_t*>(view.indices);
+        std::vector<uint32_t> indices(shortIndices + lod0.firstIndex, shortIndices + lod0.firstIndex + lod0.indexCount);
+        upload.bvh.Build(view.positions, 3 * sizeof(float), indices.data(), lod0.indexCount / 3);
+        ExtractOccluder(view.positions, shortIndices, coarsest, upload.occluderPositions, upload.occluderIndices);
+    }
+}
+
+bool UploadCookedMesh(uint32_t meshId, const std::string& path)
+{
+    MappedFile file;
+    CookedMeshView view;
+    if (!OpenCookedMesh(path, file, view)) return false;
+    MeshUpload upload;
+    PrepareMeshUpload(view, upload);
+
+    // Blobs go from the mapping to the driver as they are; only the header
+    // and the small tables are read on the CPU.
+    MeshGPU& gpu = gMeshes[meshId];
+    ApplyUploadHeader(gpu, upload);
+    UploadBuffers(gpu, upload.vertices, upload.vertexCount, upload.indices, upload.indexCount, upload.indexSize);
+    gpu.occluderPositions = std::move(upload.occluderPositions);
+    gpu.occluderIndices = std::move(upload.occluderIndices);
+    gMeshBVHs[meshId] = std::move(upload.bvh);
+
+    MarkResident(meshId);
+    for (uint32_t i = 0; i < view.header->materialCount; ++i)
+        if (!view.Material(i).empty()) gAssetRegistry.AddDependency(MeshHandle{meshId}, std::string(view.Material(i)));
+    return true;
+}
+
 const MeshGPU* GetMesh(uint32_t meshId)
 {
     auto it = gMeshes.find(meshId);
@@ -94,14 +268,171 @@ const MeshGPU* GetMesh(uint32_t meshId)
     return &it->second;
 }
 
-void Clear()
+const aartze::geometry::BVH* GetMeshBVH(uint32_t meshId)
+{
+    auto it = gMeshBVHs.find(meshId);
+    if (it == gMeshBVHs.end() || it->second.Empty()) return nullptr;
+    return &it->second;
+}
+
+size_t UploadMeshPart(uint32_t meshId, MeshUpload& upload, size_t budgetBytes)
+{
+    const size_t vertexBytes = upload.vertexCount * sizeof(PackedVertex);
+    const size_t totalBytes = upload.TotalBytes();
+    auto [it, created] = gPendingMeshes.try_emplace(meshId);
+    MeshGPU& gpu = it->second;
+    if (created)
+    {
+        // Allocate both buffers at full size and set up the vao; the data follows in slices.
+        ApplyUploadHeader(gpu, upload);
+        UploadBuffers(gpu, nullptr, upload.vertexCount, nullptr, upload.indexCount, upload.indexSize);
+    }
+    if (gStagingBuffer == 0) glGenBuffers(1, &gStagingBuffer);
+
+    size_t copied = 0;
+    glBindBuffer(GL_COPY_READ_BUFFER, gStagingBuffer);
+    while (upload.uploadedBytes < totalBytes && copied < budgetBytes)
+    {
+        const bool inVertices = upload.uploadedBytes < vertexBytes;
+        const size_t offset = inVertices ? upload.uploadedBytes : upload.uploadedBytes - vertexBytes;
+        const size_t end = inVertices ? vertexBytes : totalBytes - vertexBytes;
+        const size_t slice = std::min({STAGING_BYTES, end - offset, budgetBytes - copied});
+        const unsigned char* source = static_cast<const unsigned char*>(inVertices ? upload.vertices : upload.indices) + offset;
+
+        glBufferData(GL_COPY_READ_BUFFER, STAGING_BYTES, nullptr, GL_STREAM_DRAW);
+        void* staging = glMapBufferRange(GL_COPY_READ_BUFFER, 0, slice,
+                                         GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, inVertices ? gpu.vbo : gpu.ebo);
+        if (staging)
+        {
+            std::memcpy(staging, source, slice);
+            glUnmapBuffer(GL_COPY_READ_BUFFER);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, offset, slice);
+        }
+        else
+            glBufferSubData(GL_COPY_WRITE_BUFFER, offset, slice, source);
+        upload.uploadedBytes += slice;
+        copied += slice;
+    }
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    if (upload.uploadedBytes >= totalBytes)
+    {
+        auto old = gMeshes.find(meshId);
+        if (old != gMeshes.end()) DeleteBuffers(old->second);
+        gpu.occluderPositions = std::move(upload.occluderPositions);
+        gpu.occluderIndices = std::move(upload.occluderIndices);
+        gMeshes[meshId] = std::move(gpu);
+        gMeshBVHs[meshId] = std::move(upload.bvh);
+        gPendingMeshes.erase(it);
+        MarkResident(meshId);
+    }
+    return copied;
+}
+
+void CancelMeshUpload(uint32_t meshId)
+{
+    auto it = gPendingMeshes.find(meshId);
+    if (it == gPendingMeshes.end()) return;
+    DeleteBuffers(it->second);
+    gPendingMeshes.erase(it);
+}
+
+void UnloadMesh(uint32_t meshId)
 {
-    for (auto& [id, m] : gMeshes)
+    CancelMeshUpload(meshId);
+    auto it = gMeshes.find(meshId);
+    if (it != gMeshes.end())
     {
-        if (m.vbo) glDeleteBuffers(1, &m.vbo);
-        if (m.vao) glDeleteVertexArrays(1, &m.vao);
+        DeleteBuffers(it->second);
+        gMeshes.erase(it);
     }
+    gMeshBVHs.erase(meshId);
+    gAssetRegistry.SetState(MeshHandle{meshId}, AssetState::Unloaded);
+}
+
+size_t UploadTexturePart(TextureUpload& upload, size_t budgetBytes)
+{
+    if (upload.uploadedRows >= upload.height) return 0;
+    if (upload.texture == 0)
+    {
+        glGenTextures(1, &upload.texture);
+        glBindTexture(GL_TEXTURE_2D, upload.texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, upload.width, upload.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    }
+    else
+        glBindTexture(GL_TEXTURE_2D, upload.texture);
+
+    const size_t rowBytes = size_t(upload.width) * 4;
+    const int rows = static_cast<int>(std::clamp<size_t>(budgetBytes / rowBytes, 1, size_t(upload.height - upload.uploadedRows)));
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, upload.uploadedRows, upload.width, rows, GL_RGBA, GL_UNSIGNED_BYTE,
+                    upload.pixels + upload.uploadedRows * rowBytes);
+    upload.uploadedRows += rows;
+    if (upload.uploadedRows == upload.height) glGenerateMipmap(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return rows * rowBytes;
+}
+
+void DeleteTexture(unsigned texture)
+{
+    if (texture) glDeleteTextures(1, &texture);
+}
+
+void Clear()
+{
+    for (auto& [id, m] : gMeshes) DeleteBuffers(m);
+    for (auto& [id, m] : gPendingMeshes) DeleteBuffers(m);
+    if (gStagingBuffer) glDeleteBuffers(1, &gStagingBuffer);
+    gStagingBuffer = 0;
     gMeshes.clear();
+    gPendingMeshes.clear();
+    gMeshBVHs.clear();
+    gAssetRegistry.UnloadTextures();
+}
+
+void ForEachMeshMemoryStats(const std::function<void(const MeshMemoryStats&)>& fn)
+{
+    for (const auto& [id, m] : gMeshes)
+    {
+        MeshMemoryStats stats;
+        stats.meshId = id;
+        stats.vertexCount = static_cast<uint32_t>(m.vertexCount);
+        stats.indexCount = static_cast<uint32_t>(m.indexCount);
+        stats.lodCount = static_cast<uint32_t>(m.lodCount);
+        stats.vertexBytes = m.vertexBytes;
+        stats.indexBytes = m.indexBytes;
+        stats.unindexedBytes = size_t(m.indexCount) * UNINDEXED_VERTEX_BYTES;
+        fn(stats);
+    }
+}
+
+void ReportMeshMemory()
+{
+    MeshMemoryStats total;
+    size_t meshes = 0;
+    std::cout << "[MEMORY] Mesh Report:\n";
+    ForEachMeshMemoryStats([&](const MeshMemoryStats& s) {
+        std::cout << " - Mesh " << s.meshId << " | Vertices: " << s.vertexCount << " | Indices: " << s.indexCount
+                  << " | LODs: " << s.lodCount
+                  << " | GPU Bytes: " << (s.vertexBytes + s.indexBytes) << " (unindexed " << s.unindexedBytes << ")\n";
+        total.vertexCount += s.vertexCount;
+        total.indexCount += s.indexCount;
+        total.vertexBytes += s.vertexBytes;
+        total.indexBytes += s.indexBytes;
+        total.unindexedBytes += s.unindexedBytes;
+        ++meshes;
+    });
+    const size_t bytes = total.vertexBytes + total.indexBytes;
+    std::cout << " - Total: " << meshes << " meshes | Vertex Bytes: " << total.vertexBytes
+              << " | Index Bytes: " << total.indexBytes << " | Unindexed: " << total.unindexedBytes;
+    if (bytes > 0) std::cout << " (" << double(total.unindexedBytes) / double(bytes) << "x)";
+    std::cout << "\n";
 }
 }
 
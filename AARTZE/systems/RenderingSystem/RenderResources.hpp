@@ -1,23 +1,136 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "aartze/geometry/BVH.h"
+#include "aartze/geometry/Simplify.h"
+#include "VertexFormat.hpp"
+
 struct MeshData; // from utils/MeshUtils.hpp
+struct CookedMeshView; // from utils/CookedMesh.hpp
+
+// Levels of detail kept per mesh, level 0 included.
+constexpr int MAX_MESH_LODS = 4;
+// Occluder geometry is kept on the CPU only when the coarsest level has at
+// most this many triangles; larger ones would cost too much to rasterize
+// every frame.
+constexpr uint32_t MAX_OCCLUDER_TRIANGLES = 4096;
 
 struct MeshGPU
 {
     unsigned vao{0};
     unsigned vbo{0};
-    int vertexCount{0};
+    unsigned ebo{0};
+    int vertexCount{0};  // unique vertices in the vbo
+    int indexCount{0};   // level 0, drawn with glDrawElements
+    unsigned indexType{0};  // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
     int stride{0};
+    size_t vertexBytes{0};
+    size_t indexBytes{0};   // every level
+    // Index ranges of each level in the ebo, finest first, with the
+    // object-space error the LOD selector projects to the screen.
+    aartze::geometry::LodLevel lods[MAX_MESH_LODS]{};
+    int lodCount{1};
+    // Object-space bounds, filled at upload for culling.
+    float boundsMin[3]{0.0f, 0.0f, 0.0f};
+    float boundsMax[3]{0.0f, 0.0f, 0.0f};
+    float boundsCenter[3]{0.0f, 0.0f, 0.0f};
+    float boundsRadius{0.0f};
+    // The coarsest level in object space, compacted to the vertices it uses,
+    // for the occlusion buffer. Empty past MAX_OCCLUDER_TRIANGLES.
+    std::vector<float> occluderPositions;
+    std::vector<uint32_t> occluderIndices;
+};
+
+// A mesh already packed for the GPU (PackedVertex vertices, indices of every
+// level) and prepared off the main thread, which UploadMeshPart copies to GL
+// a slice at a time. The vertex and index bytes must outlive the upload.
+struct MeshUpload
+{
+    const void* vertices{nullptr};
+    size_t vertexCount{0};
+    const void* indices{nullptr};
+    size_t indexCount{0};
+    size_t indexSize{sizeof(uint16_t)};
+    aartze::geometry::LodLevel lods[MAX_MESH_LODS]{};
+    int lodCount{1};
+    float boundsMin[3]{0.0f, 0.0f, 0.0f};
+    float boundsMax[3]{0.0f, 0.0f, 0.0f};
+    float boundsCenter[3]{0.0f, 0.0f, 0.0f};
+    float boundsRadius{0.0f};
+    aartze::geometry::BVH bvh;  // moved into RenderResources when the upload completes
+    std::vector<float> occluderPositions;  // moved into the MeshGPU likewise
+    std::vector<uint32_t> occluderIndices;
+    size_t uploadedBytes{0};    // through the vertex bytes, then the index bytes
+
+    size_t TotalBytes() const { return vertexCount * sizeof(PackedVertex) + indexCount * indexSize; }
+};
+
+// An RGBA8 image decoded off the main thread, which UploadTexturePart copies
+// to GL a band of rows at a time. The pixels must outlive the upload.
+struct TextureUpload
+{
+    const unsigned char* pixels{nullptr};
+    int width{0};
+    int height{0};
+    int uploadedRows{0};
+    unsigned texture{0};  // created by the first UploadTexturePart
+
+    size_t TotalBytes() const { return size_t(width) * size_t(height) * 4; }
+};
+
+// Size of one vertex in the old de-indexed 11-float layout, for comparison.
+constexpr size_t UNINDEXED_VERTEX_BYTES = 11 * sizeof(float);
+
+struct MeshMemoryStats
+{
+    uint32_t meshId{0};
+    uint32_t vertexCount{0};
+    uint32_t indexCount{0};  // level 0
+    uint32_t lodCount{1};
+    size_t vertexBytes{0};
+    size_t indexBytes{0};  // every level
+    size_t unindexedBytes{0};  // what the same triangles took as 44-byte soup
 };
 
 namespace RenderResources
 {
-// Create or fetch a GPU mesh for given id using provided data
+// Create or fetch a GPU mesh for given id using provided data. Uploads mark
+// the mesh resident in gAssetRegistry, which then holds its textures.
 void UploadMesh(uint32_t meshId, const MeshData& data);
+// Map a cooked .amesh file (utils/CookedMesh.hpp) and upload its blobs as
+// they are; false if the file is missing, stale or malformed.
+bool UploadCookedMesh(uint32_t meshId, const std::string& path);
+// CPU side of an upload, safe on any thread (no GL calls): pack `data` into
+// `storage`, or point at the blobs of a mapped .amesh, and build the BVH.
+// False if `data` has no triangles.
+bool PrepareMeshUpload(const MeshData& data, std::vector<unsigned char>& storage, MeshUpload& upload);
+void PrepareMeshUpload(const CookedMeshView& view, MeshUpload& upload);
+// Copy up to `budgetBytes` more of `upload` into the mesh's buffers through
+// an orphaned staging buffer, so the copy never waits on the GPU. Buffers are
+// allocated on the first call; the mesh replaces any previous one under this
+// id (GetMesh, GetMeshBVH) once its last byte is in. Returns the bytes copied.
+size_t UploadMeshPart(uint32_t meshId, MeshUpload& upload, size_t budgetBytes);
+// Free the buffers of an UploadMeshPart sequence that will not be finished.
+void CancelMeshUpload(uint32_t meshId);
+// Free a mesh's buffers and BVH, and any unfinished upload under its id.
+// Renderables keep the id and are skipped until it is uploaded again.
+void UnloadMesh(uint32_t meshId);
+// Copy up to `budgetBytes` more of `upload` into its texture, in whole rows
+// and at least one, allocating it on the first call and building mipmaps
+// after the last row. Returns the bytes copied.
+size_t UploadTexturePart(TextureUpload& upload, size_t budgetBytes);
+void DeleteTexture(unsigned texture);
 const MeshGPU* GetMesh(uint32_t meshId);
+// Object-space triangle BVH built at upload, for ray queries (picking, line of sight).
+const aartze::geometry::BVH* GetMeshBVH(uint32_t meshId);
 void Clear();
+void ForEachMeshMemoryStats(const std::function<void(const MeshMemoryStats&)>& fn);
+// Prints GPU bytes per mesh and in total, next to the unindexed equivalent.
+void ReportMeshMemory();
 }
 
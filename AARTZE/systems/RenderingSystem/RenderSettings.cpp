@@ -4,4 +4,8 @@ bool gUseDeferred = true;
 bool gEnableSSAO = true;
 bool gEnableShadows = false;
 bool gEnableSSR = false;
+bool gEnableOcclusionCulling = true;
 
+bool gEnableLod = true;
+float gLodPixelError = 1.0f;
+float gLodHysteresis = 0.25f;
@@ -4,4 +4,8 @@ extern bool gUseDeferred;
 extern bool gEnableSSAO;
 extern bool gEnableShadows;
 extern bool gEnableSSR;
+extern bool gEnableOcclusionCulling;
 
+extern bool gEnableLod;
+extern float gLodPixelError;   // largest projected simplification error allowed, in pixels
+extern float gLodHysteresis;   // fraction the error must pass the budget by before a level changes
@@ -6,11 +6,14 @@
 #include <vector>
 
 #include "core/Coordinator.hpp"
+#include "core/MemoryManager.hpp"
 #include "components/RenderableComponent.hpp"
 #include "components/TransformComponent.hpp"
 #include "components/MaterialComponent.hpp"
 #include "RenderResources.hpp"
 #include "DeferredRenderer.hpp"
+#include "FrustumCulling.hpp"
+#include "SceneRaycast.hpp"
 #include "../core/Coordinator.hpp"
 #include "../components/TransformComponent.hpp"
 #include "../editor/EditorState.hpp"
@@ -29,6 +32,7 @@ static unsigned compileShader(unsigned type, const char* src)
 bool RenderingSystem::Initialize(GLFWwindow* window)
 {
     m_window = window;
+    m_drawQuery = &gCoordinator.GetQuery<RenderableComponent, TransformComponent>();
     ensureProgram();
     m_deferred = new DeferredRenderer();
     m_deferred->Initialize();
@@ -38,6 +42,9 @@ bool RenderingSystem::Initialize(GLFWwindow* window)
 void RenderingSystem::Shutdown()
 {
     if (m_program) glDeleteProgram(m_program);
+    m_queue.Shutdown();
+    gSceneRaycaster.Clear();
+    RenderResources::ReportMeshMemory();
     RenderResources::Clear();
     if (m_deferred){ m_deferred->Shutdown(); delete m_deferred; m_deferred=nullptr; }
     if (m_lineProg) glDeleteProgram(m_lineProg);
@@ -52,29 +59,38 @@ void RenderingSystem::ensureProgram()
     const char* vs = R"GLSL(
         #version 330 core
         layout(location=0) in vec3 aPos;
-        layout(location=1) in vec3 aNormal;
+        layout(location=1) in vec2 aOctNormal;  // octahedral, see VertexFormat.hpp
         layout(location=2) in vec3 aColor;
         layout(location=3) in vec2 aUV;
+        layout(location=4) in mat4 iModel;      // per instance (RenderQueue)
+        layout(location=8) in vec4 iBaseMetal;
+        layout(location=9) in float iRough;
         uniform mat4 uProj;
         uniform mat4 uView;
-        uniform mat4 uModel;
         out vec3 vPos;
         out vec3 vNrm;
         out vec3 vCol;
+        flat out vec3 vBaseColor;
+        flat out float vMetallic;
+        flat out float vRoughness;
+        vec3 octDecode(vec2 e){
+            vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+            if (n.z < 0.0) n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+            return normalize(n);
+        }
         void main(){
-            vec4 wp = uModel * vec4(aPos,1.0);
-            vPos = wp.xyz; vNrm = mat3(uModel) * aNormal; vCol = aColor;
+            vec4 wp = iModel * vec4(aPos,1.0);
+            vPos = wp.xyz; vNrm = mat3(iModel) * octDecode(aOctNormal); vCol = aColor;
+            vBaseColor = iBaseMetal.rgb; vMetallic = iBaseMetal.a; vRoughness = iRough;
             gl_Position = uProj * uView * wp;
         }
     )GLSL";
     const char* fs = R"GLSL(
         #version 330 core
         in vec3 vPos; in vec3 vNrm; in vec3 vCol;
+        flat in vec3 vBaseColor; flat in float vMetallic; flat in float vRoughness;
         out vec4 FragColor;
         uniform vec3 uCamPos;
-        uniform vec3 uBaseColor;
-        uniform float uMetallic;
-        uniform float uRoughness;
         // single directional light
         const vec3 Ldir = normalize(vec3(-0.3, -1.0, -0.2));
         void main(){
@@ -87,20 +103,20 @@ void RenderingSystem::ensureProgram()
             float NdotH = max(dot(N,H),0.0);
             float VdotH = max(dot(V,H),0.0);
             // cheap GGX term
-            float a = max(0.04, uRoughness*uRoughness);
+            float a = max(0.04, vRoughness*vRoughness);
             float a2 = a*a;
             float denom = (NdotH*NdotH*(a2-1.0)+1.0);
             float D = a2/(3.14159*denom*denom + 1e-4);
-            float k = (uRoughness+1.0);
+            float k = (vRoughness+1.0);
             k = (k*k)/8.0;
             float Gv = NdotV/(NdotV*(1.0-k)+k);
             float Gl = NdotL/(NdotL*(1.0-k)+k);
             float G = Gv*Gl;
-            vec3 F0 = mix(vec3(0.04), uBaseColor, uMetallic);
+            vec3 F0 = mix(vec3(0.04), vBaseColor, vMetallic);
             vec3 F = F0 + (1.0-F0)*pow(1.0-VdotH,5.0);
             vec3 spec = (D*G*F) / max(4.0*NdotV*NdotL, 1e-4);
-            vec3 kd = (1.0 - F)*(1.0 - uMetallic);
-            vec3 diffuse = kd * uBaseColor / 3.14159;
+            vec3 kd = (1.0 - F)*(1.0 - vMetallic);
+            vec3 diffuse = kd * vBaseColor / 3.14159;
             vec3 color = (diffuse + spec) * NdotL;
             color = pow(color, vec3(1.0/2.2));
             FragColor = vec4(color, 1.0);
@@ -112,6 +128,9 @@ void RenderingSystem::ensureProgram()
     glAttachShader(m_program, v); glAttachShader(m_program, f);
     glLinkProgram(m_program);
     glDeleteShader(v); glDeleteShader(f);
+    m_locProj = glGetUniformLocation(m_program, "uProj");
+    m_locView = glGetUniformLocation(m_program, "uView");
+    m_locCam = glGetUniformLocation(m_program, "uCamPos");
 }
 
 static void perspective(float out[16], float fovyRad, float aspect, float znear, float zfar)
@@ -133,10 +152,6 @@ static void mul(float r[16], const float a[16], const float b[16])
 }
 
 static void translate(float m[16], float x,float y,float z){ identity(m); m[12]=x; m[13]=y; m[14]=z; }
-static void rotateY(float m[16], float degrees){ identity(m); float r=degrees*3.1415926f/180.f; m[0]=cos(r); m[2]=sin(r); m[8]=-sin(r); m[10]=cos(r);} 
-static void rotateX(float m[16], float degrees){ identity(m); float r=degrees*3.1415926f/180.f; m[5]=cos(r); m[6]=-sin(r); m[9]=sin(r); m[10]=cos(r);} 
-static void rotateZ(float m[16], float degrees){ identity(m); float r=degrees*3.1415926f/180.f; m[0]=cos(r); m[1]=-sin(r); m[4]=sin(r); m[5]=cos(r);} 
-static void scaleM(float m[16], float x,float y,float z){ identity(m); m[0]=x; m[5]=y; m[10]=z; }
 
 void RenderingSystem::GetView(float out[16]) const
 {
@@ -163,6 +178,21 @@ void RenderingSystem::GetProj(float out[16], int w, int h) const
     perspective(out, 45.0f*3.1415926f/180.f, (float)w/(float)h, 0.1f, 100.0f);
 }
 
+bool RenderingSystem::Pick(float ndcX, float ndcY, SceneRayHit& hit) const
+{
+    // Camera basis rather than an inverted view-projection: same as GetView/GetProj.
+    float cy = cosf(m_camYaw*3.1415926f/180.f), sy = sinf(m_camYaw*3.1415926f/180.f);
+    float cp = cosf(m_camPitch*3.1415926f/180.f), sp = sinf(m_camPitch*3.1415926f/180.f);
+    float F[3] = { cy*cp, sp, sy*cp };
+    float S[3] = { -F[2], 0.0f, F[0] };  // F x up
+    float sLen = sqrtf(S[0]*S[0]+S[2]*S[2]); S[0]/=sLen; S[2]/=sLen;
+    float U[3] = { S[1]*F[2]-S[2]*F[1], S[2]*F[0]-S[0]*F[2], S[0]*F[1]-S[1]*F[0] };
+    float ty = tanf(0.5f*45.0f*3.1415926f/180.f), tx = ty*m_aspect;
+    float dir[3];
+    for (int a = 0; a < 3; ++a) dir[a] = F[a] + S[a]*ndcX*tx + U[a]*ndcY*ty;
+    return gSceneRaycaster.Raycast(m_camPos, dir, 100.0f, hit);
+}
+
 // Helper forward for static function used below
 static void projectPoint(const float* M, const float* V, const float* P, const float p[3], int w,int h, float out2[2]);
 
@@ -214,54 +244,27 @@ void RenderingSystem::Render()
     float T[16]; translate(T, -eye[0], -eye[1], -eye[2]); float View[16]; mul(View, V, T);
 
     int w=1280,h=720; if(m_window){ glfwGetFramebufferSize(m_window,&w,&h);} float Proj[16]; perspective(Proj, 45.0f*3.1415926f/180.f, (float)w/(float)h, 0.1f, 100.0f);
+    m_aspect = (float)w/(float)h;
     if (m_deferred) m_deferred->Resize(w,h);
 
-    extern bool gUseDeferred; extern bool gEnableSSAO; extern bool gEnableShadows; extern bool gEnableSSR;
+    extern bool gUseDeferred; extern bool gEnableSSAO; extern bool gEnableShadows; extern bool gEnableSSR; extern bool gEnableOcclusionCulling;
+    extern bool gEnableLod;
+    const Frustum frustum = ExtractFrustum(Proj, View);
+    const float lodPixelScale = gEnableLod ? Proj[5] * 0.5f * (float)h : 0.0f;
+    m_queue.Build(*m_drawQuery, &frustum, gEnableOcclusionCulling ? &m_occlusion : nullptr, 0, lodPixelScale);
+    gSceneRaycaster.Update(*m_drawQuery);
     if (gUseDeferred && m_deferred)
     {
-        m_deferred->GeometryPass(Proj, View);
+        m_deferred->GeometryPass(Proj, View, m_queue);
         m_deferred->LightingPass(Proj, View, m_camPos);
     }
     else
     {
         if (!m_program) ensureProgram();
         glUseProgram(m_program);
-        int locProj = glGetUniformLocation(m_program, "uProj");
-        int locView = glGetUniformLocation(m_program, "uView");
-        int locModel= glGetUniformLocation(m_program, "uModel");
-        int locBC  = glGetUniformLocation(m_program, "uBaseColor");
-        int locMet = glGetUniformLocation(m_program, "uMetallic");
-        int locRgh = glGetUniformLocation(m_program, "uRoughness");
-        int locCam = glGetUniformLocation(m_program, "uCamPos");
-        glUniformMatrix4fv(locProj,1,GL_FALSE,Proj); glUniformMatrix4fv(locView,1,GL_FALSE,View);
-    glUniform3f(locCam, m_camPos[0], m_camPos[1], m_camPos[2]);
-
-        auto entities = gCoordinator.GetEntitiesWithComponents<RenderableComponent, TransformComponent>();
-        for (auto e : entities)
-        {
-            auto& tr = gCoordinator.GetComponent<TransformComponent>(e);
-            float Tm[16], Rx[16], Ry[16], Rz[16], S[16], Rxy[16], Rxyz[16], M[16], TR[16];
-            translate(Tm, tr.position[0], tr.position[1], tr.position[2]);
-            rotateX(Rx, tr.rotation[0]); rotateY(Ry, tr.rotation[1]); rotateZ(Rz, tr.rotation[2]);
-            mul(Rxy, Ry, Rx); mul(Rxyz, Rxy, Rz); scaleM(S, tr.scale[0], tr.scale[1], tr.scale[2]); mul(TR, Tm, Rxyz); mul(M, TR, S);
-            glUniformMatrix4fv(locModel,1,GL_FALSE,M);
-
-            auto& rend = gCoordinator.GetComponent<RenderableComponent>(e);
-            float baseColor[3] = {0.8f,0.8f,0.8f}; float metallic=0.0f; float rough=0.8f;
-            if (gCoordinator.HasComponent<MaterialComponent>(e))
-            {
-                auto& mat = gCoordinator.GetComponent<MaterialComponent>(e);
-                baseColor[0]=mat.baseColor[0]; baseColor[1]=mat.baseColor[1]; baseColor[2]=mat.baseColor[2]; metallic=mat.metallic; rough=mat.roughness;
-            }
-            glUniform3f(locBC, baseColor[0], baseColor[1], baseColor[2]);
-            glUniform1f(locMet, metallic); glUniform1f(locRgh, rough);
-
-            if (const MeshGPU* gpu = RenderResources::GetMesh(rend.meshId))
-            {
-                glBindVertexArray(gpu->vao);
-                glDrawArrays(GL_TRIANGLES, 0, gpu->vertexCount);
-            }
-        }
+        glUniformMatrix4fv(m_locProj,1,GL_FALSE,Proj); glUniformMatrix4fv(m_locView,1,GL_FALSE,View);
+        glUniform3f(m_locCam, m_camPos[0], m_camPos[1], m_camPos[2]);
+        m_queue.Submit();
     glBindVertexArray(0);
     drawGridAndAxes();
 }
@@ -286,6 +289,8 @@ void RenderingSystem::ensureLineProgram()
     m_lineProg = glCreateProgram(); glAttachShader(m_lineProg, v); glAttachShader(m_lineProg, f); glLinkProgram(m_lineProg);
     glDeleteShader(v); glDeleteShader(f);
     glGenVertexArrays(1,&m_gridVao); glGenBuffers(1,&m_gridVbo);
+    m_lineLocProj = glGetUniformLocation(m_lineProg,"uProj"); m_lineLocView = glGetUniformLocation(m_lineProg,"uView");
+    m_lineLocModel = glGetUniformLocation(m_lineProg,"uModel"); m_lineLocColor = glGetUniformLocation(m_lineProg,"uColor");
 }
 
 void RenderingSystem::drawGridAndAxes()
@@ -293,34 +298,35 @@ void RenderingSystem::drawGridAndAxes()
     ensureLineProgram();
     int w=1280,h=720; if(m_window){ glfwGetFramebufferSize(m_window,&w,&h);} float Proj[16]; GetProj(Proj,w,h); float View[16]; GetView(View);
     glUseProgram(m_lineProg);
-    glUniformMatrix4fv(glGetUniformLocation(m_lineProg,"uProj"),1,GL_FALSE,Proj);
-    glUniformMatrix4fv(glGetUniformLocation(m_lineProg,"uView"),1,GL_FALSE,View);
-    float M[16]; identity(M); glUniformMatrix4fv(glGetUniformLocation(m_lineProg,"uModel"),1,GL_FALSE,M);
+    glUniformMatrix4fv(m_lineLocProj,1,GL_FALSE,Proj);
+    glUniformMatrix4fv(m_lineLocView,1,GL_FALSE,View);
+    float M[16]; identity(M); glUniformMatrix4fv(m_lineLocModel,1,GL_FALSE,M);
     glBindVertexArray(m_gridVao); glBindBuffer(GL_ARRAY_BUFFER,m_gridVbo);
 
-    // Build grid vertices
-    std::vector<float> verts; verts.reserve((41*4+6)*3);
+    // Build grid vertices in the frame arena; they only live until the upload
+    const int lines=101; const size_t floatCount=lines*4*3;
+    float* verts = MemoryManager::FrameArena().AllocateArray<float>(floatCount); size_t n=0;
     float range=50.0f;
     for (int i=-50;i<=50;++i){
-        verts.push_back((float)i); verts.push_back(0.0f); verts.push_back(-range);
-        verts.push_back((float)i); verts.push_back(0.0f); verts.push_back( range);
-        verts.push_back(-range); verts.push_back(0.0f); verts.push_back((float)i);
-        verts.push_back( range); verts.push_back(0.0f); verts.push_back((float)i);
+        verts[n++]=(float)i; verts[n++]=0.0f; verts[n++]=-range;
+        verts[n++]=(float)i; verts[n++]=0.0f; verts[n++]= range;
+        verts[n++]=-range; verts[n++]=0.0f; verts[n++]=(float)i;
+        verts[n++]= range; verts[n++]=0.0f; verts[n++]=(float)i;
     }
     // Upload and draw grid
-    glBufferData(GL_ARRAY_BUFFER, verts.size()*sizeof(float), verts.data(), GL_DYNAMIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, n*sizeof(float), verts, GL_DYNAMIC_DRAW);
     glEnableVertexAttribArray(0); glVertexAttribPointer(0,3,GL_FLOAT,GL_FALSE,3*sizeof(float),(void*)0);
-    glUniform3f(glGetUniformLocation(m_lineProg,"uColor"), 0.25f,0.25f,0.25f);
-    glDrawArrays(GL_LINES,0,(GLsizei)(verts.size()/3));
+    glUniform3f(m_lineLocColor, 0.25f,0.25f,0.25f);
+    glDrawArrays(GL_LINES,0,(GLsizei)(n/3));
 
     // Axes
     float axes[] = { 0,0,0, 1.5f,0,0,  0,0,0, 0,1.5f,0,  0,0,0, 0,0,1.5f };
     glBufferData(GL_ARRAY_BUFFER, sizeof(axes), axes, GL_DYNAMIC_DRAW);
     glVertexAttribPointer(0,3,GL_FLOAT,GL_FALSE,3*sizeof(float),(void*)0);
     glEnableVertexAttribArray(0);
-    glUniform3f(glGetUniformLocation(m_lineProg,"uColor"), 1,0,0); glDrawArrays(GL_LINES,0,2);
-    glUniform3f(glGetUniformLocation(m_lineProg,"uColor"), 0,1,0); glDrawArrays(GL_LINES,2,2);
-    glUniform3f(glGetUniformLocation(m_lineProg,"uColor"), 0,0,1); glDrawArrays(GL_LINES,4,2);
+    glUniform3f(m_lineLocColor, 1,0,0); glDrawArrays(GL_LINES,0,2);
+    glUniform3f(m_lineLocColor, 0,1,0); glDrawArrays(GL_LINES,2,2);
+    glUniform3f(m_lineLocColor, 0,0,1); glDrawArrays(GL_LINES,4,2);
     glBindVertexArray(0);
 }
 
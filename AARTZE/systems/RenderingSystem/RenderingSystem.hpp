@@ -1,6 +1,12 @@
 #pragma once
 #include <cstdint>
+#include "core/Query.hpp"
+#include "RenderQueue.hpp"
+#include "OcclusionCulling.hpp"
 struct GLFWwindow;
+struct RenderableComponent;
+struct TransformComponent;
+struct SceneRayHit;
 
 class RenderingSystem
 {
@@ -11,13 +17,21 @@ public:
     void GetView(float out[16]) const;  // column-major
     void GetProj(float out[16], int w, int h) const;
     const float* GetCameraPos() const { return m_camPos; }
+    const RenderQueueStats& GetRenderStats() const { return m_queue.GetStats(); }
+    // Closest renderable under a viewport point in NDC ([-1, 1], y up), as of the last frame.
+    bool Pick(float ndcX, float ndcY, SceneRayHit& hit) const;
 
 private:
     GLFWwindow* m_window{nullptr};
     unsigned m_program{0};
+    int m_locProj{-1}, m_locView{-1}, m_locCam{-1};
+    RenderQueue m_queue;
+    OcclusionBuffer m_occlusion;
+    Query<RenderableComponent, TransformComponent>* m_drawQuery{nullptr};
     float m_camPos[3] {0.0f, 1.5f, 3.0f};
     float m_camYaw{ -90.0f };
     float m_camPitch{ -10.0f };
+    float m_aspect{ 16.0f/9.0f };
     bool  m_mouseLook{ false };
     float m_camSpeed{ 2.0f };
     bool  m_useDeferred{ true };
@@ -33,6 +47,7 @@ public:
     void SetCameraSpeed(float s) { m_camSpeed = s; }
 private:
     unsigned m_lineProg{0};
+    int m_lineLocProj{-1}, m_lineLocView{-1}, m_lineLocModel{-1}, m_lineLocColor{-1};
     unsigned m_gridVao{0}, m_gridVbo{0};
     void ensureLineProgram();
     void drawGridAndAxes();
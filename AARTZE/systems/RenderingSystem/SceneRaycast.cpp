@@ -0,0 +1,231 @@
+#include "SceneRaycast.hpp"
+#include <algorithm>
+#include <cmath>
+#include "RenderQueue.hpp"
+#include "RenderResources.hpp"
+#include "components/InteractableComponent.hpp"
+#include "components/RenderableComponent.hpp"
+#include "components/TransformComponent.hpp"
+
+using aartze::geometry::Ray;
+using aartze::geometry::RayHit;
+
+SceneRaycaster gSceneRaycaster;
+
+namespace
+{
+// Rays stop this far short of their end points so the surfaces they start or
+// end on don't count as blockers.
+constexpr float LINE_OF_SIGHT_EPSILON = 1e-3f;
+
+// 3x4 inverse of an affine column-major model matrix.
+bool InvertAffine(const float m[16], float out[12])
+{
+    const float a = m[0], b = m[4], c = m[8];
+    const float d = m[1], e = m[5], f = m[9];
+    const float g = m[2], h = m[6], i = m[10];
+    const float A = e * i - f * h, B = f * g - d * i, C = d * h - e * g;
+    const float det = a * A + b * B + c * C;
+    if (det == 0.0f) return false;
+    const float inv = 1.0f / det;
+    const float r[9] = {A * inv, (c * h - b * i) * inv, (b * f - c * e) * inv,
+                        B * inv, (a * i - c * g) * inv, (c * d - a * f) * inv,
+                        C * inv, (b * g - a * h) * inv, (a * e - b * d) * inv};
+    // r is row-major; store column-major followed by -R * t.
+    for (int col = 0; col < 3; ++col)
+        for (int row = 0; row < 3; ++row) out[col * 3 + row] = r[row * 3 + col];
+    for (int row = 0; row < 3; ++row)
+        out[9 + row] = -(r[row * 3] * m[12] + r[row * 3 + 1] * m[13] + r[row * 3 + 2] * m[14]);
+    return true;
+}
+
+// World-space box of an object-space box under an affine matrix (Arvo).
+void TransformBounds(const float m[16], const float mn[3], const float mx[3], float out[6])
+{
+    for (int row = 0; row < 3; ++row)
+    {
+        float lo = m[12 + row], hi = m[12 + row];
+        for (int col = 0; col < 3; ++col)
+        {
+            const float p = m[col * 4 + row] * mn[col], q = m[col * 4 + row] * mx[col];
+            lo += std::min(p, q);
+            hi += std::max(p, q);
+        }
+        out[row] = lo;
+        out[3 + row] = hi;
+    }
+}
+
+bool Invert4x4(const float m[16], float out[16])
+{
+    float inv[16];
+    inv[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] + m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+    inv[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+    inv[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] + m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+    inv[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+    inv[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+    inv[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] + m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+    inv[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+    inv[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] + m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+    inv[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15] + m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+    inv[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15] - m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+    inv[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15] + m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+    inv[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14] - m[4] * m[2] * m[13] - m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+    inv[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11] - m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+    inv[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11] + m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+    inv[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11] - m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+    inv[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10] + m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+    const float det = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+    if (det == 0.0f) return false;
+    for (int i = 0; i < 16; ++i) out[i] = inv[i] / det;
+    return true;
+}
+}
+
+void SceneRaycaster::Update(Query<RenderableComponent, TransformComponent>& query)
+{
+    m_instances.clear();
+    m_bounds.clear();
+    std::vector<uint64_t> layout;
+    layout.reserve(m_layout.size());
+    query.ForEach([&](Entity e, RenderableComponent& rend, TransformComponent& tr) {
+        if (!rend.isVisible) return;
+        const MeshGPU* mesh = RenderResources::GetMesh(rend.meshId);
+        const aartze::geometry::BVH* bvh = RenderResources::GetMeshBVH(rend.meshId);
+        if (!mesh || !bvh) return;
+        float model[16];
+        ComposeModelMatrix(tr, model);
+        Instance inst{e, rend.meshId, bvh, {}};
+        if (!InvertAffine(model, inst.worldToObject)) return;  // zero scale: nothing to hit
+        float box[6];
+        TransformBounds(model, mesh->boundsMin, mesh->boundsMax, box);
+        m_bounds.insert(m_bounds.end(), box, box + 6);
+        m_instances.push_back(inst);
+        layout.push_back((uint64_t(e) << 32) | rend.meshId);
+    });
+
+    if (layout == m_layout && !m_tree.Empty())
+        m_tree.RefitBounds(m_bounds.data());
+    else
+    {
+        m_tree.BuildFromBounds(m_bounds.data(), m_instances.size());
+        m_layout.swap(layout);
+    }
+}
+
+void SceneRaycaster::Clear()
+{
+    m_instances.clear();
+    m_bounds.clear();
+    m_layout.clear();
+    m_tree = aartze::geometry::BVH();
+}
+
+void SceneRaycaster::ToObject(const Instance& inst, const Ray& world, Ray& local) const
+{
+    // An affine map keeps the ray parameter t, so distances need no rescaling.
+    const float* m = inst.worldToObject;
+    for (int row = 0; row < 3; ++row)
+    {
+        local.origin[row] = m[row] * world.origin[0] + m[3 + row] * world.origin[1] + m[6 + row] * world.origin[2] + m[9 + row];
+        local.direction[row] = m[row] * world.direction[0] + m[3 + row] * world.direction[1] + m[6 + row] * world.direction[2];
+    }
+    local.tMin = world.tMin;
+    local.tMax = world.tMax;
+}
+
+bool SceneRaycaster::Raycast(const float origin[3], const float direction[3], float maxDistance, SceneRayHit& hit,
+                             Entity ignore) const
+{
+    hit = SceneRayHit{};
+    const float len = std::sqrt(direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2]);
+    if (len == 0.0f) return false;
+    Ray ray;
+    for (int a = 0; a < 3; ++a) { ray.origin[a] = origin[a]; ray.direction[a] = direction[a] / len; }
+    ray.tMax = maxDistance;
+
+    m_tree.Traverse(ray, [&](uint32_t i, float& tMax) {
+        const Instance& inst = m_instances[i];
+        if (inst.entity == ignore) return false;
+        Ray local;
+        ToObject(inst, ray, local);
+        local.tMax = tMax;
+        RayHit meshHit;
+        if (inst.bvh->Intersect(local, meshHit))
+        {
+            tMax = meshHit.t;
+            hit.entity = inst.entity;
+            hit.meshId = inst.meshId;
+            hit.triangle = meshHit.primitive;
+            hit.distance = meshHit.t;
+        }
+        return false;
+    });
+    if (hit.entity == INVALID_ENTITY) return false;
+    for (int a = 0; a < 3; ++a) hit.position[a] = ray.origin[a] + ray.direction[a] * hit.distance;
+    return true;
+}
+
+bool SceneRaycaster::LineOfSight(const float from[3], const float to[3], Entity ignoreA, Entity ignoreB) const
+{
+    Ray ray;
+    for (int a = 0; a < 3; ++a) { ray.origin[a] = from[a]; ray.direction[a] = to[a] - from[a]; }
+    const float len = std::sqrt(ray.direction[0] * ray.direction[0] + ray.direction[1] * ray.direction[1] +
+                                ray.direction[2] * ray.direction[2]);
+    if (len <= 2.0f * LINE_OF_SIGHT_EPSILON) return true;
+    // t runs 0..1 along the segment; trim a fixed distance off both ends.
+    ray.tMin = LINE_OF_SIGHT_EPSILON / len;
+    ray.tMax = 1.0f - LINE_OF_SIGHT_EPSILON / len;
+
+    bool blocked = false;
+    m_tree.Traverse(ray, [&](uint32_t i, float&) {
+        const Instance& inst = m_instances[i];
+        if (inst.entity == ignoreA || inst.entity == ignoreB) return false;
+        Ray local;
+        ToObject(inst, ray, local);
+        blocked = inst.bvh->Occluded(local);
+        return blocked;
+    });
+    return !blocked;
+}
+
+bool SceneRaycaster::CanInteract(Entity user, const float eye[3], Entity target, const TransformComponent& targetTransform,
+                                 const InteractableComponent& interactable) const
+{
+    if (!interactable.canInteract) return false;
+    const float* p = targetTransform.position.data();
+    const float dx = p[0] - eye[0], dy = p[1] - eye[1], dz = p[2] - eye[2];
+    if (dx * dx + dy * dy + dz * dz > interactable.interactionRadius * interactable.interactionRadius) return false;
+    return !interactable.requiresLineOfSight || LineOfSight(eye, p, user, target);
+}
+
+bool SceneRaycaster::CanSee(Entity observer, const float eye[3], Entity target, const float point[3], float maxDistance) const
+{
+    const float dx = point[0] - eye[0], dy = point[1] - eye[1], dz = point[2] - eye[2];
+    if (dx * dx + dy * dy + dz * dz > maxDistance * maxDistance) return false;
+    return LineOfSight(eye, point, observer, target);
+}
+
+bool ScreenPointToRay(const float proj[16], const float view[16], float ndcX, float ndcY, float origin[3],
+                      float direction[3])
+{
+    float viewProj[16], inv[16];
+    for (int c = 0; c < 4; ++c)
+        for (int r = 0; r < 4; ++r)
+            viewProj[c * 4 + r] = proj[r] * view[c * 4] + proj[4 + r] * view[c * 4 + 1] + proj[8 + r] * view[c * 4 + 2] +
+                                  proj[12 + r] * view[c * 4 + 3];
+    if (!Invert4x4(viewProj, inv)) return false;
+    auto unproject = [&](float z, float out[3]) {
+        float w = inv[3] * ndcX + inv[7] * ndcY + inv[11] * z + inv[15];
+        for (int r = 0; r < 3; ++r) out[r] = (inv[r] * ndcX + inv[4 + r] * ndcY + inv[8 + r] * z + inv[12 + r]) / w;
+    };
+    float farPoint[3];
+    unproject(-1.0f, origin);
+    unproject(1.0f, farPoint);
+    float len = 0.0f;
+    for (int a = 0; a < 3; ++a) { direction[a] = farPoint[a] - origin[a]; len += direction[a] * direction[a]; }
+    len = std::sqrt(len);
+    if (len == 0.0f) return false;
+    for (int a = 0; a < 3; ++a) direction[a] /= len;
+    return true;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "core/Entity.hpp"
+#include "core/Query.hpp"
+#include "aartze/geometry/BVH.h"
+
+struct InteractableComponent;
+struct RenderableComponent;
+struct TransformComponent;
+
+struct SceneRayHit
+{
+    Entity entity{INVALID_ENTITY};
+    uint32_t meshId{0};
+    uint32_t triangle{0};   // index into the mesh's uploaded index list / 3
+    float distance{0.0f};   // along the normalized ray direction
+    float position[3]{0.0f, 0.0f, 0.0f};
+};
+
+/**
+ * @brief Triangle-accurate ray queries against every visible renderable.
+ *
+ * A two-level hierarchy: a box BVH over the world-space bounds of all
+ * instances, whose leaves transform the ray into object space and trace the
+ * mesh's own BVH (RenderResources::GetMeshBVH). Update() refits the instance
+ * tree while the set of instances is unchanged and rebuilds it otherwise.
+ *
+ * RenderingSystem updates gSceneRaycaster once per frame after the systems
+ * ran, so gameplay queries see the previous frame's placement. Queries are
+ * const and may run from jobs in parallel; Update() must not overlap them.
+ */
+class SceneRaycaster
+{
+public:
+    void Update(Query<RenderableComponent, TransformComponent>& query);
+    void Clear();
+
+    // Closest hit within maxDistance, skipping `ignore` (usually the caster).
+    bool Raycast(const float origin[3], const float direction[3], float maxDistance, SceneRayHit& hit,
+                 Entity ignore = INVALID_ENTITY) const;
+    // True when no geometry except the two given entities lies between the points.
+    bool LineOfSight(const float from[3], const float to[3], Entity ignoreA = INVALID_ENTITY,
+                     Entity ignoreB = INVALID_ENTITY) const;
+
+    // Interaction gate for InteractableComponent: enabled, within
+    // interactionRadius of `eye`, and visible from it when requiresLineOfSight.
+    bool CanInteract(Entity user, const float eye[3], Entity target, const TransformComponent& targetTransform,
+                     const InteractableComponent& interactable) const;
+    // AI perception: `point` on `target` is within maxDistance and unobstructed.
+    bool CanSee(Entity observer, const float eye[3], Entity target, const float point[3], float maxDistance) const;
+
+    size_t InstanceCount() const { return m_instances.size(); }
+
+private:
+    struct Instance
+    {
+        Entity entity;
+        uint32_t meshId;
+        const aartze::geometry::BVH* bvh;
+        float worldToObject[12];  // 3x4 affine, column-major
+    };
+
+    std::vector<Instance> m_instances;
+    std::vector<float> m_bounds;      // world-space box per instance, min xyz max xyz
+    std::vector<uint64_t> m_layout;   // (entity, mesh) per instance at the last rebuild
+    aartze::geometry::BVH m_tree;
+
+    void ToObject(const Instance& inst, const aartze::geometry::Ray& world, aartze::geometry::Ray& local) const;
+};
+
+extern SceneRaycaster gSceneRaycaster;
+
+// World-space ray through a viewport position in NDC ([-1, 1], y up) for a
+// column-major projection and view. Returns false if the matrices are singular.
+bool ScreenPointToRay(const float proj[16], const float view[16], float ndcX, float ndcY, float origin[3],
+                      float direction[3]);
@@ -0,0 +1,119 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// GPU vertex of every uploaded mesh, 16 bytes instead of 11 floats:
+//   attribute 0  position  half3             offset 0
+//   attribute 1  normal    snorm8x2 (octa)   offset 6
+//   attribute 2  color     unorm8x3 (+pad)   offset 8
+//   attribute 3  uv        half2             offset 12
+// Half positions keep ~3 significant digits, plenty for the [-1, 1]
+// normalized meshes the loaders produce by default; meshes imported
+// unnormalized at world scale lose precision accordingly.
+struct PackedVertex
+{
+    uint16_t position[3];
+    int8_t normal[2];
+    uint8_t color[4];
+    uint16_t uv[2];
+};
+static_assert(sizeof(PackedVertex) == 16, "PackedVertex must stay 16 bytes");
+
+// IEEE 754 binary16, round to nearest even; overflow saturates to infinity.
+inline uint16_t FloatToHalf(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const uint32_t sign = (bits >> 16) & 0x8000u;
+    const uint32_t absBits = bits & 0x7FFFFFFFu;
+    if (absBits >= 0x7F800000u) return uint16_t(sign | 0x7C00u | (absBits > 0x7F800000u ? 0x200u : 0u));
+    if (absBits >= 0x477FF000u) return uint16_t(sign | 0x7C00u);  // rounds past 65504
+    if (absBits < 0x38800000u)
+    {
+        // Subnormal half (or zero): shift the implicit-one mantissa into place.
+        if (absBits < 0x33000000u) return uint16_t(sign);
+        const uint32_t exponent = absBits >> 23;
+        const uint32_t mantissa = (absBits & 0x7FFFFFu) | 0x800000u;
+        const uint32_t shift = 126 - exponent;
+        uint32_t half = mantissa >> shift;
+        const uint32_t rest = mantissa & ((1u << shift) - 1);
+        const uint32_t halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1u))) ++half;
+        return uint16_t(sign | half);
+    }
+    uint32_t half = ((absBits - 0x38000000u) >> 13);
+    const uint32_t rest = absBits & 0x1FFFu;
+    if (rest > 0x1000u || (rest == 0x1000u && (half & 1u))) ++half;
+    return uint16_t(sign | half);
+}
+
+inline float HalfToFloat(uint16_t half)
+{
+    const uint32_t sign = uint32_t(half & 0x8000u) << 16;
+    uint32_t exponent = (half >> 10) & 0x1Fu;
+    uint32_t mantissa = half & 0x3FFu;
+    uint32_t bits;
+    if (exponent == 0x1Fu)
+        bits = sign | 0x7F800000u | (mantissa << 13);
+    else if (exponent != 0)
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    else if (mantissa == 0)
+        bits = sign;
+    else
+    {
+        exponent = 113;
+        while (!(mantissa & 0x400u)) { mantissa <<= 1; --exponent; }
+        bits = sign | (exponent << 23) | ((mantissa & 0x3FFu) << 13);
+    }
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Octahedral unit-vector encoding; the vertex shaders carry the matching decode.
+inline void OctEncode(const float n[3], int8_t out[2])
+{
+    const float l1 = std::fabs(n[0]) + std::fabs(n[1]) + std::fabs(n[2]);
+    float x = l1 > 0.0f ? n[0] / l1 : 0.0f;
+    float y = l1 > 0.0f ? n[1] / l1 : 0.0f;
+    if (n[2] < 0.0f)
+    {
+        const float fx = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        const float fy = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = fx; y = fy;
+    }
+    out[0] = int8_t(std::lround(std::fmax(-1.0f, std::fmin(1.0f, x)) * 127.0f));
+    out[1] = int8_t(std::lround(std::fmax(-1.0f, std::fmin(1.0f, y)) * 127.0f));
+}
+
+inline void OctDecode(const int8_t in[2], float out[3])
+{
+    float x = std::fmax(in[0] / 127.0f, -1.0f), y = std::fmax(in[1] / 127.0f, -1.0f);
+    float z = 1.0f - std::fabs(x) - std::fabs(y);
+    if (z < 0.0f)
+    {
+        const float fx = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        const float fy = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = fx; y = fy;
+    }
+    const float len = std::sqrt(x * x + y * y + z * z);
+    out[0] = x / len; out[1] = y / len; out[2] = z / len;
+}
+
+inline uint8_t FloatToUnorm8(float value)
+{
+    return uint8_t(std::lround(std::fmax(0.0f, std::fmin(1.0f, value)) * 255.0f));
+}
+
+inline PackedVertex PackVertex(const float position[3], const float normal[3], const float color[3], const float uv[2])
+{
+    PackedVertex v;
+    for (int i = 0; i < 3; ++i) v.position[i] = FloatToHalf(position[i]);
+    OctEncode(normal, v.normal);
+    for (int i = 0; i < 3; ++i) v.color[i] = FloatToUnorm8(color[i]);
+    v.color[3] = 255;
+    v.uv[0] = FloatToHalf(uv[0]);
+    v.uv[1] = FloatToHalf(uv[1]);
+    return v;
+}
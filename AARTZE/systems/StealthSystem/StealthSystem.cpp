@@ -3,17 +3,21 @@
 #include <algorithm>
 
 #include "Coordinator.hpp"
+#include "SystemScheduler.hpp"
 #include "SneakingComponent.hpp"
 
 void StealthSystem::Update(float deltaTime)
 {
-    auto entities = gCoordinator.GetEntitiesWithComponents<SneakingComponent>();
-    for (auto entity : entities)
-    {
-        auto& sneak = gCoordinator.GetComponent<SneakingComponent>(entity);
+    if (!m_query) m_query = &gCoordinator.GetQuery<SneakingComponent>();
+    m_query->ForEach([deltaTime](Entity, SneakingComponent& sneak) {
         if (sneak.isSneaking)
             sneak.noiseLevel = std::max(0.0f, sneak.noiseLevel - deltaTime);
         else
             sneak.noiseLevel = std::min(1.0f, sneak.noiseLevel + deltaTime);
-    }
+    });
+}
+
+void StealthSystem::DeclareAccess(SystemAccessBuilder& access) const
+{
+    access.Write<SneakingComponent>();
 }
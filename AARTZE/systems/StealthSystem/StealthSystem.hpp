@@ -1,12 +1,19 @@
 #pragma once
+#include "Query.hpp"
 #include "System.hpp"
 
+struct SneakingComponent;
+
 class StealthSystem : public System
 {
    public:
     void Update(float deltaTime) override;
+    void DeclareAccess(SystemAccessBuilder& access) const override;
     const char* GetName() const override
     {
         return "StealthSystem";
     }
+
+   private:
+    Query<SneakingComponent>* m_query = nullptr;
 };
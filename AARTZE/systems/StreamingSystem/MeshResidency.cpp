@@ -0,0 +1,166 @@
+#include "MeshResidency.hpp"
+#include <algorithm>
+#include <climits>
+
+void MeshResidency::AddRef(uint32_t meshId, const std::string& path, size_t estimatedGpuBytes, size_t estimatedCpuBytes)
+{
+    auto [it, created] = m_entries.try_emplace(meshId);
+    Entry& entry = it->second;
+    if (created)
+    {
+        entry.path = path;
+        entry.gpuBytes = estimatedGpuBytes;
+        entry.cpuBytes = estimatedCpuBytes;
+        entry.priority = INT_MIN;
+    }
+    if (entry.refCount++ == 0 && entry.state == MeshResidencyState::Resident) m_lru.erase(entry.lru);
+}
+
+void MeshResidency::Release(uint32_t meshId)
+{
+    auto it = m_entries.find(meshId);
+    if (it == m_entries.end() || it->second.refCount == 0) return;
+    Entry& entry = it->second;
+    if (--entry.refCount > 0) return;
+    switch (entry.state)
+    {
+    case MeshResidencyState::Resident:
+        entry.lru = m_lru.insert(m_lru.end(), meshId);
+        break;
+    case MeshResidencyState::Loading:
+        break;  // cancelled by the next Update unless referenced again first
+    default:
+        m_entries.erase(it);
+        break;
+    }
+}
+
+void MeshResidency::Prioritize(uint32_t meshId, int priority)
+{
+    auto it = m_entries.find(meshId);
+    if (it != m_entries.end() && it->second.refCount > 0) it->second.priority = std::max(it->second.priority, priority);
+}
+
+void MeshResidency::OnLoaded(uint32_t meshId, size_t gpuBytes, size_t cpuBytes)
+{
+    auto it = m_entries.find(meshId);
+    if (it == m_entries.end() || it->second.state != MeshResidencyState::Loading) return;
+    Entry& entry = it->second;
+    m_loadingGpu -= entry.gpuBytes;
+    m_loadingCpu -= entry.cpuBytes;
+    --m_loadingCount;
+    entry.state = MeshResidencyState::Resident;
+    entry.gpuBytes = gpuBytes;
+    entry.cpuBytes = cpuBytes;
+    m_residentGpu += gpuBytes;
+    m_residentCpu += cpuBytes;
+    ++m_residentCount;
+    if (entry.refCount == 0) entry.lru = m_lru.insert(m_lru.end(), meshId);
+}
+
+void MeshResidency::OnFailed(uint32_t meshId)
+{
+    auto it = m_entries.find(meshId);
+    if (it == m_entries.end() || it->second.state != MeshResidencyState::Loading) return;
+    Entry& entry = it->second;
+    m_loadingGpu -= entry.gpuBytes;
+    m_loadingCpu -= entry.cpuBytes;
+    --m_loadingCount;
+    entry.state = MeshResidencyState::Failed;
+    if (entry.refCount == 0) m_entries.erase(it);
+}
+
+bool MeshResidency::Fits(size_t gpuBytes, size_t cpuBytes) const
+{
+    return CommittedGpuBytes() + gpuBytes <= m_budget.gpuBytes && CommittedCpuBytes() + cpuBytes <= m_budget.cpuBytes;
+}
+
+void MeshResidency::Evict(uint32_t meshId, Entry& entry, ResidencyActions& out)
+{
+    m_lru.erase(entry.lru);
+    m_residentGpu -= entry.gpuBytes;
+    m_residentCpu -= entry.cpuBytes;
+    --m_residentCount;
+    ++m_evictions;
+    out.evict.push_back(meshId);
+    m_entries.erase(meshId);
+}
+
+void MeshResidency::Update(ResidencyActions& out)
+{
+    out.Clear();
+    m_wanted.clear();
+    for (auto it = m_entries.begin(); it != m_entries.end();)
+    {
+        Entry& entry = it->second;
+        if (entry.state == MeshResidencyState::Loading && entry.refCount == 0)
+        {
+            m_loadingGpu -= entry.gpuBytes;
+            m_loadingCpu -= entry.cpuBytes;
+            --m_loadingCount;
+            out.cancel.push_back(it->first);
+            it = m_entries.erase(it);
+            continue;
+        }
+        if (entry.state == MeshResidencyState::Absent)
+            m_wanted.push_back(it->first);
+        else if (entry.state == MeshResidencyState::Loading && entry.priority != INT_MIN &&
+                 entry.priority != entry.requestedPriority)
+        {
+            entry.requestedPriority = entry.priority;
+            out.load.push_back({it->first, &entry.path, entry.priority});
+        }
+        ++it;
+    }
+
+    // Measured sizes can exceed the estimates, and the budget can shrink.
+    while (!Fits(0, 0) && !m_lru.empty())
+    {
+        const uint32_t victim = m_lru.front();
+        Evict(victim, m_entries.at(victim), out);
+    }
+
+    // Most urgent first. A load that does not fit once the cache is spent
+    // blocks the ones behind it, so small meshes cannot starve a large one.
+    std::sort(m_wanted.begin(), m_wanted.end(), [this](uint32_t a, uint32_t b) {
+        const int pa = m_entries.at(a).priority, pb = m_entries.at(b).priority;
+        return pa != pb ? pa > pb : a < b;
+    });
+    m_deferred = 0;
+    for (size_t i = 0; i < m_wanted.size(); ++i)
+    {
+        const uint32_t meshId = m_wanted[i];
+        Entry& entry = m_entries.at(meshId);
+        while (!Fits(entry.gpuBytes, entry.cpuBytes) && !m_lru.empty())
+        {
+            const uint32_t victim = m_lru.front();
+            Evict(victim, m_entries.at(victim), out);
+        }
+        // With nothing committed a mesh larger than the budget still loads, alone.
+        if (!Fits(entry.gpuBytes, entry.cpuBytes) && (CommittedGpuBytes() > 0 || CommittedCpuBytes() > 0))
+        {
+            m_deferred = m_wanted.size() - i;
+            break;
+        }
+        entry.state = MeshResidencyState::Loading;
+        entry.requestedPriority = entry.priority;
+        m_loadingGpu += entry.gpuBytes;
+        m_loadingCpu += entry.cpuBytes;
+        ++m_loadingCount;
+        out.load.push_back({meshId, &entry.path, entry.priority});
+    }
+
+    for (auto& [id, entry] : m_entries) entry.priority = INT_MIN;
+}
+
+MeshResidencyState MeshResidency::State(uint32_t meshId) const
+{
+    auto it = m_entries.find(meshId);
+    return it == m_entries.end() ? MeshResidencyState::Absent : it->second.state;
+}
+
+uint32_t MeshResidency::RefCount(uint32_t meshId) const
+{
+    auto it = m_entries.find(meshId);
+    return it == m_entries.end() ? 0 : it->second.refCount;
+}
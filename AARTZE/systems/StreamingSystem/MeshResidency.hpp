@@ -0,0 +1,114 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct ResidencyBudget
+{
+    size_t gpuBytes = size_t(512) << 20;  // vertex and index buffers
+    size_t cpuBytes = size_t(256) << 20;  // what stays in RAM per mesh (the BVH)
+};
+
+enum class MeshResidencyState : uint8_t
+{
+    Absent,    // wanted but not requested yet, or waiting for budget
+    Loading,   // handed to the streaming pipeline
+    Resident,  // on the GPU; evictable once nothing references it
+    Failed,    // not retried until every reference is dropped
+};
+
+// What the owner of a MeshResidency should do this frame.
+struct ResidencyActions
+{
+    struct Load
+    {
+        uint32_t meshId;
+        const std::string* path;  // valid until the next call into MeshResidency
+        int priority;
+    };
+    std::vector<Load> load;        // start streaming, or update the priority of a load in flight
+    std::vector<uint32_t> cancel;  // loads nobody references any more
+    std::vector<uint32_t> evict;   // resident meshes to unload, least recently used first
+
+    void Clear()
+    {
+        load.clear();
+        cancel.clear();
+        evict.clear();
+    }
+};
+
+/**
+ * @brief Decides which streamed meshes are resident under a GPU and a CPU
+ * memory budget. Users (streaming cells) hold references per meshId; a mesh
+ * is loaded while referenced and, once the last reference is dropped, stays
+ * cached until the budget needs its bytes, least recently used first. A
+ * referenced mesh is never evicted: when the budget is full of them, new
+ * loads wait, highest priority first.
+ *
+ * Pure bookkeeping, no GL or IO: Update() returns the loads, cancels and
+ * evictions for the owner to carry out, and the owner reports finished loads
+ * back with their measured sizes. Main thread only.
+ */
+class MeshResidency
+{
+public:
+    void SetBudget(const ResidencyBudget& budget) { m_budget = budget; }
+    const ResidencyBudget& Budget() const { return m_budget; }
+
+    // `estimatedGpuBytes`/`estimatedCpuBytes` are charged against the budget
+    // while the mesh loads and replaced by the real sizes in OnLoaded.
+    void AddRef(uint32_t meshId, const std::string& path, size_t estimatedGpuBytes, size_t estimatedCpuBytes);
+    void Release(uint32_t meshId);
+    // Raise the priority a referenced mesh loads with this frame (higher
+    // first). Priorities are reset by every Update; a mesh nobody raised
+    // keeps the priority its load was requested with.
+    void Prioritize(uint32_t meshId, int priority);
+
+    void OnLoaded(uint32_t meshId, size_t gpuBytes, size_t cpuBytes);
+    void OnFailed(uint32_t meshId);
+
+    void Update(ResidencyActions& out);
+
+    MeshResidencyState State(uint32_t meshId) const;
+    uint32_t RefCount(uint32_t meshId) const;
+    size_t ResidentGpuBytes() const { return m_residentGpu; }
+    size_t ResidentCpuBytes() const { return m_residentCpu; }
+    // Resident plus the estimates of loads in flight.
+    size_t CommittedGpuBytes() const { return m_residentGpu + m_loadingGpu; }
+    size_t CommittedCpuBytes() const { return m_residentCpu + m_loadingCpu; }
+    size_t ResidentCount() const { return m_residentCount; }
+    size_t LoadingCount() const { return m_loadingCount; }
+    size_t CachedCount() const { return m_lru.size(); }
+    size_t DeferredCount() const { return m_deferred; }  // wanted loads the budget held back last Update
+    uint64_t EvictionCount() const { return m_evictions; }
+
+private:
+    struct Entry
+    {
+        std::string path;
+        uint32_t refCount{0};
+        int priority{0};
+        int requestedPriority{0};  // what the pipeline was last told
+        MeshResidencyState state{MeshResidencyState::Absent};
+        size_t gpuBytes{0};  // estimate until resident, then measured
+        size_t cpuBytes{0};
+        std::list<uint32_t>::iterator lru;  // valid while resident and unreferenced
+    };
+
+    bool Fits(size_t gpuBytes, size_t cpuBytes) const;
+    void Evict(uint32_t meshId, Entry& entry, ResidencyActions& out);
+
+    ResidencyBudget m_budget;
+    std::unordered_map<uint32_t, Entry> m_entries;
+    std::list<uint32_t> m_lru;  // resident, unreferenced; front is the least recently used
+    std::vector<uint32_t> m_wanted;
+    size_t m_residentGpu{0}, m_residentCpu{0};
+    size_t m_loadingGpu{0}, m_loadingCpu{0};
+    size_t m_residentCount{0}, m_loadingCount{0};
+    size_t m_deferred{0};
+    uint64_t m_evictions{0};
+};
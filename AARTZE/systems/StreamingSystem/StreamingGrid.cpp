@@ -0,0 +1,158 @@
+#include "StreamingGrid.hpp"
+#include <algorithm>
+#include <cmath>
+
+#include "MeshResidency.hpp"
+
+namespace
+{
+float PointRectDistanceSq(float px, float pz, float minX, float minZ, float maxX, float maxZ)
+{
+    const float dx = std::max({minX - px, 0.0f, px - maxX});
+    const float dz = std::max({minZ - pz, 0.0f, pz - maxZ});
+    return dx * dx + dz * dz;
+}
+
+float PointSegmentDistanceSq(float px, float pz, float ax, float az, float bx, float bz)
+{
+    const float ex = bx - ax, ez = bz - az;
+    const float lengthSq = ex * ex + ez * ez;
+    float t = lengthSq > 0.0f ? ((px - ax) * ex + (pz - az) * ez) / lengthSq : 0.0f;
+    t = std::clamp(t, 0.0f, 1.0f);
+    const float dx = ax + t * ex - px, dz = az + t * ez - pz;
+    return dx * dx + dz * dz;
+}
+
+// Slab test of the segment a->b against the rectangle.
+bool SegmentHitsRect(float ax, float az, float bx, float bz, float minX, float minZ, float maxX, float maxZ)
+{
+    float t0 = 0.0f, t1 = 1.0f;
+    const float origin[2] = {ax, az}, direction[2] = {bx - ax, bz - az};
+    const float lo[2] = {minX, minZ}, hi[2] = {maxX, maxZ};
+    for (int a = 0; a < 2; ++a)
+    {
+        if (direction[a] == 0.0f)
+        {
+            if (origin[a] < lo[a] || origin[a] > hi[a]) return false;
+            continue;
+        }
+        float tNear = (lo[a] - origin[a]) / direction[a], tFar = (hi[a] - origin[a]) / direction[a];
+        if (tNear > tFar) std::swap(tNear, tFar);
+        t0 = std::max(t0, tNear);
+        t1 = std::min(t1, tFar);
+        if (t0 > t1) return false;
+    }
+    return true;
+}
+}
+
+int StreamingGrid::CellCoord(float v) const
+{
+    return static_cast<int>(std::floor(v / m_settings.cellSize));
+}
+
+float StreamingGrid::Distance(const Cell& cell) const
+{
+    const float size = m_settings.cellSize;
+    const float minX = cell.x * size, minZ = cell.z * size, maxX = minX + size, maxZ = minZ + size;
+    const float ax = m_viewer[0], az = m_viewer[2], bx = m_ahead[0], bz = m_ahead[2];
+    if (SegmentHitsRect(ax, az, bx, bz, minX, minZ, maxX, maxZ)) return 0.0f;
+    float best = std::min(PointRectDistanceSq(ax, az, minX, minZ, maxX, maxZ),
+                          PointRectDistanceSq(bx, bz, minX, minZ, maxX, maxZ));
+    const float corners[4][2] = {{minX, minZ}, {maxX, minZ}, {minX, maxZ}, {maxX, maxZ}};
+    for (const auto& c : corners) best = std::min(best, PointSegmentDistanceSq(c[0], c[1], ax, az, bx, bz));
+    return std::sqrt(best);
+}
+
+void StreamingGrid::AddAsset(const float position[3], uint32_t meshId, const std::string& path,
+                             size_t estimatedGpuBytes, size_t estimatedCpuBytes)
+{
+    const int x = CellCoord(position[0]), z = CellCoord(position[2]);
+    Cell& cell = m_cells[Key(x, z)];
+    cell.x = x;
+    cell.z = z;
+    for (const Asset& asset : cell.assets)
+        if (asset.meshId == meshId) return;
+    // An active cell takes the reference on its next Update.
+    cell.assets.push_back({meshId, path, estimatedGpuBytes, estimatedCpuBytes});
+}
+
+void StreamingGrid::Clear(MeshResidency& residency)
+{
+    for (uint64_t key : m_active)
+    {
+        Cell& cell = m_cells.at(key);
+        for (size_t i = 0; i < cell.referenced; ++i) residency.Release(cell.assets[i].meshId);
+    }
+    m_active.clear();
+    m_cells.clear();
+}
+
+void StreamingGrid::Update(const float viewer[3], float dt, MeshResidency& residency)
+{
+    // Smoothed velocity, so a single uneven frame does not swing the look-ahead.
+    if (m_hasViewer && dt > 0.0f)
+    {
+        const float d[3] = {viewer[0] - m_viewer[0], viewer[1] - m_viewer[1], viewer[2] - m_viewer[2]};
+        const bool teleport = d[0] * d[0] + d[1] * d[1] + d[2] * d[2] >
+                              m_settings.teleportDistance * m_settings.teleportDistance;
+        const float blend = 1.0f - std::exp(-dt / 0.25f);
+        for (int a = 0; a < 3; ++a) m_velocity[a] = teleport ? 0.0f : m_velocity[a] + (d[a] / dt - m_velocity[a]) * blend;
+    }
+    m_hasViewer = true;
+    float ahead[3], length = 0.0f;
+    for (int a = 0; a < 3; ++a)
+    {
+        m_viewer[a] = viewer[a];
+        ahead[a] = m_velocity[a] * m_settings.prefetchSeconds;
+        length += ahead[a] * ahead[a];
+    }
+    length = std::sqrt(length);
+    const float scale = length > m_settings.maxPrefetchDistance ? m_settings.maxPrefetchDistance / length : 1.0f;
+    for (int a = 0; a < 3; ++a) m_ahead[a] = viewer[a] + ahead[a] * scale;
+
+    // Activate: only cells around the look-ahead segment can be in range.
+    const float reach = m_settings.loadRadius;
+    const int x0 = CellCoord(std::min(m_viewer[0], m_ahead[0]) - reach);
+    const int x1 = CellCoord(std::max(m_viewer[0], m_ahead[0]) + reach);
+    const int z0 = CellCoord(std::min(m_viewer[2], m_ahead[2]) - reach);
+    const int z1 = CellCoord(std::max(m_viewer[2], m_ahead[2]) + reach);
+    for (int x = x0; x <= x1; ++x)
+        for (int z = z0; z <= z1; ++z)
+        {
+            auto it = m_cells.find(Key(x, z));
+            if (it == m_cells.end() || it->second.active || Distance(it->second) > reach) continue;
+            it->second.active = true;
+            m_active.push_back(it->first);
+        }
+
+    // Release cells past the unload radius; reference and rank the rest.
+    for (size_t i = 0; i < m_active.size();)
+    {
+        Cell& cell = m_cells.at(m_active[i]);
+        const float distance = Distance(cell);
+        if (distance > m_settings.unloadRadius)
+        {
+            for (size_t a = 0; a < cell.referenced; ++a) residency.Release(cell.assets[a].meshId);
+            cell.referenced = 0;
+            cell.active = false;
+            m_active[i] = m_active.back();
+            m_active.pop_back();
+            continue;
+        }
+        for (; cell.referenced < cell.assets.size(); ++cell.referenced)
+        {
+            const Asset& asset = cell.assets[cell.referenced];
+            residency.AddRef(asset.meshId, asset.path, asset.gpuBytes, asset.cpuBytes);
+        }
+        const int priority = -static_cast<int>(distance / m_settings.cellSize);
+        for (const Asset& asset : cell.assets) residency.Prioritize(asset.meshId, priority);
+        ++i;
+    }
+}
+
+bool StreamingGrid::IsActive(const float position[3]) const
+{
+    auto it = m_cells.find(Key(CellCoord(position[0]), CellCoord(position[2])));
+    return it != m_cells.end() && it->second.active;
+}
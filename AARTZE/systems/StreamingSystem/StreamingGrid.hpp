@@ -0,0 +1,86 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class MeshResidency;
+
+struct StreamingGridSettings
+{
+    float cellSize = 64.0f;        // square cells on the ground (XZ) plane
+    float loadRadius = 192.0f;     // a cell this close is activated...
+    float unloadRadius = 256.0f;   // ...and released only once it is this far (hysteresis)
+    float prefetchSeconds = 2.0f;  // look-ahead along the viewer velocity
+    float maxPrefetchDistance = 160.0f;
+    float teleportDistance = 100.0f;  // a jump this long per update resets the velocity
+};
+
+/**
+ * @brief World cells declaring the meshes placed in them, activated by
+ * distance from the viewer. A cell comes in once the viewer's look-ahead
+ * segment (from the viewer to where its velocity takes it in
+ * prefetchSeconds) is within loadRadius, and goes out once it is beyond
+ * unloadRadius, so a viewer moving along a cell border does not thrash.
+ *
+ * An active cell holds one MeshResidency reference per distinct mesh and,
+ * every update, raises its meshes' priority by distance ring: cells nearest
+ * the look-ahead segment load first, so what lies ahead of a moving viewer
+ * goes before what lies behind it.
+ */
+class StreamingGrid
+{
+public:
+    explicit StreamingGrid(const StreamingGridSettings& settings = {}) : m_settings(settings) {}
+
+    // Call before adding assets; changing the cell size re-buckets nothing.
+    void SetSettings(const StreamingGridSettings& settings) { m_settings = settings; }
+    const StreamingGridSettings& Settings() const { return m_settings; }
+
+    // Declare an instance of `meshId` at world `position`. `estimatedGpuBytes`
+    // and `estimatedCpuBytes` are what MeshResidency charges while it loads.
+    void AddAsset(const float position[3], uint32_t meshId, const std::string& path, size_t estimatedGpuBytes,
+                  size_t estimatedCpuBytes);
+    // Drop every cell, releasing the references of the active ones.
+    void Clear(MeshResidency& residency);
+
+    // Move the viewer; `dt` is the time since the last update, used for the
+    // velocity estimate.
+    void Update(const float viewer[3], float dt, MeshResidency& residency);
+
+    size_t CellCount() const { return m_cells.size(); }
+    size_t ActiveCellCount() const { return m_active.size(); }
+    const float* Velocity() const { return m_velocity; }
+    // True if the cell holding `position` is active.
+    bool IsActive(const float position[3]) const;
+
+private:
+    struct Asset
+    {
+        uint32_t meshId;
+        std::string path;
+        size_t gpuBytes;
+        size_t cpuBytes;
+    };
+    struct Cell
+    {
+        int x{0}, z{0};
+        std::vector<Asset> assets;  // one per distinct mesh
+        size_t referenced{0};       // leading assets holding a MeshResidency reference
+        bool active{false};
+    };
+
+    static uint64_t Key(int x, int z) { return (uint64_t(uint32_t(x)) << 32) | uint32_t(z); }
+    int CellCoord(float v) const;
+    // Distance on the ground plane from the cell's square to the look-ahead segment.
+    float Distance(const Cell& cell) const;
+
+    StreamingGridSettings m_settings;
+    std::unordered_map<uint64_t, Cell> m_cells;
+    std::vector<uint64_t> m_active;
+    float m_viewer[3]{0.0f, 0.0f, 0.0f};
+    float m_ahead[3]{0.0f, 0.0f, 0.0f};  // end of the look-ahead segment
+    float m_velocity[3]{0.0f, 0.0f, 0.0f};
+    bool m_hasViewer{false};
+};
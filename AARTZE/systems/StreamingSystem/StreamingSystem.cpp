@@ -1,32 +1,317 @@
 #include "StreamingSystem.hpp"
+#include <algorithm>
 #include <chrono>
-#include "utils/AssetLoader.hpp"
-#include "systems/RenderingSystem/RenderResources.hpp"
+#include <filesystem>
+#include "core/JobSystem.hpp"
+#include "core/Profiler.hpp"
+#include "core/SystemScheduler.hpp"
 #include "utils/MeshUtils.hpp"
+#include "World/AssetRegistry.hpp"
 
-void StreamingSystem::RequestMesh(const std::string& path, uint32_t meshId)
+namespace
 {
-    if (pending.count(meshId)) return;
-    auto f = AssetLoader::LoadMeshAsync(path);
-    pending.emplace(meshId, PendingMesh{std::move(f), meshId, path});
+bool IsPendingLoad(StreamStage stage) { return stage == StreamStage::Reading || stage == StreamStage::Decoding; }
+
+// Report a streamed mesh's progress to the registry; a mesh uploaded earlier
+// stays Resident while a new copy streams in.
+void MarkMesh(uint32_t meshId, AssetState state)
+{
+    const MeshHandle mesh{meshId};
+    if (gAssetRegistry.State(mesh) != AssetState::Resident) gAssetRegistry.SetState(mesh, state);
+}
+}
+
+void StreamingSystem::RequestMesh(const std::string& path, uint32_t meshId, int priority)
+{
+    auto it = requests.find(meshId);
+    if (it != requests.end())
+    {
+        it->second->priority = priority;
+        return;
+    }
+    auto request = std::make_shared<MeshRequest>();
+    request->meshId = meshId;
+    request->path = path;
+    request->priority = priority;
+    request->sequence = nextSequence++;
+    std::error_code ec;
+    request->estimatedBytes = static_cast<size_t>(std::filesystem::file_size(path, ec));
+    if (ec) request->estimatedBytes = 0;
+    requests.emplace(meshId, std::move(request));
+    MarkMesh(meshId, AssetState::Queued);
+}
+
+void StreamingSystem::CancelMesh(uint32_t meshId)
+{
+    auto it = requests.find(meshId);
+    if (it == requests.end()) return;
+    RequestPtr request = it->second;
+    requests.erase(it);
+    MarkMesh(meshId, AssetState::Unloaded);
+    if (request->loadSlot)
+    {
+        // A job owns it until its stage ends; Update reaps it from `retired`.
+        request->cancelled.store(true, std::memory_order_relaxed);
+        retired.push_back(std::move(request));
+        return;
+    }
+    if (request->stage.load(std::memory_order_relaxed) == StreamStage::Uploading)
+        RenderResources::CancelMeshUpload(meshId);
+    uploads.erase(std::remove(uploads.begin(), uploads.end(), request), uploads.end());
+    Release(*request);
+}
+
+void StreamingSystem::AddWorldAsset(const float position[3], uint32_t meshId, const std::string& path)
+{
+    // The file is a fair upper bound for the GPU blobs; the BVH kept in RAM
+    // is of the same order. Both are replaced by measured sizes on upload.
+    std::error_code ec;
+    const std::string cooked = ResolveCookedMesh(path);
+    size_t bytes = static_cast<size_t>(std::filesystem::file_size(cooked.empty() ? path : cooked, ec));
+    if (ec) bytes = 0;
+    grid.AddAsset(position, meshId, path, bytes, bytes);
+}
+
+void StreamingSystem::ClearWorldAssets()
+{
+    grid.Clear(residency);
+}
+
+void StreamingSystem::SetViewer(const float position[3])
+{
+    std::copy(position, position + 3, viewer);
+    hasViewer = true;
+}
+
+void StreamingSystem::Release(MeshRequest& request)
+{
+    inFlightBytes -= std::min(inFlightBytes, request.reservedBytes);
+    request.reservedBytes = 0;
+    request.upload = MeshUpload{};
+    request.view = CookedMeshView{};
+    request.file.Close();
+    std::vector<unsigned char>().swap(request.blob);
+}
+
+void StreamingSystem::ReadStage(RequestPtr request)
+{
+    if (request->cancelled.load(std::memory_order_relaxed))
+    {
+        request->stage.store(StreamStage::Cancelled, std::memory_order_release);
+        return;
+    }
+    // Cooked meshes: map the file and fault it in, so the disk reads happen
+    // here instead of inside the main thread's upload copies. Source assets
+    // are read by Assimp itself as part of decoding.
+    const std::string cooked = ResolveCookedMesh(request->path);
+    if (!cooked.empty() && OpenCookedMesh(cooked, request->file, request->view)) request->file.Prefetch();
+    request->stage.store(StreamStage::Decoding, std::memory_order_release);
+    (void)gJobSystem.Enqueue([request]() { DecodeStage(request); });
+}
+
+void StreamingSystem::DecodeStage(RequestPtr request)
+{
+    if (request->cancelled.load(std::memory_order_relaxed))
+    {
+        request->stage.store(StreamStage::Cancelled, std::memory_order_release);
+        return;
+    }
+    const MeshHandle mesh{request->meshId};
+    if (request->view.header)
+    {
+        RenderResources::PrepareMeshUpload(request->view, request->upload);
+        request->decodedBytes = request->file.Size();
+        for (uint32_t i = 0; i < request->view.header->materialCount; ++i)
+            if (!request->view.Material(i).empty())
+                gAssetRegistry.AddDependency(mesh, std::string(request->view.Material(i)));
+    }
+    else
+    {
+        MeshData md;
+        auto ext = std::filesystem::path(request->path).extension().string();
+        for(char& c:ext) c=(char)tolower((unsigned char)c);
+        if (ext == ".gltf" || ext == ".glb") md = LoadGltfModel(request->path, true, 1.0f);
+        else md = LoadMeshAny(request->path, true, 1.0f);
+        if (!RenderResources::PrepareMeshUpload(md, request->blob, request->upload))
+        {
+            request->stage.store(StreamStage::Failed, std::memory_order_release);
+            return;
+        }
+        request->decodedBytes = request->blob.size();
+        // Textures decode on other workers while this mesh waits for upload.
+        for (const std::string& texture : md.texturePaths)
+            if (!texture.empty()) gAssetRegistry.AddDependency(mesh, texture);
+    }
+    request->decodedBytes += request->upload.bvh.MemoryBytes();
+    request->stage.store(request->cancelled.load(std::memory_order_relaxed) ? StreamStage::Cancelled : StreamStage::Ready,
+                         std::memory_order_release);
+}
+
+void StreamingSystem::Dispatch()
+{
+    while (loading < settings.maxConcurrentLoads)
+    {
+        MeshRequest* best = nullptr;
+        for (auto& [id, request] : requests)
+        {
+            if (request->loadSlot || request->stage.load(std::memory_order_relaxed) != StreamStage::Queued) continue;
+            if (!best || request->priority > best->priority ||
+                (request->priority == best->priority && request->sequence < best->sequence))
+                best = request.get();
+        }
+        if (!best) return;
+        // Over the cap only an empty pipeline may start a load, so a mesh
+        // larger than the cap still streams, alone.
+        if (inFlightBytes > 0 && inFlightBytes + best->estimatedBytes > settings.inFlightByteCap) return;
+        best->reservedBytes = best->estimatedBytes;
+        inFlightBytes += best->reservedBytes;
+        best->loadSlot = true;
+        ++loading;
+        best->stage.store(StreamStage::Reading, std::memory_order_relaxed);
+        MarkMesh(best->meshId, AssetState::Loading);
+        RequestPtr request = requests[best->meshId];
+        (void)gJobSystem.Enqueue([request]() { ReadStage(request); });
+    }
+}
+
+void StreamingSystem::Upload()
+{
+    // Finish what is already on the GPU first, then by priority.
+    std::stable_sort(uploads.begin(), uploads.end(), [](const RequestPtr& a, const RequestPtr& b) {
+        const bool aStarted = a->stage.load(std::memory_order_relaxed) == StreamStage::Uploading;
+        const bool bStarted = b->stage.load(std::memory_order_relaxed) == StreamStage::Uploading;
+        if (aStarted != bStarted) return aStarted;
+        if (a->priority != b->priority) return a->priority > b->priority;
+        return a->sequence < b->sequence;
+    });
+
+    // One staging slice at a time so the time budget is checked between copies.
+    constexpr size_t SLICE_BYTES = size_t(1) << 20;
+    const auto start = std::chrono::high_resolution_clock::now();
+    size_t budget = settings.uploadBudgetBytes;
+    size_t meshesDone = 0;
+    while (!uploads.empty() && budget > 0)
+    {
+        const double ms =
+            std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        if (ms >= settings.uploadBudgetMs) break;
+        MeshRequest& request = *uploads.front();
+        request.stage.store(StreamStage::Uploading, std::memory_order_relaxed);
+        budget -= RenderResources::UploadMeshPart(request.meshId, request.upload, std::min(budget, SLICE_BYTES));
+        if (request.upload.uploadedBytes < request.upload.TotalBytes()) continue;
+        const MeshGPU* mesh = RenderResources::GetMesh(request.meshId);
+        const aartze::geometry::BVH* bvh = RenderResources::GetMeshBVH(request.meshId);
+        residency.OnLoaded(request.meshId, mesh->vertexBytes + mesh->indexBytes, bvh ? bvh->MemoryBytes() : 0);
+        Release(request);
+        requests.erase(request.meshId);
+        uploads.erase(uploads.begin());
+        ++meshesDone;
+    }
+    // Decoded textures share what the meshes left of both budgets.
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    if (ms < settings.uploadBudgetMs) budget -= std::min(budget, gAssetRegistry.UploadTextures(budget, settings.uploadBudgetMs - ms));
+    ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    gProfiler.Add("Streaming Upload", ms);
+    gProfiler.AddCounter("Streaming Uploaded Bytes", settings.uploadBudgetBytes - budget);
+    gProfiler.AddCounter("Streaming Meshes Uploaded", meshesDone);
 }
 
-void StreamingSystem::Update(float)
+void StreamingSystem::UpdateResidency(float dt)
 {
-    for (auto it = pending.begin(); it != pending.end(); )
+    if (!hasViewer) return;
+    grid.Update(viewer, dt, residency);
+    residency.Update(residencyActions);
+    for (uint32_t meshId : residencyActions.cancel) CancelMesh(meshId);
+    for (uint32_t meshId : residencyActions.evict) RenderResources::UnloadMesh(meshId);
+    for (const ResidencyActions::Load& load : residencyActions.load)
     {
-        auto& p = it->second;
-        if (p.fut.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+        // Already uploaded under this id by someone else: adopt it.
+        const MeshGPU* mesh = IsPending(load.meshId) ? nullptr : RenderResources::GetMesh(load.meshId);
+        if (mesh)
         {
-            uint32_t mid = p.fut.get(); (void)mid; // mesh registry ID
-            MeshData md;
-            auto ext = std::filesystem::path(p.path).extension().string();
-            for(char& c:ext) c=(char)tolower((unsigned char)c);
-            if (ext == ".gltf" || ext == ".glb") md = LoadGltfModel(p.path, true, 1.0f);
-            else md = LoadMeshAny(p.path, true, 1.0f);
-            if (!md.vertices.empty()) RenderResources::UploadMesh(p.meshId, md);
-            it = pending.erase(it);
+            const aartze::geometry::BVH* bvh = RenderResources::GetMeshBVH(load.meshId);
+            residency.OnLoaded(load.meshId, mesh->vertexBytes + mesh->indexBytes, bvh ? bvh->MemoryBytes() : 0);
+            continue;
         }
-        else ++it;
+        RequestMesh(*load.path, load.meshId, load.priority);
     }
+
+    gProfiler.AddCounter("Streaming Active Cells", grid.ActiveCellCount());
+    gProfiler.AddCounter("Streaming Resident Meshes", residency.ResidentCount());
+    gProfiler.AddCounter("Streaming Resident GPU Bytes", residency.ResidentGpuBytes());
+    gProfiler.AddCounter("Streaming Resident CPU Bytes", residency.ResidentCpuBytes());
+    gProfiler.AddCounter("Streaming Evicted", residencyActions.evict.size());
+    gProfiler.AddCounter("Streaming Deferred", residency.DeferredCount());
+}
+
+void StreamingSystem::Update(float dt)
+{
+    // Collect what the stage jobs finished since the last frame.
+    for (auto it = requests.begin(); it != requests.end();)
+    {
+        MeshRequest& request = *it->second;
+        const StreamStage stage = request.stage.load(std::memory_order_acquire);
+        if (!request.loadSlot || IsPendingLoad(stage))
+        {
+            ++it;
+            continue;
+        }
+        request.loadSlot = false;
+        --loading;
+        if (stage == StreamStage::Ready)
+        {
+            // Trade the file-size estimate for what decoding actually holds.
+            inFlightBytes = inFlightBytes - std::min(inFlightBytes, request.reservedBytes) + request.decodedBytes;
+            request.reservedBytes = request.decodedBytes;
+            uploads.push_back(it->second);
+            ++it;
+            continue;
+        }
+        if (stage == StreamStage::Failed)
+        {
+            residency.OnFailed(request.meshId);
+            MarkMesh(request.meshId, AssetState::Failed);
+        }
+        Release(request);
+        it = requests.erase(it);
+    }
+    for (auto it = retired.begin(); it != retired.end();)
+    {
+        if (IsPendingLoad((*it)->stage.load(std::memory_order_acquire)))
+        {
+            ++it;
+            continue;
+        }
+        --loading;
+        Release(**it);
+        it = retired.erase(it);
+    }
+
+    UpdateResidency(dt);
+    Dispatch();
+    Upload();
+
+    size_t queued = 0;
+    for (const auto& [id, request] : requests) queued += request->stage.load(std::memory_order_relaxed) == StreamStage::Queued;
+    gProfiler.AddCounter("Streaming Queued", queued);
+    gProfiler.AddCounter("Streaming Loading", loading);
+    gProfiler.AddCounter("Streaming Upload Queue", uploads.size());
+    gProfiler.AddCounter("Streaming In-Flight Bytes", inFlightBytes);
+    gProfiler.AddCounter("Textures Resident", gAssetRegistry.ResidentTextureCount());
+    gProfiler.AddCounter("Texture Resident Bytes", gAssetRegistry.ResidentTextureBytes());
+    gProfiler.AddCounter("Texture Upload Queue", gAssetRegistry.PendingTextureUploads());
+}
+
+void StreamingSystem::Shutdown()
+{
+    grid.Clear(residency);
+    std::vector<uint32_t> ids;
+    for (const auto& [id, request] : requests) ids.push_back(id);
+    for (uint32_t id : ids) CancelMesh(id);
+}
+
+void StreamingSystem::DeclareAccess(SystemAccessBuilder& access) const
+{
+    // Uploads finished meshes to GL; touches no components.
+    access.MainThread();
 }
@@ -1,15 +1,123 @@
 #pragma once
 #include "core/System.hpp"
-#include <future>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
+#include "MeshResidency.hpp"
+#include "StreamingGrid.hpp"
+#include "systems/RenderingSystem/RenderResources.hpp"
+#include "utils/CookedMesh.hpp"
+
+struct StreamingSettings
+{
+    size_t uploadBudgetBytes = size_t(8) << 20;  // GPU copies per frame
+    double uploadBudgetMs = 2.0;                 // ... and main-thread time spent on them
+    size_t inFlightByteCap = size_t(256) << 20;  // read, decoded and staged but not yet uploaded
+    size_t maxConcurrentLoads = 4;               // requests in the read/decode stages at once
+};
+
+// Where a request is in the pipeline. Reading and Decoding run as background
+// jobs on gJobSystem; everything else happens on the main thread.
+enum class StreamStage : uint8_t
+{
+    Queued,     // waiting for a load slot, by priority
+    Reading,    // mapping the cooked file and faulting its pages in
+    Decoding,   // importing a source asset / validating a cooked one, packing, BVH
+    Ready,      // GPU-ready bytes waiting for upload budget
+    Uploading,  // part of the bytes copied to GL
+    Cancelled,  // dropped by a job after CancelMesh; reaped next Update
+    Failed,
+};
+
+/**
+ * @brief Staged mesh streaming. RequestMesh queues a mesh by priority; file
+ * IO and decoding run as background jobs, a few at a time and under a cap
+ * on the bytes held in flight, and the main thread only copies finished
+ * bytes to GL within a per-frame budget. Nothing that parses or builds runs
+ * on the main thread, so a stream-in costs at most the upload budget.
+ * Textures a mesh uses are handed to gAssetRegistry as it decodes, and
+ * their decoded pixels go up from what the meshes leave of the budget.
+ *
+ * World streaming sits on top: cells of `grid` declare the meshes placed in
+ * them, the viewer position (SetViewer) activates and releases cells, and
+ * `residency` turns the resulting references into requests, cancels and
+ * evictions under its GPU/CPU budget. Meshes requested directly through
+ * RequestMesh are not tracked by it and are never evicted.
+ */
 struct StreamingSystem : public System
 {
-    struct PendingMesh { std::future<uint32_t> fut; uint32_t meshId; std::string path; };
-    std::unordered_map<uint32_t, PendingMesh> pending; // by meshId
+    // State shared between the main thread and the stage jobs. The jobs
+    // hold a reference, so a cancelled request can finish its stage safely.
+    struct MeshRequest
+    {
+        uint32_t meshId = 0;
+        std::string path;
+        int priority = 0;           // higher streams first
+        uint64_t sequence = 0;      // FIFO among equal priorities
+        size_t estimatedBytes = 0;  // file size, reserved when the load starts
+        size_t reservedBytes = 0;   // counted against inFlightByteCap
+        bool loadSlot = false;      // holds one of maxConcurrentLoads (main thread only)
+        std::atomic<StreamStage> stage{StreamStage::Queued};
+        std::atomic<bool> cancelled{false};
+
+        // Filled by the jobs, read by the main thread once stage is Ready.
+        MappedFile file;                    // cooked meshes upload straight from the mapping
+        CookedMeshView view;
+        std::vector<unsigned char> blob;    // source meshes: packed vertices, then indices
+        MeshUpload upload;
+        size_t decodedBytes = 0;
+    };
+
+    StreamingSettings settings;
+    StreamingGrid grid;
+    MeshResidency residency;
+
     void Update(float) override;
+    void Shutdown() override;
+    void DeclareAccess(SystemAccessBuilder& access) const override;
     const char* GetName() const override { return "StreamingSystem"; }
-    void RequestMesh(const std::string& path, uint32_t meshId);
-    size_t PendingCount() const { return pending.size(); }
+
+    // Queue `path` for `meshId`, or change the priority of the request
+    // already pending for it.
+    void RequestMesh(const std::string& path, uint32_t meshId, int priority = 0);
+    // Drop a request at whatever stage it is; a resident mesh is unaffected.
+    // A job still working on it finishes its stage and is discarded.
+    void CancelMesh(uint32_t meshId);
+    bool IsPending(uint32_t meshId) const { return requests.count(meshId) != 0; }
+    size_t PendingCount() const { return requests.size(); }
+    size_t InFlightBytes() const { return inFlightBytes; }
+
+    // Declare a world-streamed instance of `meshId` at `position`; its size
+    // is estimated from the file until the mesh is resident.
+    void AddWorldAsset(const float position[3], uint32_t meshId, const std::string& path);
+    // Forget every world asset, before another world is declared; meshes
+    // already resident stay cached until the residency budget needs room.
+    void ClearWorldAssets();
+    // Where world streaming measures distances from, usually the camera;
+    // world cells are only streamed once this has been set.
+    void SetViewer(const float position[3]);
+
+private:
+    using RequestPtr = std::shared_ptr<MeshRequest>;
+    void Dispatch();
+    void Upload();
+    void Release(MeshRequest& request);
+    void UpdateResidency(float dt);
+    static void ReadStage(RequestPtr request);
+    static void DecodeStage(RequestPtr request);
+
+    std::unordered_map<uint32_t, RequestPtr> requests;  // by meshId, every stage
+    std::vector<RequestPtr> uploads;                    // Ready/Uploading, in upload order
+    std::vector<RequestPtr> retired;                    // cancelled while a job still holds them
+    size_t inFlightBytes = 0;
+    size_t loading = 0;  // requests in Reading/Decoding
+    uint64_t nextSequence = 0;
+    ResidencyActions residencyActions;
+    float viewer[3]{0.0f, 0.0f, 0.0f};
+    bool hasViewer = false;
 };
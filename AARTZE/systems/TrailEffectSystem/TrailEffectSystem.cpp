@@ -1,15 +1,20 @@
 #include "TrailEffectSystem.hpp"
 
 #include "Coordinator.hpp"
+#include "SystemScheduler.hpp"
 #include "TrailEffectComponent.hpp"
 
 void TrailEffectSystem::Update(float deltaTime)
 {
-    auto entities = gCoordinator.GetEntitiesWithComponents<TrailEffectComponent>();
-    for (auto entity : entities)
-    {
-        auto& trail = gCoordinator.GetComponent<TrailEffectComponent>(entity);
+    // Removal is deferred to SystemManager's sync point, so it is safe here.
+    if (!m_query) m_query = &gCoordinator.GetQuery<TrailEffectComponent>();
+    m_query->ForEach([deltaTime](Entity entity, TrailEffectComponent& trail) {
         trail.lifetime -= deltaTime;
         if (trail.lifetime <= 0.0f) gCoordinator.RemoveComponent<TrailEffectComponent>(entity);
-    }
+    });
+}
+
+void TrailEffectSystem::DeclareAccess(SystemAccessBuilder& access) const
+{
+    access.Write<TrailEffectComponent>();
 }
@@ -1,12 +1,19 @@
 #pragma once
+#include "Query.hpp"
 #include "System.hpp"
 
+struct TrailEffectComponent;
+
 class TrailEffectSystem : public System
 {
    public:
     void Update(float deltaTime) override;
+    void DeclareAccess(SystemAccessBuilder& access) const override;
     const char* GetName() const override
     {
         return "TrailEffectSystem";
     }
+
+   private:
+    Query<TrailEffectComponent>* m_query = nullptr;
 };
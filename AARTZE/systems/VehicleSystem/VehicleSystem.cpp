@@ -3,27 +3,26 @@
 #include <algorithm>
 
 #include "Coordinator.hpp"
+#include "SystemScheduler.hpp"
 #include "DrivingComponent.hpp"
 #include "environment/TireSplashComponent.hpp"
 
 void VehicleSystem::Update(float deltaTime)
 {
-    auto drivingEntities = gCoordinator.GetEntitiesWithComponents<DrivingComponent>();
-    for (auto entity : drivingEntities)
+    if (!m_driving)
     {
-        auto& drive = gCoordinator.GetComponent<DrivingComponent>(entity);
+        m_driving = &gCoordinator.GetQuery<DrivingComponent>();
+        m_splashing = &gCoordinator.GetQuery<DrivingComponent, TireSplashComponent>();
+    }
+
+    m_driving->ForEach([deltaTime](Entity, DrivingComponent& drive) {
         if (drive.isDriving)
             drive.acceleration = std::min(1.0f, drive.acceleration + deltaTime);
         else
             drive.acceleration = 0.0f;
-    }
+    });
 
-    auto splashEntities =
-        gCoordinator.GetEntitiesWithComponents<DrivingComponent, TireSplashComponent>();
-    for (auto entity : splashEntities)
-    {
-        auto& drive = gCoordinator.GetComponent<DrivingComponent>(entity);
-        auto& splash = gCoordinator.GetComponent<TireSplashComponent>(entity);
+    m_splashing->ForEach([deltaTime](Entity, DrivingComponent& drive, TireSplashComponent& splash) {
         if (drive.isDriving)
         {
             splash.splashIntensity =
@@ -35,5 +34,10 @@ void VehicleSystem::Update(float deltaTime)
             splash.splashIntensity = 0.0f;
             splash.lastSplashTime = 0.0f;
         }
-    }
+    });
+}
+
+void VehicleSystem::DeclareAccess(SystemAccessBuilder& access) const
+{
+    access.Write<DrivingComponent, TireSplashComponent>();
 }
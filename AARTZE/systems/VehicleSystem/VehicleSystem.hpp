@@ -1,12 +1,21 @@
 #pragma once
+#include "Query.hpp"
 #include "System.hpp"
 
+struct DrivingComponent;
+struct TireSplashComponent;
+
 class VehicleSystem : public System
 {
    public:
     void Update(float deltaTime) override;
+    void DeclareAccess(SystemAccessBuilder& access) const override;
     const char* GetName() const override
     {
         return "VehicleSystem";
     }
+
+   private:
+    Query<DrivingComponent>* m_driving = nullptr;
+    Query<DrivingComponent, TireSplashComponent>* m_splashing = nullptr;
 };
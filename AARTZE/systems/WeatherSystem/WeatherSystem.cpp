@@ -3,6 +3,7 @@
 #include <algorithm>
 
 #include "Coordinator.hpp"
+#include "SystemScheduler.hpp"
 #include "environment/PuddleComponent.hpp"
 #include "environment/RainAudioComponent.hpp"
 #include "environment/RainOcclusionComponent.hpp"
@@ -11,38 +12,40 @@
 
 void WeatherSystem::Update(float deltaTime)
 {
-    auto rippleEntities = gCoordinator.GetEntitiesWithComponents<RainRipplesComponent>();
-    for (auto entity : rippleEntities)
+    if (!m_ripples)
     {
-        auto& ripple = gCoordinator.GetComponent<RainRipplesComponent>(entity);
+        m_ripples = &gCoordinator.GetQuery<RainRipplesComponent>();
+        m_screens = &gCoordinator.GetQuery<ScreenWetnessEffectComponent>();
+        m_puddles = &gCoordinator.GetQuery<PuddleComponent>();
+        m_audio = &gCoordinator.GetQuery<RainAudioComponent>();
+    }
+
+    m_ripples->ForEachParallel([this](Entity entity, RainRipplesComponent& ripple) {
         bool occluded = gCoordinator.HasComponent<RainOcclusionComponent>(entity);
         ripple.active = isRaining && !occluded;
-    }
+    });
 
-    auto screenEntities = gCoordinator.GetEntitiesWithComponents<ScreenWetnessEffectComponent>();
-    for (auto entity : screenEntities)
-    {
-        auto& screen = gCoordinator.GetComponent<ScreenWetnessEffectComponent>(entity);
+    m_screens->ForEachParallel([this, deltaTime](Entity, ScreenWetnessEffectComponent& screen) {
         if (isRaining)
             screen.wetnessAmount = std::min(1.0f, screen.wetnessAmount + deltaTime);
         else
             screen.wetnessAmount = std::max(0.0f, screen.wetnessAmount - deltaTime);
-    }
+    });
 
-    auto puddleEntities = gCoordinator.GetEntitiesWithComponents<PuddleComponent>();
-    for (auto entity : puddleEntities)
-    {
-        auto& puddle = gCoordinator.GetComponent<PuddleComponent>(entity);
+    m_puddles->ForEachParallel([this, deltaTime](Entity, PuddleComponent& puddle) {
         if (isRaining && puddle.isDynamic)
             puddle.depth = std::min(1.0f, puddle.depth + deltaTime);
         else
             puddle.depth = std::max(0.0f, puddle.depth - deltaTime);
-    }
+    });
 
-    auto audioEntities = gCoordinator.GetEntitiesWithComponents<RainAudioComponent>();
-    for (auto entity : audioEntities)
-    {
-        auto& audio = gCoordinator.GetComponent<RainAudioComponent>(entity);
+    m_audio->ForEachParallel([this](Entity, RainAudioComponent& audio) {
         audio.volume = isRaining ? 1.0f : 0.0f;
-    }
+    });
+}
+
+void WeatherSystem::DeclareAccess(SystemAccessBuilder& access) const
+{
+    access.Write<RainRipplesComponent, ScreenWetnessEffectComponent, PuddleComponent, RainAudioComponent>()
+        .Read<RainOcclusionComponent>();
 }
@@ -1,13 +1,26 @@
 #pragma once
+#include "Query.hpp"
 #include "System.hpp"
 
+struct RainRipplesComponent;
+struct ScreenWetnessEffectComponent;
+struct PuddleComponent;
+struct RainAudioComponent;
+
 class WeatherSystem : public System
 {
    public:
     bool isRaining = true;
     void Update(float deltaTime) override;
+    void DeclareAccess(SystemAccessBuilder& access) const override;
     const char* GetName() const override
     {
         return "WeatherSystem";
     }
+
+   private:
+    Query<RainRipplesComponent>* m_ripples = nullptr;
+    Query<ScreenWetnessEffectComponent>* m_screens = nullptr;
+    Query<PuddleComponent>* m_puddles = nullptr;
+    Query<RainAudioComponent>* m_audio = nullptr;
 };
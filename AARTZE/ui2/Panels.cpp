@@ -39,13 +39,12 @@ void OutlinerPanel::paint(DrawList& dl)
     dl.text(m_bounds.x + 12, bodyY + 12, "Search...", s.Text);
 
     const float listTop = bodyY + 36; const float listH = m_bounds.h - headerH() - 44; const float rowH = 22.0f;
-    int total = 0; for (unsigned e=0;e<MAX_ENTITIES;++e) if (gCoordinator.IsEntityAlive(e)) ++total;
+    int total = 0; gCoordinator.ForEachEntity([&](Entity){ ++total; });
     int first = std::max(0, (int)(m_scroll/rowH)); int visible = (int)(listH/rowH)+2; int last = std::min(total, first+visible);
 
     int idx=0;
-    for (unsigned e=0;e<MAX_ENTITIES;++e)
+    gCoordinator.ForEachEntity([&](Entity e)
     {
-        if (!gCoordinator.IsEntityAlive(e)) continue;
         if (idx>=first && idx<last)
         {
             float y = listTop + (idx*rowH - m_scroll);
@@ -59,7 +58,7 @@ void OutlinerPanel::paint(DrawList& dl)
             dl.rectFilled(lock.x, lock.y, lock.w, lock.h, EditorState::IsLocked(e)?rgba(s.Accent):item);
         }
         ++idx;
-    }
+    });
 }
 
 void OutlinerPanel::tick()
@@ -74,7 +73,7 @@ void OutlinerPanel::tick()
     if (inside((float)mx,(float)my, click) && glfwGetMouseButton(m_window, GLFW_MOUSE_BUTTON_LEFT)==GLFW_PRESS)
     {
         int row = (int)((my - listTop + m_scroll)/rowH);
-        int cur=0; unsigned hit=(unsigned)-1; for(unsigned e=0;e<MAX_ENTITIES;++e) if (gCoordinator.IsEntityAlive(e)){ if(cur==row){hit=e;break;} ++cur; }
+        int cur=0; unsigned hit=(unsigned)-1; gCoordinator.ForEachEntity([&](Entity e){ if(cur==row) hit=e; ++cur; });
         if (hit!=(unsigned)-1)
         {
             Rect r{ m_bounds.x + 8, (float)(listTop + (row*rowH - m_scroll)), m_bounds.w - 16, rowH-4 };
@@ -2,6 +2,8 @@
 #include <glad/glad.h>
 #include <vector>
 
+#include "../core/MemoryManager.hpp"
+
 namespace ui2 {
 
 static unsigned CompileShader(unsigned type, const char* src)
@@ -53,7 +55,7 @@ void RendererGL::render(const DrawList& list, int fbWidth, int fbHeight)
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    std::vector<Vtx> verts; verts.reserve(list.cmds.size()*6);
+    FrameVector<Vtx> verts; verts.reserve(list.cmds.size()*6);  // rebuilt every frame
     auto pushRect = [&](float x,float y,float w,float h, unsigned rgba){
         float r = ((rgba)     & 0xFF) / 255.0f;
         float g = ((rgba>>8)  & 0xFF) / 255.0f;
@@ -3,34 +3,34 @@
 #include <string>
 
 #include "core/Coordinator.hpp"
-#include "World/MeshRegistry.hpp"
-#include "World/TextureRegistry.hpp"
+#include "World/AssetRegistry.hpp"
 #include "utils/SkeletonUtils.hpp"
 
-// Forward declaration so async loaders can call the global function
-uint32_t RegisterMesh(const std::string& path);
-
 namespace AssetLoader
 {
 inline std::future<uint32_t> LoadMeshAsync(const std::string& path)
 {
-    return gThreadPool.enqueue([path]() { return ::RegisterMesh(path); });
+    return gJobSystem.Enqueue([path]() { return gAssetRegistry.RegisterMesh(path).id; });
 }
 
-inline std::future<uint32_t> LoadTextureAsync(const std::string& path)
+// Starts decoding on a worker and returns at once; poll
+// gAssetRegistry.State(handle), and ReleaseTexture it when done.
+inline TextureHandle LoadTextureAsync(const std::string& path)
 {
-    return gThreadPool.enqueue([path]() { return ::RegisterTexture(path); });
+    const TextureHandle texture = gAssetRegistry.RegisterTexture(path);
+    gAssetRegistry.RequestTexture(texture);
+    return texture;
 }
 
 inline std::future<SkeletonComponent> LoadSkeletonAsync(const std::string& path)
 {
-    return gThreadPool.enqueue([path]() { return LoadFbxSkeleton(path); });
+    return gJobSystem.Enqueue([path]() { return LoadFbxSkeleton(path); });
 }
 
 inline std::future<std::vector<AnimationClip>> LoadAnimationsAsync(
     const std::string& path, const SkeletonComponent& skeleton)
 {
-    return gThreadPool.enqueue(
+    return gJobSystem.Enqueue(
         [path, skeleton]() { return LoadFbxAnimations(path, skeleton); });
 }
 }  // namespace AssetLoader
@@ -0,0 +1,243 @@
+#include "CookedMesh.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "utils/MeshUtils.hpp"
+
+std::string_view CookedMeshView::Material(uint32_t i) const
+{
+    const char* strings = reinterpret_cast<const char*>(materialTable + header->materialCount + 1);
+    return std::string_view(strings + materialTable[i], materialTable[i + 1] - materialTable[i]);
+}
+
+void PackMeshVertices(const MeshData& data, PackedVertex* out)
+{
+    const size_t vcount = data.vertices.size() / 3;
+    const float defaultNormal[3] = {0.0f, 0.0f, 1.0f};
+    const float defaultColor[3] = {1.0f, 1.0f, 1.0f};
+    const float defaultUV[2] = {0.0f, 0.0f};
+    const bool hasNormals = data.normals.size() >= vcount * 3;
+    const bool hasColors = data.colors.size() >= vcount * 3;
+    const bool hasUVs = data.texCoords.size() >= vcount * 2;
+    for (size_t i = 0; i < vcount; ++i)
+        out[i] = PackVertex(&data.vertices[i * 3], hasNormals ? &data.normals[i * 3] : defaultNormal,
+                            hasColors ? &data.colors[i * 3] : defaultColor, hasUVs ? &data.texCoords[i * 2] : defaultUV);
+}
+
+void ComputeMeshBounds(const float* positions, size_t vertexCount, float boundsMin[3], float boundsMax[3],
+                       float boundsCenter[3], float& boundsRadius)
+{
+    for (int a = 0; a < 3; ++a) boundsMin[a] = boundsMax[a] = boundsCenter[a] = 0.0f;
+    boundsRadius = 0.0f;
+    if (vertexCount == 0) return;
+    for (int a = 0; a < 3; ++a) { boundsMin[a] = positions[a]; boundsMax[a] = positions[a]; }
+    for (size_t i = 1; i < vertexCount; ++i)
+        for (int a = 0; a < 3; ++a)
+        {
+            boundsMin[a] = std::min(boundsMin[a], positions[i * 3 + a]);
+            boundsMax[a] = std::max(boundsMax[a], positions[i * 3 + a]);
+        }
+    for (int a = 0; a < 3; ++a) boundsCenter[a] = 0.5f * (boundsMin[a] + boundsMax[a]);
+    float r2 = 0.0f;
+    for (size_t i = 0; i < vertexCount; ++i)
+    {
+        float dx = positions[i * 3 + 0] - boundsCenter[0];
+        float dy = positions[i * 3 + 1] - boundsCenter[1];
+        float dz = positions[i * 3 + 2] - boundsCenter[2];
+        r2 = std::max(r2, dx * dx + dy * dy + dz * dz);
+    }
+    boundsRadius = std::sqrt(r2);
+}
+
+namespace
+{
+uint64_t AlignUp(uint64_t offset) { return (offset + AMESH_ALIGNMENT - 1) & ~uint64_t(AMESH_ALIGNMENT - 1); }
+
+bool InFile(uint64_t offset, uint64_t bytes, uint64_t fileBytes)
+{
+    return offset % AMESH_ALIGNMENT == 0 && offset <= fileBytes && bytes <= fileBytes - offset;
+}
+
+// Largest value in an index blob; one linear pass.
+template <class Index>
+uint32_t MaxIndex(const void* blob, uint32_t count)
+{
+    const Index* indices = static_cast<const Index*>(blob);
+    Index largest = 0;
+    for (uint32_t i = 0; i < count; ++i) largest = std::max(largest, indices[i]);
+    return largest;
+}
+}
+
+bool CookMesh(const MeshData& data, const std::string& path)
+{
+    if (data.vertices.size() < 3) return false;
+    if (data.indices.empty())
+    {
+        MeshData welded = data;
+        WeldVertices(welded);
+        return CookMesh(welded, path);
+    }
+    const size_t vcount = data.vertices.size() / 3;
+    const size_t icount = data.indices.size() - data.indices.size() % 3;
+
+    AmeshHeader header{};
+    header.magic = AMESH_MAGIC;
+    header.version = AMESH_VERSION;
+    header.headerBytes = sizeof(AmeshHeader);
+    header.vertexStride = sizeof(PackedVertex);
+    header.vertexCount = static_cast<uint32_t>(vcount);
+    header.indexCount = static_cast<uint32_t>(icount);
+    // 16-bit indices whenever every vertex is addressable with them, as at upload.
+    header.indexSize = vcount <= 0x10000 ? 2 : 4;
+    ComputeMeshBounds(data.vertices.data(), vcount, header.boundsMin, header.boundsMax, header.boundsCenter,
+                      header.boundsRadius);
+
+    // A mesh without a LOD chain is its own level 0.
+    std::vector<aartze::geometry::LodLevel> lods(data.lods.begin(), data.lods.end());
+    if (lods.empty()) lods.push_back({0, static_cast<uint32_t>(icount), 0.0f});
+    header.lodCount = static_cast<uint32_t>(lods.size());
+
+    std::vector<uint32_t> materialTable(1, 0);
+    std::string materialStrings;
+    for (const std::string& texture : data.texturePaths)
+    {
+        materialStrings += texture;
+        materialTable.push_back(static_cast<uint32_t>(materialStrings.size()));
+    }
+    header.materialCount = static_cast<uint32_t>(materialTable.size() - 1);
+
+    header.vertexOffset = AlignUp(sizeof(AmeshHeader));
+    header.indexOffset = AlignUp(header.vertexOffset + vcount * sizeof(PackedVertex));
+    header.positionOffset = AlignUp(header.indexOffset + icount * header.indexSize);
+    header.lodOffset = AlignUp(header.positionOffset + vcount * 3 * sizeof(float));
+    header.materialOffset = AlignUp(header.lodOffset + lods.size() * sizeof(aartze::geometry::LodLevel));
+    header.fileBytes = header.materialOffset + materialTable.size() * sizeof(uint32_t) + materialStrings.size();
+
+    std::vector<unsigned char> file(header.fileBytes, 0);
+    std::memcpy(file.data(), &header, sizeof(header));
+    PackMeshVertices(data, reinterpret_cast<PackedVertex*>(file.data() + header.vertexOffset));
+    if (header.indexSize == 2)
+    {
+        uint16_t* out = reinterpret_cast<uint16_t*>(file.data() + header.indexOffset);
+        for (size_t i = 0; i < icount; ++i) out[i] = static_cast<uint16_t>(data.indices[i]);
+    }
+    else
+        std::memcpy(file.data() + header.indexOffset, data.indices.data(), icount * sizeof(uint32_t));
+    std::memcpy(file.data() + header.positionOffset, data.vertices.data(), vcount * 3 * sizeof(float));
+    std::memcpy(file.data() + header.lodOffset, lods.data(), lods.size() * sizeof(aartze::geometry::LodLevel));
+    std::memcpy(file.data() + header.materialOffset, materialTable.data(), materialTable.size() * sizeof(uint32_t));
+    std::memcpy(file.data() + header.materialOffset + materialTable.size() * sizeof(uint32_t), materialStrings.data(),
+                materialStrings.size());
+
+    // Write next to the target and rename, so a reader never maps a half-written file.
+    const std::string temp = path + ".tmp";
+    std::FILE* out = std::fopen(temp.c_str(), "wb");
+    if (!out)
+    {
+        std::cerr << "[CookedMesh] Failed to open " << temp << " for writing\n";
+        return false;
+    }
+    const bool written = std::fwrite(file.data(), 1, file.size(), out) == file.size();
+    if (std::fclose(out) != 0 || !written)
+    {
+        std::cerr << "[CookedMesh] Failed to write " << temp << "\n";
+        std::remove(temp.c_str());
+        return false;
+    }
+    std::error_code ec;
+    std::filesystem::rename(temp, path, ec);
+    if (ec)
+    {
+        std::cerr << "[CookedMesh] Failed to move " << temp << " to " << path << ": " << ec.message() << "\n";
+        std::remove(temp.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool CookMeshAsset(const std::string& sourcePath, const std::string& cookedPath, bool normalize, float scaleFactor)
+{
+    std::string ext = std::filesystem::path(sourcePath).extension().string();
+    for (char& c : ext) c = (char)tolower((unsigned char)c);
+    // Cooking stores texture paths only; they are registered when the cooked file is loaded.
+    MeshData data = (ext == ".gltf" || ext == ".glb") ? ImportGltfFile(sourcePath, normalize, scaleFactor)
+                                                      : ImportAssimpFile(sourcePath, normalize, scaleFactor, false);
+    if (data.vertices.empty()) return false;
+    return CookMesh(data, cookedPath);
+}
+
+std::string ResolveCookedMesh(const std::string& path)
+{
+    if (IsCookedMeshPath(path)) return path;
+    std::error_code ec;
+    std::filesystem::path cooked(path);
+    cooked.replace_extension(".amesh");
+    const auto cookedTime = std::filesystem::last_write_time(cooked, ec);
+    if (ec) return {};
+    const auto sourceTime = std::filesystem::last_write_time(path, ec);
+    if (!ec && sourceTime > cookedTime) return {};
+    return cooked.string();
+}
+
+bool OpenCookedMesh(const std::string& path, MappedFile& file, CookedMeshView& view)
+{
+    view = CookedMeshView{};
+    if (!file.Open(path))
+    {
+        std::cerr << "[CookedMesh] Failed to map " << path << "\n";
+        return false;
+    }
+    auto reject = [&](const char* why) {
+        std::cerr << "[CookedMesh] " << path << ": " << why << "\n";
+        view = CookedMeshView{};
+        file.Close();
+        return false;
+    };
+    if (file.Size() < sizeof(AmeshHeader)) return reject("truncated header");
+    const AmeshHeader& h = *reinterpret_cast<const AmeshHeader*>(file.Data());
+    if (h.magic != AMESH_MAGIC) return reject("not an .amesh file");
+    if (h.version != AMESH_VERSION) return reject("stale format version, recook it");
+    if (h.headerBytes != sizeof(AmeshHeader) || h.vertexStride != sizeof(PackedVertex))
+        return reject("layout does not match this build");
+    if (h.indexSize != 2 && h.indexSize != 4) return reject("bad index size");
+    if (h.fileBytes != file.Size()) return reject("size does not match the header");
+    const uint64_t n = h.fileBytes;
+    if (!InFile(h.vertexOffset, uint64_t(h.vertexCount) * h.vertexStride, n) ||
+        !InFile(h.indexOffset, uint64_t(h.indexCount) * h.indexSize, n) ||
+        !InFile(h.positionOffset, uint64_t(h.vertexCount) * 3 * sizeof(float), n) ||
+        !InFile(h.lodOffset, uint64_t(h.lodCount) * sizeof(aartze::geometry::LodLevel), n) ||
+        !InFile(h.materialOffset, (uint64_t(h.materialCount) + 1) * sizeof(uint32_t), n))
+        return reject("section outside the file");
+    if (h.lodCount == 0) return reject("no levels");
+
+    const unsigned char* base = file.Data();
+    view.header = &h;
+    view.vertices = reinterpret_cast<const PackedVertex*>(base + h.vertexOffset);
+    view.indices = base + h.indexOffset;
+    view.positions = reinterpret_cast<const float*>(base + h.positionOffset);
+    view.lods = reinterpret_cast<const aartze::geometry::LodLevel*>(base + h.lodOffset);
+    view.materialTable = reinterpret_cast<const uint32_t*>(base + h.materialOffset);
+
+    for (uint32_t i = 0; i < h.lodCount; ++i)
+        if (view.lods[i].firstIndex > h.indexCount || view.lods[i].indexCount > h.indexCount - view.lods[i].firstIndex)
+            return reject("level outside the index blob");
+    // The BVH build and the GPU both index vertices with these unchecked.
+    if (h.indexCount > 0)
+    {
+        const uint32_t largest = h.indexSize == sizeof(uint16_t) ? MaxIndex<uint16_t>(view.indices, h.indexCount)
+                                                                 : MaxIndex<uint32_t>(view.indices, h.indexCount);
+        if (largest >= h.vertexCount) return reject("index past the vertex count");
+    }
+    const uint64_t stringBytes = n - h.materialOffset - (uint64_t(h.materialCount) + 1) * sizeof(uint32_t);
+    for (uint32_t i = 0; i < h.materialCount; ++i)
+        if (view.materialTable[i] > view.materialTable[i + 1] || view.materialTable[i + 1] > stringBytes)
+            return reject("bad material table");
+    if (view.materialTable[0] != 0) return reject("bad material table");
+    return true;
+}
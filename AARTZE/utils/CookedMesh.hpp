@@ -0,0 +1,122 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "aartze/geometry/Simplify.h"
+#include "aartze/import/MappedFile.h"
+#include "systems/RenderingSystem/VertexFormat.hpp"
+
+struct MeshData; // from utils/MeshUtils.hpp
+
+// .amesh: a mesh cooked into the exact bytes RenderResources uploads, so the
+// runtime maps the file and hands the blobs to GL without parsing them.
+//
+//   AmeshHeader                     offset 0
+//   PackedVertex[vertexCount]       vertexOffset, 16-byte GPU vertices
+//   uint16/uint32[indexCount]       indexOffset, every LOD level, indexSize bytes each
+//   float[vertexCount * 3]          positionOffset, full-precision positions for the CPU BVH
+//   LodLevel[lodCount]              lodOffset, finest first
+//   uint32[materialCount + 1]       materialOffset, byte offsets of each diffuse
+//   char[]                          texture path after the table (empty = none)
+//
+// Every section starts on an AMESH_ALIGNMENT boundary. Little-endian only;
+// a file with another magic or version is rejected and should be recooked.
+constexpr uint32_t AMESH_MAGIC = 0x48534D41u;  // "AMSH"
+constexpr uint32_t AMESH_VERSION = 1;
+constexpr size_t AMESH_ALIGNMENT = 64;
+
+struct AmeshHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t headerBytes;   // sizeof(AmeshHeader)
+    uint32_t vertexStride;  // sizeof(PackedVertex)
+    uint32_t vertexCount;
+    uint32_t indexCount;    // every level
+    uint32_t indexSize;     // 2 or 4
+    uint32_t lodCount;
+    uint32_t materialCount;
+    uint32_t reserved;
+    float boundsMin[3];
+    float boundsMax[3];
+    float boundsCenter[3];
+    float boundsRadius;
+    uint64_t vertexOffset;
+    uint64_t indexOffset;
+    uint64_t positionOffset;
+    uint64_t lodOffset;
+    uint64_t materialOffset;
+    uint64_t fileBytes;
+};
+static_assert(sizeof(AmeshHeader) == 128, "AmeshHeader is part of the file format");
+static_assert(sizeof(aartze::geometry::LodLevel) == 12, "LodLevel is stored verbatim in .amesh files");
+
+using aartze::importer::MappedFile;
+
+/**
+ * @brief Sections of a validated .amesh file. Every pointer aims into the
+ * MappedFile it was opened from and dies with it.
+ */
+struct CookedMeshView
+{
+    const AmeshHeader* header{nullptr};
+    const PackedVertex* vertices{nullptr};
+    const void* indices{nullptr};
+    const float* positions{nullptr};
+    const aartze::geometry::LodLevel* lods{nullptr};
+    const uint32_t* materialTable{nullptr};
+
+    size_t VertexBytes() const { return size_t(header->vertexCount) * header->vertexStride; }
+    size_t IndexBytes() const { return size_t(header->indexCount) * header->indexSize; }
+    // Diffuse texture path of material i; empty when it has none.
+    std::string_view Material(uint32_t i) const;
+};
+
+/**
+ * @brief Pack the attribute streams of `data` into GPU vertices, with the
+ * defaults the shaders assume for missing streams. `out` holds
+ * data.vertices.size() / 3 entries.
+ */
+void PackMeshVertices(const MeshData& data, PackedVertex* out);
+
+/**
+ * @brief AABB of xyz positions plus a sphere centred on it that encloses
+ * every vertex (tighter than the box's half-diagonal).
+ */
+void ComputeMeshBounds(const float* positions, size_t vertexCount, float boundsMin[3], float boundsMax[3],
+                       float boundsCenter[3], float& boundsRadius);
+
+/**
+ * @brief Write `data` (indexed, with its LOD chain) as an .amesh file.
+ * Unindexed data is welded first, as UploadMesh would.
+ */
+bool CookMesh(const MeshData& data, const std::string& path);
+
+/**
+ * @brief Import a source asset through the regular Assimp loaders and cook
+ * it to `cookedPath`.
+ */
+bool CookMeshAsset(const std::string& sourcePath, const std::string& cookedPath, bool normalize = true,
+                   float scaleFactor = 1.0f);
+
+/**
+ * @brief Map `path` into `file` and point `view` at its sections after
+ * checking the header, that every section lies inside the file and that
+ * every index is below the vertex count. Besides the header and the small
+ * tables only the index blob is read, once; the vertex blobs stay untouched.
+ */
+bool OpenCookedMesh(const std::string& path, MappedFile& file, CookedMeshView& view);
+
+inline bool IsCookedMeshPath(const std::string& path)
+{
+    return path.size() > 6 && path.compare(path.size() - 6, 6, ".amesh") == 0;
+}
+
+/**
+ * @brief The .amesh to load for `path`: the path itself if it is one, else a
+ * cooked sibling (same name, .amesh extension) at least as new as the
+ * source. Empty when the source has to be imported.
+ */
+std::string ResolveCookedMesh(const std::string& path);
@@ -5,6 +5,8 @@
 
 #include <algorithm>
 #include <array>
+#include <cstdint>
+#include <cstring>
 #include <assimp/Importer.hpp>
 #include <filesystem>
 #include <fstream>
@@ -15,9 +17,13 @@
 #include <unordered_map>
 #include <vector>
 
+#include "aartze/geometry/MeshOps.h"
+#include "aartze/geometry/Simplify.h"
+#include "aartze/import/Gltf.h"
+#include "core/JobSystem.hpp"
+
 #ifndef MESHUTILS_NO_REGISTRY
-#include "World/TextureRegistry.hpp"
-#include "utils/AssetLoader.hpp"
+#include "World/AssetRegistry.hpp"
 #endif
 
 struct MeshData
@@ -29,7 +35,124 @@ struct MeshData
     std::vector<int> boneIndices;      // 4 per vertex
     std::vector<float> boneWeights;    // 4 per vertex
     std::vector<uint32_t> textureIds;  // diffuse texture IDs per material
+    std::vector<std::string> texturePaths;  // the files behind textureIds, empty where there is none
+    std::vector<uint32_t> indices;     // 3 per triangle; empty = unindexed triangle list
+    // Index ranges into `indices`, finest first, all over the same vertices;
+    // empty = the whole list is the only level.
+    std::vector<aartze::geometry::LodLevel> lods;
 };
+
+// Attribute streams of a MeshData with one entry per vertex. Streams shorter
+// than that are cleared, since they could no longer be matched to their
+// vertices once the vertex order changes.
+struct MeshDataStreams
+{
+    aartze::geometry::VertexStream streams[6];
+    std::vector<float>* floats[6];
+    std::vector<int>* ints[6];
+    size_t count = 0;
+};
+
+inline MeshDataStreams CollectMeshStreams(MeshData& data, size_t vertexCount)
+{
+    MeshDataStreams out;
+    auto addFloats = [&](std::vector<float>& v, size_t n) {
+        if (v.size() < vertexCount * n) { v.clear(); return; }
+        out.streams[out.count] = {v.data(), n * sizeof(float), n * sizeof(float)};
+        out.floats[out.count] = &v;
+        out.ints[out.count++] = nullptr;
+    };
+    addFloats(data.vertices, 3);
+    addFloats(data.normals, 3);
+    addFloats(data.colors, 3);
+    addFloats(data.texCoords, 2);
+    addFloats(data.boneWeights, 4);
+    if (data.boneIndices.size() >= vertexCount * 4)
+    {
+        out.streams[out.count] = {data.boneIndices.data(), 4 * sizeof(int), 4 * sizeof(int)};
+        out.floats[out.count] = nullptr;
+        out.ints[out.count++] = &data.boneIndices;
+    }
+    else
+        data.boneIndices.clear();
+    return out;
+}
+
+// Move every stream's vertex v to remap[v] and rewrite the indices to match.
+inline void RemapMeshData(MeshData& data, const MeshDataStreams& s, size_t vertexCount, const uint32_t* remap,
+                          size_t newCount)
+{
+    using aartze::geometry::MeshOps;
+    std::vector<unsigned char> scratch;
+    for (size_t i = 0; i < s.count; ++i)
+    {
+        const size_t stride = s.streams[i].stride;
+        scratch.resize(newCount * stride);
+        MeshOps::RemapVertexBuffer(scratch.data(), s.streams[i].data, vertexCount, stride, remap);
+        if (s.floats[i]) { s.floats[i]->resize(newCount * stride / sizeof(float)); std::memcpy(s.floats[i]->data(), scratch.data(), scratch.size()); }
+        else { s.ints[i]->resize(newCount * stride / sizeof(int)); std::memcpy(s.ints[i]->data(), scratch.data(), scratch.size()); }
+    }
+    MeshOps::RemapIndexBuffer(data.indices.data(), data.indices.data(), data.indices.size(), remap);
+}
+
+// Merge vertices whose attributes are bit-identical and rewrite `indices` to
+// match. Some loaders emit one vertex per face corner; welding restores sharing so
+// the mesh can be drawn indexed. Indexed input is remapped, unindexed input
+// gets an index list.
+inline void WeldVertices(MeshData& data)
+{
+    using aartze::geometry::MeshOps;
+    const size_t count = data.vertices.size() / 3;
+    if (count == 0) return;
+    if (data.indices.empty())
+    {
+        data.indices.resize(count);
+        for (size_t i = 0; i < count; ++i) data.indices[i] = static_cast<uint32_t>(i);
+    }
+    const MeshDataStreams streams = CollectMeshStreams(data, count);
+    std::vector<uint32_t> remap(count);
+    const size_t unique = MeshOps::Weld(remap.data(), data.indices.data(), data.indices.size(), count,
+                                        streams.streams, streams.count);
+    RemapMeshData(data, streams, count, remap.data(), unique);
+}
+
+// Import-time index optimization: weld, reorder triangles for the
+// post-transform cache and then for overdraw, and finally lay vertices out in
+// the order the index buffer fetches them. Indexed input whose vertices are
+// already shared can skip the weld with `weld` false.
+inline void OptimizeMesh(MeshData& data, bool weld = true)
+{
+    using aartze::geometry::MeshOps;
+    if (weld || data.indices.empty()) WeldVertices(data);
+    const size_t count = data.vertices.size() / 3;
+    const size_t indexCount = data.indices.size() - data.indices.size() % 3;
+    if (indexCount == 0) return;
+    uint32_t* indices = data.indices.data();
+    MeshOps::OptimizeVertexCache(indices, indices, indexCount, count);
+    MeshOps::OptimizeOverdraw(indices, indices, indexCount, data.vertices.data(), count, 3 * sizeof(float));
+
+    const MeshDataStreams streams = CollectMeshStreams(data, count);
+    std::vector<uint32_t> remap(count);
+    const size_t used = MeshOps::OptimizeVertexFetch(remap.data(), indices, data.indices.size(), count);
+    RemapMeshData(data, streams, count, remap.data(), used);
+}
+
+// Append quadric-simplified levels of detail to `indices`. Runs after
+// OptimizeMesh so the levels index the final vertex order; vertices only
+// the coarse levels drop stay in the shared buffer.
+inline void GenerateLods(MeshData& data,
+                         const aartze::geometry::LodChainSettings& settings = aartze::geometry::LodChainSettings{})
+{
+    using aartze::geometry::Simplifier;
+    data.lods.clear();
+    const size_t count = data.vertices.size() / 3;
+    data.indices.resize(data.indices.size() - data.indices.size() % 3);
+    if (count == 0 || data.indices.empty() || settings.maxLevels == 0) return;
+    data.lods.resize(settings.maxLevels);
+    const size_t levels = Simplifier::BuildLodChain(data.indices, data.vertices.data(), count, 3 * sizeof(float),
+                                                    data.lods.data(), settings);
+    data.lods.resize(levels);
+}
 // Normalize vertices to fit in [-1, 1] box
 inline void NormalizeVertices(std::vector<float>& vertices)
 {
@@ -174,16 +297,227 @@ inline std::vector<float> LoadFbxVertices(const std::string& path, bool normaliz
     return vertices;
 }
 
-// Load full FBX model (positions, texcoords, colors)
-#ifndef MESHUTILS_NO_REGISTRY
-inline MeshData LoadFbxModel(const std::string& path, bool normalize = true,
-                             float scaleFactor = 1.0f)
+// Axis-aligned bounds of the positions a loader has written.
+struct MeshBounds
+{
+    float min[3]{std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+                 std::numeric_limits<float>::max()};
+    float max[3]{std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(),
+                 std::numeric_limits<float>::lowest()};
+
+    void Add(const float p[3])
+    {
+        for (int a = 0; a < 3; ++a)
+        {
+            min[a] = std::min(min[a], p[a]);
+            max[a] = std::max(max[a], p[a]);
+        }
+    }
+    void Add(const MeshBounds& other)
+    {
+        for (int a = 0; a < 3; ++a)
+        {
+            min[a] = std::min(min[a], other.min[a]);
+            max[a] = std::max(max[a], other.max[a]);
+        }
+    }
+};
+
+// The loaders' last step: with `normalize`, centre the vertices and scale the
+// largest extent of `bounds` to 2 * scaleFactor; otherwise just scale them.
+inline void FitMeshVertices(MeshData& data, const MeshBounds& bounds, bool normalize, float scaleFactor,
+                            JobSystem& jobs = gJobSystem)
 {
+    const float center[3] = {(bounds.min[0] + bounds.max[0]) * 0.5f, (bounds.min[1] + bounds.max[1]) * 0.5f,
+                             (bounds.min[2] + bounds.max[2]) * 0.5f};
+    const float maxExtent =
+        std::max({bounds.max[0] - bounds.min[0], bounds.max[1] - bounds.min[1], bounds.max[2] - bounds.min[2]});
+    const bool fit = normalize && maxExtent > 0.0f;
+    if (!fit && scaleFactor == 1.0f) return;
+    const float scale = fit ? 2.0f / maxExtent * scaleFactor : scaleFactor;
+    jobs.ParallelFor(0, data.vertices.size() / 3, size_t(1) << 16, [&](size_t begin, size_t end) {
+        float* p = data.vertices.data();
+        for (size_t i = begin * 3; i < end * 3; i += 3)
+            for (int a = 0; a < 3; ++a) p[i + a] = fit ? (p[i + a] - center[a]) * scale : p[i + a] * scale;
+    });
+}
+
+// Convert every triangle of an Assimp scene into one MeshData, keeping the
+// scene's indices. A first pass gives each aiMesh a disjoint range of
+// vertices and of indices (prefix sums over the meshes) and sizes every
+// stream; each mesh's vertices are then copied once and its triangles
+// written as indices offset past the vertices before it, both as parallel
+// jobs over ranges of the pre-sized streams (large meshes split further).
+// Points and lines are skipped. The jobs keep their own bounds, which reduce
+// to the scene's for normalization, which runs in parallel as well. With
+// `useMaterials`, meshes without vertex colours take their material's
+// diffuse colour and texturePaths gets each material's diffuse texture.
+inline MeshData ConvertAssimpScene(const aiScene* scene, const std::string& directory, bool normalize,
+                                   float scaleFactor, bool useMaterials, JobSystem& jobs = gJobSystem)
+{
+    struct VertexRange
+    {
+        unsigned mesh;
+        unsigned first;
+        unsigned last;
+    };
+    struct FaceRange
+    {
+        unsigned mesh;
+        unsigned firstFace;
+        unsigned lastFace;
+        size_t firstIndex;
+    };
+    constexpr unsigned RANGE_VERTICES = 16384;
+    constexpr unsigned RANGE_FACES = 16384;
+
+    // Sizing pass: faces are only scanned for meshes that may hold points or lines.
     MeshData data;
+    std::vector<VertexRange> vertexRanges;
+    std::vector<FaceRange> faceRanges;
+    std::vector<size_t> firstVertex(scene->mNumMeshes);
+    std::vector<aiColor3D> meshColors(scene->mNumMeshes, aiColor3D(1.0f, 1.0f, 1.0f));
+    size_t vertexCount = 0, indexCount = 0;
+    for (unsigned m = 0; m < scene->mNumMeshes; ++m)
+    {
+        const aiMesh* mesh = scene->mMeshes[m];
+        firstVertex[m] = vertexCount;
+        vertexCount += mesh->mNumVertices;
+        for (unsigned v = 0; v < mesh->mNumVertices; v += RANGE_VERTICES)
+            vertexRanges.push_back({m, v, std::min(mesh->mNumVertices, v + RANGE_VERTICES)});
+        if (mesh->mPrimitiveTypes == aiPrimitiveType_TRIANGLE)
+        {
+            for (unsigned f = 0; f < mesh->mNumFaces; f += RANGE_FACES)
+            {
+                const unsigned last = std::min(mesh->mNumFaces, f + RANGE_FACES);
+                faceRanges.push_back({m, f, last, indexCount});
+                indexCount += size_t(last - f) * 3;
+            }
+        }
+        else
+        {
+            size_t triangles = 0;
+            for (unsigned f = 0; f < mesh->mNumFaces; ++f) triangles += mesh->mFaces[f].mNumIndices == 3;
+            faceRanges.push_back({m, 0, mesh->mNumFaces, indexCount});
+            indexCount += triangles * 3;
+        }
+
+        if (!useMaterials || mesh->mMaterialIndex >= scene->mNumMaterials) continue;
+        const aiMaterial* mat = scene->mMaterials[mesh->mMaterialIndex];
+        if (!mesh->HasVertexColors(0)) mat->Get(AI_MATKEY_COLOR_DIFFUSE, meshColors[m]);
+        aiString texPath;
+        if (mat->GetTexture(aiTextureType_DIFFUSE, 0, &texPath) == AI_SUCCESS)
+            data.texturePaths.push_back(directory + texPath.C_Str());
+        else
+            data.texturePaths.emplace_back();
+    }
+    if (vertexCount > std::numeric_limits<uint32_t>::max())
+    {
+        std::cerr << "Assimp scene has too many vertices for 32-bit indices" << std::endl;
+        return {};
+    }
+    data.textureIds.assign(data.texturePaths.size(), 0);
+    data.vertices.resize(vertexCount * 3);
+    data.normals.resize(vertexCount * 3);
+    data.texCoords.resize(vertexCount * 2);
+    data.colors.resize(vertexCount * 3);
+    data.indices.resize(indexCount);
+
+    // Joining identical vertices leaves none that no face uses, so a mesh of
+    // triangles only is bounded by its vertices; one that also holds points
+    // or lines is bounded by its triangle corners instead.
+    std::vector<MeshBounds> vertexBounds(vertexRanges.size());
+    jobs.ParallelFor(0, vertexRanges.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t r = begin; r < end; ++r)
+        {
+            const VertexRange& range = vertexRanges[r];
+            const aiMesh* mesh = scene->mMeshes[range.mesh];
+            const aiVector3D* normals = mesh->HasNormals() ? mesh->mNormals : nullptr;
+            const aiVector3D* uvs = mesh->HasTextureCoords(0) ? mesh->mTextureCoords[0] : nullptr;
+            const aiColor4D* colors = mesh->HasVertexColors(0) ? mesh->mColors[0] : nullptr;
+            const aiColor3D color = meshColors[range.mesh];
+            const bool bound = mesh->mPrimitiveTypes == aiPrimitiveType_TRIANGLE;
+            MeshBounds& bounds = vertexBounds[r];
+            for (unsigned v = range.first; v < range.last; ++v)
+            {
+                const size_t out = firstVertex[range.mesh] + v;
+                const aiVector3D& p = mesh->mVertices[v];
+                float* position = &data.vertices[out * 3];
+                position[0] = p.x;
+                position[1] = p.y;
+                position[2] = p.z;
+                if (bound) bounds.Add(position);
+                const aiVector3D n = normals ? normals[v] : aiVector3D(0.0f, 0.0f, 1.0f);
+                float* normal = &data.normals[out * 3];
+                normal[0] = n.x;
+                normal[1] = n.y;
+                normal[2] = n.z;
+                float* uv = &data.texCoords[out * 2];
+                uv[0] = uvs ? uvs[v].x : 0.0f;
+                uv[1] = uvs ? uvs[v].y : 0.0f;
+                float* rgb = &data.colors[out * 3];
+                rgb[0] = colors ? colors[v].r : color.r;
+                rgb[1] = colors ? colors[v].g : color.g;
+                rgb[2] = colors ? colors[v].b : color.b;
+            }
+        }
+    });
+
+    std::vector<MeshBounds> faceBounds(faceRanges.size());
+    jobs.ParallelFor(0, faceRanges.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t r = begin; r < end; ++r)
+        {
+            const FaceRange& range = faceRanges[r];
+            const aiMesh* mesh = scene->mMeshes[range.mesh];
+            const uint32_t base = static_cast<uint32_t>(firstVertex[range.mesh]);
+            const bool bound = mesh->mPrimitiveTypes != aiPrimitiveType_TRIANGLE;
+            MeshBounds& bounds = faceBounds[r];
+            uint32_t* out = &data.indices[range.firstIndex];
+            for (unsigned f = range.firstFace; f < range.lastFace; ++f)
+            {
+                const aiFace& face = mesh->mFaces[f];
+                if (face.mNumIndices != 3) continue;
+                for (unsigned j = 0; j < 3; ++j)
+                {
+                    const unsigned index = face.mIndices[j];
+                    *out++ = base + index;
+                    if (!bound) continue;
+                    const aiVector3D& p = mesh->mVertices[index];
+                    const float position[3] = {p.x, p.y, p.z};
+                    bounds.Add(position);
+                }
+            }
+        }
+    });
+
+    MeshBounds total;
+    for (const MeshBounds& bounds : vertexBounds) total.Add(bounds);
+    for (const MeshBounds& bounds : faceBounds) total.Add(bounds);
+    FitMeshVertices(data, total, normalize, scaleFactor, jobs);
+    return data;
+}
+
+// Convert, optimize and build the LOD chain for a scene read with
+// ImportAssimpFile's flags. Assimp has already joined its identical
+// vertices, so the weld is skipped.
+inline MeshData ImportAssimpScene(const aiScene* scene, const std::string& directory, bool normalize,
+                                  float scaleFactor, bool useMaterials, JobSystem& jobs = gJobSystem)
+{
+    MeshData data = ConvertAssimpScene(scene, directory, normalize, scaleFactor, useMaterials, jobs);
+    OptimizeMesh(data, false);
+    GenerateLods(data);
+    return data;
+}
+
+// Read `path` with Assimp (triangulated, identical vertices joined, node
+// transforms applied) and import it with ImportAssimpScene.
+inline MeshData ImportAssimpFile(const std::string& path, bool normalize, float scaleFactor, bool useMaterials,
+                                 JobSystem& jobs = gJobSystem)
+{
     if (!std::filesystem::exists(path))
     {
         std::cerr << "Mesh file not found: " << path << std::endl;
-        return data;
+        return {};
     }
     Assimp::Importer importer;
     const aiScene* scene =
@@ -193,125 +527,207 @@ inline MeshData LoadFbxModel(const std::string& path, bool normalize = true,
     {
         std::cerr << "Assimp failed to load " << path << ": "
                   << importer.GetErrorString() << std::endl;
-        return data;
+        return {};
     }
 
-    float minX = std::numeric_limits<float>::max();
-    float minY = std::numeric_limits<float>::max();
-    float minZ = std::numeric_limits<float>::max();
-    float maxX = std::numeric_limits<float>::lowest();
-    float maxY = std::numeric_limits<float>::lowest();
-    float maxZ = std::numeric_limits<float>::lowest();
-
     std::string directory;
     size_t slash = path.find_last_of("/\\");
     if (slash != std::string::npos) directory = path.substr(0, slash + 1);
 
-    for (unsigned int m = 0; m < scene->mNumMeshes; ++m)
+    return ImportAssimpScene(scene, directory, normalize, scaleFactor, useMaterials, jobs);
+}
+
+// Convert every triangle a glTF scene draws into one MeshData, keeping the
+// file's indices instead of writing a vertex per face corner. Each node
+// instance of a mesh appends its primitives' vertices in world space (as
+// aiProcess_PreTransformVertices did on the Assimp path) and their indices,
+// offset past the vertices before them. Strips and fans become lists; points
+// and lines are skipped. V is flipped the way Assimp's glTF importer flips
+// it, and primitives without vertex colours take their material's base
+// colour. Instances are converted as parallel jobs into pre-sized streams.
+inline MeshData ConvertGltfScene(const aartze::importer::GltfScene& scene, bool normalize, float scaleFactor,
+                                 JobSystem& jobs = gJobSystem)
+{
+    using aartze::importer::GltfPrimitive;
+    struct Draw
     {
-        const aiMesh* mesh = scene->mMeshes[m];
-        for (unsigned int i = 0; i < mesh->mNumFaces; ++i)
+        const GltfPrimitive* primitive;
+        const float* world;
+        size_t firstVertex;
+        size_t firstIndex;
+        size_t triangles;
+    };
+    auto triangleCount = [](const GltfPrimitive& p) -> size_t {
+        const size_t n = p.indices.Empty() ? p.vertexCount : p.indices.count;
+        if (p.mode == GltfPrimitive::kTriangles) return n / 3;
+        if (p.mode == GltfPrimitive::kTriangleStrip || p.mode == GltfPrimitive::kTriangleFan) return n > 2 ? n - 2 : 0;
+        return 0;
+    };
+
+    // Sizing pass over the default scene, parents before children.
+    MeshData data;
+    std::vector<Draw> draws;
+    std::vector<int32_t> materials;  // in first-use order
+    size_t vertexCount = 0, indexCount = 0;
+    std::vector<int32_t> stack(scene.roots.rbegin(), scene.roots.rend());
+    while (!stack.empty())
+    {
+        const aartze::importer::GltfNode& node = scene.nodes[stack.back()];
+        stack.pop_back();
+        stack.insert(stack.end(), node.children.rbegin(), node.children.rend());
+        if (node.mesh < 0) continue;
+        for (const GltfPrimitive& p : scene.meshes[node.mesh].primitives)
         {
-            const aiFace& face = mesh->mFaces[i];
-            for (unsigned int j = 0; j < 3; ++j)
+            const size_t triangles = triangleCount(p);
+            if (triangles == 0 || p.positions.Empty()) continue;
+            draws.push_back({&p, node.world, vertexCount, indexCount, triangles});
+            vertexCount += p.vertexCount;
+            indexCount += triangles * 3;
+            if (p.material >= 0 && std::find(materials.begin(), materials.end(), p.material) == materials.end())
+                materials.push_back(p.material);
+        }
+    }
+    if (vertexCount > std::numeric_limits<uint32_t>::max())
+    {
+        std::cerr << "glTF scene has too many vertices for 32-bit indices" << std::endl;
+        return data;
+    }
+    for (int32_t m : materials)
+    {
+        const int32_t texture = scene.materials[m].baseColorTexture.texture;
+        const int32_t image = texture >= 0 ? scene.textures[texture].image : -1;
+        // Images embedded in the file have no path to load them by.
+        data.texturePaths.push_back(image >= 0 ? scene.images[image].path : std::string());
+    }
+    data.textureIds.assign(data.texturePaths.size(), 0);
+    data.vertices.resize(vertexCount * 3);
+    data.normals.resize(vertexCount * 3);
+    data.texCoords.resize(vertexCount * 2);
+    data.colors.resize(vertexCount * 3);
+    data.indices.resize(indexCount);
+
+    std::vector<MeshBounds> drawBounds(draws.size());
+    jobs.ParallelFor(0, draws.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t d = begin; d < end; ++d)
+        {
+            const Draw& draw = draws[d];
+            const GltfPrimitive& p = *draw.primitive;
+            const float* m = draw.world;
+            // Normals go through the inverse transpose of the upper 3x3: its
+            // cofactor matrix, sign-corrected by the determinant.
+            const float* c0 = m;
+            const float* c1 = m + 4;
+            const float* c2 = m + 8;
+            const float cofactor[3][3] = {
+                {c1[1] * c2[2] - c1[2] * c2[1], c1[2] * c2[0] - c1[0] * c2[2], c1[0] * c2[1] - c1[1] * c2[0]},
+                {c2[1] * c0[2] - c2[2] * c0[1], c2[2] * c0[0] - c2[0] * c0[2], c2[0] * c0[1] - c2[1] * c0[0]},
+                {c0[1] * c1[2] - c0[2] * c1[1], c0[2] * c1[0] - c0[0] * c1[2], c0[0] * c1[1] - c0[1] * c1[0]}};
+            const float det = c0[0] * cofactor[0][0] + c0[1] * cofactor[0][1] + c0[2] * cofactor[0][2];
+            const float sign = det < 0.0f ? -1.0f : 1.0f;
+            const aartze::importer::GltfMaterial* material = p.material >= 0 ? &scene.materials[p.material] : nullptr;
+            const float white[3] = {1.0f, 1.0f, 1.0f};
+            const float* baseColor = material ? material->baseColor : white;
+            MeshBounds& bounds = drawBounds[d];
+            for (size_t v = 0; v < p.vertexCount; ++v)
             {
-                unsigned int index = face.mIndices[j];
-                const auto& v = mesh->mVertices[index];
-                data.vertices.push_back(v.x);
-                data.vertices.push_back(v.y);
-                data.vertices.push_back(v.z);
-                aiVector3D n(0.0f, 0.0f, 1.0f);
-                if (mesh->HasNormals())
+                const size_t out = draw.firstVertex + v;
+                const float* src = p.positions.Element(v);
+                float* position = &data.vertices[out * 3];
+                for (int a = 0; a < 3; ++a)
+                    position[a] = m[a] * src[0] + m[4 + a] * src[1] + m[8 + a] * src[2] + m[12 + a];
+                bounds.Add(position);
+
+                float* normal = &data.normals[out * 3];
+                if (p.normals.Empty())
                 {
-                    n = mesh->mNormals[index];
+                    normal[0] = 0.0f;
+                    normal[1] = 0.0f;
+                    normal[2] = 1.0f;
                 }
-                data.normals.push_back(n.x);
-                data.normals.push_back(n.y);
-                data.normals.push_back(n.z);
-
-                // Texcoords
-                aiVector3D uv(0.0f, 0.0f, 0.0f);
-                if (mesh->HasTextureCoords(0))
+                else
                 {
-                    uv = mesh->mTextureCoords[0][index];
-                }
-                data.texCoords.push_back(uv.x);
-                data.texCoords.push_back(uv.y);
-
-                // Colors
-                aiColor3D color(1.0f, 1.0f, 1.0f);
-                if (mesh->HasVertexColors(0))
-                {
-                    const auto& c = mesh->mColors[0][index];
-                    color.r = c.r;
-                    color.g = c.g;
-                    color.b = c.b;
-                }
-                else if (mesh->mMaterialIndex < scene->mNumMaterials)
-                {
-                    scene->mMaterials[mesh->mMaterialIndex]->Get(AI_MATKEY_COLOR_DIFFUSE, color);
-                }
-                data.colors.push_back(color.r);
-                data.colors.push_back(color.g);
-                data.colors.push_back(color.b);
-                for (int bw = 0; bw < 4; ++bw)
-                {
-                    data.boneIndices.push_back(0);
-                    data.boneWeights.push_back(0.0f);
+                    const float* n = p.normals.Element(v);
+                    float length = 0.0f;
+                    for (int a = 0; a < 3; ++a)
+                    {
+                        normal[a] = sign * (cofactor[0][a] * n[0] + cofactor[1][a] * n[1] + cofactor[2][a] * n[2]);
+                        length += normal[a] * normal[a];
+                    }
+                    length = std::sqrt(length);
+                    if (length > 0.0f)
+                        for (int a = 0; a < 3; ++a) normal[a] /= length;
                 }
 
-                // AABB tracking
-                minX = std::min(minX, v.x);
-                minY = std::min(minY, v.y);
-                minZ = std::min(minZ, v.z);
-                maxX = std::max(maxX, v.x);
-                maxY = std::max(maxY, v.y);
-                maxZ = std::max(maxZ, v.z);
+                float* uv = &data.texCoords[out * 2];
+                const bool hasUV = !p.texCoords[0].Empty();
+                uv[0] = hasUV ? p.texCoords[0].Element(v)[0] : 0.0f;
+                uv[1] = hasUV ? 1.0f - p.texCoords[0].Element(v)[1] : 0.0f;
+                const float* color = p.colors.Empty() ? baseColor : p.colors.Element(v);
+                std::copy_n(color, 3, &data.colors[out * 3]);
             }
-        }
 
-        if (mesh->mMaterialIndex < scene->mNumMaterials)
-        {
-            const aiMaterial* mat = scene->mMaterials[mesh->mMaterialIndex];
-            aiString texPath;
-            if (mat->GetTexture(aiTextureType_DIFFUSE, 0, &texPath) == AI_SUCCESS)
+            // A mirroring transform turns the winding inside out; swap it back.
+            const bool mirrored = det < 0.0f;
+            auto at = [&](size_t k) { return p.indices.Empty() ? uint32_t(k) : p.indices.data[k]; };
+            const uint32_t base = static_cast<uint32_t>(draw.firstVertex);
+            uint32_t* out = &data.indices[draw.firstIndex];
+            for (size_t t = 0; t < draw.triangles; ++t, out += 3)
             {
-                std::string full = directory + texPath.C_Str();
-                auto future = AssetLoader::LoadTextureAsync(full);
-                data.textureIds.push_back(future.get());
-            }
-            else
-            {
-                data.textureIds.push_back(0);
+                uint32_t a, b, c;
+                if (p.mode == GltfPrimitive::kTriangles)
+                    a = at(t * 3), b = at(t * 3 + 1), c = at(t * 3 + 2);
+                else if (p.mode == GltfPrimitive::kTriangleStrip)
+                    a = at(t + (t & 1)), b = at(t + 1 - (t & 1)), c = at(t + 2);
+                else
+                    a = at(t + 1), b = at(t + 2), c = at(0);
+                if (mirrored) std::swap(b, c);
+                out[0] = base + a;
+                out[1] = base + b;
+                out[2] = base + c;
             }
         }
-    }
+    });
 
-    float centerX = (minX + maxX) * 0.5f;
-    float centerY = (minY + maxY) * 0.5f;
-    float centerZ = (minZ + maxZ) * 0.5f;
-    float maxExtent = std::max({maxX - minX, maxY - minY, maxZ - minZ});
+    MeshBounds total;
+    for (const MeshBounds& bounds : drawBounds) total.Add(bounds);
+    FitMeshVertices(data, total, normalize, scaleFactor, jobs);
+    return data;
+}
 
-    if (normalize && maxExtent > 0.0f)
-    {
-        float scale = 2.0f / maxExtent * scaleFactor;
-        for (size_t i = 0; i < data.vertices.size(); i += 3)
-        {
-            data.vertices[i] = (data.vertices[i] - centerX) * scale;
-            data.vertices[i + 1] = (data.vertices[i + 1] - centerY) * scale;
-            data.vertices[i + 2] = (data.vertices[i + 2] - centerZ) * scale;
-        }
-    }
-    else
+// Read a .gltf or .glb with the native loader (no Assimp), convert it with
+// ConvertGltfScene, then weld, optimize and build the LOD chain.
+inline MeshData ImportGltfFile(const std::string& path, bool normalize, float scaleFactor)
+{
+    aartze::importer::GltfScene scene;
+    std::string error;
+    if (!aartze::importer::LoadGltf(path, scene, &error))
     {
-        for (size_t i = 0; i < data.vertices.size(); i += 3)
-        {
-            data.vertices[i] *= scaleFactor;
-            data.vertices[i + 1] *= scaleFactor;
-            data.vertices[i + 2] *= scaleFactor;
-        }
+        std::cerr << "glTF load failed: " << error << std::endl;
+        return {};
     }
+    MeshData data = ConvertGltfScene(scene, normalize, scaleFactor);
+    OptimizeMesh(data);
+    GenerateLods(data);
+    return data;
+}
 
+#ifndef MESHUTILS_NO_REGISTRY
+// Fill textureIds from texturePaths through gAssetRegistry.
+inline void RegisterMeshTextures(MeshData& data)
+{
+    data.textureIds.resize(data.texturePaths.size());
+    for (size_t i = 0; i < data.texturePaths.size(); ++i)
+        data.textureIds[i] = data.texturePaths[i].empty() ? 0 : gAssetRegistry.RegisterTexture(data.texturePaths[i]).id;
+}
+#endif // MESHUTILS_NO_REGISTRY
+
+// Load full FBX model (positions, texcoords, colors)
+#ifndef MESHUTILS_NO_REGISTRY
+inline MeshData LoadFbxModel(const std::string& path, bool normalize = true,
+                             float scaleFactor = 1.0f)
+{
+    MeshData data = ImportAssimpFile(path, normalize, scaleFactor, true);
+    RegisterMeshTextures(data);
     return data;
 }
 #endif // MESHUTILS_NO_REGISTRY
@@ -366,6 +782,14 @@ inline MeshData LoadFbxSkinnedModel(const std::string& path)
             }
         }
 
+        for (unsigned int i = 0; i < mesh->mNumFaces; ++i)
+        {
+            const aiFace& face = mesh->mFaces[i];
+            if (face.mNumIndices != 3) continue;
+            for (unsigned int j = 0; j < 3; ++j)
+                data.indices.push_back(static_cast<uint32_t>(vertexOffset + face.mIndices[j]));
+        }
+
         std::vector<std::array<int, 4>> tmpIndices(mesh->mNumVertices);
         std::vector<std::array<float, 4>> tmpWeights(mesh->mNumVertices);
         for (unsigned int b = 0; b < mesh->mNumBones; ++b)
@@ -414,15 +838,18 @@ inline MeshData LoadFbxSkinnedModel(const std::string& path)
             if (mat->GetTexture(aiTextureType_DIFFUSE, 0, &texPath) == AI_SUCCESS)
             {
                 std::string full = std::string(texPath.C_Str());
-                auto future = AssetLoader::LoadTextureAsync(full);
-                data.textureIds.push_back(future.get());
+                data.textureIds.push_back(gAssetRegistry.RegisterTexture(full).id);
+                data.texturePaths.push_back(full);
             }
             else
             {
                 data.textureIds.push_back(0);
+                data.texturePaths.emplace_back();
             }
         }
     }
+    OptimizeMesh(data);
+    GenerateLods(data);
     return data;
 }
 #endif // MESHUTILS_NO_REGISTRY
@@ -432,136 +859,8 @@ inline MeshData LoadFbxSkinnedModel(const std::string& path)
 inline MeshData LoadGltfModel(const std::string& path, bool normalize = true,
                               float scaleFactor = 1.0f)
 {
-    MeshData data;
-    if (!std::filesystem::exists(path))
-    {
-        std::cerr << "Mesh file not found: " << path << std::endl;
-        return data;
-    }
-    Assimp::Importer importer;
-    const aiScene* scene =
-        importer.ReadFile(path, aiProcess_Triangulate | aiProcess_JoinIdenticalVertices |
-                                    aiProcess_PreTransformVertices);
-    if (!scene || !scene->HasMeshes())
-    {
-        std::cerr << "Assimp failed to load " << path << ": "
-                  << importer.GetErrorString() << std::endl;
-        return data;
-    }
-
-    float minX = std::numeric_limits<float>::max();
-    float minY = std::numeric_limits<float>::max();
-    float minZ = std::numeric_limits<float>::max();
-    float maxX = std::numeric_limits<float>::lowest();
-    float maxY = std::numeric_limits<float>::lowest();
-    float maxZ = std::numeric_limits<float>::lowest();
-
-    std::string directory;
-    size_t slash = path.find_last_of("/\\");
-    if (slash != std::string::npos) directory = path.substr(0, slash + 1);
-
-    for (unsigned int m = 0; m < scene->mNumMeshes; ++m)
-    {
-        const aiMesh* mesh = scene->mMeshes[m];
-        for (unsigned int i = 0; i < mesh->mNumFaces; ++i)
-        {
-            const aiFace& face = mesh->mFaces[i];
-            for (unsigned int j = 0; j < 3; ++j)
-            {
-                unsigned int index = face.mIndices[j];
-                const auto& v = mesh->mVertices[index];
-                data.vertices.push_back(v.x);
-                data.vertices.push_back(v.y);
-                data.vertices.push_back(v.z);
-                aiVector3D n(0.0f, 0.0f, 1.0f);
-                if (mesh->HasNormals())
-                {
-                    n = mesh->mNormals[index];
-                }
-                data.normals.push_back(n.x);
-                data.normals.push_back(n.y);
-                data.normals.push_back(n.z);
-
-                aiVector3D uv(0.0f, 0.0f, 0.0f);
-                if (mesh->HasTextureCoords(0))
-                {
-                    uv = mesh->mTextureCoords[0][index];
-                }
-                data.texCoords.push_back(uv.x);
-                data.texCoords.push_back(uv.y);
-
-                aiColor3D color(1.0f, 1.0f, 1.0f);
-                if (mesh->HasVertexColors(0))
-                {
-                    const auto& c = mesh->mColors[0][index];
-                    color.r = c.r;
-                    color.g = c.g;
-                    color.b = c.b;
-                }
-                else if (mesh->mMaterialIndex < scene->mNumMaterials)
-                {
-                    scene->mMaterials[mesh->mMaterialIndex]->Get(AI_MATKEY_COLOR_DIFFUSE, color);
-                }
-                data.colors.push_back(color.r);
-                data.colors.push_back(color.g);
-                data.colors.push_back(color.b);
-                for (int bw = 0; bw < 4; ++bw)
-                {
-                    data.boneIndices.push_back(0);
-                    data.boneWeights.push_back(0.0f);
-                }
-
-                minX = std::min(minX, v.x);
-                minY = std::min(minY, v.y);
-                minZ = std::min(minZ, v.z);
-                maxX = std::max(maxX, v.x);
-                maxY = std::max(maxY, v.y);
-                maxZ = std::max(maxZ, v.z);
-            }
-        }
-
-        if (mesh->mMaterialIndex < scene->mNumMaterials)
-        {
-            const aiMaterial* mat = scene->mMaterials[mesh->mMaterialIndex];
-            aiString texPath;
-            if (mat->GetTexture(aiTextureType_DIFFUSE, 0, &texPath) == AI_SUCCESS)
-            {
-                std::string full = directory + texPath.C_Str();
-                uint32_t texId = RegisterTexture(full);
-                data.textureIds.push_back(texId);
-            }
-            else
-            {
-                data.textureIds.push_back(0);
-            }
-        }
-    }
-
-    float centerX = (minX + maxX) * 0.5f;
-    float centerY = (minY + maxY) * 0.5f;
-    float centerZ = (minZ + maxZ) * 0.5f;
-    float maxExtent = std::max({maxX - minX, maxY - minY, maxZ - minZ});
-
-    if (normalize && maxExtent > 0.0f)
-    {
-        float scale = 2.0f / maxExtent * scaleFactor;
-        for (size_t i = 0; i < data.vertices.size(); i += 3)
-        {
-            data.vertices[i] = (data.vertices[i] - centerX) * scale;
-            data.vertices[i + 1] = (data.vertices[i + 1] - centerY) * scale;
-            data.vertices[i + 2] = (data.vertices[i + 2] - centerZ) * scale;
-        }
-    }
-    else
-    {
-        for (size_t i = 0; i < data.vertices.size(); i += 3)
-        {
-            data.vertices[i] *= scaleFactor;
-            data.vertices[i + 1] *= scaleFactor;
-            data.vertices[i + 2] *= scaleFactor;
-        }
-    }
-
+    MeshData data = ImportGltfFile(path, normalize, scaleFactor);
+    RegisterMeshTextures(data);
     return data;
 }
 #endif // MESHUTILS_NO_REGISTRY
@@ -570,60 +869,6 @@ inline MeshData LoadGltfModel(const std::string& path, bool normalize = true,
 #ifndef MESHUTILS_NO_REGISTRY
 inline MeshData LoadMeshAny(const std::string& path, bool normalize = true, float scaleFactor = 1.0f)
 {
-    MeshData data;
-    if (!std::filesystem::exists(path)) { std::cerr << "Mesh file not found: " << path << std::endl; return data; }
-    Assimp::Importer importer;
-    const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_JoinIdenticalVertices | aiProcess_PreTransformVertices);
-    if (!scene || !scene->HasMeshes()) { std::cerr << "Assimp failed to load " << path << ": " << importer.GetErrorString() << std::endl; return data; }
-
-    float minX=std::numeric_limits<float>::max(), minY=minX, minZ=minX;
-    float maxX=std::numeric_limits<float>::lowest(), maxY=maxX, maxZ=maxX;
-
-    for (unsigned int m = 0; m < scene->mNumMeshes; ++m)
-    {
-        const aiMesh* mesh = scene->mMeshes[m];
-        for (unsigned int i = 0; i < mesh->mNumFaces; ++i)
-        {
-            const aiFace& face = mesh->mFaces[i];
-            for (unsigned int j = 0; j < 3; ++j)
-            {
-                unsigned int index = face.mIndices[j];
-                const auto& v = mesh->mVertices[index];
-                data.vertices.push_back(v.x); data.vertices.push_back(v.y); data.vertices.push_back(v.z);
-                aiVector3D n(0.0f,0.0f,1.0f); if (mesh->HasNormals()) n = mesh->mNormals[index];
-                data.normals.push_back(n.x); data.normals.push_back(n.y); data.normals.push_back(n.z);
-                aiVector3D uv(0.0f,0.0f,0.0f); if (mesh->HasTextureCoords(0)) uv = mesh->mTextureCoords[0][index];
-                data.texCoords.push_back(uv.x); data.texCoords.push_back(uv.y);
-                aiColor3D color(1.0f,1.0f,1.0f); if (mesh->HasVertexColors(0)) { const auto& c = mesh->mColors[0][index]; color = aiColor3D(c.r,c.g,c.b); }
-                data.colors.push_back(color.r); data.colors.push_back(color.g); data.colors.push_back(color.b);
-                for (int bw=0; bw<4; ++bw) { data.boneIndices.push_back(0); data.boneWeights.push_back(0.0f); }
-                minX=std::min(minX,v.x); minY=std::min(minY,v.y); minZ=std::min(minZ,v.z);
-                maxX=std::max(maxX,v.x); maxY=std::max(maxY,v.y); maxZ=std::max(maxZ,v.z);
-            }
-        }
-    }
-
-    float centerX=(minX+maxX)*0.5f, centerY=(minY+maxY)*0.5f, centerZ=(minZ+maxZ)*0.5f;
-    float maxExtent = std::max({maxX - minX, maxY - minY, maxZ - minZ});
-    if (normalize && maxExtent > 0.0f)
-    {
-        float scale = 2.0f/maxExtent * scaleFactor;
-        for (size_t i=0;i<data.vertices.size();i+=3)
-        {
-            data.vertices[i]   = (data.vertices[i]   - centerX) * scale;
-            data.vertices[i+1] = (data.vertices[i+1] - centerY) * scale;
-            data.vertices[i+2] = (data.vertices[i+2] - centerZ) * scale;
-        }
-    }
-    else
-    {
-        for (size_t i=0;i<data.vertices.size();i+=3)
-        {
-            data.vertices[i]   *= scaleFactor;
-            data.vertices[i+1] *= scaleFactor;
-            data.vertices[i+2] *= scaleFactor;
-        }
-    }
-    return data;
+    return ImportAssimpFile(path, normalize, scaleFactor, false);
 }
 #endif // MESHUTILS_NO_REGISTRY
@@ -1,3 +1,529 @@
 #include "BVH.h"
-namespace aartze::geometry { }
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
 
+#include "core/JobSystem.hpp"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define AARTZE_BVH_AVX 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define AARTZE_BVH_SSE 1
+#endif
+
+namespace aartze::geometry {
+
+namespace {
+
+constexpr float kInf = std::numeric_limits<float>::infinity();
+constexpr uint32_t kMaxBins = 32;
+// Ranges at least this large fork their second child / bin in parallel.
+constexpr size_t kParallelSubtree = 4096;
+constexpr size_t kParallelBin = 1u << 16;
+constexpr size_t kBinGrain = 1u << 14;
+// Past this depth splits fall back to the object median, which bounds the
+// tree depth (and the traversal stacks) at about this plus log2(count).
+constexpr uint32_t kMedianDepth = 48;
+
+struct Aabb {
+    float mn[3] = {kInf, kInf, kInf};
+    float mx[3] = {-kInf, -kInf, -kInf};
+    void Grow(const float p[3]) {
+        for (int a = 0; a < 3; ++a) { mn[a] = std::min(mn[a], p[a]); mx[a] = std::max(mx[a], p[a]); }
+    }
+    void Grow(const Aabb& b) {
+        for (int a = 0; a < 3; ++a) { mn[a] = std::min(mn[a], b.mn[a]); mx[a] = std::max(mx[a], b.mx[a]); }
+    }
+    float HalfArea() const {
+        const float x = mx[0] - mn[0], y = mx[1] - mn[1], z = mx[2] - mn[2];
+        return x < 0.0f ? 0.0f : x * y + y * z + z * x;
+    }
+};
+
+struct BuildNode {
+    Aabb box;
+    uint32_t left = 0;  // 0 = leaf (the root is never a child); right = left + 1
+    uint32_t begin = 0, count = 0;
+    uint8_t axis = 0;
+};
+
+struct Bin {
+    Aabb box;
+    uint32_t count = 0;
+};
+
+struct BuildState {
+    const Aabb* boxes;
+    const float* centroids;  // 3 per primitive
+    uint32_t* order;
+    BuildNode* nodes;
+    std::atomic<uint32_t> nodeCount{1};
+    BVHBuildSettings settings;
+};
+
+// Bounds and centroid bounds of order[begin, end).
+void RangeBounds(const BuildState& s, size_t begin, size_t end, Aabb& box, Aabb& centroidBox) {
+    auto accumulate = [&](size_t first, size_t last, Aabb& b, Aabb& c) {
+        for (size_t i = first; i < last; ++i) {
+            const uint32_t p = s.order[i];
+            b.Grow(s.boxes[p]);
+            c.Grow(s.centroids + p * 3);
+        }
+    };
+    if (!s.settings.parallel || end - begin < kParallelBin) { accumulate(begin, end, box, centroidBox); return; }
+    std::mutex merge;
+    gJobSystem.ParallelFor(begin, end, kBinGrain, [&](size_t first, size_t last) {
+        Aabb b, c;
+        accumulate(first, last, b, c);
+        std::lock_guard<std::mutex> lock(merge);
+        box.Grow(b);
+        centroidBox.Grow(c);
+    });
+}
+
+// Bin order[begin, end) on all three axes at once.
+void BinRange(const BuildState& s, size_t begin, size_t end, const Aabb& centroidBox, uint32_t binCount,
+              const float scale[3], Bin (*bins)[kMaxBins]) {
+    auto accumulate = [&](size_t first, size_t last, Bin (*out)[kMaxBins]) {
+        for (size_t i = first; i < last; ++i) {
+            const uint32_t p = s.order[i];
+            for (int a = 0; a < 3; ++a) {
+                const uint32_t b = std::min(binCount - 1, uint32_t((s.centroids[p * 3 + a] - centroidBox.mn[a]) * scale[a]));
+                out[a][b].box.Grow(s.boxes[p]);
+                ++out[a][b].count;
+            }
+        }
+    };
+    if (!s.settings.parallel || end - begin < kParallelBin) { accumulate(begin, end, bins); return; }
+    std::mutex merge;
+    gJobSystem.ParallelFor(begin, end, kBinGrain, [&](size_t first, size_t last) {
+        Bin local[3][kMaxBins];
+        accumulate(first, last, local);
+        std::lock_guard<std::mutex> lock(merge);
+        for (int a = 0; a < 3; ++a)
+            for (uint32_t b = 0; b < binCount; ++b) { bins[a][b].box.Grow(local[a][b].box); bins[a][b].count += local[a][b].count; }
+    });
+}
+
+void Subdivide(BuildState& s, uint32_t nodeIndex, size_t begin, size_t end, uint32_t depth) {
+    BuildNode& node = s.nodes[nodeIndex];
+    Aabb centroidBox;
+    RangeBounds(s, begin, end, node.box, centroidBox);
+    node.begin = uint32_t(begin);
+    node.count = uint32_t(end - begin);
+    const size_t count = end - begin;
+    if (count <= 1) return;
+
+    const uint32_t binCount = std::clamp<uint32_t>(s.settings.bins, 2, kMaxBins);
+    float scale[3];
+    for (int a = 0; a < 3; ++a) {
+        const float extent = centroidBox.mx[a] - centroidBox.mn[a];
+        scale[a] = extent > 0.0f ? binCount / extent * 0.99999f : 0.0f;
+    }
+
+    int bestAxis = -1;
+    uint32_t bestSplit = 0;
+    float bestCost = kInf;
+    if (depth < kMedianDepth) {
+        Bin bins[3][kMaxBins];
+        BinRange(s, begin, end, centroidBox, binCount, scale, bins);
+        for (int a = 0; a < 3; ++a) {
+            if (scale[a] == 0.0f) continue;
+            // Right-to-left sweep stores suffix costs, left-to-right finishes them.
+            float rightCost[kMaxBins];
+            Aabb right;
+            uint32_t rightCount = 0;
+            for (uint32_t b = binCount - 1; b > 0; --b) {
+                right.Grow(bins[a][b].box);
+                rightCount += bins[a][b].count;
+                rightCost[b - 1] = right.HalfArea() * rightCount;
+            }
+            Aabb left;
+            uint32_t leftCount = 0;
+            for (uint32_t b = 0; b + 1 < binCount; ++b) {
+                left.Grow(bins[a][b].box);
+                leftCount += bins[a][b].count;
+                const float cost = left.HalfArea() * leftCount + rightCost[b];
+                if (leftCount > 0 && leftCount < count && cost < bestCost) { bestCost = cost; bestAxis = a; bestSplit = b; }
+            }
+        }
+        // Compare against a leaf in units of one primitive test.
+        const float parentArea = node.box.HalfArea();
+        bestCost = parentArea > 0.0f ? s.settings.traversalCost + bestCost / parentArea : kInf;
+        if (count <= s.settings.maxLeafSize && bestCost >= float(count)) return;
+    }
+
+    size_t middle;
+    if (bestAxis >= 0) {
+        const float mn = centroidBox.mn[bestAxis], sc = scale[bestAxis];
+        middle = std::partition(s.order + begin, s.order + end, [&](uint32_t p) {
+                     return std::min(binCount - 1, uint32_t((s.centroids[p * 3 + bestAxis] - mn) * sc)) <= bestSplit;
+                 }) - s.order;
+    } else {
+        // Coincident centroids or the depth cap: split at the object median.
+        if (count <= s.settings.maxLeafSize) return;
+        bestAxis = 0;
+        for (int a = 1; a < 3; ++a)
+            if (centroidBox.mx[a] - centroidBox.mn[a] > centroidBox.mx[bestAxis] - centroidBox.mn[bestAxis]) bestAxis = a;
+        middle = begin + count / 2;
+        std::nth_element(s.order + begin, s.order + middle, s.order + end,
+                         [&](uint32_t x, uint32_t y) { return s.centroids[x * 3 + bestAxis] < s.centroids[y * 3 + bestAxis]; });
+    }
+
+    const uint32_t left = s.nodeCount.fetch_add(2, std::memory_order_relaxed);
+    node.left = left;
+    node.axis = uint8_t(bestAxis);
+    if (s.settings.parallel && count >= kParallelSubtree) {
+        JobCounter counter;
+        BuildState* state = &s;
+        gJobSystem.Run([state, left, middle, end, depth]() { Subdivide(*state, left + 1, middle, end, depth + 1); }, &counter);
+        Subdivide(s, left, begin, middle, depth + 1);
+        gJobSystem.Wait(counter);
+    } else {
+        Subdivide(s, left, begin, middle, depth + 1);
+        Subdivide(s, left + 1, middle, end, depth + 1);
+    }
+}
+
+inline void Cross(const float a[3], const float b[3], float out[3]) {
+    out[0] = a[1] * b[2] - a[2] * b[1];
+    out[1] = a[2] * b[0] - a[0] * b[2];
+    out[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+inline float Dot(const float a[3], const float b[3]) { return a[0] * b[0] + a[1] * b[1] + a[2] * b[2]; }
+
+// Moller-Trumbore against a stored (v0, e1, e2) triangle, two-sided.
+inline bool IntersectTriangle(const float* tri, const float origin[3], const float dir[3], float tMin, float tMax,
+                              float& t, float& u, float& v) {
+    const float* e1 = tri + 3;
+    const float* e2 = tri + 6;
+    float p[3];
+    Cross(dir, e2, p);
+    const float det = Dot(e1, p);
+    if (det == 0.0f) return false;
+    const float inv = 1.0f / det;
+    const float s[3] = {origin[0] - tri[0], origin[1] - tri[1], origin[2] - tri[2]};
+    u = Dot(s, p) * inv;
+    if (u < 0.0f || u > 1.0f) return false;
+    float q[3];
+    Cross(s, e1, q);
+    v = Dot(dir, q) * inv;
+    if (v < 0.0f || u + v > 1.0f) return false;
+    t = Dot(e2, q) * inv;
+    return t >= tMin && t <= tMax;
+}
+
+// Bit i set when lane i of the packet enters `node` within its [tMin, tMax].
+template <int N>
+uint32_t PacketBoxMask(const BVHNode& node, const float* const origin[3], const float* const invDir[3],
+                       const float* tMin, const float* tMax) {
+    uint32_t mask = 0;
+    int lane = 0;
+#if AARTZE_BVH_AVX
+    for (; lane + 8 <= N; lane += 8) {
+        __m256 nearT = _mm256_loadu_ps(tMin + lane), farT = _mm256_loadu_ps(tMax + lane);
+        for (int a = 0; a < 3; ++a) {
+            const __m256 o = _mm256_loadu_ps(origin[a] + lane), inv = _mm256_loadu_ps(invDir[a] + lane);
+            const __m256 t0 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(node.boundsMin[a]), o), inv);
+            const __m256 t1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(node.boundsMax[a]), o), inv);
+            const __m256 negative = _mm256_cmp_ps(inv, _mm256_setzero_ps(), _CMP_LT_OQ);
+            // NaN slabs (0 * inf) fall through to the accumulated value, the second operand.
+            nearT = _mm256_max_ps(_mm256_blendv_ps(t0, t1, negative), nearT);
+            farT = _mm256_min_ps(_mm256_blendv_ps(t1, t0, negative), farT);
+        }
+        mask |= uint32_t(_mm256_movemask_ps(_mm256_cmp_ps(nearT, farT, _CMP_LE_OQ))) << lane;
+    }
+#endif
+#if AARTZE_BVH_SSE
+    for (; lane + 4 <= N; lane += 4) {
+        __m128 nearT = _mm_loadu_ps(tMin + lane), farT = _mm_loadu_ps(tMax + lane);
+        for (int a = 0; a < 3; ++a) {
+            const __m128 o = _mm_loadu_ps(origin[a] + lane), inv = _mm_loadu_ps(invDir[a] + lane);
+            const __m128 t0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.boundsMin[a]), o), inv);
+            const __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.boundsMax[a]), o), inv);
+            const __m128 negative = _mm_cmplt_ps(inv, _mm_setzero_ps());
+            const __m128 near = _mm_or_ps(_mm_and_ps(negative, t1), _mm_andnot_ps(negative, t0));
+            const __m128 far = _mm_or_ps(_mm_and_ps(negative, t0), _mm_andnot_ps(negative, t1));
+            nearT = _mm_max_ps(near, nearT);
+            farT = _mm_min_ps(far, farT);
+        }
+        mask |= uint32_t(_mm_movemask_ps(_mm_cmple_ps(nearT, farT))) << lane;
+    }
+#endif
+    for (; lane < N; ++lane) {
+        const float o[3] = {origin[0][lane], origin[1][lane], origin[2][lane]};
+        const float inv[3] = {invDir[0][lane], invDir[1][lane], invDir[2][lane]};
+        if (RayBoxEntry(node, o, inv, tMin[lane], tMax[lane]) != kInf) mask |= 1u << lane;
+    }
+    return mask;
+}
+
+}
+
+void BVH::Build(const float* positions, size_t positionStride, const uint32_t* indices, size_t triangleCount,
+                const BVHBuildSettings& settings) {
+    indices_.assign(indices, indices + triangleCount * 3);
+    bounds_.clear();
+    const size_t floatStride = positionStride / sizeof(float);
+    std::vector<float> boxes(triangleCount * 6);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        Aabb box;
+        for (int k = 0; k < 3; ++k) box.Grow(positions + indices[t * 3 + k] * floatStride);
+        std::memcpy(&boxes[t * 6], box.mn, sizeof(box.mn));
+        std::memcpy(&boxes[t * 6 + 3], box.mx, sizeof(box.mx));
+    }
+    BuildNodes(boxes.data(), triangleCount, settings);
+    StoreTriangles(positions, positionStride);
+}
+
+void BVH::BuildFromBounds(const float* bounds, size_t count, const BVHBuildSettings& settings) {
+    indices_.clear();
+    triangles_.clear();
+    BuildNodes(bounds, count, settings);
+    bounds_.resize(count * 6);
+    for (size_t slot = 0; slot < count; ++slot) std::memcpy(&bounds_[slot * 6], bounds + primitives_[slot] * 6, 6 * sizeof(float));
+}
+
+void BVH::BuildNodes(const float* primitiveBounds, size_t count, const BVHBuildSettings& settings) {
+    nodes_.clear();
+    primitives_.clear();
+    if (count == 0) return;
+
+    std::vector<Aabb> boxes(count);
+    std::vector<float> centroids(count * 3);
+    std::vector<uint32_t> order(count);
+    for (size_t p = 0; p < count; ++p) {
+        std::memcpy(boxes[p].mn, primitiveBounds + p * 6, 3 * sizeof(float));
+        std::memcpy(boxes[p].mx, primitiveBounds + p * 6 + 3, 3 * sizeof(float));
+        for (int a = 0; a < 3; ++a) centroids[p * 3 + a] = 0.5f * (boxes[p].mn[a] + boxes[p].mx[a]);
+        order[p] = uint32_t(p);
+    }
+    std::vector<BuildNode> nodes(count * 2);
+    BuildState state;
+    state.boxes = boxes.data();
+    state.centroids = centroids.data();
+    state.order = order.data();
+    state.nodes = nodes.data();
+    state.settings = settings;
+    state.settings.maxLeafSize = std::clamp<uint32_t>(settings.maxLeafSize, 1, 0xFFFF);
+    Subdivide(state, 0, 0, count, 0);
+
+    // Flatten depth-first so the first child follows its parent; the second
+    // child's index is patched in once it is emitted.
+    nodes_.reserve(state.nodeCount.load());
+    std::vector<std::pair<uint32_t, uint32_t>> stack{{0u, ~0u}};  // (build node, parent to patch)
+    while (!stack.empty()) {
+        const auto [source, parent] = stack.back();
+        stack.pop_back();
+        const uint32_t index = uint32_t(nodes_.size());
+        if (parent != ~0u) nodes_[parent].offset = index;
+        const BuildNode& b = nodes[source];
+        BVHNode out{};
+        std::memcpy(out.boundsMin, b.box.mn, sizeof(out.boundsMin));
+        std::memcpy(out.boundsMax, b.box.mx, sizeof(out.boundsMax));
+        out.axis = b.axis;
+        if (b.left) {
+            stack.push_back({b.left + 1, index});
+            stack.push_back({b.left, ~0u});
+        } else {
+            out.offset = b.begin;
+            out.count = uint16_t(b.count);
+        }
+        nodes_.push_back(out);
+    }
+    primitives_ = std::move(order);
+}
+
+void BVH::StoreTriangles(const float* positions, size_t positionStride) {
+    const size_t floatStride = positionStride / sizeof(float);
+    triangles_.resize(primitives_.size() * 9);
+    for (size_t slot = 0; slot < primitives_.size(); ++slot) {
+        const uint32_t* tri = &indices_[primitives_[slot] * 3];
+        const float* v0 = positions + tri[0] * floatStride;
+        const float* v1 = positions + tri[1] * floatStride;
+        const float* v2 = positions + tri[2] * floatStride;
+        float* out = &triangles_[slot * 9];
+        for (int a = 0; a < 3; ++a) { out[a] = v0[a]; out[3 + a] = v1[a] - v0[a]; out[6 + a] = v2[a] - v0[a]; }
+    }
+}
+
+void BVH::Refit(const float* positions, size_t positionStride) {
+    if (indices_.empty()) return;
+    StoreTriangles(positions, positionStride);
+    RefitNodes();
+}
+
+void BVH::RefitBounds(const float* bounds) {
+    if (bounds_.empty()) return;
+    for (size_t slot = 0; slot < primitives_.size(); ++slot) std::memcpy(&bounds_[slot * 6], bounds + primitives_[slot] * 6, 6 * sizeof(float));
+    RefitNodes();
+}
+
+void BVH::RefitNodes() {
+    // Children always follow their parent, so a reverse sweep sees them first.
+    for (size_t i = nodes_.size(); i-- > 0;) {
+        BVHNode& node = nodes_[i];
+        Aabb box;
+        if (node.count) {
+            for (uint32_t slot = node.offset; slot < node.offset + node.count; ++slot) {
+                if (!triangles_.empty()) {
+                    const float* t = &triangles_[slot * 9];
+                    const float v1[3] = {t[0] + t[3], t[1] + t[4], t[2] + t[5]};
+                    const float v2[3] = {t[0] + t[6], t[1] + t[7], t[2] + t[8]};
+                    box.Grow(t);
+                    box.Grow(v1);
+                    box.Grow(v2);
+                } else {
+                    box.Grow(&bounds_[slot * 6]);
+                    box.Grow(&bounds_[slot * 6 + 3]);
+                }
+            }
+        } else {
+            for (const BVHNode* child : {&nodes_[i + 1], &nodes_[node.offset]}) {
+                box.Grow(child->boundsMin);
+                box.Grow(child->boundsMax);
+            }
+        }
+        std::memcpy(node.boundsMin, box.mn, sizeof(box.mn));
+        std::memcpy(node.boundsMax, box.mx, sizeof(box.mx));
+    }
+}
+
+bool BVH::Intersect(const Ray& ray, RayHit& hit) const {
+    hit = RayHit{};
+    if (triangles_.empty()) return false;
+    const float invDir[3] = {1.0f / ray.direction[0], 1.0f / ray.direction[1], 1.0f / ray.direction[2]};
+    float tMax = ray.tMax;
+    if (RayBoxEntry(nodes_[0], ray.origin, invDir, ray.tMin, tMax) == kInf) return false;
+    uint32_t stack[96];
+    int depth = 0;
+    uint32_t index = 0;
+    for (;;) {
+        const BVHNode& node = nodes_[index];
+        if (node.count) {
+            for (uint32_t slot = node.offset; slot < node.offset + node.count; ++slot) {
+                float t, u, v;
+                if (IntersectTriangle(&triangles_[slot * 9], ray.origin, ray.direction, ray.tMin, tMax, t, u, v)) {
+                    tMax = t;
+                    hit.primitive = primitives_[slot];
+                    hit.t = t; hit.u = u; hit.v = v;
+                }
+            }
+        } else {
+            uint32_t nearChild = index + 1, farChild = node.offset;
+            float tNear = RayBoxEntry(nodes_[nearChild], ray.origin, invDir, ray.tMin, tMax);
+            float tFar = RayBoxEntry(nodes_[farChild], ray.origin, invDir, ray.tMin, tMax);
+            if (tFar < tNear) { std::swap(nearChild, farChild); std::swap(tNear, tFar); }
+            if (tNear != kInf) {
+                if (tFar != kInf) stack[depth++] = farChild;
+                index = nearChild;
+                continue;
+            }
+        }
+        if (depth == 0) break;
+        index = stack[--depth];
+    }
+    return hit.Hit();
+}
+
+bool BVH::Occluded(const Ray& ray) const {
+    if (triangles_.empty()) return false;
+    const float invDir[3] = {1.0f / ray.direction[0], 1.0f / ray.direction[1], 1.0f / ray.direction[2]};
+    uint32_t stack[96];
+    int depth = 0;
+    stack[depth++] = 0;
+    while (depth) {
+        const uint32_t index = stack[--depth];
+        const BVHNode& node = nodes_[index];
+        if (RayBoxEntry(node, ray.origin, invDir, ray.tMin, ray.tMax) == kInf) continue;
+        if (node.count) {
+            for (uint32_t slot = node.offset; slot < node.offset + node.count; ++slot) {
+                float t, u, v;
+                if (IntersectTriangle(&triangles_[slot * 9], ray.origin, ray.direction, ray.tMin, ray.tMax, t, u, v)) return true;
+            }
+        } else {
+            // Order by direction sign only; any hit ends the walk, so exact distances don't matter.
+            const bool reverse = ray.direction[node.axis] < 0.0f;
+            stack[depth++] = reverse ? index + 1 : node.offset;
+            stack[depth++] = reverse ? node.offset : index + 1;
+        }
+    }
+    return false;
+}
+
+template <int N>
+uint32_t BVH::TracePacket(const RayPacket<N>& packet, RayPacket<N>* closest) const {
+    alignas(32) float invX[N], invY[N], invZ[N];
+    float dirSum[3] = {0.0f, 0.0f, 0.0f};
+    uint32_t active = 0;
+    for (int i = 0; i < N; ++i) {
+        invX[i] = 1.0f / packet.dx[i];
+        invY[i] = 1.0f / packet.dy[i];
+        invZ[i] = 1.0f / packet.dz[i];
+        if (closest) closest->primitive[i] = RayHit::kNone;
+        if (packet.tMin[i] <= packet.tMax[i]) {
+            active |= 1u << i;
+            dirSum[0] += packet.dx[i]; dirSum[1] += packet.dy[i]; dirSum[2] += packet.dz[i];
+        }
+    }
+    if (triangles_.empty() || !active) return 0;
+    const float* origin[3] = {packet.ox, packet.oy, packet.oz};
+    const float* invDir[3] = {invX, invY, invZ};
+    // Closest-hit lanes shrink their own tMax; any-hit lanes work on a copy
+    // and retire from `active` at the first blocker.
+    float anyHitMax[N];
+    std::memcpy(anyHitMax, packet.tMax, sizeof(anyHitMax));
+    float* tMax = closest ? closest->tMax : anyHitMax;
+    uint32_t occluded = 0;
+
+    uint32_t stack[96];
+    int depth = 0;
+    stack[depth++] = 0;
+    while (depth) {
+        const uint32_t index = stack[--depth];
+        const BVHNode& node = nodes_[index];
+        const uint32_t mask = PacketBoxMask<N>(node, origin, invDir, packet.tMin, tMax) & active;
+        if (!mask) continue;
+        if (node.count) {
+            for (uint32_t slot = node.offset; slot < node.offset + node.count; ++slot) {
+                const float* tri = &triangles_[slot * 9];
+                for (uint32_t lanes = mask; lanes; lanes &= lanes - 1) {
+                    int i = 0;
+                    while (!(lanes & (1u << i))) ++i;
+                    const float o[3] = {packet.ox[i], packet.oy[i], packet.oz[i]};
+                    const float d[3] = {packet.dx[i], packet.dy[i], packet.dz[i]};
+                    float t, u, v;
+                    if (!IntersectTriangle(tri, o, d, packet.tMin[i], tMax[i], t, u, v)) continue;
+                    if (!closest) {
+                        occluded |= 1u << i;
+                        active &= ~(1u << i);
+                        continue;
+                    }
+                    tMax[i] = t;
+                    closest->primitive[i] = primitives_[slot];
+                    closest->u[i] = u;
+                    closest->v[i] = v;
+                }
+            }
+            if (!active) return occluded;
+        } else {
+            // Nearer child by the packet's mean direction goes on top.
+            const bool reverse = dirSum[node.axis] < 0.0f;
+            stack[depth++] = reverse ? index + 1 : node.offset;
+            stack[depth++] = reverse ? node.offset : index + 1;
+        }
+    }
+    return occluded;
+}
+
+void BVH::Intersect(RayPacket<4>& packet) const { TracePacket(packet, &packet); }
+void BVH::Intersect(RayPacket<8>& packet) const { TracePacket(packet, &packet); }
+uint32_t BVH::Occluded(const RayPacket<4>& packet) const { return TracePacket<4>(packet, nullptr); }
+uint32_t BVH::Occluded(const RayPacket<8>& packet) const { return TracePacket<8>(packet, nullptr); }
+
+}
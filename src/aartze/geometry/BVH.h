@@ -1,5 +1,162 @@
 #pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
 namespace aartze::geometry {
-struct BVH { int nodes=0; };
+
+struct Ray {
+    float origin[3];
+    float direction[3];  // need not be unit length; t is measured in multiples of it
+    float tMin = 0.0f;
+    float tMax = std::numeric_limits<float>::infinity();
+};
+
+struct RayHit {
+    static constexpr uint32_t kNone = ~0u;
+    uint32_t primitive = kNone;  // triangle index as passed to Build
+    float t = 0.0f;
+    float u = 0.0f, v = 0.0f;  // barycentric weights of the triangle's second and third vertex
+    bool Hit() const { return primitive != kNone; }
+};
+
+// N coherent rays (camera rays through neighbouring pixels, shadow rays to
+// one light) in SoA layout, N = 4 or 8. A lane with tMax < tMin is inactive.
+// Intersect writes primitive/u/v per lane and shrinks tMax to the hit distance.
+template <int N>
+struct RayPacket {
+    float ox[N], oy[N], oz[N];
+    float dx[N], dy[N], dz[N];
+    float tMin[N], tMax[N];
+    uint32_t primitive[N];
+    float u[N], v[N];
+};
+
+// Flattened depth-first: an interior node's first child directly follows it,
+// so the common descent is a sequential read.
+struct BVHNode {
+    float boundsMin[3];
+    uint32_t offset;  // leaf: first primitive slot; interior: index of the second child
+    float boundsMax[3];
+    uint16_t count;   // primitives in the leaf, 0 for interior nodes
+    uint8_t axis;     // split axis, to visit the nearer child first
+    uint8_t pad;
+};
+static_assert(sizeof(BVHNode) == 32, "BVHNode should stay two nodes per cache line");
+
+struct BVHBuildSettings {
+    uint32_t bins = 16;          // SAH candidate planes per axis are bins - 1
+    uint32_t maxLeafSize = 16;   // leaves may hold fewer when a split is cheaper
+    float traversalCost = 1.0f;  // relative to one primitive test
+    bool parallel = true;        // fork subtrees and bin large ranges on gJobSystem
+};
+
+/**
+ * Bounding volume hierarchy built with the binned surface area heuristic.
+ * Triangle mode (Build) answers closest-hit and any-hit queries for single
+ * rays and packets, keeping its own leaf-ordered copy of the triangles.
+ * Bounds mode (BuildFromBounds) indexes arbitrary boxes, e.g. object
+ * instances of a scene, and hands leaf primitives to a Traverse callback.
+ * Queries are const and safe to run from many threads; Build and Refit are not.
+ */
+class BVH {
+public:
+    // `positions` is xyz floats, `positionStride` bytes apart; `indices` has 3 per triangle.
+    void Build(const float* positions, size_t positionStride, const uint32_t* indices, size_t triangleCount,
+               const BVHBuildSettings& settings = {});
+    // `bounds` holds min xyz, max xyz per primitive.
+    void BuildFromBounds(const float* bounds, size_t count, const BVHBuildSettings& settings = {});
+
+    // Recompute node bounds for moved vertices or boxes; topology stays as
+    // built, so trees refit through large deformations trace slower.
+    void Refit(const float* positions, size_t positionStride);
+    void RefitBounds(const float* bounds);
+
+    bool Intersect(const Ray& ray, RayHit& hit) const;  // closest hit
+    bool Occluded(const Ray& ray) const;               // any hit in [tMin, tMax]
+    void Intersect(RayPacket<4>& packet) const;
+    void Intersect(RayPacket<8>& packet) const;
+    uint32_t Occluded(const RayPacket<4>& packet) const;  // bit i set: lane i blocked
+    uint32_t Occluded(const RayPacket<8>& packet) const;
+
+    // Visit leaf primitives whose boxes the ray enters, roughly front to back.
+    // visit(uint32_t primitive, float& tMax) may shrink tMax to prune the
+    // rest of the walk; returning true stops it.
+    template <class Visit>
+    void Traverse(const Ray& ray, Visit&& visit) const;
+
+    bool Empty() const { return nodes_.empty(); }
+    size_t NodeCount() const { return nodes_.size(); }
+    size_t PrimitiveCount() const { return primitives_.size(); }
+    // Heap bytes held by the tree and its copies of the primitives.
+    size_t MemoryBytes() const {
+        return nodes_.capacity() * sizeof(BVHNode) +
+               (primitives_.capacity() + indices_.capacity()) * sizeof(uint32_t) +
+               (triangles_.capacity() + bounds_.capacity()) * sizeof(float);
+    }
+    const std::vector<BVHNode>& Nodes() const { return nodes_; }
+    // Primitive id stored in leaf slot `slot`.
+    uint32_t Primitive(size_t slot) const { return primitives_[slot]; }
+
+private:
+    void BuildNodes(const float* primitiveBounds, size_t count, const BVHBuildSettings& settings);
+    void RefitNodes();
+    void StoreTriangles(const float* positions, size_t positionStride);
+    // Closest hit into *closest (which may alias packet), or any hit when null; returns the any-hit mask.
+    template <int N> uint32_t TracePacket(const RayPacket<N>& packet, RayPacket<N>* closest) const;
+
+    std::vector<BVHNode> nodes_;
+    std::vector<uint32_t> primitives_;  // leaf slot -> primitive id
+    std::vector<float> triangles_;      // leaf slot -> v0, v1 - v0, v2 - v0 (9 floats)
+    std::vector<uint32_t> indices_;     // triangle mode: source indices, kept for Refit
+    std::vector<float> bounds_;         // bounds mode: leaf slot -> min xyz, max xyz
+};
+
+// Entry distance of the ray into `node`, or +inf if it misses [tMin, tMax].
+// invDir components are inf for axis-parallel rays; a ray lying in a slab
+// plane gives 0 * inf = NaN there, which the comparisons below skip.
+inline float RayBoxEntry(const BVHNode& node, const float origin[3], const float invDir[3], float tMin, float tMax) {
+    for (int a = 0; a < 3; ++a) {
+        const float t0 = (node.boundsMin[a] - origin[a]) * invDir[a];
+        const float t1 = (node.boundsMax[a] - origin[a]) * invDir[a];
+        const float nearT = invDir[a] < 0.0f ? t1 : t0, farT = invDir[a] < 0.0f ? t0 : t1;
+        if (nearT > tMin) tMin = nearT;
+        if (farT < tMax) tMax = farT;
+    }
+    return tMin <= tMax ? tMin : std::numeric_limits<float>::infinity();
+}
+
+template <class Visit>
+void BVH::Traverse(const Ray& ray, Visit&& visit) const {
+    if (nodes_.empty()) return;
+    const float invDir[3] = {1.0f / ray.direction[0], 1.0f / ray.direction[1], 1.0f / ray.direction[2]};
+    float tMax = ray.tMax;
+    if (RayBoxEntry(nodes_[0], ray.origin, invDir, ray.tMin, tMax) == std::numeric_limits<float>::infinity()) return;
+    uint32_t stack[96];
+    int depth = 0;
+    uint32_t index = 0;
+    for (;;) {
+        const BVHNode& node = nodes_[index];
+        if (node.count) {
+            for (uint32_t i = node.offset; i < node.offset + node.count; ++i)
+                if (visit(primitives_[i], tMax)) return;
+        } else {
+            uint32_t nearChild = index + 1, farChild = node.offset;
+            float tNear = RayBoxEntry(nodes_[nearChild], ray.origin, invDir, ray.tMin, tMax);
+            float tFar = RayBoxEntry(nodes_[farChild], ray.origin, invDir, ray.tMin, tMax);
+            if (tFar < tNear) { std::swap(nearChild, farChild); std::swap(tNear, tFar); }
+            if (tNear != std::numeric_limits<float>::infinity()) {
+                if (tFar != std::numeric_limits<float>::infinity()) stack[depth++] = farChild;
+                index = nearChild;
+                continue;
+            }
+        }
+        if (depth == 0) return;
+        index = stack[--depth];
+    }
 }
 
+}
@@ -0,0 +1,573 @@
+#include "ClusterHierarchy.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "Simplify.h"
+#include "core/JobSystem.hpp"
+
+namespace aartze::geometry {
+
+namespace {
+
+constexpr float kInfinity = std::numeric_limits<float>::infinity();
+
+constexpr uint32_t kNone = ~0u;
+
+// A group simplification that keeps more than this fraction of its triangles
+// (mostly locked border) is not worth a level; its clusters join neighbouring
+// groups instead.
+constexpr float kMinGroupReduction = 0.85f;
+
+// Groups are simplified in parallel, this many per job.
+constexpr size_t kGroupGrain = 4;
+
+struct Sphere {
+    float center[3];
+    float radius;
+};
+
+// Sphere around the AABB of the spheres, grown to enclose all of them.
+Sphere Enclose(size_t count, const float* const* centers, const float* radii) {
+    Sphere s{{0.0f, 0.0f, 0.0f}, 0.0f};
+    if (count == 0) return s;
+    float mn[3], mx[3];
+    for (int a = 0; a < 3; ++a) { mn[a] = kInfinity; mx[a] = -kInfinity; }
+    for (size_t i = 0; i < count; ++i)
+        for (int a = 0; a < 3; ++a) {
+            mn[a] = std::min(mn[a], centers[i][a] - radii[i]);
+            mx[a] = std::max(mx[a], centers[i][a] + radii[i]);
+        }
+    for (int a = 0; a < 3; ++a) s.center[a] = 0.5f * (mn[a] + mx[a]);
+    for (size_t i = 0; i < count; ++i) {
+        const float d[3] = {centers[i][0] - s.center[0], centers[i][1] - s.center[1], centers[i][2] - s.center[2]};
+        s.radius = std::max(s.radius, std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]) + radii[i]);
+    }
+    return s;
+}
+
+float Distance(const float a[3], const float b[3]) {
+    const float d[3] = {a[0] - b[0], a[1] - b[1], a[2] - b[2]};
+    return std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+}
+
+// Error in pixels of `error` seen on a sphere, taken at its nearest point.
+float ProjectedError(const ClusterView& view, const float center[3], float radius, float error) {
+    const float distance = std::max(Distance(center, view.eye) - radius, view.zNear);
+    return error * view.pixelScale / distance;
+}
+
+bool SphereInFrustum(const ClusterView& view, const float center[3], float radius) {
+    for (const float* p : view.planes)
+        if (p[0] * center[0] + p[1] * center[1] + p[2] * center[2] + p[3] < -radius) return false;
+    return true;
+}
+
+bool Backfacing(const ClusterView& view, const MeshletBounds& b) {
+    if (b.coneCutoff >= 1.0f) return false;
+    const float d[3] = {b.coneApex[0] - view.eye[0], b.coneApex[1] - view.eye[1], b.coneApex[2] - view.eye[2]};
+    const float length = std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+    return d[0] * b.coneAxis[0] + d[1] * b.coneAxis[1] + d[2] * b.coneAxis[2] >= b.coneCutoff * length;
+}
+
+// Clusters of one round, by position in the round's list, as a graph: two
+// clusters are neighbours when they share vertices, weighted by how many.
+struct ClusterGraph {
+    std::vector<uint32_t> offsets;                          // CSR
+    std::vector<std::pair<uint32_t, uint32_t>> neighbours;  // (neighbour, shared vertex count)
+};
+
+ClusterGraph BuildClusterGraph(const std::vector<Cluster>& clusters, const std::vector<uint32_t>& level,
+                               const std::vector<uint32_t>& indices) {
+    // (vertex, cluster) pairs, unique per cluster; clusters meeting at a vertex are neighbours.
+    std::vector<std::pair<uint32_t, uint32_t>> corners;
+    std::vector<uint32_t> vertices;
+    for (uint32_t c = 0; c < level.size(); ++c) {
+        const Cluster& cluster = clusters[level[c]];
+        vertices.assign(indices.begin() + cluster.firstIndex, indices.begin() + cluster.firstIndex + cluster.indexCount);
+        std::sort(vertices.begin(), vertices.end());
+        vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+        for (uint32_t v : vertices) corners.push_back({v, c});
+    }
+    std::sort(corners.begin(), corners.end());
+    std::vector<std::pair<uint32_t, uint32_t>> links;
+    for (size_t i = 0; i < corners.size();) {
+        size_t j = i;
+        while (j < corners.size() && corners[j].first == corners[i].first) ++j;
+        for (size_t a = i; a < j; ++a)
+            for (size_t b = i; b < j; ++b)
+                if (a != b) links.push_back({corners[a].second, corners[b].second});
+        i = j;
+    }
+    std::sort(links.begin(), links.end());
+
+    ClusterGraph graph;
+    graph.offsets.assign(level.size() + 1, 0);
+    for (size_t i = 0; i < links.size();) {
+        size_t j = i;
+        while (j < links.size() && links[j] == links[i]) ++j;
+        graph.neighbours.push_back({links[i].second, uint32_t(j - i)});
+        ++graph.offsets[links[i].first + 1];
+        i = j;
+    }
+    for (size_t c = 0; c < level.size(); ++c) graph.offsets[c + 1] += graph.offsets[c];
+    return graph;
+}
+
+// Of the groups `accept` allows, the one sharing the most vertices with
+// `members`; kNone if none of them is adjacent.
+template <class Accept>
+uint32_t AdjacentGroup(const ClusterGraph& graph, const std::vector<uint32_t>& groupOf, const uint32_t* members,
+                       size_t count, Accept&& accept) {
+    std::vector<std::pair<uint32_t, uint32_t>> candidates;
+    for (size_t m = 0; m < count; ++m)
+        for (uint32_t k = graph.offsets[members[m]]; k < graph.offsets[members[m] + 1]; ++k) {
+            const uint32_t group = groupOf[graph.neighbours[k].first];
+            if (group != kNone && accept(group)) candidates.push_back({group, graph.neighbours[k].second});
+        }
+    std::sort(candidates.begin(), candidates.end());
+    uint32_t best = kNone, bestShared = 0;
+    for (size_t i = 0; i < candidates.size();) {
+        size_t j = i;
+        uint32_t shared = 0;
+        for (; j < candidates.size() && candidates[j].first == candidates[i].first; ++j) shared += candidates[j].second;
+        if (shared > bestShared) { best = candidates[i].first; bestShared = shared; }
+        i = j;
+    }
+    return best;
+}
+
+// Partition the graph's clusters into groups of up to `groupSize`
+// neighbours, growing each group along the clusters it shares the most
+// border vertices with. Each group is seeded next to the one before, at the
+// free neighbour with the fewest free neighbours of its own, so the
+// partition sweeps the surface instead of stranding single clusters between
+// groups. A group left at half size or less joins the adjacent group it
+// shares the most with.
+std::vector<std::vector<uint32_t>> GroupClusters(const ClusterGraph& graph, size_t groupSize) {
+    const uint32_t clusterCount = uint32_t(graph.offsets.size() - 1);
+    std::vector<std::vector<uint32_t>> groups;
+    std::vector<uint32_t> groupOf(clusterCount, kNone);
+    std::vector<uint32_t> frontier;  // free neighbours of earlier groups, latest last
+    uint32_t scan = 0;
+    auto freeNeighbours = [&](uint32_t c) {
+        uint32_t count = 0;
+        for (uint32_t k = graph.offsets[c]; k < graph.offsets[c + 1]; ++k) count += groupOf[graph.neighbours[k].first] == kNone;
+        return count;
+    };
+    auto nextSeed = [&]() {
+        uint32_t best = kNone, bestFree = ~0u;
+        if (!groups.empty())
+            for (uint32_t member : groups.back())
+                for (uint32_t k = graph.offsets[member]; k < graph.offsets[member + 1]; ++k) {
+                    const uint32_t c = graph.neighbours[k].first;
+                    if (groupOf[c] != kNone) continue;
+                    const uint32_t free = freeNeighbours(c);
+                    if (free < bestFree) { best = c; bestFree = free; }
+                }
+        if (best != kNone) return best;
+        while (!frontier.empty()) {
+            const uint32_t c = frontier.back();
+            frontier.pop_back();
+            if (groupOf[c] == kNone) return c;
+        }
+        while (scan < clusterCount && groupOf[scan] != kNone) ++scan;
+        return scan < clusterCount ? scan : kNone;
+    };
+
+    std::vector<std::pair<uint32_t, uint32_t>> candidates;
+    for (uint32_t seed = nextSeed(); seed != kNone; seed = nextSeed()) {
+        const uint32_t id = uint32_t(groups.size());
+        std::vector<uint32_t> group{seed};
+        groupOf[seed] = id;
+        while (group.size() < groupSize) {
+            candidates.clear();
+            for (uint32_t member : group)
+                for (uint32_t k = graph.offsets[member]; k < graph.offsets[member + 1]; ++k)
+                    if (groupOf[graph.neighbours[k].first] == kNone) candidates.push_back(graph.neighbours[k]);
+            if (candidates.empty()) break;
+            std::sort(candidates.begin(), candidates.end());
+            uint32_t best = candidates[0].first, bestShared = 0;
+            for (size_t i = 0; i < candidates.size();) {
+                size_t j = i;
+                uint32_t shared = 0;
+                for (; j < candidates.size() && candidates[j].first == candidates[i].first; ++j) shared += candidates[j].second;
+                if (shared > bestShared) { best = candidates[i].first; bestShared = shared; }
+                i = j;
+            }
+            group.push_back(best);
+            groupOf[best] = id;
+        }
+        for (uint32_t member : group)
+            for (uint32_t k = graph.offsets[member]; k < graph.offsets[member + 1]; ++k)
+                if (groupOf[graph.neighbours[k].first] == kNone) frontier.push_back(graph.neighbours[k].first);
+        groups.push_back(std::move(group));
+    }
+
+    for (uint32_t g = 0; g < groups.size(); ++g) {
+        if (groups[g].empty() || groups[g].size() * 2 > groupSize) continue;
+        const uint32_t into = AdjacentGroup(graph, groupOf, groups[g].data(), groups[g].size(),
+                                            [&](uint32_t h) { return h != g; });
+        if (into == kNone) continue;
+        for (uint32_t c : groups[g]) groupOf[c] = into;
+        groups[into].insert(groups[into].end(), groups[g].begin(), groups[g].end());
+        groups[g].clear();
+    }
+    groups.erase(std::remove_if(groups.begin(), groups.end(), [](const std::vector<uint32_t>& g) { return g.empty(); }),
+                 groups.end());
+    return groups;
+}
+
+// Simplified replacement for one group, in global vertex ids.
+struct GroupResult {
+    bool simplified = false;
+    float error = 0.0f;
+    std::vector<uint32_t> indices;
+    std::vector<uint32_t> clusterSizes;  // index counts of the new clusters, in order
+};
+
+GroupResult SimplifyGroup(const std::vector<Cluster>& clusters, const std::vector<uint32_t>& group,
+                          const std::vector<uint32_t>& indices, const float* positions, size_t positionStride,
+                          const ClusterSettings& settings) {
+    GroupResult result;
+    std::vector<uint32_t> merged;
+    for (uint32_t c : group)
+        merged.insert(merged.end(), indices.begin() + clusters[c].firstIndex,
+                      indices.begin() + clusters[c].firstIndex + clusters[c].indexCount);
+
+    // Work on the group's own vertices; the simplifier and the meshlet
+    // builder size their tables by vertex count.
+    std::vector<uint32_t> global(merged);
+    std::sort(global.begin(), global.end());
+    global.erase(std::unique(global.begin(), global.end()), global.end());
+    std::vector<float> local(global.size() * 3);
+    for (size_t v = 0; v < global.size(); ++v)
+        std::memcpy(&local[v * 3], reinterpret_cast<const char*>(positions) + size_t(global[v]) * positionStride,
+                    3 * sizeof(float));
+    for (uint32_t& i : merged) i = uint32_t(std::lower_bound(global.begin(), global.end(), i) - global.begin());
+
+    const size_t triangles = merged.size() / 3;
+    const size_t target = std::max<size_t>(1, size_t(triangles * settings.reduction)) * 3;
+    std::vector<uint32_t> simplified(merged.size());
+    const size_t count = Simplifier::Simplify(simplified.data(), merged.data(), merged.size(), local.data(),
+                                              global.size(), 3 * sizeof(float), target, kInfinity, &result.error);
+    if (count == 0 || count > merged.size() * kMinGroupReduction) return result;
+    result.simplified = true;
+
+    MeshletBuffers meshlets;
+    Meshlets::Build(meshlets, simplified.data(), count, local.data(), global.size(), 3 * sizeof(float),
+                    settings.maxVertices, settings.maxTriangles);
+    for (const Meshlet& m : meshlets.meshlets) {
+        for (uint32_t t = 0; t < m.triangleCount * 3; ++t)
+            result.indices.push_back(global[meshlets.vertices[m.vertexOffset + meshlets.triangles[m.triangleOffset * 3 + t]]]);
+        result.clusterSizes.push_back(m.triangleCount * 3);
+    }
+    return result;
+}
+
+}
+
+ClusterView ClusterView::FromMatrix(const float m[16], const float eye[3], float pixelScale, float pixelError) {
+    ClusterView view;
+    // Gribb-Hartmann: rows of the matrix combined, column-major storage.
+    auto row = [&](int r, int a) { return m[a * 4 + r]; };
+    for (int p = 0; p < 6; ++p) {
+        const int axis = p / 2;
+        const float sign = (p % 2 == 0) ? 1.0f : -1.0f;
+        for (int a = 0; a < 4; ++a) view.planes[p][a] = row(3, a) + sign * row(axis, a);
+        const float length = std::sqrt(view.planes[p][0] * view.planes[p][0] + view.planes[p][1] * view.planes[p][1] +
+                                       view.planes[p][2] * view.planes[p][2]);
+        if (length > 0.0f)
+            for (float& k : view.planes[p]) k /= length;
+    }
+    std::copy(eye, eye + 3, view.eye);
+    view.pixelScale = pixelScale;
+    view.pixelError = pixelError;
+    return view;
+}
+
+void ClusterHierarchy::Build(const uint32_t* indices, size_t indexCount, const float* positions, size_t vertexCount,
+                             size_t positionStride, const ClusterSettings& settings) {
+    clusters_.clear();
+    nodes_.clear();
+    indices_.clear();
+    levels_ = 0;
+    indexCount -= indexCount % 3;
+    if (indexCount == 0) return;
+
+    auto addCluster = [&](const uint32_t* triangles, size_t count, uint32_t level) {
+        Cluster c;
+        c.firstIndex = uint32_t(indices_.size());
+        c.indexCount = uint32_t(count);
+        c.level = level;
+        indices_.insert(indices_.end(), triangles, triangles + count);
+        c.bounds = Meshlets::ComputeBounds(triangles, count, positions, positionStride);
+        c.parentError = kInfinity;
+        clusters_.push_back(c);
+    };
+
+    // Level 0: the input split into meshlets.
+    {
+        MeshletBuffers meshlets;
+        Meshlets::Build(meshlets, indices, indexCount, positions, vertexCount, positionStride, settings.maxVertices,
+                        settings.maxTriangles);
+        std::vector<uint32_t> triangles;
+        for (const Meshlet& m : meshlets.meshlets) {
+            triangles.clear();
+            for (uint32_t t = 0; t < m.triangleCount * 3; ++t)
+                triangles.push_back(meshlets.vertices[m.vertexOffset + meshlets.triangles[m.triangleOffset * 3 + t]]);
+            addCluster(triangles.data(), triangles.size(), 0);
+            Cluster& c = clusters_.back();
+            std::copy(c.bounds.center, c.bounds.center + 3, c.lodCenter);
+            c.lodRadius = c.bounds.radius;
+        }
+    }
+    levels_ = 1;
+
+    std::vector<uint32_t> level(clusters_.size());
+    for (uint32_t c = 0; c < level.size(); ++c) level[c] = c;
+    size_t groupSize = settings.groupSize;
+    while (level.size() > 1) {
+        const ClusterGraph graph = BuildClusterGraph(clusters_, level, indices_);
+        std::vector<std::vector<uint32_t>> groups = GroupClusters(graph, groupSize);
+        std::vector<GroupResult> results(groups.size());
+        auto simplify = [&](const std::vector<uint32_t>& todo) {
+            gJobSystem.ParallelFor(0, todo.size(), kGroupGrain, [&](size_t first, size_t last) {
+                std::vector<uint32_t> members;
+                for (size_t i = first; i < last; ++i) {
+                    members.clear();
+                    for (uint32_t c : groups[todo[i]]) members.push_back(level[c]);
+                    results[todo[i]] = SimplifyGroup(clusters_, members, indices_, positions, positionStride, settings);
+                }
+            });
+        };
+        std::vector<uint32_t> todo(groups.size());
+        for (uint32_t g = 0; g < todo.size(); ++g) todo[g] = g;
+        simplify(todo);
+
+        // A group that would not simplify hands each of its clusters to the
+        // simplified group next to it that shares the most vertices, and
+        // those groups run again with the extra clusters.
+        std::vector<uint32_t> groupOf(level.size(), kNone);
+        for (uint32_t g = 0; g < groups.size(); ++g)
+            for (uint32_t c : groups[g]) groupOf[c] = g;
+        std::vector<uint8_t> grown(groups.size(), 0);
+        todo.clear();
+        std::vector<uint32_t> kept;
+        for (uint32_t g = 0; g < groups.size(); ++g) {
+            if (results[g].simplified) continue;
+            kept.clear();
+            for (uint32_t c : groups[g]) {
+                const uint32_t into = AdjacentGroup(graph, groupOf, &c, 1, [&](uint32_t h) { return results[h].simplified; });
+                if (into == kNone) {
+                    kept.push_back(c);
+                    continue;
+                }
+                groups[into].push_back(c);
+                groupOf[c] = into;
+                if (!grown[into]) todo.push_back(into);
+                grown[into] = 1;
+            }
+            groups[g] = kept;
+        }
+        simplify(todo);
+
+        // Clusters of groups that still would not simplify go round again in
+        // new groups.
+        std::vector<uint32_t> next;
+        std::vector<const float*> centers;
+        std::vector<float> radii;
+        bool progress = false;
+        for (size_t g = 0; g < groups.size(); ++g) {
+            const GroupResult& r = results[g];
+            if (!r.simplified) {
+                for (uint32_t c : groups[g]) next.push_back(level[c]);
+                continue;
+            }
+            progress = true;
+            for (uint32_t& c : groups[g]) c = level[c];
+            // The group's sphere encloses its clusters' own group spheres and
+            // its error adds to theirs, so parents always test coarser than children.
+            centers.clear();
+            radii.clear();
+            float error = 0.0f;
+            uint32_t depth = 0;
+            for (uint32_t c : groups[g]) {
+                centers.push_back(clusters_[c].lodCenter);
+                radii.push_back(clusters_[c].lodRadius);
+                error = std::max(error, clusters_[c].lodError);
+                depth = std::max(depth, clusters_[c].level + 1);
+            }
+            const Sphere sphere = Enclose(centers.size(), centers.data(), radii.data());
+            error += r.error;
+            for (uint32_t c : groups[g]) {
+                std::copy(sphere.center, sphere.center + 3, clusters_[c].parentCenter);
+                clusters_[c].parentRadius = sphere.radius;
+                clusters_[c].parentError = error;
+            }
+            size_t offset = 0;
+            for (uint32_t size : r.clusterSizes) {
+                next.push_back(uint32_t(clusters_.size()));
+                addCluster(r.indices.data() + offset, size, depth);
+                levels_ = std::max(levels_, depth + 1);
+                Cluster& c = clusters_.back();
+                std::copy(sphere.center, sphere.center + 3, c.lodCenter);
+                c.lodRadius = sphere.radius;
+                c.lodError = error;
+                offset += size;
+            }
+        }
+        // Once no group simplifies, larger groups have less border to keep;
+        // the clusters left when even one group of everything fails are roots.
+        if (!progress) {
+            if (groupSize >= level.size()) break;
+            groupSize *= 2;
+            continue;
+        }
+        groupSize = settings.groupSize;
+        level.swap(next);
+    }
+    for (Cluster& c : clusters_)
+        if (c.parentError == kInfinity) {
+            std::copy(c.lodCenter, c.lodCenter + 3, c.parentCenter);
+            c.parentRadius = c.lodRadius;
+        }
+
+    // BVH over every cluster, one subtree per level so that finer levels drop
+    // out whole at a distance. Clusters and their index ranges are then laid
+    // out in leaf order.
+    std::stable_sort(clusters_.begin(), clusters_.end(), [](const Cluster& a, const Cluster& b) { return a.level < b.level; });
+    BuildNode(0, uint32_t(clusters_.size()), std::max<size_t>(1, settings.leafSize));
+    std::vector<uint32_t> ordered;
+    ordered.reserve(indices_.size());
+    for (Cluster& c : clusters_) {
+        const uint32_t first = uint32_t(ordered.size());
+        ordered.insert(ordered.end(), indices_.begin() + c.firstIndex, indices_.begin() + c.firstIndex + c.indexCount);
+        c.firstIndex = first;
+    }
+    indices_.swap(ordered);
+}
+
+uint32_t ClusterHierarchy::BuildNode(uint32_t first, uint32_t count, size_t leafSize) {
+    const uint32_t index = uint32_t(nodes_.size());
+    nodes_.push_back({});
+
+    {
+        std::vector<const float*> centers(count), parentCenters(count);
+        std::vector<float> radii(count), parentRadii(count);
+        float maxParentError = 0.0f;
+        for (uint32_t i = 0; i < count; ++i) {
+            const Cluster& c = clusters_[first + i];
+            centers[i] = c.bounds.center;
+            radii[i] = c.bounds.radius;
+            parentCenters[i] = c.parentCenter;
+            parentRadii[i] = c.parentRadius;
+            maxParentError = std::max(maxParentError, c.parentError);
+        }
+        const Sphere bounds = Enclose(count, centers.data(), radii.data());
+        const Sphere parent = Enclose(count, parentCenters.data(), parentRadii.data());
+        ClusterNode& node = nodes_[index];
+        std::copy(bounds.center, bounds.center + 3, node.center);
+        node.radius = bounds.radius;
+        std::copy(parent.center, parent.center + 3, node.parentCenter);
+        node.parentRadius = parent.radius;
+        node.maxParentError = maxParentError;
+    }
+
+    if (count <= leafSize) {
+        nodes_[index].first = first;
+        nodes_[index].count = count;
+        return index;
+    }
+
+    uint32_t split;
+    Cluster* begin = clusters_.data() + first;
+    Cluster* end = begin + count;
+    if (begin->level != (end - 1)->level) {
+        // Split between levels (already sorted by level), as near the middle as possible.
+        const uint32_t middleLevel = begin[count / 2].level;
+        split = uint32_t(std::lower_bound(begin, end, middleLevel, [](const Cluster& c, uint32_t l) { return c.level < l; }) - begin);
+        if (split == 0)
+            split = uint32_t(std::upper_bound(begin, end, middleLevel, [](uint32_t l, const Cluster& c) { return l < c.level; }) - begin);
+    } else {
+        // Median split of the culling centers along their widest axis.
+        float mn[3] = {kInfinity, kInfinity, kInfinity}, mx[3] = {-kInfinity, -kInfinity, -kInfinity};
+        for (const Cluster* c = begin; c != end; ++c)
+            for (int a = 0; a < 3; ++a) { mn[a] = std::min(mn[a], c->bounds.center[a]); mx[a] = std::max(mx[a], c->bounds.center[a]); }
+        int axis = 0;
+        for (int a = 1; a < 3; ++a)
+            if (mx[a] - mn[a] > mx[axis] - mn[axis]) axis = a;
+        split = count / 2;
+        std::nth_element(begin, begin + split, end,
+                         [axis](const Cluster& a, const Cluster& b) { return a.bounds.center[axis] < b.bounds.center[axis]; });
+    }
+
+    BuildNode(first, split, leafSize);
+    const uint32_t right = BuildNode(first + split, count - split, leafSize);
+    nodes_[index].first = right;
+    nodes_[index].count = 0;
+    return index;
+}
+
+size_t ClusterHierarchy::Select(const ClusterView& view, std::vector<uint32_t>& selected,
+                                ClusterSelectionStats* stats) const {
+    selected.clear();
+    ClusterSelectionStats s;
+    if (nodes_.empty()) {
+        if (stats) *stats = s;
+        return 0;
+    }
+    uint32_t stack[64];
+    uint32_t depth = 0;
+    stack[depth++] = 0;
+    while (depth > 0) {
+        const ClusterNode& node = nodes_[stack[--depth]];
+        ++s.nodesVisited;
+        if (!SphereInFrustum(view, node.center, node.radius)) continue;
+        // Every cluster below is covered by a parent that is already fine enough.
+        if (ProjectedError(view, node.parentCenter, node.parentRadius, node.maxParentError) <= view.pixelError) continue;
+        if (node.count == 0) {
+            stack[depth++] = node.first;
+            stack[depth++] = uint32_t(&node - nodes_.data()) + 1;
+            continue;
+        }
+        for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+            const Cluster& c = clusters_[i];
+            ++s.clustersTested;
+            if (ProjectedError(view, c.parentCenter, c.parentRadius, c.parentError) <= view.pixelError ||
+                ProjectedError(view, c.lodCenter, c.lodRadius, c.lodError) > view.pixelError) {
+                ++s.lodRejected;
+                continue;
+            }
+            if (!SphereInFrustum(view, c.bounds.center, c.bounds.radius)) { ++s.frustumCulled; continue; }
+            if (view.backfaceCulling && Backfacing(view, c.bounds)) { ++s.backfaceCulled; continue; }
+            selected.push_back(i);
+            s.triangles += c.indexCount / 3;
+        }
+    }
+    s.selected = uint32_t(selected.size());
+    if (stats) *stats = s;
+    return selected.size();
+}
+
+void ClusterHierarchy::BuildDrawList(const uint32_t* selected, size_t count,
+                                     std::vector<DrawElementsIndirectCommand>& commands) const {
+    commands.clear();
+    std::vector<uint32_t> order(selected, selected + count);
+    std::sort(order.begin(), order.end(),
+              [&](uint32_t a, uint32_t b) { return clusters_[a].firstIndex < clusters_[b].firstIndex; });
+    for (uint32_t i : order) {
+        const Cluster& c = clusters_[i];
+        if (!commands.empty() && commands.back().firstIndex + commands.back().count == c.firstIndex)
+            commands.back().count += c.indexCount;
+        else {
+            DrawElementsIndirectCommand command;
+            command.count = c.indexCount;
+            command.firstIndex = c.firstIndex;
+            commands.push_back(command);
+        }
+    }
+}
+
+}
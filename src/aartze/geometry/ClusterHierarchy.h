@@ -0,0 +1,126 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Meshlets.h"
+
+namespace aartze::geometry {
+
+// Same layout as GL's DrawElementsIndirectCommand, so a list can feed
+// glMultiDrawElementsIndirect directly where GL 4.3 is available. The GL 3.3
+// path draws it with glMultiDrawElements, passing count and
+// firstIndex * index size per command.
+struct DrawElementsIndirectCommand {
+    uint32_t count = 0;
+    uint32_t instanceCount = 1;
+    uint32_t firstIndex = 0;
+    int32_t baseVertex = 0;
+    uint32_t baseInstance = 0;
+};
+
+/**
+ * One node of the cluster DAG. Clusters of level 0 hold the original
+ * triangles; a group of neighbouring clusters is merged, simplified with its
+ * outer border locked and split again into the clusters of the next level.
+ * A cluster keeps the bounds and error of the group it came out of (lod*) and
+ * of the group that replaced it (parent*). All clusters of a group share these
+ * values, so a cluster is drawn exactly when its parent group is too coarse
+ * and its own group is fine enough, and every view gets a crack-free cut.
+ */
+struct Cluster {
+    uint32_t firstIndex = 0;  // range of ClusterHierarchy::Indices()
+    uint32_t indexCount = 0;
+    uint32_t level = 0;       // simplification steps between this cluster and the input
+    MeshletBounds bounds;     // for frustum and backface culling
+    float lodCenter[3] = {0.0f, 0.0f, 0.0f};
+    float lodRadius = 0.0f;
+    float lodError = 0.0f;     // object-space deviation from level 0
+    float parentCenter[3] = {0.0f, 0.0f, 0.0f};
+    float parentRadius = 0.0f;
+    float parentError = 0.0f;  // infinite for roots
+};
+
+// Flattened depth-first like BVHNode: an interior node's first child follows it.
+struct ClusterNode {
+    float center[3];        // encloses the clusters' culling spheres
+    float radius;
+    float parentCenter[3];  // encloses their parent spheres
+    float parentRadius;
+    float maxParentError;   // the whole subtree is too fine once this projects under the budget
+    uint32_t first;         // leaf: first cluster; interior: right child
+    uint32_t count;         // clusters in a leaf, 0 for interior nodes
+};
+
+struct ClusterSettings {
+    size_t maxVertices = Meshlets::kMaxVertices;
+    size_t maxTriangles = Meshlets::kMaxTriangles;
+    size_t groupSize = 4;      // clusters merged and simplified together
+    float reduction = 0.5f;    // fraction of a group's triangles each step aims to keep
+    size_t leafSize = 8;       // clusters per BVH leaf
+};
+
+// Everything in the mesh's object space. pixelScale is the projected size of
+// one unit at unit distance, Proj[5] * viewportHeight / 2, times the
+// instance's scale.
+struct ClusterView {
+    float planes[6][4];  // normalized, pointing inward
+    float eye[3];
+    float pixelScale = 1.0f;
+    float pixelError = 1.0f;
+    float zNear = 0.1f;
+    bool backfaceCulling = true;
+
+    // Planes from a column-major model-view-projection matrix in GL clip space.
+    static ClusterView FromMatrix(const float modelViewProj[16], const float eye[3], float pixelScale,
+                                  float pixelError = 1.0f);
+};
+
+struct ClusterSelectionStats {
+    uint32_t nodesVisited = 0;
+    uint32_t clustersTested = 0;
+    uint32_t lodRejected = 0;     // another level of the DAG covers this cluster's surface
+    uint32_t frustumCulled = 0;   // clusters, not counting whole nodes culled
+    uint32_t backfaceCulled = 0;
+    uint32_t selected = 0;
+    uint64_t triangles = 0;
+};
+
+/**
+ * Offline cluster LOD for a triangle mesh: meshlets, a DAG of progressively
+ * simplified clusters and a BVH over all of them, plus a CPU reference of the
+ * per-view traversal. Every level indexes the input vertex buffer, so the
+ * whole DAG is one index buffer that a selection draws ranges of. Clusters
+ * whose group would not simplify (mostly locked border) join a neighbouring
+ * group that does; a round where no group simplifies is retried with larger
+ * groups, and only what is left once a single group fails becomes roots.
+ */
+class ClusterHierarchy {
+public:
+    void Build(const uint32_t* indices, size_t indexCount, const float* positions, size_t vertexCount,
+               size_t positionStride, const ClusterSettings& settings = {});
+
+    const std::vector<Cluster>& Clusters() const { return clusters_; }
+    const std::vector<ClusterNode>& Nodes() const { return nodes_; }
+    const std::vector<uint32_t>& Indices() const { return indices_; }
+    uint32_t LevelCount() const { return levels_; }
+
+    // Clusters to draw for `view`: the cut whose projected error fits
+    // view.pixelError, minus clusters outside the frustum or facing away.
+    // Returns the count written to `selected` (which is cleared first).
+    size_t Select(const ClusterView& view, std::vector<uint32_t>& selected, ClusterSelectionStats* stats = nullptr) const;
+
+    // One command per run of selected clusters adjacent in Indices(). Leaves
+    // keep their clusters adjacent there, so nearby clusters usually merge.
+    void BuildDrawList(const uint32_t* selected, size_t count, std::vector<DrawElementsIndirectCommand>& commands) const;
+
+private:
+    uint32_t BuildNode(uint32_t first, uint32_t count, size_t leafSize);
+
+    std::vector<Cluster> clusters_;
+    std::vector<ClusterNode> nodes_;
+    std::vector<uint32_t> indices_;
+    uint32_t levels_ = 0;
+};
+
+}
@@ -1,3 +1,345 @@
 #include "HalfEdgeMesh.h"
-namespace aartze::geometry { }
+#include <algorithm>
+#include <cstring>
 
+#include "core/JobSystem.hpp"
+
+namespace aartze::geometry {
+
+namespace {
+
+constexpr uint32_t kInvalid = HalfEdgeMesh::kInvalid;
+// Twin matching is split across gJobSystem above this many half-edges.
+constexpr size_t kParallelHalfEdges = 1u << 16;
+constexpr size_t kMatchGrain = 1u << 14;
+
+// Live half-edges grouped by origin vertex (CSR): those leaving v are
+// outgoing[offsets[v] .. offsets[v + 1]).
+struct OutgoingTable {
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> outgoing;
+
+    void Build(const std::vector<uint32_t>& halfEdgeVertex, size_t vertexCount) {
+        offsets.assign(vertexCount + 1, 0);
+        for (uint32_t v : halfEdgeVertex)
+            if (v != kInvalid) ++offsets[v + 1];
+        for (size_t v = 0; v < vertexCount; ++v) offsets[v + 1] += offsets[v];
+        outgoing.resize(offsets.back());
+        std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (uint32_t h = 0; h < halfEdgeVertex.size(); ++h)
+            if (halfEdgeVertex[h] != kInvalid) outgoing[cursor[halfEdgeVertex[h]]++] = h;
+    }
+};
+
+}  // namespace
+
+void HalfEdgeMesh::Build(const float* positions, size_t positionStride, size_t vertexCount, const uint32_t* indices,
+                         size_t indexCount) {
+    const size_t faceCount = indexCount / 3;
+    positions_.resize(vertexCount * 3);
+    const char* src = reinterpret_cast<const char*>(positions);
+    for (size_t v = 0; v < vertexCount; ++v) std::memcpy(&positions_[v * 3], src + v * positionStride, sizeof(float) * 3);
+
+    halfEdgeVertex_.assign(indices, indices + faceCount * 3);
+    halfEdgeTwin_.assign(faceCount * 3, kInvalid);
+    faceFlags_.assign(faceCount, kFaceAlive);
+    vertexHalfEdge_.assign(vertexCount, kInvalid);
+    liveFaces_ = faceCount;
+    for (size_t f = 0; f < faceCount; ++f) {
+        const uint32_t* v = &halfEdgeVertex_[f * 3];
+        if (v[0] >= vertexCount || v[1] >= vertexCount || v[2] >= vertexCount || v[0] == v[1] || v[1] == v[2] ||
+            v[2] == v[0])
+            KillFace(uint32_t(f));
+    }
+
+    OutgoingTable table;
+    table.Build(halfEdgeVertex_, vertexCount);
+    // Pair a->b with b->a only when each direction occurs exactly once; the
+    // test is symmetric, so both sides agree without synchronization.
+    auto match = [&](size_t first, size_t last) {
+        for (size_t h = first; h < last; ++h) {
+            const uint32_t a = halfEdgeVertex_[h];
+            if (a == kInvalid) continue;
+            const uint32_t b = To(uint32_t(h));
+            uint32_t same = 0, opposite = 0, twin = kInvalid;
+            for (uint32_t i = table.offsets[a]; i < table.offsets[a + 1]; ++i) same += To(table.outgoing[i]) == b;
+            for (uint32_t i = table.offsets[b]; i < table.offsets[b + 1]; ++i)
+                if (To(table.outgoing[i]) == a) { twin = table.outgoing[i]; ++opposite; }
+            if (same == 1 && opposite == 1) halfEdgeTwin_[h] = twin;
+        }
+    };
+    if (halfEdgeVertex_.size() >= kParallelHalfEdges)
+        gJobSystem.ParallelFor(0, halfEdgeVertex_.size(), kMatchGrain, match);
+    else
+        match(0, halfEdgeVertex_.size());
+
+    liveVertices_ = 0;
+    for (uint32_t h = 0; h < halfEdgeVertex_.size(); ++h) {
+        const uint32_t v = halfEdgeVertex_[h];
+        if (v == kInvalid) continue;
+        if (vertexHalfEdge_[v] == kInvalid) ++liveVertices_;
+        if (vertexHalfEdge_[v] == kInvalid || halfEdgeTwin_[h] == kInvalid) vertexHalfEdge_[v] = h;
+    }
+}
+
+void HalfEdgeMesh::SetPosition(uint32_t v, const float p[3]) {
+    std::memcpy(&positions_[size_t(v) * 3], p, sizeof(float) * 3);
+}
+
+uint32_t HalfEdgeMesh::Valence(uint32_t v) const {
+    uint32_t count = 0;
+    ForEachOutgoing(v, [&](uint32_t) { ++count; });
+    return count + (IsBoundaryVertex(v) ? 1 : 0);
+}
+
+void HalfEdgeMesh::OneRing(uint32_t v, std::vector<uint32_t>& neighbours) const {
+    neighbours.clear();
+    uint32_t last = kInvalid;
+    ForEachOutgoing(v, [&](uint32_t h) {
+        neighbours.push_back(To(h));
+        last = h;
+    });
+    if (last != kInvalid && IsBoundaryVertex(v)) neighbours.push_back(From(Prev(last)));
+}
+
+void HalfEdgeMesh::BoundaryLoops(std::vector<std::vector<uint32_t>>& loops) const {
+    loops.clear();
+    std::vector<uint8_t> visited(halfEdgeVertex_.size(), 0);
+    for (uint32_t start = 0; start < halfEdgeVertex_.size(); ++start) {
+        if (visited[start] || halfEdgeVertex_[start] == kInvalid || halfEdgeTwin_[start] != kInvalid) continue;
+        std::vector<uint32_t> loop;
+        uint32_t h = start;
+        do {
+            visited[h] = 1;
+            loop.push_back(From(h));
+            // Rotate around To(h) back to the boundary half-edge leaving it.
+            uint32_t g = Next(h);
+            for (size_t guard = 0; halfEdgeTwin_[g] != kInvalid && guard < halfEdgeVertex_.size(); ++guard)
+                g = Next(halfEdgeTwin_[g]);
+            h = g;
+        } while (h != start && halfEdgeTwin_[h] == kInvalid && !visited[h]);
+        loops.push_back(std::move(loop));
+    }
+}
+
+TopologyReport HalfEdgeMesh::CheckTopology() const {
+    TopologyReport report;
+    OutgoingTable table;
+    table.Build(halfEdgeVertex_, VertexCount());
+    for (uint32_t h = 0; h < halfEdgeVertex_.size(); ++h) {
+        if (halfEdgeVertex_[h] == kInvalid || halfEdgeTwin_[h] != kInvalid) continue;
+        const uint32_t a = From(h), b = To(h);
+        uint32_t others = 0;
+        for (uint32_t i = table.offsets[a]; i < table.offsets[a + 1]; ++i) others += To(table.outgoing[i]) == b;
+        for (uint32_t i = table.offsets[b]; i < table.offsets[b + 1]; ++i) others += To(table.outgoing[i]) == a;
+        if (others == 1)
+            ++report.boundaryEdges;
+        else
+            ++report.nonManifoldEdges;
+    }
+    for (uint32_t v = 0; v < VertexCount(); ++v) {
+        if (!VertexAlive(v)) continue;
+        uint32_t fan = 0;
+        ForEachOutgoing(v, [&](uint32_t) { ++fan; });
+        if (fan != table.offsets[v + 1] - table.offsets[v]) ++report.nonManifoldVertices;
+    }
+    std::vector<std::vector<uint32_t>> loops;
+    BoundaryLoops(loops);
+    report.boundaryLoops = loops.size();
+    return report;
+}
+
+bool HalfEdgeMesh::CollapseEdge(uint32_t h, const float* position) {
+    if (h >= halfEdgeVertex_.size() || !FaceAlive(Face(h))) return false;
+    const uint32_t t = Twin(h);
+    const uint32_t a = From(h), b = To(h), c = From(Prev(h));
+    const uint32_t d = t != kInvalid ? From(Prev(t)) : kInvalid;
+    if (t != kInvalid && IsBoundaryVertex(a) && IsBoundaryVertex(b)) return false;
+    // Link condition: the only neighbours a and b share are the opposite corners.
+    OneRing(a, scratchA_);
+    OneRing(b, scratchB_);
+    uint32_t shared = 0;
+    for (uint32_t x : scratchA_) {
+        if (x == b || std::find(scratchB_.begin(), scratchB_.end(), x) == scratchB_.end()) continue;
+        if (x != c && x != d) return false;
+        ++shared;
+    }
+    if (shared != (t != kInvalid ? 2u : 1u)) return false;
+    // An interior opposite corner of valence 3 would be left with two faces on one edge.
+    if (!IsBoundaryVertex(c) && Valence(c) <= 3) return false;
+    if (t != kInvalid && !IsBoundaryVertex(d) && Valence(d) <= 3) return false;
+
+    scratchA_.clear();
+    ForEachOutgoing(a, [&](uint32_t g) { scratchA_.push_back(g); });
+    const uint32_t x = Twin(Next(h)), y = Twin(Prev(h));  // c->b, a->c
+    const uint32_t u = t != kInvalid ? Twin(Next(t)) : kInvalid;  // d->a
+    const uint32_t w = t != kInvalid ? Twin(Prev(t)) : kInvalid;  // b->d
+    for (uint32_t g : scratchA_) halfEdgeVertex_[g] = b;
+    KillFace(Face(h));
+    if (t != kInvalid) KillFace(Face(t));
+    Link(x, y);
+    Link(u, w);
+    vertexHalfEdge_[a] = kInvalid;
+    --liveVertices_;
+    if (position) SetPosition(b, position);
+
+    RepairOutgoing(b, {w, y, x != kInvalid ? Next(x) : kInvalid, u != kInvalid ? Next(u) : kInvalid});
+    RepairOutgoing(c, {x, y != kInvalid ? Next(y) : kInvalid});
+    if (t != kInvalid) RepairOutgoing(d, {u, w != kInvalid ? Next(w) : kInvalid});
+    return true;
+}
+
+bool HalfEdgeMesh::FlipEdge(uint32_t h) {
+    if (h >= halfEdgeVertex_.size() || !FaceAlive(Face(h))) return false;
+    const uint32_t t = Twin(h);
+    if (t == kInvalid) return false;
+    const uint32_t a = From(h), b = To(h), c = From(Prev(h)), d = From(Prev(t));
+    if (c == d) return false;
+    auto keepsValence = [&](uint32_t v) { return IsBoundaryVertex(v) || Valence(v) > 3; };
+    if (!keepsValence(a) || !keepsValence(b)) return false;
+    OneRing(c, scratchA_);
+    if (std::find(scratchA_.begin(), scratchA_.end(), d) != scratchA_.end()) return false;
+
+    const uint32_t bc = Twin(Next(h)), ca = Twin(Prev(h)), ad = Twin(Next(t)), db = Twin(Prev(t));
+    // Quad a, d, b, c becomes faces (c, a, d) and (d, b, c).
+    const uint32_t h0 = FaceHalfEdge(Face(h)), h1 = FaceHalfEdge(Face(t));
+    halfEdgeVertex_[h0] = c;
+    halfEdgeVertex_[h0 + 1] = a;
+    halfEdgeVertex_[h0 + 2] = d;
+    halfEdgeVertex_[h1] = d;
+    halfEdgeVertex_[h1 + 1] = b;
+    halfEdgeVertex_[h1 + 2] = c;
+    Link(h0, ca);
+    Link(h0 + 1, ad);
+    Link(h0 + 2, h1 + 2);
+    Link(h1, db);
+    Link(h1 + 1, bc);
+    RepairOutgoing(a, {h0 + 1});
+    RepairOutgoing(b, {h1 + 1});
+    RepairOutgoing(c, {h0});
+    RepairOutgoing(d, {h1});
+    return true;
+}
+
+uint32_t HalfEdgeMesh::SplitEdge(uint32_t h, float t) {
+    if (h >= halfEdgeVertex_.size() || !FaceAlive(Face(h))) return kInvalid;
+    const uint32_t twin = Twin(h);
+    const uint32_t a = From(h), b = To(h), c = From(Prev(h));
+    const uint32_t m = uint32_t(vertexHalfEdge_.size());
+    float p[3];
+    for (int k = 0; k < 3; ++k) p[k] = Position(a)[k] + t * (Position(b)[k] - Position(a)[k]);
+    positions_.insert(positions_.end(), p, p + 3);
+    vertexHalfEdge_.push_back(kInvalid);  // counted live by RepairOutgoing below
+
+    // (a, b, c) becomes (a, m, c) + (m, b, c).
+    const uint32_t n0 = Next(h), bc = Twin(n0);
+    const uint32_t h2 = AddFace(m, b, c);
+    halfEdgeVertex_[n0] = m;
+    Link(n0, h2 + 2);
+    Link(h2 + 1, bc);
+    if (twin != kInvalid) {
+        // (b, a, d) becomes (b, m, d) + (m, a, d).
+        const uint32_t d = From(Prev(twin)), n1 = Next(twin), ad = Twin(n1);
+        const uint32_t h3 = AddFace(m, a, d);
+        halfEdgeVertex_[n1] = m;
+        Link(n1, h3 + 2);
+        Link(h3 + 1, ad);
+        Link(h, h3);
+        Link(twin, h2);
+    }
+    RepairOutgoing(m, {h2});
+    RepairOutgoing(a, {h});
+    RepairOutgoing(b, {h2 + 1});
+    return m;
+}
+
+void HalfEdgeMesh::Compact(std::vector<uint32_t>* vertexRemap) {
+    std::vector<uint32_t> vertexMap(VertexCount(), kInvalid), faceMap(FaceCount(), kInvalid);
+    uint32_t vertices = 0, faces = 0;
+    for (uint32_t v = 0; v < VertexCount(); ++v)
+        if (VertexAlive(v)) vertexMap[v] = vertices++;
+    for (uint32_t f = 0; f < FaceCount(); ++f)
+        if (FaceAlive(f)) faceMap[f] = faces++;
+    auto mapHalfEdge = [&](uint32_t h) { return h == kInvalid ? kInvalid : faceMap[Face(h)] * 3 + h % 3; };
+
+    std::vector<float> positions(size_t(vertices) * 3);
+    std::vector<uint32_t> vertexHalfEdge(vertices);
+    for (uint32_t v = 0; v < VertexCount(); ++v) {
+        if (vertexMap[v] == kInvalid) continue;
+        std::memcpy(&positions[size_t(vertexMap[v]) * 3], Position(v), sizeof(float) * 3);
+        vertexHalfEdge[vertexMap[v]] = mapHalfEdge(vertexHalfEdge_[v]);
+    }
+    std::vector<uint32_t> halfEdgeVertex(size_t(faces) * 3), halfEdgeTwin(size_t(faces) * 3);
+    for (uint32_t f = 0; f < FaceCount(); ++f) {
+        if (faceMap[f] == kInvalid) continue;
+        for (uint32_t k = 0; k < 3; ++k) {
+            halfEdgeVertex[faceMap[f] * 3 + k] = vertexMap[halfEdgeVertex_[f * 3 + k]];
+            halfEdgeTwin[faceMap[f] * 3 + k] = mapHalfEdge(halfEdgeTwin_[f * 3 + k]);
+        }
+    }
+    positions_.swap(positions);
+    vertexHalfEdge_.swap(vertexHalfEdge);
+    halfEdgeVertex_.swap(halfEdgeVertex);
+    halfEdgeTwin_.swap(halfEdgeTwin);
+    faceFlags_.assign(faces, kFaceAlive);
+    if (vertexRemap) vertexRemap->swap(vertexMap);
+}
+
+void HalfEdgeMesh::Extract(std::vector<float>& positions, std::vector<uint32_t>& indices,
+                           std::vector<uint32_t>* vertexRemap) const {
+    std::vector<uint32_t> vertexMap(VertexCount(), kInvalid);
+    positions.clear();
+    positions.reserve(liveVertices_ * 3);
+    for (uint32_t v = 0; v < VertexCount(); ++v) {
+        if (!VertexAlive(v)) continue;
+        vertexMap[v] = uint32_t(positions.size() / 3);
+        positions.insert(positions.end(), Position(v), Position(v) + 3);
+    }
+    indices.clear();
+    indices.reserve(liveFaces_ * 3);
+    for (uint32_t f = 0; f < FaceCount(); ++f)
+        if (FaceAlive(f))
+            for (uint32_t k = 0; k < 3; ++k) indices.push_back(vertexMap[halfEdgeVertex_[f * 3 + k]]);
+    if (vertexRemap) vertexRemap->swap(vertexMap);
+}
+
+void HalfEdgeMesh::RepairOutgoing(uint32_t v, std::initializer_list<uint32_t> candidates) {
+    for (uint32_t start : candidates) {
+        if (start == kInvalid || !FaceAlive(Face(start)) || From(start) != v) continue;
+        uint32_t h = start;
+        while (halfEdgeTwin_[h] != kInvalid) {
+            h = Next(halfEdgeTwin_[h]);
+            if (h == start) break;  // interior vertex: any half-edge will do
+        }
+        if (vertexHalfEdge_[v] == kInvalid) ++liveVertices_;
+        vertexHalfEdge_[v] = h;
+        return;
+    }
+    if (vertexHalfEdge_[v] != kInvalid) --liveVertices_;
+    vertexHalfEdge_[v] = kInvalid;
+}
+
+uint32_t HalfEdgeMesh::AddFace(uint32_t a, uint32_t b, uint32_t c) {
+    const uint32_t h = uint32_t(halfEdgeVertex_.size());
+    halfEdgeVertex_.insert(halfEdgeVertex_.end(), {a, b, c});
+    halfEdgeTwin_.insert(halfEdgeTwin_.end(), 3, kInvalid);
+    faceFlags_.push_back(kFaceAlive);
+    ++liveFaces_;
+    return h;
+}
+
+void HalfEdgeMesh::Link(uint32_t a, uint32_t b) {
+    if (a != kInvalid) halfEdgeTwin_[a] = b;
+    if (b != kInvalid) halfEdgeTwin_[b] = a;
+}
+
+void HalfEdgeMesh::KillFace(uint32_t f) {
+    for (uint32_t k = 0; k < 3; ++k) {
+        halfEdgeVertex_[f * 3 + k] = kInvalid;
+        halfEdgeTwin_[f * 3 + k] = kInvalid;
+    }
+    faceFlags_[f] = 0;
+    --liveFaces_;
+}
+
+}
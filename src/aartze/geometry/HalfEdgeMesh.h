@@ -1,5 +1,132 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
 namespace aartze::geometry {
-struct HalfEdgeMesh { int dummy=0; };
+
+struct TopologyReport {
+    size_t boundaryEdges = 0;        // half-edges without a twin that are not non-manifold
+    size_t boundaryLoops = 0;
+    size_t nonManifoldEdges = 0;     // half-edges sharing their vertex pair with 2+ others, or misoriented
+    size_t nonManifoldVertices = 0;  // vertices whose faces don't form a single fan
+    bool Manifold() const { return nonManifoldEdges == 0 && nonManifoldVertices == 0; }
+};
+
+/**
+ * Index-based half-edge structure over a triangle mesh, stored as parallel
+ * arrays. Faces are implicit: face f owns half-edges 3f, 3f + 1 and 3f + 2,
+ * so next/prev are arithmetic and only the origin vertex and the twin are
+ * stored per half-edge. Half-edge h runs from From(h) to To(h) = From(Next(h)).
+ *
+ * Edges shared by more than two faces, or by two faces with inconsistent
+ * winding, are left without twins and reported by CheckTopology. Every vertex
+ * keeps one outgoing half-edge; on the boundary it is the one without a twin,
+ * so walking the fan from it visits every face around the vertex.
+ *
+ * CollapseEdge, FlipEdge and SplitEdge never move existing elements: removed
+ * faces and vertices are only marked dead, so indices held by the caller stay
+ * valid until Compact() squeezes them out.
+ */
+class HalfEdgeMesh {
+public:
+    static constexpr uint32_t kInvalid = ~0u;
+
+    // `positions` is xyz floats, `positionStride` bytes apart, e.g.
+    // Build(&mesh.positions[0].x, sizeof(glm::vec3), ...) for an aartze::Mesh.
+    // Triangles with repeated or out-of-range indices become dead faces.
+    void Build(const float* positions, size_t positionStride, size_t vertexCount, const uint32_t* indices,
+               size_t indexCount);
+
+    size_t VertexCount() const { return vertexHalfEdge_.size(); }  // including dead vertices
+    size_t FaceCount() const { return faceFlags_.size(); }         // including dead faces
+    size_t HalfEdgeCount() const { return halfEdgeVertex_.size(); }
+    size_t LiveVertexCount() const { return liveVertices_; }
+    size_t LiveFaceCount() const { return liveFaces_; }
+
+    static uint32_t Face(uint32_t h) { return h / 3; }
+    static uint32_t Next(uint32_t h) { return h % 3 == 2 ? h - 2 : h + 1; }
+    static uint32_t Prev(uint32_t h) { return h % 3 == 0 ? h + 2 : h - 1; }
+    uint32_t Twin(uint32_t h) const { return halfEdgeTwin_[h]; }
+    uint32_t From(uint32_t h) const { return halfEdgeVertex_[h]; }
+    uint32_t To(uint32_t h) const { return halfEdgeVertex_[Next(h)]; }
+    uint32_t FaceHalfEdge(uint32_t f) const { return f * 3; }
+    uint32_t VertexHalfEdge(uint32_t v) const { return vertexHalfEdge_[v]; }  // kInvalid when dead or isolated
+
+    bool FaceAlive(uint32_t f) const { return faceFlags_[f] & kFaceAlive; }
+    bool VertexAlive(uint32_t v) const { return vertexHalfEdge_[v] != kInvalid; }
+    bool IsBoundaryEdge(uint32_t h) const { return halfEdgeTwin_[h] == kInvalid; }
+    bool IsBoundaryVertex(uint32_t v) const {
+        return vertexHalfEdge_[v] != kInvalid && halfEdgeTwin_[vertexHalfEdge_[v]] == kInvalid;
+    }
+
+    const float* Position(uint32_t v) const { return &positions_[size_t(v) * 3]; }
+    void SetPosition(uint32_t v, const float p[3]);
+
+    // Outgoing half-edges of v in fan order, starting at the boundary if v is on one.
+    template <class Fn>
+    void ForEachOutgoing(uint32_t v, Fn&& fn) const;
+    uint32_t Valence(uint32_t v) const;
+    // Neighbouring vertices in fan order (one more than the outgoing half-edges on the boundary).
+    void OneRing(uint32_t v, std::vector<uint32_t>& neighbours) const;
+    // Each loop lists its vertices in the order of the boundary half-edges.
+    void BoundaryLoops(std::vector<std::vector<uint32_t>>& loops) const;
+    TopologyReport CheckTopology() const;
+
+    // Merge From(h) into To(h), moved to `position` (null keeps it), removing
+    // the one or two faces on the edge. Refused (false) when the result would
+    // not be manifold: the endpoints must share exactly the opposite vertices
+    // as neighbours, and an interior edge may not join two boundary vertices.
+    bool CollapseEdge(uint32_t h, const float* position = nullptr);
+    // Replace the edge between the two faces on h by the other diagonal of
+    // their quad. Refused on the boundary, when the diagonal already exists or
+    // when an endpoint would drop below valence 3.
+    bool FlipEdge(uint32_t h);
+    // Insert a vertex at From(h) + t * (To(h) - From(h)), splitting each face
+    // on the edge in two. Returns the new vertex.
+    uint32_t SplitEdge(uint32_t h, float t = 0.5f);
+
+    // Drop dead faces and vertices. vertexRemap, if given, receives the new
+    // index of each old vertex or kInvalid.
+    void Compact(std::vector<uint32_t>* vertexRemap = nullptr);
+    // Live triangles as an indexed list over live vertices, without compacting.
+    void Extract(std::vector<float>& positions, std::vector<uint32_t>& indices,
+                 std::vector<uint32_t>* vertexRemap = nullptr) const;
+
+private:
+    static constexpr uint8_t kFaceAlive = 1;
+
+    // Point v at an outgoing half-edge, rotated to the boundary one if any.
+    // `candidates` are tried in order; v is marked isolated if none is live.
+    void RepairOutgoing(uint32_t v, std::initializer_list<uint32_t> candidates);
+    uint32_t AddFace(uint32_t a, uint32_t b, uint32_t c);  // returns its first half-edge, twins unset
+    void Link(uint32_t a, uint32_t b);  // make a and b twins; either may be kInvalid
+    void KillFace(uint32_t f);
+
+    // Vertices
+    std::vector<float> positions_;  // xyz
+    std::vector<uint32_t> vertexHalfEdge_;
+    // Half-edges
+    std::vector<uint32_t> halfEdgeVertex_;  // origin
+    std::vector<uint32_t> halfEdgeTwin_;
+    // Faces
+    std::vector<uint8_t> faceFlags_;
+
+    size_t liveVertices_ = 0;
+    size_t liveFaces_ = 0;
+    std::vector<uint32_t> scratchA_, scratchB_;  // one-rings during collapse and flip
+};
+
+template <class Fn>
+void HalfEdgeMesh::ForEachOutgoing(uint32_t v, Fn&& fn) const {
+    const uint32_t start = vertexHalfEdge_[v];
+    if (start == kInvalid) return;
+    uint32_t h = start;
+    do {
+        fn(h);
+        h = halfEdgeTwin_[Prev(h)];
+    } while (h != kInvalid && h != start);
 }
 
+}
@@ -1,3 +1,291 @@
 #include "MeshOps.h"
-namespace aartze::geometry { }
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
 
+namespace aartze::geometry {
+
+namespace {
+
+// ---- Forsyth scoring -------------------------------------------------------
+constexpr int kForsythCacheSize = 32;
+constexpr float kCacheDecayPower = 1.5f;
+constexpr float kLastTriangleScore = 0.75f;
+constexpr float kValenceBoostScale = 2.0f;
+constexpr float kValenceBoostPower = 0.5f;
+
+// Scores are tabulated: pow() per rescore dominates the loop otherwise.
+constexpr uint32_t kMaxValence = 32;
+struct ScoreTables {
+    float cache[kForsythCacheSize + 1];  // index 0 = not cached
+    float valence[kMaxValence + 1];
+    ScoreTables() {
+        cache[0] = 0.0f;
+        for (int i = 0; i < kForsythCacheSize; ++i)
+            cache[i + 1] = i < 3 ? kLastTriangleScore
+                                 : std::pow(1.0f - float(i - 3) / float(kForsythCacheSize - 3), kCacheDecayPower);
+        valence[0] = 0.0f;
+        for (uint32_t v = 1; v <= kMaxValence; ++v) valence[v] = kValenceBoostScale * std::pow(float(v), -kValenceBoostPower);
+    }
+};
+
+float VertexScore(const ScoreTables& tables, int cachePosition, uint32_t liveTriangles) {
+    if (liveTriangles == 0) return -1.0f;
+    return tables.cache[cachePosition + 1] + tables.valence[std::min(liveTriangles, kMaxValence)];
+}
+
+// FIFO cache as insertion timestamps: v is cached while fewer than
+// `cacheSize` insertions happened since its own.
+struct FifoCache {
+    std::vector<uint32_t> stamp;
+    uint32_t clock;
+    unsigned size;
+    FifoCache(size_t vertexCount, unsigned cacheSize) : stamp(vertexCount, 0), clock(cacheSize + 1), size(cacheSize) {}
+    bool Touch(uint32_t v) {  // returns true on a miss
+        if (clock - stamp[v] > size) { stamp[v] = clock++; return true; }
+        return false;
+    }
+    void Reset() { clock += size + 1; }
+};
+
+}
+
+size_t MeshOps::Weld(uint32_t* remap, const uint32_t* indices, size_t indexCount, size_t vertexCount,
+                     const VertexStream* streams, size_t streamCount) {
+    std::fill(remap, remap + vertexCount, kUnused);
+    auto bytesOf = [&](size_t s, uint32_t v) { return static_cast<const unsigned char*>(streams[s].data) + v * streams[s].stride; };
+    auto hashVertex = [&](uint32_t v) {
+        uint64_t h = 1469598103934665603ull;  // FNV-1a over 32-bit words
+        for (size_t s = 0; s < streamCount; ++s) {
+            const unsigned char* p = bytesOf(s, v);
+            size_t b = 0;
+            for (uint32_t word; b + 4 <= streams[s].size; b += 4) {
+                std::memcpy(&word, p + b, 4);
+                h = (h ^ word) * 1099511628211ull;
+            }
+            for (; b < streams[s].size; ++b) h = (h ^ p[b]) * 1099511628211ull;
+        }
+        return h;
+    };
+    auto sameVertex = [&](uint32_t a, uint32_t b) {
+        for (size_t s = 0; s < streamCount; ++s)
+            if (std::memcmp(bytesOf(s, a), bytesOf(s, b), streams[s].size) != 0) return false;
+        return true;
+    };
+
+    // Open-addressed table of representative vertices, at most half full.
+    size_t tableSize = 1;
+    while (tableSize < vertexCount * 2) tableSize <<= 1;
+    std::vector<uint32_t> table(tableSize, kUnused);
+    size_t unique = 0;
+    const size_t visits = indices ? indexCount : vertexCount;
+    for (size_t i = 0; i < visits; ++i) {
+        const uint32_t v = indices ? indices[i] : uint32_t(i);
+        if (remap[v] != kUnused) continue;
+        size_t slot = size_t(hashVertex(v)) & (tableSize - 1);
+        while (table[slot] != kUnused && !sameVertex(table[slot], v)) slot = (slot + 1) & (tableSize - 1);
+        if (table[slot] == kUnused) { table[slot] = v; remap[v] = uint32_t(unique++); }
+        else remap[v] = remap[table[slot]];
+    }
+    return unique;
+}
+
+void MeshOps::RemapVertexBuffer(void* destination, const void* vertices, size_t vertexCount, size_t vertexSize,
+                                const uint32_t* remap) {
+    auto* dst = static_cast<unsigned char*>(destination);
+    auto* src = static_cast<const unsigned char*>(vertices);
+    for (size_t v = 0; v < vertexCount; ++v)
+        if (remap[v] != kUnused) std::memcpy(dst + remap[v] * vertexSize, src + v * vertexSize, vertexSize);
+}
+
+void MeshOps::RemapIndexBuffer(uint32_t* destination, const uint32_t* indices, size_t indexCount, const uint32_t* remap) {
+    for (size_t i = 0; i < indexCount; ++i) destination[i] = remap[indices ? indices[i] : uint32_t(i)];
+}
+
+void MeshOps::OptimizeVertexCache(uint32_t* destination, const uint32_t* indices, size_t indexCount, size_t vertexCount) {
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0) return;
+    std::vector<uint32_t> input(indices, indices + triangleCount * 3);
+
+    // Vertex -> triangle adjacency (CSR).
+    std::vector<uint32_t> live(vertexCount, 0), offsets(vertexCount + 1, 0), adjacency(triangleCount * 3);
+    for (uint32_t v : input) ++live[v];
+    for (size_t v = 0; v < vertexCount; ++v) offsets[v + 1] = offsets[v] + live[v];
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (size_t t = 0; t < triangleCount; ++t)
+        for (int k = 0; k < 3; ++k) adjacency[fill[input[t * 3 + k]]++] = uint32_t(t);
+
+    static const ScoreTables tables;
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) vertexScore[v] = VertexScore(tables, -1, live[v]);
+    std::vector<float> triangleScore(triangleCount);
+    std::vector<char> emitted(triangleCount, 0);
+    for (size_t t = 0; t < triangleCount; ++t)
+        triangleScore[t] = vertexScore[input[t * 3]] + vertexScore[input[t * 3 + 1]] + vertexScore[input[t * 3 + 2]];
+
+    uint32_t cache[kForsythCacheSize + 3];
+    int cacheCount = 0;
+    size_t cursor = 0;  // fallback scan when nothing in the cache has live triangles
+    uint32_t best = 0;
+    float bestScore = -1.0f;
+    for (size_t t = 0; t < triangleCount; ++t)
+        if (triangleScore[t] > bestScore) { bestScore = triangleScore[t]; best = uint32_t(t); }
+
+    for (size_t out = 0; out < triangleCount; ++out) {
+        if (bestScore < 0.0f) {
+            while (emitted[cursor]) ++cursor;
+            best = uint32_t(cursor);
+        }
+        const uint32_t* tri = &input[best * 3];
+        std::memcpy(destination + out * 3, tri, 3 * sizeof(uint32_t));
+        emitted[best] = 1;
+
+        // Remove the triangle from its vertices' live lists.
+        for (int k = 0; k < 3; ++k) {
+            uint32_t v = tri[k];
+            uint32_t* begin = &adjacency[offsets[v]];
+            uint32_t* end = begin + live[v];
+            *std::find(begin, end, best) = end[-1];
+            --live[v];
+        }
+
+        // LRU: the triangle's vertices move to the front.
+        uint32_t next[kForsythCacheSize + 3];
+        int nextCount = 0;
+        for (int k = 0; k < 3; ++k) next[nextCount++] = tri[k];
+        for (int i = 0; i < cacheCount; ++i)
+            if (cache[i] != tri[0] && cache[i] != tri[1] && cache[i] != tri[2]) next[nextCount++] = cache[i];
+        for (int i = 0; i < nextCount; ++i) cachePosition[next[i]] = i < kForsythCacheSize ? i : -1;
+        std::memcpy(cache, next, sizeof(uint32_t) * nextCount);
+        cacheCount = nextCount;
+
+        // Rescore every vertex that moved and its live triangles; the best of
+        // those is the next candidate.
+        for (int i = 0; i < cacheCount; ++i) {
+            uint32_t v = cache[i];
+            float updated = VertexScore(tables, cachePosition[v], live[v]);
+            float delta = updated - vertexScore[v];
+            vertexScore[v] = updated;
+            for (uint32_t a = offsets[v]; a < offsets[v] + live[v]; ++a) triangleScore[adjacency[a]] += delta;
+        }
+        cacheCount = std::min(cacheCount, kForsythCacheSize);
+        bestScore = -1.0f;
+        for (int i = 0; i < cacheCount; ++i) {
+            uint32_t v = cache[i];
+            for (uint32_t a = offsets[v]; a < offsets[v] + live[v]; ++a)
+                if (triangleScore[adjacency[a]] > bestScore) { bestScore = triangleScore[adjacency[a]]; best = adjacency[a]; }
+        }
+    }
+}
+
+void MeshOps::OptimizeOverdraw(uint32_t* destination, const uint32_t* indices, size_t indexCount, const float* positions,
+                               size_t vertexCount, size_t positionStride, float threshold) {
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0) return;
+    std::vector<uint32_t> input(indices, indices + triangleCount * 3);
+    const size_t floatStride = positionStride / sizeof(float);
+
+    // Hard boundaries: triangles whose three vertices all miss the cache.
+    constexpr unsigned kCacheSize = 16;
+    FifoCache cache(vertexCount, kCacheSize);
+    std::vector<size_t> hard;
+    for (size_t t = 0; t < triangleCount; ++t) {
+        int misses = cache.Touch(input[t * 3]) + cache.Touch(input[t * 3 + 1]) + cache.Touch(input[t * 3 + 2]);
+        if (t == 0 || misses == 3) hard.push_back(t);
+    }
+    hard.push_back(triangleCount);
+
+    // Soft boundaries: replay each hard cluster with a fresh cache and cut as
+    // soon as the running ACMR is within `threshold` of the whole cluster's.
+    std::vector<size_t> clusters;
+    for (size_t h = 0; h + 1 < hard.size(); ++h) {
+        const size_t begin = hard[h], end = hard[h + 1];
+        cache.Reset();
+        size_t totalMisses = 0;
+        for (size_t t = begin; t < end; ++t)
+            for (int k = 0; k < 3; ++k) totalMisses += cache.Touch(input[t * 3 + k]);
+        const float target = threshold * float(totalMisses) / float(end - begin);
+
+        cache.Reset();
+        size_t start = begin, misses = 0;
+        clusters.push_back(begin);
+        for (size_t t = begin; t < end; ++t) {
+            for (int k = 0; k < 3; ++k) misses += cache.Touch(input[t * 3 + k]);
+            if (t + 1 < end && float(misses) / float(t + 1 - start) <= target) {
+                clusters.push_back(t + 1);
+                cache.Reset();
+                start = t + 1;
+                misses = 0;
+            }
+        }
+    }
+    clusters.push_back(triangleCount);
+
+    // Sort by how far each cluster faces away from the mesh centre: outside
+    // surfaces first, so they fill depth before what they hide.
+    struct Cluster { size_t begin, end; float centroid[3], normal[3], area; float key; };
+    std::vector<Cluster> sorted(clusters.size() - 1);
+    float meshCentroid[3] = {0, 0, 0}, meshArea = 0.0f;
+    for (size_t c = 0; c + 1 < clusters.size(); ++c) {
+        Cluster& cl = sorted[c];
+        cl = {clusters[c], clusters[c + 1], {0, 0, 0}, {0, 0, 0}, 0.0f, 0.0f};
+        for (size_t t = cl.begin; t < cl.end; ++t) {
+            const float* a = positions + input[t * 3] * floatStride;
+            const float* b = positions + input[t * 3 + 1] * floatStride;
+            const float* d = positions + input[t * 3 + 2] * floatStride;
+            float e1[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]}, e2[3] = {d[0] - a[0], d[1] - a[1], d[2] - a[2]};
+            float n[3] = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+            float area = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+            for (int k = 0; k < 3; ++k) {
+                cl.centroid[k] += area * (a[k] + b[k] + d[k]) / 3.0f;
+                cl.normal[k] += n[k];
+            }
+            cl.area += area;
+        }
+        for (int k = 0; k < 3; ++k) meshCentroid[k] += cl.centroid[k];
+        meshArea += cl.area;
+        if (cl.area > 0.0f) for (float& x : cl.centroid) x /= cl.area;
+    }
+    if (meshArea > 0.0f) for (float& x : meshCentroid) x /= meshArea;
+    for (Cluster& cl : sorted) {
+        float len = std::sqrt(cl.normal[0] * cl.normal[0] + cl.normal[1] * cl.normal[1] + cl.normal[2] * cl.normal[2]);
+        float dot = 0.0f;
+        for (int k = 0; k < 3; ++k) dot += (cl.centroid[k] - meshCentroid[k]) * cl.normal[k];
+        cl.key = len > 0.0f ? dot / len : 0.0f;
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), [](const Cluster& a, const Cluster& b) { return a.key > b.key; });
+
+    uint32_t* out = destination;
+    for (const Cluster& cl : sorted) {
+        std::memcpy(out, &input[cl.begin * 3], (cl.end - cl.begin) * 3 * sizeof(uint32_t));
+        out += (cl.end - cl.begin) * 3;
+    }
+}
+
+size_t MeshOps::OptimizeVertexFetch(uint32_t* remap, const uint32_t* indices, size_t indexCount, size_t vertexCount) {
+    std::fill(remap, remap + vertexCount, kUnused);
+    uint32_t next = 0;
+    for (size_t i = 0; i < indexCount; ++i)
+        if (remap[indices[i]] == kUnused) remap[indices[i]] = next++;
+    return next;
+}
+
+VertexCacheStatistics MeshOps::AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount,
+                                                  unsigned cacheSize) {
+    VertexCacheStatistics stats;
+    if (indexCount < 3) return stats;
+    FifoCache cache(vertexCount, cacheSize);
+    std::vector<char> referenced(vertexCount, 0);
+    size_t unique = 0;
+    for (size_t i = 0; i < indexCount; ++i) {
+        stats.verticesTransformed += cache.Touch(indices[i]);
+        if (!referenced[indices[i]]) { referenced[indices[i]] = 1; ++unique; }
+    }
+    stats.acmr = float(stats.verticesTransformed) / float(indexCount / 3);
+    stats.atvr = float(stats.verticesTransformed) / float(unique);
+    return stats;
+}
+
+}
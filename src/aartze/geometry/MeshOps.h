@@ -1,5 +1,61 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
+
 namespace aartze::geometry {
-struct MeshOps { static void Weld(){} };
-}
 
+// One attribute stream of a vertex buffer: `size` bytes per vertex, `stride`
+// bytes between consecutive vertices.
+struct VertexStream {
+    const void* data;
+    size_t size;
+    size_t stride;
+};
+
+struct VertexCacheStatistics {
+    uint32_t verticesTransformed = 0;
+    float acmr = 0.0f;  // transformed vertices per triangle (0.5 is ideal for big grids, 3 is worst)
+    float atvr = 0.0f;  // transformed vertices per referenced vertex (1 is ideal)
+};
+
+/**
+ * Index-buffer optimization for triangle lists, run on imported meshes in
+ * this order: Weld, OptimizeVertexCache, OptimizeOverdraw, OptimizeVertexFetch.
+ * Functions take raw arrays so engine MeshData and runtime Mesh share them.
+ * `destination` may alias `indices` unless stated otherwise.
+ */
+struct MeshOps {
+    static constexpr uint32_t kUnused = ~0u;
+
+    // Give bit-identical vertices (compared over every stream) the same new
+    // index. remap[v] receives the new index, numbered in first-use order, or
+    // kUnused for vertices no index refers to. A null `indices` means every
+    // vertex in order. Returns the unique vertex count.
+    static size_t Weld(uint32_t* remap, const uint32_t* indices, size_t indexCount, size_t vertexCount,
+                       const VertexStream* streams, size_t streamCount);
+
+    // destination[remap[v]] = vertices[v]; must not alias `vertices`.
+    static void RemapVertexBuffer(void* destination, const void* vertices, size_t vertexCount, size_t vertexSize,
+                                  const uint32_t* remap);
+    static void RemapIndexBuffer(uint32_t* destination, const uint32_t* indices, size_t indexCount, const uint32_t* remap);
+
+    // Reorder triangles for the post-transform cache (Forsyth's linear-speed
+    // algorithm over a 32-entry LRU model).
+    static void OptimizeVertexCache(uint32_t* destination, const uint32_t* indices, size_t indexCount, size_t vertexCount);
+
+    // Split a cache-optimized list into clusters (Tipsify-style: hard breaks
+    // where the cache empties, soft breaks while the cluster's ACMR stays within
+    // `threshold` of the unsplit one) and draw outward-facing clusters first.
+    static void OptimizeOverdraw(uint32_t* destination, const uint32_t* indices, size_t indexCount, const float* positions,
+                                 size_t vertexCount, size_t positionStride, float threshold = 1.05f);
+
+    // remap[v] = position of v in the order the index buffer first fetches it
+    // (kUnused if never). Returns the referenced vertex count.
+    static size_t OptimizeVertexFetch(uint32_t* remap, const uint32_t* indices, size_t indexCount, size_t vertexCount);
+
+    // FIFO post-transform cache simulation.
+    static VertexCacheStatistics AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount,
+                                                    unsigned cacheSize = 16);
+};
+
+}
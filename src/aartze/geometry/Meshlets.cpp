@@ -0,0 +1,206 @@
+#include "Meshlets.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace aartze::geometry {
+
+namespace {
+
+constexpr uint8_t kNotInMeshlet = 0xFF;
+
+const float* PositionAt(const float* positions, size_t stride, uint32_t v) {
+    return reinterpret_cast<const float*>(reinterpret_cast<const char*>(positions) + size_t(v) * stride);
+}
+
+template <class VertexAt>
+MeshletBounds BoundsOf(size_t triangleCount, VertexAt&& vertexAt) {
+    MeshletBounds b;
+    if (triangleCount == 0) return b;
+    float mn[3] = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max()};
+    float mx[3] = {-mn[0], -mn[1], -mn[2]};
+    for (size_t t = 0; t < triangleCount; ++t)
+        for (int k = 0; k < 3; ++k) {
+            const float* p = vertexAt(t, k);
+            for (int a = 0; a < 3; ++a) { mn[a] = std::min(mn[a], p[a]); mx[a] = std::max(mx[a], p[a]); }
+        }
+    for (int a = 0; a < 3; ++a) b.center[a] = 0.5f * (mn[a] + mx[a]);
+    float r2 = 0.0f;
+    for (size_t t = 0; t < triangleCount; ++t)
+        for (int k = 0; k < 3; ++k) {
+            const float* p = vertexAt(t, k);
+            const float d[3] = {p[0] - b.center[0], p[1] - b.center[1], p[2] - b.center[2]};
+            r2 = std::max(r2, d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+        }
+    b.radius = std::sqrt(r2);
+
+    // Cone around the mean of the unit face normals; zero-area triangles face
+    // nowhere and keep a zero normal.
+    std::vector<float> normals(triangleCount * 3, 0.0f);
+    float axis[3] = {0.0f, 0.0f, 0.0f};
+    size_t faces = 0;
+    for (size_t t = 0; t < triangleCount; ++t) {
+        const float *p0 = vertexAt(t, 0), *p1 = vertexAt(t, 1), *p2 = vertexAt(t, 2);
+        const float u[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+        const float v[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+        float n[3] = {u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0]};
+        const float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if (length == 0.0f) continue;
+        for (int a = 0; a < 3; ++a) { n[a] /= length; axis[a] += n[a]; normals[t * 3 + a] = n[a]; }
+        ++faces;
+    }
+    const float axisLength = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+    if (faces == 0 || axisLength == 0.0f) return b;
+    for (float& a : axis) a /= axisLength;
+    float minDot = 1.0f;
+    for (size_t t = 0; t < triangleCount; ++t) {
+        const float* n = &normals[t * 3];
+        if (n[0] != 0.0f || n[1] != 0.0f || n[2] != 0.0f)
+            minDot = std::min(minDot, n[0] * axis[0] + n[1] * axis[1] + n[2] * axis[2]);
+    }
+    std::copy(axis, axis + 3, b.coneAxis);
+    // Normals spread over (nearly) a hemisphere: some triangle always faces the camera.
+    if (minDot <= 0.1f) return b;
+
+    // Pull the apex back along the axis until it lies behind every triangle's
+    // plane, so the test holds for cameras close to the cluster too.
+    float maxT = 0.0f;
+    for (size_t t = 0; t < triangleCount; ++t) {
+        const float* n = &normals[t * 3];
+        if (n[0] == 0.0f && n[1] == 0.0f && n[2] == 0.0f) continue;
+        const float* p0 = vertexAt(t, 0);
+        const float dc = (b.center[0] - p0[0]) * n[0] + (b.center[1] - p0[1]) * n[1] + (b.center[2] - p0[2]) * n[2];
+        const float dn = axis[0] * n[0] + axis[1] * n[1] + axis[2] * n[2];
+        maxT = std::max(maxT, dc / dn);
+    }
+    for (int a = 0; a < 3; ++a) b.coneApex[a] = b.center[a] - axis[a] * maxT;
+    b.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+    return b;
+}
+
+}
+
+void Meshlets::Build(MeshletBuffers& out, const uint32_t* indices, size_t indexCount, const float* positions,
+                     size_t vertexCount, size_t positionStride, size_t maxVertices, size_t maxTriangles) {
+    assert(maxVertices >= 3 && maxVertices < kNotInMeshlet && maxTriangles >= 1);
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0) return;
+
+    // Vertex -> triangles adjacency (CSR) and the centroid of every triangle.
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (size_t i = 0; i < triangleCount * 3; ++i) ++offsets[indices[i] + 1];
+    for (size_t v = 0; v < vertexCount; ++v) offsets[v + 1] += offsets[v];
+    std::vector<uint32_t> adjacency(triangleCount * 3);
+    {
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t t = 0; t < triangleCount; ++t)
+            for (int k = 0; k < 3; ++k) adjacency[fill[indices[t * 3 + k]]++] = uint32_t(t);
+    }
+    std::vector<float> centroids(triangleCount * 3);
+    for (size_t t = 0; t < triangleCount; ++t)
+        for (int a = 0; a < 3; ++a) {
+            float sum = 0.0f;
+            for (int k = 0; k < 3; ++k) sum += PositionAt(positions, positionStride, indices[t * 3 + k])[a];
+            centroids[t * 3 + a] = sum / 3.0f;
+        }
+
+    std::vector<uint8_t> emitted(triangleCount, 0);
+    std::vector<uint32_t> live(vertexCount);  // triangles not yet emitted, per vertex
+    for (size_t v = 0; v < vertexCount; ++v) live[v] = offsets[v + 1] - offsets[v];
+    std::vector<uint8_t> local(vertexCount, kNotInMeshlet);
+    size_t cursor = 0;
+    uint32_t seed = ~0u;
+    for (;;) {
+        if (seed == ~0u) {
+            while (cursor < triangleCount && emitted[cursor]) ++cursor;
+            if (cursor == triangleCount) break;
+            seed = uint32_t(cursor);
+        }
+
+        Meshlet m;
+        m.vertexOffset = uint32_t(out.vertices.size());
+        m.triangleOffset = uint32_t(out.triangles.size() / 3);
+        float sum[3] = {0.0f, 0.0f, 0.0f};
+        auto add = [&](uint32_t t) {
+            for (int k = 0; k < 3; ++k) {
+                const uint32_t v = indices[t * 3 + k];
+                if (local[v] == kNotInMeshlet) {
+                    local[v] = uint8_t(m.vertexCount++);
+                    out.vertices.push_back(v);
+                }
+                out.triangles.push_back(local[v]);
+                --live[v];
+            }
+            for (int a = 0; a < 3; ++a) sum[a] += centroids[t * 3 + a];
+            emitted[t] = 1;
+            ++m.triangleCount;
+        };
+        uint32_t last = seed;
+        add(last);
+
+        while (m.triangleCount < maxTriangles) {
+            const float center[3] = {sum[0] / m.triangleCount, sum[1] / m.triangleCount, sum[2] / m.triangleCount};
+            uint32_t best = ~0u;
+            int bestScore = 4;
+            float bestDistance = 0.0f;
+            auto consider = [&](uint32_t v) {
+                for (uint32_t a = offsets[v]; a < offsets[v + 1]; ++a) {
+                    const uint32_t t = adjacency[a];
+                    if (emitted[t]) continue;
+                    const uint32_t* tri = &indices[t * 3];
+                    const int added = (local[tri[0]] == kNotInMeshlet) + (local[tri[1]] == kNotInMeshlet) +
+                                      (local[tri[2]] == kNotInMeshlet);
+                    if (m.vertexCount + added > maxVertices) continue;
+                    // A vertex's last triangle goes first: left behind, it would
+                    // end up as a tiny meshlet of its own.
+                    const int score = (live[tri[0]] == 1 || live[tri[1]] == 1 || live[tri[2]] == 1) ? 0 : added;
+                    if (score > bestScore) continue;
+                    const float* c = &centroids[t * 3];
+                    const float d = (c[0] - center[0]) * (c[0] - center[0]) + (c[1] - center[1]) * (c[1] - center[1]) +
+                                    (c[2] - center[2]) * (c[2] - center[2]);
+                    if (score < bestScore || d < bestDistance) { best = t; bestScore = score; bestDistance = d; }
+                }
+            };
+            // Neighbours of the last triangle first; the whole border only when those run out.
+            for (int k = 0; k < 3; ++k) consider(indices[last * 3 + k]);
+            if (best == ~0u)
+                for (uint32_t i = 0; i < m.vertexCount; ++i) consider(out.vertices[m.vertexOffset + i]);
+            if (best == ~0u) break;
+            add(best);
+            last = best;
+        }
+
+        // Seed the next meshlet on this one's border, at the triangle with the
+        // fewest live neighbours, so the surface is consumed from one front.
+        seed = ~0u;
+        uint32_t seedLive = ~0u;
+        for (uint32_t i = 0; i < m.vertexCount; ++i) {
+            const uint32_t v = out.vertices[m.vertexOffset + i];
+            local[v] = kNotInMeshlet;
+            for (uint32_t a = offsets[v]; a < offsets[v + 1]; ++a) {
+                const uint32_t t = adjacency[a];
+                if (emitted[t]) continue;
+                const uint32_t* tri = &indices[t * 3];
+                const uint32_t neighbours = live[tri[0]] + live[tri[1]] + live[tri[2]];
+                if (neighbours < seedLive) { seed = t; seedLive = neighbours; }
+            }
+        }
+        out.meshlets.push_back(m);
+    }
+}
+
+MeshletBounds Meshlets::ComputeBounds(const uint32_t* indices, size_t indexCount, const float* positions,
+                                      size_t positionStride) {
+    return BoundsOf(indexCount / 3, [&](size_t t, int k) { return PositionAt(positions, positionStride, indices[t * 3 + k]); });
+}
+
+MeshletBounds Meshlets::ComputeBounds(const MeshletBuffers& buffers, const Meshlet& meshlet, const float* positions,
+                                      size_t positionStride) {
+    const uint32_t* vertices = &buffers.vertices[meshlet.vertexOffset];
+    const uint8_t* triangles = &buffers.triangles[size_t(meshlet.triangleOffset) * 3];
+    return BoundsOf(meshlet.triangleCount,
+                    [&](size_t t, int k) { return PositionAt(positions, positionStride, vertices[triangles[t * 3 + k]]); });
+}
+
+}
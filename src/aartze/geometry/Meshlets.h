@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace aartze::geometry {
+
+// Fixed-size meshlet header: ranges of MeshletBuffers::vertices (global vertex
+// ids) and MeshletBuffers::triangles (3 local 8-bit indices per triangle).
+struct Meshlet {
+    uint32_t vertexOffset = 0;
+    uint32_t triangleOffset = 0;  // in triangles
+    uint32_t vertexCount = 0;
+    uint32_t triangleCount = 0;
+};
+
+struct MeshletBuffers {
+    std::vector<Meshlet> meshlets;
+    std::vector<uint32_t> vertices;
+    std::vector<uint8_t> triangles;
+};
+
+// Bounding sphere plus a normal cone. A camera at `eye` sees none of the
+// triangles (all backfacing) when
+//   dot(normalize(coneApex - eye), coneAxis) >= coneCutoff;
+// coneCutoff is 1 when the normals spread too far for the test to ever pass.
+struct MeshletBounds {
+    float center[3] = {0.0f, 0.0f, 0.0f};
+    float radius = 0.0f;
+    float coneApex[3] = {0.0f, 0.0f, 0.0f};
+    float coneAxis[3] = {0.0f, 0.0f, 1.0f};
+    float coneCutoff = 1.0f;
+};
+
+/**
+ * Splits triangle lists into meshlets: small clusters with at most
+ * kMaxVertices vertices and kMaxTriangles triangles that are culled as a unit.
+ * Clusters grow greedily over shared vertices, preferring a vertex's last
+ * remaining triangle, then triangles that add no new vertex, then the one
+ * closest to the cluster, so they come out compact with narrow normal cones
+ * and few leftover fragments. Each meshlet is seeded on the border of the
+ * one before it.
+ */
+struct Meshlets {
+    static constexpr size_t kMaxVertices = 128;
+    static constexpr size_t kMaxTriangles = 128;
+
+    // Appends to `out`. maxVertices may be at most 255.
+    static void Build(MeshletBuffers& out, const uint32_t* indices, size_t indexCount, const float* positions,
+                      size_t vertexCount, size_t positionStride, size_t maxVertices = kMaxVertices,
+                      size_t maxTriangles = kMaxTriangles);
+
+    // Bounds of a triangle list over global vertex ids.
+    static MeshletBounds ComputeBounds(const uint32_t* indices, size_t indexCount, const float* positions,
+                                       size_t positionStride);
+    static MeshletBounds ComputeBounds(const MeshletBuffers& buffers, const Meshlet& meshlet, const float* positions,
+                                       size_t positionStride);
+};
+
+}
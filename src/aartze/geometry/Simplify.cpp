@@ -0,0 +1,362 @@
+#include "Simplify.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "HalfEdgeMesh.h"
+#include "MeshOps.h"
+
+namespace aartze::geometry {
+
+namespace {
+
+// Sum of squared distances to weighted planes, as the symmetric 4x4 matrix
+// [A b; b^T c] with A = sum w n n^T, b = sum w d n, c = sum w d^2.
+struct Quadric {
+    double xx = 0, xy = 0, xz = 0, yy = 0, yz = 0, zz = 0;
+    double x = 0, y = 0, z = 0, c = 0;
+    double weight = 0;
+
+    void AddPlane(const double n[3], double d, double w) {
+        xx += w * n[0] * n[0]; xy += w * n[0] * n[1]; xz += w * n[0] * n[2];
+        yy += w * n[1] * n[1]; yz += w * n[1] * n[2]; zz += w * n[2] * n[2];
+        x += w * d * n[0]; y += w * d * n[1]; z += w * d * n[2];
+        c += w * d * d;
+        weight += w;
+    }
+    void Add(const Quadric& q) {
+        xx += q.xx; xy += q.xy; xz += q.xz; yy += q.yy; yz += q.yz; zz += q.zz;
+        x += q.x; y += q.y; z += q.z; c += q.c;
+        weight += q.weight;
+    }
+    double Evaluate(const float p[3]) const {
+        const double px = p[0], py = p[1], pz = p[2];
+        return px * (xx * px + 2 * (xy * py + xz * pz + x)) + py * (yy * py + 2 * (yz * pz + y)) +
+               pz * (zz * pz + 2 * z) + c;
+    }
+};
+
+// Mean squared distance of p from the planes of both quadrics.
+float CollapseCost(const Quadric& a, const Quadric& b, const float p[3]) {
+    const double weight = a.weight + b.weight;
+    if (weight <= 0) return 0.0f;
+    return float(std::max(0.0, (a.Evaluate(p) + b.Evaluate(p)) / weight));
+}
+
+// Binary min-heap of vertices keyed by collapse cost. Each vertex holds at
+// most one slot, so a changed cost moves it in place instead of leaving a
+// stale entry behind; the heap never outgrows the vertex count.
+class VertexHeap {
+public:
+    static constexpr uint32_t kNone = ~0u;
+
+    void Reset(size_t vertexCount) {
+        heap_.clear();
+        slot_.assign(vertexCount, kNone);
+    }
+    bool Empty() const { return heap_.empty(); }
+    bool Contains(uint32_t v) const { return slot_[v] != kNone; }
+    float Cost(uint32_t v) const { return heap_[slot_[v]].cost; }
+    uint32_t Top() const { return heap_[0].vertex; }
+    float TopCost() const { return heap_[0].cost; }
+
+    void Update(uint32_t v, float cost) {
+        if (slot_[v] == kNone) {
+            heap_.push_back({cost, v});
+            Up(uint32_t(heap_.size() - 1));
+        } else {
+            const uint32_t i = slot_[v];
+            const bool cheaper = cost < heap_[i].cost;
+            heap_[i].cost = cost;
+            cheaper ? Up(i) : Down(i);
+        }
+    }
+    void Remove(uint32_t v) {
+        const uint32_t i = slot_[v];
+        if (i == kNone) return;
+        slot_[v] = kNone;
+        const Entry last = heap_.back();
+        heap_.pop_back();
+        if (i == heap_.size()) return;
+        const bool cheaper = last.cost < heap_[i].cost;
+        heap_[i] = last;
+        cheaper ? Up(i) : Down(i);
+    }
+
+private:
+    // Costs live in the heap itself so sifting compares without chasing vertices.
+    struct Entry {
+        float cost;
+        uint32_t vertex;
+    };
+
+    void Place(const Entry& e, uint32_t i) {
+        heap_[i] = e;
+        slot_[e.vertex] = i;
+    }
+    void Up(uint32_t i) {
+        const Entry e = heap_[i];
+        while (i > 0) {
+            const uint32_t parent = (i - 1) / 2;
+            if (heap_[parent].cost <= e.cost) break;
+            Place(heap_[parent], i);
+            i = parent;
+        }
+        Place(e, i);
+    }
+    void Down(uint32_t i) {
+        const Entry e = heap_[i];
+        const uint32_t n = uint32_t(heap_.size());
+        for (;;) {
+            uint32_t child = 2 * i + 1;
+            if (child >= n) break;
+            if (child + 1 < n && heap_[child + 1].cost < heap_[child].cost) ++child;
+            if (heap_[child].cost >= e.cost) break;
+            Place(heap_[child], i);
+            i = child;
+        }
+        Place(e, i);
+    }
+
+    std::vector<Entry> heap_;
+    std::vector<uint32_t> slot_;  // position of each vertex in heap_, kNone when absent
+};
+
+void Cross(const float a[3], const float b[3], const float o[3], double out[3]) {
+    const double u[3] = {double(a[0]) - o[0], double(a[1]) - o[1], double(a[2]) - o[2]};
+    const double v[3] = {double(b[0]) - o[0], double(b[1]) - o[1], double(b[2]) - o[2]};
+    out[0] = u[1] * v[2] - u[2] * v[1];
+    out[1] = u[2] * v[0] - u[0] * v[2];
+    out[2] = u[0] * v[1] - u[1] * v[0];
+}
+
+// The collapse state of one mesh. Levels of a LOD chain continue from where
+// the previous level stopped, so the weld, half-edge build and quadrics are
+// done once per chain and later levels only pay for their own collapses.
+class Collapser {
+public:
+    Collapser(const uint32_t* indices, size_t indexCount, const float* positions, size_t vertexCount,
+              size_t positionStride);
+
+    // Collapse until at most targetIndexCount indices remain or the next
+    // collapse would cost more than targetError.
+    void Run(size_t targetIndexCount, float targetError);
+    // Live triangles in original vertex indices; returns the index count.
+    size_t Emit(uint32_t* destination) const;
+    size_t IndexCount() const { return mesh_.LiveFaceCount() * 3; }
+    // Largest deviation introduced so far, measured against the input surface.
+    float Error() const { return std::sqrt(worst_); }
+
+private:
+    void Push(uint32_t v);
+    void Retarget(uint32_t n, uint32_t x, uint32_t removed);
+    bool Folds(uint32_t v, uint32_t h) const;
+
+    HalfEdgeMesh mesh_;
+    // Corner h keeps the original vertex it refers to; collapses never move half-edges.
+    std::vector<uint32_t> corners_;
+    std::vector<Quadric> quadrics_;
+    std::vector<uint8_t> locked_;
+    VertexHeap heap_;
+    std::vector<uint32_t> target_;  // the neighbour each queued vertex would collapse onto
+    float worst_ = 0.0f;
+    std::vector<std::pair<float, uint32_t>> options_;
+    std::vector<uint32_t> fan_, ring_;
+};
+
+Collapser::Collapser(const uint32_t* indices, size_t indexCount, const float* positions, size_t vertexCount,
+                     size_t positionStride) {
+    // Simplify on positions alone; several vertices at one position mark a seam.
+    std::vector<uint32_t> weld(vertexCount);
+    const VertexStream stream{positions, 3 * sizeof(float), positionStride};
+    const size_t unique = MeshOps::Weld(weld.data(), indices, indexCount, vertexCount, &stream, 1);
+    std::vector<float> weldedPositions(unique * 3);
+    std::vector<uint32_t> firstVertex(unique, MeshOps::kUnused);
+    locked_.assign(unique, 0);
+    std::vector<uint32_t> weldedIndices(indexCount);
+    const char* base = reinterpret_cast<const char*>(positions);
+    for (size_t i = 0; i < indexCount; ++i) {
+        const uint32_t v = indices[i], w = weld[v];
+        weldedIndices[i] = w;
+        if (firstVertex[w] == MeshOps::kUnused) {
+            firstVertex[w] = v;
+            std::memcpy(&weldedPositions[size_t(w) * 3], base + v * positionStride, 3 * sizeof(float));
+        } else if (firstVertex[w] != v) {
+            locked_[w] = 1;
+        }
+    }
+
+    mesh_.Build(weldedPositions.data(), 3 * sizeof(float), unique, weldedIndices.data(), indexCount);
+    corners_.assign(indices, indices + indexCount);
+
+    std::vector<uint32_t> outgoing(unique, 0);
+    for (uint32_t h = 0; h < mesh_.HalfEdgeCount(); ++h)
+        if (mesh_.FaceAlive(HalfEdgeMesh::Face(h))) ++outgoing[mesh_.From(h)];
+    quadrics_.resize(unique);
+    for (uint32_t v = 0; v < unique; ++v) {
+        if (!mesh_.VertexAlive(v)) continue;
+        uint32_t fan = 0;
+        mesh_.ForEachOutgoing(v, [&](uint32_t) { ++fan; });
+        if (mesh_.IsBoundaryVertex(v) || fan != outgoing[v]) locked_[v] = 1;
+    }
+    for (uint32_t f = 0; f < mesh_.FaceCount(); ++f) {
+        if (!mesh_.FaceAlive(f)) continue;
+        const uint32_t a = mesh_.From(f * 3), b = mesh_.From(f * 3 + 1), c = mesh_.From(f * 3 + 2);
+        double n[3];
+        Cross(mesh_.Position(b), mesh_.Position(c), mesh_.Position(a), n);
+        const double length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if (length == 0.0) continue;
+        for (double& k : n) k /= length;
+        const float* p = mesh_.Position(a);
+        const double d = -(n[0] * p[0] + n[1] * p[1] + n[2] * p[2]);
+        for (uint32_t v : {a, b, c}) quadrics_[v].AddPlane(n, d, 0.5 * length);
+    }
+
+    heap_.Reset(unique);
+    target_.assign(unique, HalfEdgeMesh::kInvalid);
+    for (uint32_t v = 0; v < unique; ++v) Push(v);
+}
+
+void Collapser::Push(uint32_t v) {
+    if (locked_[v] || !mesh_.VertexAlive(v)) return;
+    float best = std::numeric_limits<float>::infinity();
+    mesh_.ForEachOutgoing(v, [&](uint32_t h) {
+        const uint32_t x = mesh_.To(h);
+        const float cost = CollapseCost(quadrics_[v], quadrics_[x], mesh_.Position(x));
+        if (cost < best) {
+            best = cost;
+            target_[v] = x;
+        }
+    });
+    heap_.Update(v, best);
+}
+
+// After `removed` collapsed into x only n's edge to x changed, so a full
+// rescan of n is needed only when that edge was its best and got dearer.
+void Collapser::Retarget(uint32_t n, uint32_t x, uint32_t removed) {
+    if (locked_[n] || !heap_.Contains(n)) return Push(n);
+    const float cost = CollapseCost(quadrics_[n], quadrics_[x], mesh_.Position(x));
+    if (cost <= heap_.Cost(n)) {
+        target_[n] = x;
+        heap_.Update(n, cost);
+    } else if (target_[n] == x || target_[n] == removed) {
+        Push(n);
+    }
+}
+
+// Moving v onto To(h) must not turn any of its remaining triangles over.
+bool Collapser::Folds(uint32_t v, uint32_t h) const {
+    const uint32_t x = mesh_.To(h);
+    const float* pv = mesh_.Position(v);
+    const float* px = mesh_.Position(x);
+    bool flipped = false;
+    mesh_.ForEachOutgoing(v, [&](uint32_t g) {
+        const uint32_t a = mesh_.To(g), b = mesh_.From(HalfEdgeMesh::Prev(g));
+        if (flipped || a == x || b == x) return;
+        double before[3], after[3];
+        Cross(mesh_.Position(a), mesh_.Position(b), pv, before);
+        Cross(mesh_.Position(a), mesh_.Position(b), px, after);
+        flipped = before[0] * after[0] + before[1] * after[1] + before[2] * after[2] <= 0.0;
+    });
+    return flipped;
+}
+
+void Collapser::Run(size_t targetIndexCount, float targetError) {
+    const float limit = targetError * targetError;
+    while (!heap_.Empty() && mesh_.LiveFaceCount() * 3 > targetIndexCount) {
+        const uint32_t v = heap_.Top();
+        const float vCost = heap_.TopCost();
+        if (vCost > limit) break;
+        heap_.Remove(v);
+        if (!mesh_.VertexAlive(v)) continue;
+
+        options_.clear();
+        mesh_.ForEachOutgoing(v, [&](uint32_t h) {
+            options_.push_back({CollapseCost(quadrics_[v], quadrics_[mesh_.To(h)], mesh_.Position(mesh_.To(h))), h});
+        });
+        std::sort(options_.begin(), options_.end());
+        uint32_t done = HalfEdgeMesh::kInvalid;
+        for (const auto& [cost, h] : options_) {
+            if (cost > limit) break;
+            // A pricier fallback waits its turn behind cheaper vertices.
+            if (!heap_.Empty() && cost > heap_.TopCost() && cost > vCost) {
+                target_[v] = mesh_.To(h);
+                heap_.Update(v, cost);
+                break;
+            }
+            if (Folds(v, h)) continue;
+            fan_.clear();
+            mesh_.ForEachOutgoing(v, [&](uint32_t g) { fan_.push_back(g); });
+            const uint32_t x = mesh_.To(h), xCorner = corners_[HalfEdgeMesh::Next(h)];
+            if (!mesh_.CollapseEdge(h)) continue;
+            for (uint32_t g : fan_) corners_[g] = xCorner;
+            quadrics_[x].Add(quadrics_[v]);
+            worst_ = std::max(worst_, cost);
+            done = x;
+            break;
+        }
+        if (done == HalfEdgeMesh::kInvalid) continue;
+        Push(done);
+        mesh_.OneRing(done, ring_);
+        for (uint32_t n : ring_) Retarget(n, done, v);
+    }
+}
+
+size_t Collapser::Emit(uint32_t* destination) const {
+    size_t count = 0;
+    for (uint32_t f = 0; f < mesh_.FaceCount(); ++f) {
+        if (!mesh_.FaceAlive(f)) continue;
+        for (uint32_t k = 0; k < 3; ++k) destination[count++] = corners_[f * 3 + k];
+    }
+    return count;
+}
+
+}  // namespace
+
+size_t Simplifier::Simplify(uint32_t* destination, const uint32_t* indices, size_t indexCount, const float* positions,
+                            size_t vertexCount, size_t positionStride, size_t targetIndexCount, float targetError,
+                            float* resultError) {
+    indexCount -= indexCount % 3;
+    if (resultError) *resultError = 0.0f;
+    if (indexCount <= targetIndexCount || vertexCount == 0) {
+        if (destination != indices) std::memmove(destination, indices, indexCount * sizeof(uint32_t));
+        return indexCount;
+    }
+
+    Collapser collapser(indices, indexCount, positions, vertexCount, positionStride);
+    collapser.Run(targetIndexCount, targetError);
+    if (resultError) *resultError = collapser.Error();
+    return collapser.Emit(destination);
+}
+
+size_t Simplifier::BuildLodChain(std::vector<uint32_t>& indices, const float* positions, size_t vertexCount,
+                                 size_t positionStride, LodLevel* levels, const LodChainSettings& settings) {
+    if (settings.maxLevels == 0) return 0;
+    levels[0] = {0, uint32_t(indices.size() - indices.size() % 3), 0.0f};
+    if (settings.maxLevels == 1 || levels[0].indexCount / 3 <= settings.minTriangles || vertexCount == 0) return 1;
+
+    // Every level continues collapsing the previous one's mesh, so its error
+    // is already measured against level 0.
+    Collapser collapser(indices.data(), levels[0].indexCount, positions, vertexCount, positionStride);
+    size_t count = 1;
+    std::vector<uint32_t> scratch;
+    while (count < settings.maxLevels) {
+        const LodLevel& previous = levels[count - 1];
+        const size_t triangles = previous.indexCount / 3;
+        if (triangles <= settings.minTriangles) break;
+        const size_t target = std::max<size_t>(settings.minTriangles, size_t(triangles * settings.reduction)) * 3;
+        collapser.Run(target, std::numeric_limits<float>::infinity());
+        const size_t n = collapser.IndexCount();
+        if (n == 0 || n > previous.indexCount * settings.minReduction) break;
+        scratch.resize(n);
+        collapser.Emit(scratch.data());
+        MeshOps::OptimizeVertexCache(scratch.data(), scratch.data(), n, vertexCount);
+        levels[count] = {uint32_t(indices.size()), uint32_t(n), collapser.Error()};
+        indices.insert(indices.end(), scratch.begin(), scratch.end());
+        ++count;
+    }
+    return count;
+}
+
+}
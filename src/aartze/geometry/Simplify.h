@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace aartze::geometry {
+
+// One level of detail: a range of a shared index buffer over a shared vertex
+// buffer, and how far (object-space distance) its surface may deviate from
+// the full-detail mesh.
+struct LodLevel {
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    float error = 0.0f;
+};
+
+struct LodChainSettings {
+    uint32_t maxLevels = 4;         // including the full-detail level 0
+    float reduction = 0.3f;         // each level aims for this fraction of the previous one's triangles
+    float minReduction = 0.8f;      // stop once a level keeps more than this fraction
+    uint32_t minTriangles = 32;     // don't simplify below this
+};
+
+/**
+ * Quadric error metric simplification (Garland-Heckbert) by half-edge
+ * collapse onto existing vertices, so every level can share the original
+ * vertex buffer. Vertices with the same position are simplified as one;
+ * those on an open border, on an attribute seam (several vertices at one
+ * position) or on non-manifold geometry stay put, which keeps borders and
+ * UV/normal seams free of cracks. Collapses that would fold a triangle over
+ * are skipped.
+ */
+struct Simplifier {
+    // Collapse edges of the triangle list cheapest-first until at most
+    // targetIndexCount indices remain or the next collapse would move the
+    // surface by more than targetError. `destination` may alias `indices`.
+    // Returns the new index count; resultError receives the largest
+    // deviation introduced.
+    static size_t Simplify(uint32_t* destination, const uint32_t* indices, size_t indexCount, const float* positions,
+                           size_t vertexCount, size_t positionStride, size_t targetIndexCount,
+                           float targetError = std::numeric_limits<float>::infinity(), float* resultError = nullptr);
+
+    // Treat `indices` as level 0 and append successively coarser levels,
+    // each continuing the collapses of the one before and cache-optimized.
+    // A level's error is measured against level 0. Writes up to
+    // settings.maxLevels entries to `levels` and returns how many.
+    static size_t BuildLodChain(std::vector<uint32_t>& indices, const float* positions, size_t vertexCount,
+                                size_t positionStride, LodLevel* levels, const LodChainSettings& settings = {});
+};
+
+}
@@ -0,0 +1,610 @@
+#include "Gltf.h"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstring>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+
+#include <nlohmann/json.hpp>
+
+namespace aartze::importer {
+
+namespace {
+
+using nlohmann::json;
+
+constexpr uint32_t kGlbMagic = 0x46546C67u;      // "glTF"
+constexpr uint32_t kGlbChunkJson = 0x4E4F534Au;  // "JSON"
+constexpr uint32_t kGlbChunkBin = 0x004E4942u;   // "BIN\0"
+
+enum ComponentType : uint32_t {
+    kByte = 5120,
+    kUnsignedByte = 5121,
+    kShort = 5122,
+    kUnsignedShort = 5123,
+    kUnsignedInt = 5125,
+    kFloat = 5126,
+};
+
+// Thrown while reading; LoadGltf turns it into its error string.
+struct LoadError : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+struct Buffer {
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+};
+
+struct BufferView {
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+    size_t stride = 0;  // 0 = tightly packed
+};
+
+struct Accessor {
+    int32_t view = -1;
+    size_t offset = 0;
+    uint32_t componentType = kFloat;
+    uint32_t components = 1;
+    bool normalized = false;
+    size_t count = 0;
+    const json* sparse = nullptr;
+};
+
+struct Context {
+    const json& doc;
+    std::string directory;
+    std::vector<Buffer> buffers;
+    std::vector<BufferView> views;
+    GltfScene& scene;
+};
+
+uint32_t ReadU32(const unsigned char* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+size_t ComponentBytes(uint32_t type) {
+    switch (type) {
+        case kByte: case kUnsignedByte: return 1;
+        case kShort: case kUnsignedShort: return 2;
+        case kUnsignedInt: case kFloat: return 4;
+        default: throw LoadError("unknown component type " + std::to_string(type));
+    }
+}
+
+uint32_t ComponentCount(const std::string& type, uint32_t componentType) {
+    if (type == "SCALAR") return 1;
+    if (type == "VEC2") return 2;
+    if (type == "VEC3") return 3;
+    if (type == "VEC4") return 4;
+    // Byte and short matrices pad their columns; only float ones are read.
+    if (componentType == kFloat) {
+        if (type == "MAT2") return 4;
+        if (type == "MAT3") return 9;
+        if (type == "MAT4") return 16;
+    }
+    throw LoadError("unsupported accessor type " + type);
+}
+
+template <class T>
+constexpr uint32_t ComponentTypeOf() {
+    if constexpr (std::is_same_v<T, float>) return kFloat;
+    else if constexpr (std::is_same_v<T, uint32_t>) return kUnsignedInt;
+    else return kUnsignedShort;
+}
+
+template <class C>
+float Normalize(C c) {
+    if constexpr (std::is_same_v<C, int8_t>) return std::max(c / 127.0f, -1.0f);
+    else if constexpr (std::is_same_v<C, uint8_t>) return c / 255.0f;
+    else if constexpr (std::is_same_v<C, int16_t>) return std::max(c / 32767.0f, -1.0f);
+    else if constexpr (std::is_same_v<C, uint16_t>) return c / 65535.0f;
+    else return float(c);
+}
+
+// Strided elements of C to packed elements of T, one component type per call.
+template <class T, class C>
+void ConvertElements(T* dst, const unsigned char* src, size_t count, size_t stride, uint32_t components,
+                     bool normalized) {
+    for (size_t i = 0; i < count; ++i, src += stride)
+        for (uint32_t c = 0; c < components; ++c) {
+            C value;
+            std::memcpy(&value, src + c * sizeof(C), sizeof(C));
+            if constexpr (std::is_same_v<T, float>) *dst++ = normalized ? Normalize(value) : float(value);
+            else *dst++ = static_cast<T>(value);
+        }
+}
+
+template <class T>
+void Convert(T* dst, const unsigned char* src, size_t count, size_t stride, const Accessor& a) {
+    if (a.componentType == ComponentTypeOf<T>()) {
+        const size_t bytes = a.components * sizeof(T);
+        for (size_t i = 0; i < count; ++i) std::memcpy(dst + i * a.components, src + i * stride, bytes);
+        return;
+    }
+    if constexpr (!std::is_same_v<T, float>)
+        if (a.componentType == kFloat || a.componentType == kByte || a.componentType == kShort)
+            throw LoadError("integer attribute stored with a signed or float component type");
+    switch (a.componentType) {
+        case kByte: ConvertElements<T, int8_t>(dst, src, count, stride, a.components, a.normalized); break;
+        case kUnsignedByte: ConvertElements<T, uint8_t>(dst, src, count, stride, a.components, a.normalized); break;
+        case kShort: ConvertElements<T, int16_t>(dst, src, count, stride, a.components, a.normalized); break;
+        case kUnsignedShort: ConvertElements<T, uint16_t>(dst, src, count, stride, a.components, a.normalized); break;
+        case kUnsignedInt: ConvertElements<T, uint32_t>(dst, src, count, stride, a.components, a.normalized); break;
+        case kFloat: ConvertElements<T, float>(dst, src, count, stride, a.components, a.normalized); break;
+    }
+}
+
+// doc[key], or an empty array when the key is missing.
+const json& Array(const json& doc, const char* key) {
+    static const json empty = json::array();
+    const auto it = doc.find(key);
+    return it != doc.end() ? *it : empty;
+}
+
+const json& At(const json& array, int64_t index, const char* what) {
+    if (!array.is_array() || index < 0 || size_t(index) >= array.size())
+        throw LoadError(std::string(what) + " " + std::to_string(index) + " does not exist");
+    return array[size_t(index)];
+}
+
+// Start and stride of `count` elements of `elementBytes` at `offset` into
+// the view, checked against its end.
+const unsigned char* ViewRange(const Context& ctx, int32_t view, size_t offset, size_t count, size_t elementBytes,
+                               size_t& stride) {
+    if (view < 0 || size_t(view) >= ctx.views.size()) throw LoadError("buffer view " + std::to_string(view) + " does not exist");
+    const BufferView& v = ctx.views[view];
+    stride = v.stride ? v.stride : elementBytes;
+    if (stride < elementBytes) throw LoadError("buffer view stride is smaller than its elements");
+    if (count && (offset > v.size || v.size - offset < elementBytes ||
+                  (v.size - offset - elementBytes) / stride < count - 1))
+        throw LoadError("accessor runs past the end of its buffer view");
+    return v.data + offset;
+}
+
+Accessor ParseAccessor(const Context& ctx, int64_t index) {
+    const json& j = At(Array(ctx.doc, "accessors"), index, "accessor");
+    Accessor a;
+    a.view = j.value("bufferView", -1);
+    a.offset = j.value("byteOffset", size_t(0));
+    a.componentType = j.at("componentType").get<uint32_t>();
+    a.components = ComponentCount(j.at("type").get<std::string>(), a.componentType);
+    a.normalized = j.value("normalized", false);
+    a.count = j.at("count").get<size_t>();
+    if (j.contains("sparse")) a.sparse = &j["sparse"];
+    ComponentBytes(a.componentType);
+    return a;
+}
+
+// Accessor `index` as T. `components` lists what the semantic allows.
+template <class T>
+void ReadAccessor(const Context& ctx, int64_t index, std::initializer_list<uint32_t> components, GltfStream<T>& out) {
+    const Accessor a = ParseAccessor(ctx, index);
+    if (std::find(components.begin(), components.end(), a.components) == components.end())
+        throw LoadError("accessor " + std::to_string(index) + " has the wrong number of components");
+    const size_t elementBytes = a.components * ComponentBytes(a.componentType);
+    out = GltfStream<T>();
+    out.count = a.count;
+    out.components = a.components;
+
+    size_t stride = 0;
+    const unsigned char* src = a.view >= 0 ? ViewRange(ctx, a.view, a.offset, a.count, elementBytes, stride) : nullptr;
+    if (src && !a.sparse && a.componentType == ComponentTypeOf<T>() && stride == elementBytes &&
+        reinterpret_cast<uintptr_t>(src) % alignof(T) == 0) {
+        out.data = reinterpret_cast<const T*>(src);
+        return;
+    }
+    // Zero-filled when there is no view.
+    out.storage.resize(a.count * a.components);
+    if (src) Convert(out.storage.data(), src, a.count, stride, a);
+
+    if (a.sparse) {
+        const json& s = *a.sparse;
+        const size_t count = s.at("count").get<size_t>();
+        const json& si = s.at("indices");
+        const json& sv = s.at("values");
+        Accessor ia;
+        ia.componentType = si.at("componentType").get<uint32_t>();
+        ia.count = count;
+        if (ia.componentType != kUnsignedByte && ia.componentType != kUnsignedShort && ia.componentType != kUnsignedInt)
+            throw LoadError("sparse indices must be unsigned");
+        size_t indexStride = 0, valueStride = 0;
+        const unsigned char* indexSrc = ViewRange(ctx, si.at("bufferView").get<int32_t>(), si.value("byteOffset", size_t(0)),
+                                                  count, ComponentBytes(ia.componentType), indexStride);
+        // Sparse views are always tightly packed.
+        indexStride = ComponentBytes(ia.componentType);
+        const unsigned char* valueSrc = ViewRange(ctx, sv.at("bufferView").get<int32_t>(), sv.value("byteOffset", size_t(0)),
+                                                  count, elementBytes, valueStride);
+        valueStride = elementBytes;
+        std::vector<uint32_t> targets(count);
+        Convert(targets.data(), indexSrc, count, indexStride, ia);
+        std::vector<T> values(count * a.components);
+        Convert(values.data(), valueSrc, count, valueStride, a);
+        for (size_t i = 0; i < count; ++i) {
+            if (targets[i] >= a.count) throw LoadError("sparse index out of range");
+            std::copy_n(&values[i * a.components], a.components, &out.storage[size_t(targets[i]) * a.components]);
+        }
+    }
+    out.data = out.storage.data();
+}
+
+std::string DecodeUri(const std::string& uri) {
+    std::string out;
+    out.reserve(uri.size());
+    for (size_t i = 0; i < uri.size(); ++i) {
+        if (uri[i] == '%' && i + 2 < uri.size() && std::isxdigit(uint8_t(uri[i + 1])) && std::isxdigit(uint8_t(uri[i + 2]))) {
+            out += char(std::stoi(uri.substr(i + 1, 2), nullptr, 16));
+            i += 2;
+        } else {
+            out += uri[i];
+        }
+    }
+    return out;
+}
+
+bool IsDataUri(const std::string& uri) { return uri.compare(0, 5, "data:") == 0; }
+
+// Payload of a base64 data: URI.
+std::vector<unsigned char> DecodeDataUri(const std::string& uri, std::string* mimeType = nullptr) {
+    const size_t comma = uri.find(',');
+    const size_t marker = uri.find(";base64");
+    if (comma == std::string::npos || marker == std::string::npos || marker > comma)
+        throw LoadError("only base64 data URIs are supported");
+    if (mimeType) *mimeType = uri.substr(5, marker - 5);
+    static const auto table = [] {
+        std::array<int8_t, 256> t;
+        t.fill(-1);
+        const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        for (int i = 0; i < 64; ++i) t[uint8_t(alphabet[i])] = int8_t(i);
+        return t;
+    }();
+    std::vector<unsigned char> out;
+    out.reserve((uri.size() - comma) / 4 * 3);
+    uint32_t bits = 0;
+    int count = 0;
+    for (size_t i = comma + 1; i < uri.size() && uri[i] != '='; ++i) {
+        const int8_t v = table[uint8_t(uri[i])];
+        if (v < 0) throw LoadError("bad base64 in data URI");
+        bits = bits << 6 | uint32_t(v);
+        if (++count == 4) {
+            out.push_back(uint8_t(bits >> 16));
+            out.push_back(uint8_t(bits >> 8));
+            out.push_back(uint8_t(bits));
+            bits = 0;
+            count = 0;
+        }
+    }
+    if (count == 2) out.push_back(uint8_t(bits >> 4));
+    if (count == 3) {
+        out.push_back(uint8_t(bits >> 10));
+        out.push_back(uint8_t(bits >> 2));
+    }
+    return out;
+}
+
+void LoadBuffers(Context& ctx, const Buffer& glbBin) {
+    GltfScene& scene = ctx.scene;
+    const json& buffers = Array(ctx.doc, "buffers");
+    for (size_t i = 0; i < buffers.size(); ++i) {
+        const json& b = buffers[i];
+        const size_t length = b.at("byteLength").get<size_t>();
+        Buffer buffer;
+        if (!b.contains("uri")) {
+            if (i != 0 || !glbBin.data) throw LoadError("buffer " + std::to_string(i) + " has no data");
+            buffer = glbBin;
+        } else if (const std::string uri = b["uri"].get<std::string>(); IsDataUri(uri)) {
+            scene.embedded.push_back(DecodeDataUri(uri));
+            buffer = {scene.embedded.back().data(), scene.embedded.back().size()};
+        } else {
+            MappedFile file;
+            if (!file.Open(ctx.directory + DecodeUri(uri))) throw LoadError("cannot open buffer " + uri);
+            buffer = {file.Data(), file.Size()};
+            scene.files.push_back(std::move(file));
+        }
+        if (buffer.size < length) throw LoadError("buffer " + std::to_string(i) + " is shorter than its byteLength");
+        buffer.size = length;
+        ctx.buffers.push_back(buffer);
+    }
+
+    const json& views = Array(ctx.doc, "bufferViews");
+    for (const json& v : views) {
+        const size_t index = v.at("buffer").get<size_t>();
+        if (index >= ctx.buffers.size()) throw LoadError("buffer view refers to a missing buffer");
+        const Buffer& buffer = ctx.buffers[index];
+        const size_t offset = v.value("byteOffset", size_t(0));
+        const size_t length = v.at("byteLength").get<size_t>();
+        if (offset > buffer.size || length > buffer.size - offset) throw LoadError("buffer view runs past its buffer");
+        ctx.views.push_back({buffer.data + offset, length, v.value("byteStride", size_t(0))});
+    }
+}
+
+GltfTextureRef ParseTextureRef(const json& material, const char* key) {
+    GltfTextureRef ref;
+    if (const auto it = material.find(key); it != material.end()) {
+        ref.texture = it->at("index").get<int32_t>();
+        ref.texCoord = it->value("texCoord", 0u);
+    }
+    return ref;
+}
+
+void LoadMaterials(Context& ctx) {
+    GltfScene& scene = ctx.scene;
+    for (const json& j : Array(ctx.doc, "images")) {
+        GltfImage image;
+        image.mimeType = j.value("mimeType", std::string());
+        if (j.contains("uri")) {
+            const std::string uri = j["uri"].get<std::string>();
+            if (IsDataUri(uri)) {
+                scene.embedded.push_back(DecodeDataUri(uri, &image.mimeType));
+                image.bytes = scene.embedded.back().data();
+                image.size = scene.embedded.back().size();
+            } else {
+                image.path = ctx.directory + DecodeUri(uri);
+            }
+        } else {
+            size_t stride = 0;
+            const int32_t view = j.at("bufferView").get<int32_t>();
+            image.bytes = ViewRange(ctx, view, 0, 1, 1, stride);
+            image.size = ctx.views[view].size;
+        }
+        scene.images.push_back(std::move(image));
+    }
+    for (const json& j : Array(ctx.doc, "textures")) {
+        GltfTexture texture;
+        texture.image = j.value("source", -1);
+        if (texture.image >= int32_t(scene.images.size())) throw LoadError("texture refers to a missing image");
+        scene.textures.push_back(texture);
+    }
+
+    for (const json& j : Array(ctx.doc, "materials")) {
+        GltfMaterial m;
+        m.name = j.value("name", std::string());
+        if (const auto pbr = j.find("pbrMetallicRoughness"); pbr != j.end()) {
+            if (pbr->contains("baseColorFactor")) {
+                const auto factor = (*pbr)["baseColorFactor"].get<std::vector<float>>();
+                if (factor.size() != 4) throw LoadError("baseColorFactor needs four values");
+                std::copy_n(factor.begin(), 4, m.baseColor);
+            }
+            m.metallic = pbr->value("metallicFactor", 1.0f);
+            m.roughness = pbr->value("roughnessFactor", 1.0f);
+            m.baseColorTexture = ParseTextureRef(*pbr, "baseColorTexture");
+            m.metallicRoughnessTexture = ParseTextureRef(*pbr, "metallicRoughnessTexture");
+        }
+        if (j.contains("emissiveFactor")) {
+            const auto factor = j["emissiveFactor"].get<std::vector<float>>();
+            if (factor.size() != 3) throw LoadError("emissiveFactor needs three values");
+            std::copy_n(factor.begin(), 3, m.emissive);
+        }
+        m.normalTexture = ParseTextureRef(j, "normalTexture");
+        m.occlusionTexture = ParseTextureRef(j, "occlusionTexture");
+        m.emissiveTexture = ParseTextureRef(j, "emissiveTexture");
+        if (j.contains("normalTexture")) m.normalScale = j["normalTexture"].value("scale", 1.0f);
+        if (j.contains("occlusionTexture")) m.occlusionStrength = j["occlusionTexture"].value("strength", 1.0f);
+        const std::string alphaMode = j.value("alphaMode", std::string("OPAQUE"));
+        m.alphaMode = alphaMode == "MASK"    ? GltfMaterial::AlphaMode::Mask
+                      : alphaMode == "BLEND" ? GltfMaterial::AlphaMode::Blend
+                                             : GltfMaterial::AlphaMode::Opaque;
+        m.alphaCutoff = j.value("alphaCutoff", 0.5f);
+        m.doubleSided = j.value("doubleSided", false);
+        for (const GltfTextureRef* ref : {&m.baseColorTexture, &m.metallicRoughnessTexture, &m.normalTexture,
+                                          &m.occlusionTexture, &m.emissiveTexture})
+            if (ref->texture >= int32_t(scene.textures.size())) throw LoadError("material refers to a missing texture");
+        scene.materials.push_back(std::move(m));
+    }
+}
+
+void LoadMeshes(Context& ctx) {
+    GltfScene& scene = ctx.scene;
+    const json& meshes = Array(ctx.doc, "meshes");
+    scene.meshes.resize(meshes.size());
+    for (size_t m = 0; m < meshes.size(); ++m) {
+        const json& jm = meshes[m];
+        GltfMesh& mesh = scene.meshes[m];
+        mesh.name = jm.value("name", std::string());
+        const json& primitives = jm.at("primitives");
+        mesh.primitives.resize(primitives.size());
+        for (size_t p = 0; p < primitives.size(); ++p) {
+            const json& jp = primitives[p];
+            GltfPrimitive& prim = mesh.primitives[p];
+            prim.mode = jp.value("mode", GltfPrimitive::kTriangles);
+            prim.material = jp.value("material", -1);
+            if (prim.material >= int32_t(scene.materials.size())) throw LoadError("primitive refers to a missing material");
+            const json& attributes = jp.at("attributes");
+            auto read = [&](const char* name, std::initializer_list<uint32_t> components, auto& stream) {
+                if (const auto it = attributes.find(name); it != attributes.end())
+                    ReadAccessor(ctx, it->get<int64_t>(), components, stream);
+            };
+            read("POSITION", {3}, prim.positions);
+            read("NORMAL", {3}, prim.normals);
+            read("TANGENT", {4}, prim.tangents);
+            read("TEXCOORD_0", {2}, prim.texCoords[0]);
+            read("TEXCOORD_1", {2}, prim.texCoords[1]);
+            read("COLOR_0", {3, 4}, prim.colors);
+            read("JOINTS_0", {4}, prim.joints);
+            read("WEIGHTS_0", {4}, prim.weights);
+
+            prim.vertexCount = prim.positions.count;
+            for (const size_t count : {prim.normals.count, prim.tangents.count, prim.texCoords[0].count,
+                                       prim.texCoords[1].count, prim.colors.count, prim.joints.count, prim.weights.count})
+                if (count && count != prim.vertexCount) throw LoadError("attributes of a primitive differ in length");
+            if (jp.contains("indices")) {
+                ReadAccessor(ctx, jp["indices"].get<int64_t>(), {1}, prim.indices);
+                const uint32_t* indices = prim.indices.data;
+                const uint32_t top = prim.indices.count ? *std::max_element(indices, indices + prim.indices.count) : 0;
+                if (prim.indices.count && top >= prim.vertexCount) throw LoadError("index past the end of its vertices");
+            }
+        }
+    }
+}
+
+void LoadSkins(Context& ctx) {
+    GltfScene& scene = ctx.scene;
+    for (const json& j : Array(ctx.doc, "skins")) {
+        GltfSkin skin;
+        skin.name = j.value("name", std::string());
+        skin.joints = j.at("joints").get<std::vector<int32_t>>();
+        skin.skeleton = j.value("skeleton", -1);
+        for (const int32_t joint : skin.joints)
+            if (joint < 0 || size_t(joint) >= scene.nodes.size()) throw LoadError("skin joint is not a node");
+        if (j.contains("inverseBindMatrices")) {
+            ReadAccessor(ctx, j["inverseBindMatrices"].get<int64_t>(), {16}, skin.inverseBindMatrices);
+            if (skin.inverseBindMatrices.count < skin.joints.size())
+                throw LoadError("skin has fewer inverse bind matrices than joints");
+        }
+        scene.skins.push_back(std::move(skin));
+    }
+}
+
+// Column-major a * b.
+void Multiply(const float a[16], const float b[16], float out[16]) {
+    for (int c = 0; c < 4; ++c)
+        for (int r = 0; r < 4; ++r)
+            out[c * 4 + r] = a[r] * b[c * 4] + a[4 + r] * b[c * 4 + 1] + a[8 + r] * b[c * 4 + 2] + a[12 + r] * b[c * 4 + 3];
+}
+
+void LocalTransform(const json& j, float out[16]) {
+    if (j.contains("matrix")) {
+        const auto m = j["matrix"].get<std::vector<float>>();
+        if (m.size() != 16) throw LoadError("node matrix needs sixteen values");
+        std::copy_n(m.begin(), 16, out);
+        return;
+    }
+    const auto t = j.value("translation", std::vector<float>{0.0f, 0.0f, 0.0f});
+    const auto q = j.value("rotation", std::vector<float>{0.0f, 0.0f, 0.0f, 1.0f});
+    const auto s = j.value("scale", std::vector<float>{1.0f, 1.0f, 1.0f});
+    if (t.size() != 3 || q.size() != 4 || s.size() != 3) throw LoadError("malformed node transform");
+    const float x = q[0], y = q[1], z = q[2], w = q[3];
+    const float rotation[9] = {1 - 2 * (y * y + z * z), 2 * (x * y + z * w),     2 * (x * z - y * w),
+                               2 * (x * y - z * w),     1 - 2 * (x * x + z * z), 2 * (y * z + x * w),
+                               2 * (x * z + y * w),     2 * (y * z - x * w),     1 - 2 * (x * x + y * y)};
+    for (int c = 0; c < 3; ++c) {
+        for (int r = 0; r < 3; ++r) out[c * 4 + r] = rotation[c * 3 + r] * s[c];
+        out[c * 4 + 3] = 0.0f;
+    }
+    out[12] = t[0];
+    out[13] = t[1];
+    out[14] = t[2];
+    out[15] = 1.0f;
+}
+
+void LoadNodes(Context& ctx) {
+    GltfScene& scene = ctx.scene;
+    const json& nodes = Array(ctx.doc, "nodes");
+    scene.nodes.resize(nodes.size());
+    for (size_t n = 0; n < nodes.size(); ++n) {
+        const json& j = nodes[n];
+        GltfNode& node = scene.nodes[n];
+        node.name = j.value("name", std::string());
+        node.mesh = j.value("mesh", -1);
+        node.skin = j.value("skin", -1);
+        node.children = j.value("children", std::vector<int32_t>());
+        LocalTransform(j, node.local);
+        if (node.mesh >= int32_t(scene.meshes.size())) throw LoadError("node refers to a missing mesh");
+        if (node.skin >= int32_t(Array(ctx.doc, "skins").size())) throw LoadError("node refers to a missing skin");
+    }
+    for (size_t n = 0; n < scene.nodes.size(); ++n)
+        for (const int32_t child : scene.nodes[n].children) {
+            if (child < 0 || size_t(child) >= scene.nodes.size()) throw LoadError("node child does not exist");
+            if (scene.nodes[child].parent >= 0) throw LoadError("node has two parents");
+            scene.nodes[child].parent = int32_t(n);
+        }
+
+    // World transforms, parents first. With one parent each, a node no
+    // parentless node reaches is on a cycle.
+    std::vector<int32_t> stack;
+    for (size_t n = 0; n < scene.nodes.size(); ++n)
+        if (scene.nodes[n].parent < 0) stack.push_back(int32_t(n));
+    size_t visited = 0;
+    while (!stack.empty()) {
+        GltfNode& node = scene.nodes[stack.back()];
+        stack.pop_back();
+        ++visited;
+        if (node.parent < 0) std::copy_n(node.local, 16, node.world);
+        else Multiply(scene.nodes[node.parent].world, node.local, node.world);
+        stack.insert(stack.end(), node.children.begin(), node.children.end());
+    }
+    if (visited != scene.nodes.size()) throw LoadError("node hierarchy has a cycle");
+
+    const json& scenes = Array(ctx.doc, "scenes");
+    if (scenes.empty()) {
+        for (size_t n = 0; n < scene.nodes.size(); ++n)
+            if (scene.nodes[n].parent < 0) scene.roots.push_back(int32_t(n));
+    } else {
+        scene.roots = At(scenes, ctx.doc.value("scene", 0), "scene").value("nodes", std::vector<int32_t>());
+        for (const int32_t root : scene.roots)
+            if (root < 0 || size_t(root) >= scene.nodes.size()) throw LoadError("scene root does not exist");
+    }
+}
+
+void Load(const std::string& path, GltfScene& scene) {
+    MappedFile file;
+    if (!file.Open(path)) throw LoadError("cannot open file");
+    const unsigned char* bytes = file.Data();
+    const size_t size = file.Size();
+
+    // A .glb is a 12-byte header, then a JSON chunk and an optional BIN chunk.
+    const char* jsonBegin = reinterpret_cast<const char*>(bytes);
+    const char* jsonEnd = jsonBegin + size;
+    Buffer bin;
+    bool glb = false;
+    if (size >= 12 && ReadU32(bytes) == kGlbMagic) {
+        if (ReadU32(bytes + 4) != 2) throw LoadError("only glTF 2.0 binaries are supported");
+        const size_t length = std::min<size_t>(ReadU32(bytes + 8), size);
+        size_t offset = 12;
+        for (int chunk = 0; offset + 8 <= length; ++chunk) {
+            const size_t chunkLength = ReadU32(bytes + offset);
+            const uint32_t type = ReadU32(bytes + offset + 4);
+            offset += 8;
+            if (chunkLength > length - offset) throw LoadError("truncated chunk");
+            if (chunk == 0 && type != kGlbChunkJson) throw LoadError("first chunk is not JSON");
+            if (chunk == 0) {
+                glb = true;
+                jsonBegin = reinterpret_cast<const char*>(bytes + offset);
+                jsonEnd = jsonBegin + chunkLength;
+            } else if (type == kGlbChunkBin && !bin.data) {
+                bin = {bytes + offset, chunkLength};
+            }
+            offset += (chunkLength + 3) & ~size_t(3);
+        }
+        if (!glb) throw LoadError("no JSON chunk");
+    }
+
+    const json doc = json::parse(jsonBegin, jsonEnd);
+    const std::string version = doc.at("asset").at("version").get<std::string>();
+    if (version.compare(0, 2, "2.") != 0) throw LoadError("glTF " + version + " is not supported");
+    for (const std::string& extension : doc.value("extensionsRequired", std::vector<std::string>()))
+        if (extension != "KHR_mesh_quantization") throw LoadError("requires unsupported extension " + extension);
+
+    Context ctx{doc, {}, {}, {}, scene};
+    const size_t slash = path.find_last_of("/\\");
+    if (slash != std::string::npos) ctx.directory = path.substr(0, slash + 1);
+    // The BIN chunk is viewed in place, so the scene keeps the mapping.
+    scene.files.push_back(std::move(file));
+    LoadBuffers(ctx, bin);
+    LoadMaterials(ctx);
+    LoadMeshes(ctx);
+    LoadNodes(ctx);
+    LoadSkins(ctx);
+}
+
+}
+
+bool LoadGltf(const std::string& path, GltfScene& out, std::string* error) {
+    out = GltfScene();
+    try {
+        Load(path, out);
+        return true;
+    } catch (const std::exception& e) {
+        // LoadError, or nlohmann::json::exception for malformed or mistyped JSON.
+        out = GltfScene();
+        if (error) *error = path + ": " + e.what();
+        return false;
+    }
+}
+
+}
@@ -0,0 +1,137 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+
+namespace aartze::importer {
+
+// Elements of one accessor as T, `components` per element. `data` points
+// straight into the file when the accessor already has that layout (T
+// components, tightly packed, aligned, not sparse); otherwise the elements
+// were converted into `storage`. Move-only: a copy would leave `data`
+// pointing into the original's storage.
+template <class T>
+struct GltfStream {
+    const T* data = nullptr;
+    size_t count = 0;
+    uint32_t components = 0;
+    std::vector<T> storage;
+
+    GltfStream() = default;
+    GltfStream(GltfStream&&) noexcept = default;
+    GltfStream& operator=(GltfStream&&) noexcept = default;
+    GltfStream(const GltfStream&) = delete;
+    GltfStream& operator=(const GltfStream&) = delete;
+
+    bool Empty() const { return count == 0; }
+    bool Borrowed() const { return data && storage.empty(); }
+    const T* Element(size_t i) const { return data + i * components; }
+};
+
+// One draw: indexed or not, as the file has it; nothing is de-indexed.
+struct GltfPrimitive {
+    static constexpr uint32_t kTriangles = 4;
+    static constexpr uint32_t kTriangleStrip = 5;
+    static constexpr uint32_t kTriangleFan = 6;
+
+    uint32_t mode = kTriangles;  // glTF topology; 0-3 are points and lines
+    int32_t material = -1;
+    size_t vertexCount = 0;
+    GltfStream<float> positions;     // 3
+    GltfStream<float> normals;       // 3
+    GltfStream<float> tangents;      // 4, w is the bitangent sign
+    GltfStream<float> texCoords[2];  // 2
+    GltfStream<float> colors;        // 3 or 4
+    GltfStream<uint16_t> joints;     // 4, indices into the node's skin joints
+    GltfStream<float> weights;       // 4
+    GltfStream<uint32_t> indices;    // 1; empty = vertices in order
+};
+
+struct GltfMesh {
+    std::string name;
+    std::vector<GltfPrimitive> primitives;
+};
+
+struct GltfTextureRef {
+    int32_t texture = -1;
+    uint32_t texCoord = 0;  // which texCoords set
+};
+
+struct GltfMaterial {
+    enum class AlphaMode : uint8_t { Opaque, Mask, Blend };
+
+    std::string name;
+    float baseColor[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    float metallic = 1.0f;
+    float roughness = 1.0f;
+    float emissive[3] = {0.0f, 0.0f, 0.0f};
+    float normalScale = 1.0f;
+    float occlusionStrength = 1.0f;
+    float alphaCutoff = 0.5f;
+    AlphaMode alphaMode = AlphaMode::Opaque;
+    bool doubleSided = false;
+    GltfTextureRef baseColorTexture;
+    GltfTextureRef metallicRoughnessTexture;
+    GltfTextureRef normalTexture;
+    GltfTextureRef occlusionTexture;
+    GltfTextureRef emissiveTexture;
+};
+
+// A file next to the model (`path`), or encoded bytes inside it (`bytes`,
+// which live as long as the scene).
+struct GltfImage {
+    std::string path;
+    std::string mimeType;
+    const unsigned char* bytes = nullptr;
+    size_t size = 0;
+};
+
+struct GltfTexture {
+    int32_t image = -1;
+};
+
+struct GltfSkin {
+    std::string name;
+    std::vector<int32_t> joints;  // nodes
+    int32_t skeleton = -1;
+    GltfStream<float> inverseBindMatrices;  // 16 per joint, column-major; empty = identity
+};
+
+struct GltfNode {
+    std::string name;
+    int32_t parent = -1;
+    int32_t mesh = -1;
+    int32_t skin = -1;
+    std::vector<int32_t> children;
+    float local[16];  // column-major, from `matrix` or TRS
+    float world[16];  // local times every ancestor's
+};
+
+/**
+ * A glTF 2.0 asset as stored: meshes keep their primitives, index buffers
+ * and instancing through nodes. .glb files and external .bin buffers are
+ * memory-mapped and accessor data is read from the buffer views in place,
+ * so a scene stays valid only as long as it (and the files) are around.
+ * Morph targets, cameras, lights, animations and extensions are skipped.
+ */
+struct GltfScene {
+    std::vector<GltfMesh> meshes;
+    std::vector<GltfMaterial> materials;
+    std::vector<GltfTexture> textures;
+    std::vector<GltfImage> images;
+    std::vector<GltfSkin> skins;
+    std::vector<GltfNode> nodes;
+    std::vector<int32_t> roots;  // nodes of the default scene
+
+    std::vector<MappedFile> files;                     // the .glb / .bin files viewed
+    std::vector<std::vector<unsigned char>> embedded;  // decoded data: URIs
+};
+
+// Load a .gltf or .glb file. On failure returns false, leaves `out` empty and
+// says why in `error`.
+bool LoadGltf(const std::string& path, GltfScene& out, std::string* error = nullptr);
+
+}
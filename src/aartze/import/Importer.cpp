@@ -1,5 +1,32 @@
 #include "Importer.h"
+#include <algorithm>
+#include <cctype>
+
+#include "Gltf.h"
+#include "aartze/core/Log.h"
+
 namespace aartze::importer {
-bool ImportFile(const std::string&){ return true; }
+
+namespace {
+
+bool HasExtension(const std::string& path, const char* extension) {
+    const std::string ext(extension);
+    if (path.size() < ext.size()) return false;
+    return std::equal(ext.rbegin(), ext.rend(), path.rbegin(),
+                      [](char a, char b) { return a == std::tolower(static_cast<unsigned char>(b)); });
 }
 
+}
+
+bool ValidateFile(const std::string& path) {
+    if (!HasExtension(path, ".gltf") && !HasExtension(path, ".glb")) return true;
+    GltfScene scene;
+    std::string error;
+    if (!LoadGltf(path, scene, &error)) {
+        core::LogError(error);
+        return false;
+    }
+    return true;
+}
+
+}
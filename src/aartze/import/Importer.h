@@ -1,6 +1,10 @@
 #pragma once
 #include <string>
 namespace aartze::importer {
-bool ImportFile(const std::string& path);
+// Check that a file can be imported, without keeping anything: .gltf and
+// .glb files are read with LoadGltf and the scene is dropped; other formats
+// are accepted without being read. Engine loads go through ImportGltfFile
+// and ImportAssimpFile (AARTZE/utils/MeshUtils.hpp).
+bool ValidateFile(const std::string& path);
 }
 
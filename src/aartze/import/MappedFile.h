@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <utility>
+
+namespace aartze::importer {
+
+// Read-only memory mapping of a whole file; move-only, unmaps on destruction.
+// Pages are faulted in on first touch, so opening costs nothing per byte.
+// Used for .glb/.bin buffers and for cooked .amesh files.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { Close(); }
+    MappedFile(MappedFile&& other) noexcept { *this = std::move(other); }
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // False for missing and empty files.
+    bool Open(const std::string& path);
+    void Close();
+    const unsigned char* Data() const { return data_; }
+    size_t Size() const { return size_; }
+    // Touch every page so the disk reads happen now, on the calling thread,
+    // rather than on whoever reads the data first.
+    void Prefetch() const;
+
+private:
+    const unsigned char* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#endif
+};
+
+}
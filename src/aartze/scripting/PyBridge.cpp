@@ -20,14 +20,19 @@
 #include <array>
 #include <tuple>
 #include <algorithm>
-// Assimp and cgltf for importers
+#include <limits>
+// Assimp for importers; glTF goes through the native loader
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
-#include <cgltf.h>
 
 #include "aartze/render/scene/GizmoRenderer.h"
 #include "aartze/input/InputSystem.h"
+#include "aartze/geometry/BVH.h"
+#include "aartze/import/Gltf.h"
+// Only the scene conversion; textures are not registered here.
+#define MESHUTILS_NO_REGISTRY
+#include "utils/MeshUtils.hpp"
 
 namespace py = pybind11;
 
@@ -42,8 +47,15 @@ static std::unordered_map<int, Entity> g_entities;
 static std::unordered_map<std::string,int> g_name_to_id;
 static int g_next_id = 1;
 
-// Minimal mesh store for imported assets (triangles only)
-struct Mesh { std::vector<float> pos; std::vector<float> nrm; };
+// Minimal mesh store for imported assets (indexed triangles only)
+struct Mesh { std::vector<float> pos; std::vector<float> nrm; std::vector<uint32_t> idx; aartze::geometry::BVH bvh; };
+
+static void draw_mesh(const Mesh& m){
+  const bool normals = m.nrm.size()==m.pos.size();
+  glBegin(GL_TRIANGLES);
+  for(uint32_t v : m.idx){ if(normals) glNormal3f(m.nrm[v*3+0], m.nrm[v*3+1], m.nrm[v*3+2]); glVertex3f(m.pos[v*3+0], m.pos[v*3+1], m.pos[v*3+2]); }
+  glEnd();
+}
 static std::unordered_map<int, Mesh> g_meshes; // entity id -> mesh
 
 // --- Simple orbit camera state (Blender-like) ---
@@ -56,6 +68,10 @@ static int   g_vp_w = 1280, g_vp_h = 720;
 static float g_P[16] = {0};
 static float g_V[16] = {0};
 static float g_PV[16] = {0};
+// Camera basis of the last render, for picking rays
+static float g_cam_eye[3] = {0,0,0};
+static float g_cam_fwd[3] = {0,0,-1}, g_cam_right[3] = {1,0,0}, g_cam_up[3] = {0,1,0};
+static float g_cam_tan = 0.41421356f, g_cam_aspect = 16.f/9.f;
 
 static void mul4x4(const float A[16], const float B[16], float R[16]){
   for(int r=0;r<4;++r){ for(int c=0;c<4;++c){ R[r*4+c]=A[r*4+0]*B[0*4+c]+A[r*4+1]*B[1*4+c]+A[r*4+2]*B[2*4+c]+A[r*4+3]*B[3*4+c]; }}
@@ -196,6 +212,8 @@ void EngineAPI::render(){
   };
   // Store matrices for gizmo math
   for(int i=0;i<16;++i){ g_P[i]=P[i]; g_V[i]=V[i]; }
+  for(int i=0;i<3;++i){ g_cam_eye[i]=eye[i]; g_cam_fwd[i]=f[i]; g_cam_right[i]=r[i]; g_cam_up[i]=u[i]; }
+  g_cam_tan = t; g_cam_aspect = aspect;
   mul4x4(P, V, g_PV);
   glMatrixMode(GL_PROJECTION); glLoadMatrixf(P);
   glMatrixMode(GL_MODELVIEW);  glLoadMatrixf(V);
@@ -241,28 +259,8 @@ void EngineAPI::render(){
     if(e.visible){
       auto mit = g_meshes.find(it->second);
       glPushMatrix(); glTranslatef(e.tx, e.ty-0.5f, e.tz);
-      if(mit == g_meshes.end() || mit->second.pos.empty()) draw_cube();
-      else {
-        const auto& m = mit->second;
-        size_t triCount = m.pos.size()/9; // 3 verts * 3 comps
-        glBegin(GL_TRIANGLES);
-        for(size_t t=0;t<triCount;++t){
-          size_t i = t*9; size_t in = t*9; // normals per-vertex
-          if(m.nrm.size()==m.pos.size()){
-            glNormal3f(m.nrm[in+0], m.nrm[in+1], m.nrm[in+2]);
-            glVertex3f(m.pos[i+0], m.pos[i+1], m.pos[i+2]);
-            glNormal3f(m.nrm[in+3], m.nrm[in+4], m.nrm[in+5]);
-            glVertex3f(m.pos[i+3], m.pos[i+4], m.pos[i+5]);
-            glNormal3f(m.nrm[in+6], m.nrm[in+7], m.nrm[in+8]);
-            glVertex3f(m.pos[i+6], m.pos[i+7], m.pos[i+8]);
-          } else {
-            glVertex3f(m.pos[i+0], m.pos[i+1], m.pos[i+2]);
-            glVertex3f(m.pos[i+3], m.pos[i+4], m.pos[i+5]);
-            glVertex3f(m.pos[i+6], m.pos[i+7], m.pos[i+8]);
-          }
-        }
-        glEnd();
-      }
+      if(mit == g_meshes.end() || mit->second.idx.empty()) draw_cube();
+      else draw_mesh(mit->second);
       glPopMatrix();
     }
   }
@@ -271,12 +269,9 @@ void EngineAPI::render(){
   for(const auto& kv : g_meshes){
     int id = kv.first; if(auto itE=g_entities.find(id); itE!=g_entities.end()){
       const auto& e = itE->second; if(!e.visible) continue; if(e.name=="Cube") continue;
-      const auto& m = kv.second; if(m.pos.empty()) continue;
+      const auto& m = kv.second; if(m.idx.empty()) continue;
       glPushMatrix(); glTranslatef(e.tx, e.ty, e.tz);
-      glBegin(GL_TRIANGLES);
-      size_t triCount = m.pos.size()/9;
-      for(size_t t=0;t<triCount;++t){ size_t i=t*9; size_t in=t*9; if(m.nrm.size()==m.pos.size()) glNormal3f(m.nrm[in+0], m.nrm[in+1], m.nrm[in+2]); glVertex3f(m.pos[i+0],m.pos[i+1],m.pos[i+2]); if(m.nrm.size()==m.pos.size()) glNormal3f(m.nrm[in+3], m.nrm[in+4], m.nrm[in+5]); glVertex3f(m.pos[i+3],m.pos[i+4],m.pos[i+5]); if(m.nrm.size()==m.pos.size()) glNormal3f(m.nrm[in+6], m.nrm[in+7], m.nrm[in+8]); glVertex3f(m.pos[i+6],m.pos[i+7],m.pos[i+8]); }
-      glEnd();
+      draw_mesh(m);
       glPopMatrix();
     }
   }
@@ -444,34 +439,20 @@ static bool load_with_assimp(const std::string& path, Mesh& out){
   Assimp::Importer imp; const aiScene* sc = imp.ReadFile(path, aiProcess_Triangulate | aiProcess_GenNormals | aiProcess_JoinIdenticalVertices);
   if(!sc || !sc->mRootNode || sc->mNumMeshes==0) return false;
   aiMesh* mesh = sc->mMeshes[0];
-  out.pos.clear(); out.nrm.clear();
-  out.pos.reserve(mesh->mNumFaces * 9);
-  if(mesh->HasNormals()) out.nrm.reserve(mesh->mNumFaces*9);
-  for(unsigned f=0; f<mesh->mNumFaces; ++f){
-    const aiFace& face = mesh->mFaces[f]; if(face.mNumIndices!=3) continue; for(unsigned i=0;i<3;++i){ unsigned idx = face.mIndices[i]; aiVector3D v = mesh->mVertices[idx]; out.pos.push_back(v.x); out.pos.push_back(v.y); out.pos.push_back(v.z); if(mesh->HasNormals()){ aiVector3D n = mesh->mNormals[idx]; out.nrm.push_back(n.x); out.nrm.push_back(n.y); out.nrm.push_back(n.z);} }
-  }
-  return !out.pos.empty();
+  out.pos.resize(size_t(mesh->mNumVertices)*3); out.nrm.clear(); out.idx.clear();
+  if(mesh->HasNormals()) out.nrm.resize(out.pos.size());
+  for(unsigned v=0; v<mesh->mNumVertices; ++v){ out.pos[v*3+0]=mesh->mVertices[v].x; out.pos[v*3+1]=mesh->mVertices[v].y; out.pos[v*3+2]=mesh->mVertices[v].z; if(mesh->HasNormals()){ out.nrm[v*3+0]=mesh->mNormals[v].x; out.nrm[v*3+1]=mesh->mNormals[v].y; out.nrm[v*3+2]=mesh->mNormals[v].z; } }
+  out.idx.reserve(size_t(mesh->mNumFaces)*3);
+  for(unsigned f=0; f<mesh->mNumFaces; ++f){ const aiFace& face = mesh->mFaces[f]; if(face.mNumIndices==3) out.idx.insert(out.idx.end(), face.mIndices, face.mIndices+3); }
+  return !out.idx.empty();
 }
-static bool load_with_cgltf(const std::string& path, Mesh& out){
-  cgltf_options options{}; cgltf_data* data=nullptr; if(cgltf_parse_file(&options, path.c_str(), &data)!=cgltf_result_success) return false; cgltf_load_buffers(&options, data, path.c_str());
-  out.pos.clear(); out.nrm.clear();
-  bool ok=false;
-  for(size_t mi=0; mi<data->meshes_count && !ok; ++mi){ const cgltf_mesh& m = data->meshes[mi]; if(m.primitives_count==0) continue; const cgltf_primitive& p = m.primitives[0]; const cgltf_accessor* pos=nullptr; const cgltf_accessor* nrm=nullptr; for(size_t ai=0; ai<p.attributes_count; ++ai){ const auto& a = p.attributes[ai]; if(a.type==cgltf_attribute_type_position) pos=a.data; else if(a.type==cgltf_attribute_type_normal) nrm=a.data; }
-    if(!pos) continue; size_t vcount = pos->count; std::vector<float> tmpPos; tmpPos.reserve(vcount*3); for(size_t i=0;i<vcount;++i){ float v[3]; cgltf_accessor_read_float(pos, i, v, 3); tmpPos.push_back(v[0]); tmpPos.push_back(v[1]); tmpPos.push_back(v[2]); }
-    std::vector<unsigned int> idx; if(p.indices){ idx.resize(p.indices->count); for(size_t i=0;i<idx.size();++i){ idx[i]=(unsigned)cgltf_accessor_read_index(p.indices, i); } }
-    if(idx.empty()){ // assume sequential triangles
-      for(size_t i=0;i+2<vcount; i+=3){ out.pos.insert(out.pos.end(), {tmpPos[i*3+0],tmpPos[i*3+1],tmpPos[i*3+2], tmpPos[(i+1)*3+0],tmpPos[(i+1)*3+1],tmpPos[(i+1)*3+2], tmpPos[(i+2)*3+0],tmpPos[(i+2)*3+1],tmpPos[(i+2)*3+2]}); }
-    } else {
-      for(size_t i=0;i+2<idx.size(); i+=3){ unsigned a=idx[i], b=idx[i+1], c=idx[i+2]; out.pos.insert(out.pos.end(), {tmpPos[a*3+0],tmpPos[a*3+1],tmpPos[a*3+2], tmpPos[b*3+0],tmpPos[b*3+1],tmpPos[b*3+2], tmpPos[c*3+0],tmpPos[c*3+1],tmpPos[c*3+2]}); }
-    }
-    if(nrm){ size_t ncount = nrm->count; std::vector<float> tmpN; tmpN.reserve(ncount*3); for(size_t i=0;i<ncount;++i){ float v[3]; cgltf_accessor_read_float(nrm, i, v, 3); tmpN.push_back(v[0]); tmpN.push_back(v[1]); tmpN.push_back(v[2]); }
-      if(idx.empty()){ for(size_t i=0;i+2<ncount; i+=3){ out.nrm.insert(out.nrm.end(), {tmpN[i*3+0],tmpN[i*3+1],tmpN[i*3+2], tmpN[(i+1)*3+0],tmpN[(i+1)*3+1],tmpN[(i+1)*3+2], tmpN[(i+2)*3+0],tmpN[(i+2)*3+1],tmpN[(i+2)*3+2]}); } }
-      else { for(size_t i=0;i+2<idx.size(); i+=3){ unsigned a=idx[i], b=idx[i+1], c=idx[i+2]; out.nrm.insert(out.nrm.end(), {tmpN[a*3+0],tmpN[a*3+1],tmpN[a*3+2], tmpN[b*3+0],tmpN[b*3+1],tmpN[b*3+2], tmpN[c*3+0],tmpN[c*3+1],tmpN[c*3+2]}); } }
-    }
-    ok = !out.pos.empty();
-  }
-  cgltf_free(data);
-  return ok;
+// Every primitive of every node the default scene draws, in world space and
+// with the file's indices, through the engine's glTF conversion.
+static bool load_with_gltf(const std::string& path, Mesh& out){
+  aartze::importer::GltfScene scene; if(!aartze::importer::LoadGltf(path, scene)) return false;
+  MeshData data = ConvertGltfScene(scene, false, 1.0f);
+  out.pos = std::move(data.vertices); out.nrm = std::move(data.normals); out.idx = std::move(data.indices);
+  return !out.idx.empty();
 }
 
 static std::string filenameStem(const std::string& p){ auto s = p; size_t slash = s.find_last_of("/\\"); if(slash!=std::string::npos) s = s.substr(slash+1); size_t dot = s.find_last_of('.'); if(dot!=std::string::npos) s = s.substr(0,dot); return s; }
@@ -479,14 +460,49 @@ static std::string filenameStem(const std::string& p){ auto s = p; size_t slash
 int import_file_impl(const std::string& path){
   std::string lower = path; std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
   Mesh mesh; bool ok=false;
-  if(lower.rfind(".gltf")!=std::string::npos || lower.rfind(".glb")!=std::string::npos) ok = load_with_cgltf(path, mesh);
+  if(lower.rfind(".gltf")!=std::string::npos || lower.rfind(".glb")!=std::string::npos) ok = load_with_gltf(path, mesh);
   if(!ok) ok = load_with_assimp(path, mesh);
   if(!ok) return -1;
+  mesh.bvh.Build(mesh.pos.data(), sizeof(float)*3, mesh.idx.data(), mesh.idx.size()/3);
   int id = make_entity(filenameStem(path));
   g_meshes[id] = std::move(mesh);
   return id;
 }
 
+// Picking: same placement as render() -- the Cube entity's geometry sits 0.5 below its origin.
+int EngineAPI::pick(float ndc_x, float ndc_y){
+  aartze::geometry::Ray ray;
+  for(int i=0;i<3;++i){
+    ray.origin[i] = g_cam_eye[i];
+    ray.direction[i] = g_cam_fwd[i] + g_cam_right[i]*ndc_x*g_cam_tan*g_cam_aspect + g_cam_up[i]*ndc_y*g_cam_tan;
+  }
+  int best = -1; float bestT = std::numeric_limits<float>::infinity();
+  for(const auto& [id, e] : g_entities){
+    if(!e.visible) continue;
+    auto mit = g_meshes.find(id);
+    bool isCube = e.name=="Cube";
+    if(mit==g_meshes.end() && !isCube) continue;
+    float off[3] = { e.tx, e.ty-(isCube?0.5f:0.f), e.tz };
+    aartze::geometry::Ray local = ray;
+    for(int i=0;i<3;++i) local.origin[i] -= off[i];
+    local.tMax = bestT;
+    if(mit!=g_meshes.end() && !mit->second.bvh.Empty()){
+      aartze::geometry::RayHit hit;
+      if(mit->second.bvh.Intersect(local, hit)){ bestT = hit.t; best = id; }
+    } else if(isCube && mit==g_meshes.end()){
+      float t0 = local.tMin, t1 = local.tMax;
+      for(int i=0;i<3;++i){
+        float inv = 1.f/local.direction[i];
+        float a = (-0.5f-local.origin[i])*inv, b = (0.5f-local.origin[i])*inv;
+        if(a>b) std::swap(a,b);
+        t0 = std::max(t0,a); t1 = std::min(t1,b);
+      }
+      if(t0<=t1){ bestT = t0; best = id; }
+    }
+  }
+  return best;
+}
+
 // Camera API
 void EngineAPI::camera_set_target(float x, float y, float z){ g_cam_target[0]=x; g_cam_target[1]=y; g_cam_target[2]=z; }
 void EngineAPI::camera_set_orbit(float yaw_deg, float pitch_deg, float dist){
@@ -525,6 +541,7 @@ PYBIND11_MODULE(aartzepy, m){
   m.def("gizmo_cancel", &EngineAPI::gizmo_cancel);
   m.def("gizmo_set_screen_axis", &EngineAPI::gizmo_set_screen_axis);
   m.def("gizmo_hover", &EngineAPI::gizmo_hover);
+  m.def("pick", &EngineAPI::pick);
   m.def("camera_set_target", &EngineAPI::camera_set_target);
   m.def("camera_set_orbit", &EngineAPI::camera_set_orbit);
   m.def("camera_orbit_delta", &EngineAPI::camera_orbit_delta);
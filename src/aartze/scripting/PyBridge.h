@@ -39,5 +39,8 @@ struct EngineAPI {
   static char gizmo_hover(float ndc_x, float ndc_y); // returns hovered axis or 0
   static void gizmo_cancel();                     // cancel and restore start transform
   static void gizmo_set_screen_axis(bool enabled); // double-press axis: screen-space lock
+
+  // Entity id of the closest visible mesh under a viewport point in NDC, or -1
+  static int  pick(float ndc_x, float ndc_y);
 };
 }
@@ -0,0 +1,63 @@
+// Offline mesh cooker: imports source assets through the engine's Assimp
+// loaders (weld, cache/overdraw/fetch optimization, LOD chain) and writes
+// .amesh files that RenderResources::UploadCookedMesh maps at runtime.
+//
+//   aartze_amesh_cook <source> [<cooked>]   one asset; default output is the
+//                                           source path with .amesh
+//   aartze_amesh_cook --dir <directory>     every mesh below the directory
+//                                           whose cooked sibling is stale
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+
+#include "utils/CookedMesh.hpp"
+
+namespace
+{
+bool IsMeshSource(const std::filesystem::path& path)
+{
+    std::string ext = path.extension().string();
+    for (char& c : ext) c = (char)tolower((unsigned char)c);
+    return ext == ".fbx" || ext == ".obj" || ext == ".gltf" || ext == ".glb" || ext == ".dae";
+}
+
+bool Cook(const std::string& source, const std::string& cooked)
+{
+    const bool ok = CookMeshAsset(source, cooked);
+    std::printf("%s %s -> %s\n", ok ? "cooked" : "FAILED", source.c_str(), cooked.c_str());
+    return ok;
+}
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::fprintf(stderr, "usage: %s <source> [<cooked>] | --dir <directory>\n", argv[0]);
+        return 2;
+    }
+    int failures = 0;
+    if (std::strcmp(argv[1], "--dir") == 0)
+    {
+        if (argc < 3) return 2;
+        size_t upToDate = 0;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(argv[2]))
+        {
+            if (!entry.is_regular_file() || !IsMeshSource(entry.path())) continue;
+            const std::string source = entry.path().string();
+            if (!ResolveCookedMesh(source).empty()) { ++upToDate; continue; }
+            std::filesystem::path cooked = entry.path();
+            cooked.replace_extension(".amesh");
+            failures += !Cook(source, cooked.string());
+        }
+        std::printf("%zu already up to date\n", upToDate);
+    }
+    else
+    {
+        std::filesystem::path cooked = argc > 2 ? std::filesystem::path(argv[2]) : std::filesystem::path(argv[1]);
+        if (argc <= 2) cooked.replace_extension(".amesh");
+        failures += !Cook(argv[1], cooked.string());
+    }
+    return failures ? 1 : 0;
+}
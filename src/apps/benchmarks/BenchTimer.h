@@ -0,0 +1,10 @@
+#pragma once
+// Wall-clock timing shared by the benchmarks.
+#include <chrono>
+
+using Clock = std::chrono::high_resolution_clock;
+
+inline double MsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
@@ -0,0 +1,278 @@
+// Builds aartze::geometry::BVH over a displaced sphere of about one million
+// triangles and measures build and refit time and ray throughput (Mrays/s)
+// for closest-hit and any-hit queries: coherent camera rays traced singly and
+// as 4- and 8-wide packets, and incoherent random rays. Queries run across
+// gJobSystem workers; a sample of rays is checked against brute force.
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "aartze/geometry/BVH.h"
+#include "core/JobSystem.hpp"
+#include "../BenchTimer.h"
+
+namespace {
+
+using namespace aartze::geometry;
+
+constexpr float kPi = 3.14159265f;
+constexpr int kImage = 1024;  // camera rays per side
+
+struct Mesh
+{
+    std::vector<float> positions;
+    std::vector<uint32_t> indices;
+    size_t TriangleCount() const { return indices.size() / 3; }
+};
+
+// rings * segments * 2 triangles; `phase` moves the bumps, for refit.
+void DisplacedSphere(Mesh& mesh, int rings, int segments, float phase)
+{
+    mesh.positions.resize(size_t(rings + 1) * (segments + 1) * 3);
+    for (int r = 0; r <= rings; ++r)
+        for (int g = 0; g <= segments; ++g)
+        {
+            float theta = kPi * r / rings, phi = 2 * kPi * g / segments;
+            float radius = 1.0f + 0.05f * std::sin(12 * theta + phase) * std::cos(9 * phi + phase);
+            float* p = &mesh.positions[(size_t(r) * (segments + 1) + g) * 3];
+            p[0] = radius * std::sin(theta) * std::cos(phi);
+            p[1] = radius * std::cos(theta);
+            p[2] = radius * std::sin(theta) * std::sin(phi);
+        }
+    if (!mesh.indices.empty()) return;
+    mesh.indices.reserve(size_t(rings) * segments * 6);
+    for (int r = 0; r < rings; ++r)
+        for (int g = 0; g < segments; ++g)
+        {
+            uint32_t a = r * (segments + 1) + g, b = a + 1, c = a + segments + 1, d = c + 1;
+            mesh.indices.insert(mesh.indices.end(), {a, c, b, b, c, d});
+        }
+}
+
+void CameraRay(int x, int y, Ray& ray)
+{
+    const float tanHalf = std::tan(0.5f * 40.0f * kPi / 180.0f);
+    ray.origin[0] = 0.3f;
+    ray.origin[1] = 0.4f;
+    ray.origin[2] = 3.0f;
+    ray.direction[0] = ((x + 0.5f) / kImage * 2 - 1) * tanHalf;
+    ray.direction[1] = ((y + 0.5f) / kImage * 2 - 1) * tanHalf;
+    ray.direction[2] = -1.0f;
+    ray.tMin = 0.0f;
+    ray.tMax = std::numeric_limits<float>::infinity();
+}
+
+std::vector<Ray> RandomRays(size_t count)
+{
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> box(-2.0f, 2.0f), unit(-1.0f, 1.0f);
+    std::vector<Ray> rays(count);
+    for (Ray& ray : rays)
+    {
+        for (int a = 0; a < 3; ++a) ray.origin[a] = box(rng);
+        for (int a = 0; a < 3; ++a) ray.direction[a] = unit(rng);
+    }
+    return rays;
+}
+
+// Reference closest hit, every triangle tested.
+float BruteForce(const Mesh& mesh, const Ray& ray)
+{
+    float best = ray.tMax;
+    for (size_t t = 0; t < mesh.TriangleCount(); ++t)
+    {
+        const float* v0 = &mesh.positions[mesh.indices[t * 3] * 3];
+        const float* v1 = &mesh.positions[mesh.indices[t * 3 + 1] * 3];
+        const float* v2 = &mesh.positions[mesh.indices[t * 3 + 2] * 3];
+        float e1[3], e2[3], s[3];
+        for (int a = 0; a < 3; ++a) { e1[a] = v1[a] - v0[a]; e2[a] = v2[a] - v0[a]; s[a] = ray.origin[a] - v0[a]; }
+        const float* d = ray.direction;
+        float p[3] = {d[1] * e2[2] - d[2] * e2[1], d[2] * e2[0] - d[0] * e2[2], d[0] * e2[1] - d[1] * e2[0]};
+        float det = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+        if (det == 0.0f) continue;
+        float inv = 1.0f / det;
+        float u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * inv;
+        if (u < 0.0f || u > 1.0f) continue;
+        float q[3] = {s[1] * e1[2] - s[2] * e1[1], s[2] * e1[0] - s[0] * e1[2], s[0] * e1[1] - s[1] * e1[0]};
+        float v = (d[0] * q[0] + d[1] * q[1] + d[2] * q[2]) * inv;
+        if (v < 0.0f || u + v > 1.0f) continue;
+        float t2 = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) * inv;
+        if (t2 >= ray.tMin && t2 < best) best = t2;
+    }
+    return best;
+}
+
+// Runs `trace(row)` for every camera row on all workers; returns Mrays/s.
+template <class Fn>
+double Throughput(size_t rays, Fn&& trace)
+{
+    auto start = Clock::now();
+    gJobSystem.ParallelFor(0, kImage, 8, [&](size_t first, size_t last) {
+        for (size_t row = first; row < last; ++row) trace(int(row));
+    });
+    return rays / (MsSince(start) * 1000.0);
+}
+
+template <int N, int W>
+void FillPacket(int x0, int y0, RayPacket<N>& packet)
+{
+    for (int i = 0; i < N; ++i)
+    {
+        Ray ray;
+        CameraRay(x0 + i % W, y0 + i / W, ray);
+        packet.ox[i] = ray.origin[0]; packet.oy[i] = ray.origin[1]; packet.oz[i] = ray.origin[2];
+        packet.dx[i] = ray.direction[0]; packet.dy[i] = ray.direction[1]; packet.dz[i] = ray.direction[2];
+        packet.tMin[i] = ray.tMin;
+        packet.tMax[i] = ray.tMax;
+    }
+}
+
+// W x (N / W) pixel tiles; rows are processed in groups of N / W.
+template <int N, int W>
+void Packets(const BVH& bvh, const char* label, std::atomic<size_t>& hits)
+{
+    constexpr int H = N / W;
+    const size_t rays = size_t(kImage) * kImage;
+    hits = 0;
+    double closest = Throughput(rays, [&](int row) {
+        if (row % H) return;
+        size_t local = 0;
+        for (int x = 0; x < kImage; x += W)
+        {
+            RayPacket<N> packet;
+            FillPacket<N, W>(x, row, packet);
+            bvh.Intersect(packet);
+            for (int i = 0; i < N; ++i) local += packet.primitive[i] != RayHit::kNone;
+        }
+        hits += local;
+    });
+    const size_t closestHits = hits;
+    hits = 0;
+    double any = Throughput(rays, [&](int row) {
+        if (row % H) return;
+        size_t local = 0;
+        for (int x = 0; x < kImage; x += W)
+        {
+            RayPacket<N> packet;
+            FillPacket<N, W>(x, row, packet);
+            uint32_t mask = bvh.Occluded(packet);
+            for (int i = 0; i < N; ++i) local += (mask >> i) & 1;
+        }
+        hits += local;
+    });
+    std::printf("  %-22s closest %7.2f Mrays/s   any %7.2f Mrays/s   (%zu / %zu hits)\n", label, closest, any,
+                closestHits, size_t(hits));
+}
+
+}  // namespace
+
+int main()
+{
+    Mesh mesh;
+    DisplacedSphere(mesh, 500, 1000, 0.0f);
+    std::printf("%zu triangles, %zu vertices, %zu workers\n", mesh.TriangleCount(), mesh.positions.size() / 3,
+                gJobSystem.WorkerCount());
+
+    BVH bvh;
+    BVHBuildSettings serial;
+    serial.parallel = false;
+    auto t0 = Clock::now();
+    bvh.Build(mesh.positions.data(), sizeof(float) * 3, mesh.indices.data(), mesh.TriangleCount(), serial);
+    const double serialMs = MsSince(t0);
+    auto t1 = Clock::now();
+    bvh.Build(mesh.positions.data(), sizeof(float) * 3, mesh.indices.data(), mesh.TriangleCount());
+    const double parallelMs = MsSince(t1);
+    std::printf("build: serial %.1f ms, parallel %.1f ms, %zu nodes\n", serialMs, parallelMs, bvh.NodeCount());
+
+    const size_t rays = size_t(kImage) * kImage;
+    std::atomic<size_t> hits{0};
+    auto report = [&](const char* label, double closest, size_t closestHits, double any) {
+        std::printf("  %-22s closest %7.2f Mrays/s   any %7.2f Mrays/s   (%zu / %zu hits)\n", label, closest, any,
+                    closestHits, size_t(hits));
+    };
+    auto single = [&](const BVH& tree, const char* label) {
+        hits = 0;
+        double closest = Throughput(rays, [&](int row) {
+            size_t local = 0;
+            for (int x = 0; x < kImage; ++x)
+            {
+                Ray ray;
+                CameraRay(x, row, ray);
+                RayHit hit;
+                local += tree.Intersect(ray, hit);
+            }
+            hits += local;
+        });
+        const size_t closestHits = hits;
+        hits = 0;
+        double any = Throughput(rays, [&](int row) {
+            size_t local = 0;
+            for (int x = 0; x < kImage; ++x)
+            {
+                Ray ray;
+                CameraRay(x, row, ray);
+                local += tree.Occluded(ray);
+            }
+            hits += local;
+        });
+        report(label, closest, closestHits, any);
+    };
+
+    std::printf("camera rays (%dx%d):\n", kImage, kImage);
+    single(bvh, "single");
+    Packets<4, 2>(bvh, "packet 4 (2x2)", hits);
+    Packets<8, 4>(bvh, "packet 8 (4x2)", hits);
+
+    const std::vector<Ray> random = RandomRays(rays);
+    hits = 0;
+    double closest = Throughput(rays, [&](int row) {
+        size_t local = 0;
+        for (int x = 0; x < kImage; ++x)
+        {
+            RayHit hit;
+            local += bvh.Intersect(random[size_t(row) * kImage + x], hit);
+        }
+        hits += local;
+    });
+    const size_t closestHits = hits;
+    hits = 0;
+    double any = Throughput(rays, [&](int row) {
+        size_t local = 0;
+        for (int x = 0; x < kImage; ++x) local += bvh.Occluded(random[size_t(row) * kImage + x]);
+        hits += local;
+    });
+    std::printf("random rays:\n");
+    report("single", closest, closestHits, any);
+
+    // Deform and refit; the tree keeps its topology, so compare against a rebuild.
+    DisplacedSphere(mesh, 500, 1000, 1.5f);
+    auto t2 = Clock::now();
+    bvh.Refit(mesh.positions.data(), sizeof(float) * 3);
+    const double refitMs = MsSince(t2);
+    std::printf("refit after deformation: %.1f ms\n", refitMs);
+    single(bvh, "refit, single");
+    BVH rebuilt;
+    rebuilt.Build(mesh.positions.data(), sizeof(float) * 3, mesh.indices.data(), mesh.TriangleCount());
+    single(rebuilt, "rebuilt, single");
+
+    // Spot-check closest hits against brute force.
+    int mismatches = 0;
+    const int samples = 64;
+    for (int i = 0; i < samples; ++i)
+    {
+        Ray ray;
+        CameraRay((i * 97) % kImage, (i * 389) % kImage, ray);
+        const Ray& r = i % 2 ? ray : random[i * 1013];
+        RayHit hit;
+        const float expected = BruteForce(mesh, r);
+        const float got = bvh.Intersect(r, hit) ? hit.t : r.tMax;
+        if (std::fabs(expected - got) > 1e-4f * std::max(1.0f, std::fabs(expected)) && expected != got) ++mismatches;
+    }
+    std::printf("brute-force check: %d / %d mismatches\n", mismatches, samples);
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,221 @@
+// Builds meshlets and the cluster LOD DAG (aartze::geometry::ClusterHierarchy)
+// for a 1M-triangle scan-like mesh, a bumpy closed surface with an attribute
+// seam, then runs the CPU reference traversal from several distances.
+// Reports build cost, meshlet fill, clusters traversed per millisecond,
+// triangles selected and the indirect commands after merging, and the roots
+// and their triangles, which is all that is drawn far away. Also checks
+// that each cut covers the surface once (area against level 0) and that
+// every cluster the normal cone culls is entirely backfacing.
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "aartze/geometry/ClusterHierarchy.h"
+#include "core/JobSystem.hpp"
+#include "../BenchTimer.h"
+
+namespace {
+
+using namespace aartze::geometry;
+
+constexpr float kPi = 3.14159265f;
+
+struct Mesh
+{
+    std::vector<float> positions;
+    std::vector<uint32_t> indices;
+};
+
+// Lat-long rock with several octaves of ridges; the longitude seam has its
+// own column of vertices as a UV seam would.
+Mesh Scan(int rings, int segments)
+{
+    Mesh m;
+    for (int r = 0; r <= rings; ++r)
+        for (int s = 0; s <= segments; ++s)
+        {
+            float theta = kPi * r / rings, phi = 2 * kPi * s / segments;
+            float k = 1.0f + 0.06f * std::sin(5 * theta) * std::sin(3 * phi) + 0.02f * std::sin(23 * theta + 2 * phi) +
+                      0.006f * std::sin(71 * phi) * std::sin(61 * theta);
+            m.positions.insert(m.positions.end(), {k * std::sin(theta) * std::cos(phi), 0.8f * k * std::cos(theta),
+                                                   k * std::sin(theta) * std::sin(phi)});
+        }
+    const uint32_t row = segments + 1;
+    for (int r = 0; r < rings; ++r)
+        for (int s = 0; s < segments; ++s)
+        {
+            uint32_t a = r * row + s, b = a + 1, c = a + row, d = c + 1;
+            if (r > 0) m.indices.insert(m.indices.end(), {a, b, c});
+            if (r < rings - 1) m.indices.insert(m.indices.end(), {b, d, c});
+        }
+    return m;
+}
+
+const float* P(const Mesh& m, uint32_t v) { return &m.positions[size_t(v) * 3]; }
+
+double Area(const Mesh& m, const uint32_t* indices, size_t count)
+{
+    double area = 0.0;
+    for (size_t i = 0; i + 2 < count; i += 3)
+    {
+        const float *a = P(m, indices[i]), *b = P(m, indices[i + 1]), *c = P(m, indices[i + 2]);
+        double u[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]}, v[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+        double n[3] = {u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0]};
+        area += 0.5 * std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    }
+    return area;
+}
+
+void Perspective(float m[16], float fovy, float aspect, float n, float f)
+{
+    float t = 1.0f / std::tan(fovy / 2);
+    std::fill(m, m + 16, 0.0f);
+    m[0] = t / aspect; m[5] = t; m[10] = (f + n) / (n - f); m[11] = -1.0f; m[14] = 2 * f * n / (n - f);
+}
+
+// View-projection of a camera at `eye` looking at the origin.
+void LookAtOrigin(float out[16], const float eye[3], const float proj[16])
+{
+    float F[3] = {-eye[0], -eye[1], -eye[2]};
+    float fl = std::sqrt(F[0] * F[0] + F[1] * F[1] + F[2] * F[2]);
+    for (float& f : F) f /= fl;
+    float S[3] = {F[1] * 0 - F[2] * 1, F[2] * 0 - F[0] * 0, F[0] * 1 - F[1] * 0};  // F x up(0,1,0)
+    float sl = std::sqrt(S[0] * S[0] + S[1] * S[1] + S[2] * S[2]);
+    for (float& s : S) s /= sl;
+    float U[3] = {S[1] * F[2] - S[2] * F[1], S[2] * F[0] - S[0] * F[2], S[0] * F[1] - S[1] * F[0]};
+    float view[16] = {S[0], U[0], -F[0], 0, S[1], U[1], -F[1], 0, S[2], U[2], -F[2], 0, 0, 0, 0, 1};
+    for (int r = 0; r < 3; ++r) view[12 + r] = -(view[r] * eye[0] + view[4 + r] * eye[1] + view[8 + r] * eye[2]);
+    for (int c = 0; c < 4; ++c)
+        for (int r = 0; r < 4; ++r)
+            out[c * 4 + r] = proj[r] * view[c * 4] + proj[4 + r] * view[c * 4 + 1] + proj[8 + r] * view[c * 4 + 2] +
+                             proj[12 + r] * view[c * 4 + 3];
+}
+
+}  // namespace
+
+int main()
+{
+    int failures = 0;
+    const Mesh mesh = Scan(500, 1000);
+    const size_t vertexCount = mesh.positions.size() / 3, triangles = mesh.indices.size() / 3;
+    std::printf("%zu workers; scan mesh: %zu vertices, %zu triangles\n", gJobSystem.WorkerCount(), vertexCount, triangles);
+
+    auto t0 = Clock::now();
+    MeshletBuffers meshlets;
+    Meshlets::Build(meshlets, mesh.indices.data(), mesh.indices.size(), mesh.positions.data(), vertexCount,
+                    3 * sizeof(float));
+    const double meshletMs = MsSince(t0);
+    size_t fullTriangles = 0;
+    for (const Meshlet& m : meshlets.meshlets) fullTriangles += m.triangleCount == Meshlets::kMaxTriangles;
+    std::printf("meshlets: %zu in %.1f ms, %.1f triangles and %.1f vertices on average, %.0f%% full\n",
+                meshlets.meshlets.size(), meshletMs, double(triangles) / meshlets.meshlets.size(),
+                double(meshlets.vertices.size()) / meshlets.meshlets.size(),
+                100.0 * fullTriangles / meshlets.meshlets.size());
+
+    auto t1 = Clock::now();
+    ClusterHierarchy hierarchy;
+    hierarchy.Build(mesh.indices.data(), mesh.indices.size(), mesh.positions.data(), vertexCount, 3 * sizeof(float));
+    const double buildMs = MsSince(t1);
+    std::vector<size_t> perLevel(hierarchy.LevelCount(), 0);
+    size_t roots = 0, rootTriangles = 0;
+    for (const Cluster& c : hierarchy.Clusters())
+    {
+        ++perLevel[c.level];
+        if (!std::isinf(c.parentError)) continue;
+        ++roots;
+        rootTriangles += c.indexCount / 3;
+    }
+    std::printf("hierarchy: %zu clusters in %u levels, %zu nodes, %.2fx the level-0 indices, %.0f ms\n",
+                hierarchy.Clusters().size(), hierarchy.LevelCount(), hierarchy.Nodes().size(),
+                double(hierarchy.Indices().size()) / mesh.indices.size(), buildMs);
+    // The roots are the cut at any distance, so they bound how cheap the mesh gets.
+    std::printf("  %zu roots, %zu triangles in the farthest cut\n", roots, rootTriangles);
+    std::printf("  clusters per level:");
+    for (size_t n : perLevel) std::printf(" %zu", n);
+    std::printf("\n");
+
+    const double fullArea = Area(mesh, mesh.indices.data(), mesh.indices.size());
+    float proj[16];
+    Perspective(proj, 45.0f * kPi / 180.0f, 16.0f / 9.0f, 0.05f, 1000.0f);
+    const float pixelScale = proj[5] * 0.5f * 1080.0f;
+    std::vector<uint32_t> selected;
+    std::vector<DrawElementsIndirectCommand> commands;
+    std::printf("\n%8s %9s %10s %9s %9s %9s %9s %8s %9s\n", "distance", "tested", "clusters/ms", "selected", "triangles",
+                "frustum", "backface", "commands", "area");
+    for (float distance : {1.3f, 2.0f, 4.0f, 10.0f, 30.0f, 100.0f})
+    {
+        const float eye[3] = {distance * 0.8f, distance * 0.3f, distance * 0.52f};
+        float viewProj[16];
+        LookAtOrigin(viewProj, eye, proj);
+        const ClusterView view = ClusterView::FromMatrix(viewProj, eye, pixelScale);
+
+        ClusterSelectionStats stats;
+        const int runs = 50;
+        auto t2 = Clock::now();
+        for (int run = 0; run < runs; ++run) hierarchy.Select(view, selected, &stats);
+        const double selectMs = MsSince(t2) / runs;
+        hierarchy.BuildDrawList(selected.data(), selected.size(), commands);
+
+        // Cut check: the same view without frustum or backface culling must
+        // cover the surface exactly once.
+        ClusterView open = view;
+        open.backfaceCulling = false;
+        for (auto& plane : open.planes) { plane[0] = plane[1] = plane[2] = 0.0f; plane[3] = 1.0f; }
+        std::vector<uint32_t> cut;
+        hierarchy.Select(open, cut);
+        double area = 0.0;
+        for (uint32_t i : cut)
+        {
+            const Cluster& c = hierarchy.Clusters()[i];
+            area += Area(mesh, hierarchy.Indices().data() + c.firstIndex, c.indexCount);
+        }
+
+        std::printf("%8.1f %9u %10.0f %9u %9llu %9u %9u %8zu %8.3fx\n", distance, stats.clustersTested,
+                    stats.clustersTested / selectMs, stats.selected, (unsigned long long)stats.triangles,
+                    stats.frustumCulled, stats.backfaceCulled, commands.size(), area / fullArea);
+        // Simplifying a convex surface shrinks it a little; a hole or a
+        // doubled region would be off by whole clusters.
+        failures += std::fabs(area / fullArea - 1.0) > 0.05;
+    }
+
+    // Cone culling must never drop a triangle that faces the camera: compare
+    // the finest cut with and without it from close around the mesh.
+    size_t wrong = 0, culled = 0;
+    for (float distance : {1.2f, 3.0f})
+        for (int k = 0; k < 8; ++k)
+        {
+            const float a = 2 * kPi * k / 8;
+            ClusterView view;
+            for (auto& plane : view.planes) { plane[0] = plane[1] = plane[2] = 0.0f; plane[3] = 1.0f; }
+            const float eye[3] = {distance * std::cos(a), 0.4f * std::sin(3.0f * a), distance * std::sin(a)};
+            std::copy(eye, eye + 3, view.eye);
+            view.pixelScale = pixelScale;
+            view.pixelError = 1e-9f;
+            std::vector<uint32_t> all, visible;
+            view.backfaceCulling = false;
+            hierarchy.Select(view, all);
+            view.backfaceCulling = true;
+            hierarchy.Select(view, visible);
+            std::sort(visible.begin(), visible.end());
+            for (uint32_t i : all)
+            {
+                if (std::binary_search(visible.begin(), visible.end(), i)) continue;
+                ++culled;
+                const Cluster& c = hierarchy.Clusters()[i];
+                const uint32_t* idx = hierarchy.Indices().data() + c.firstIndex;
+                for (uint32_t t = 0; t < c.indexCount; t += 3)
+                {
+                    const float *p0 = P(mesh, idx[t]), *p1 = P(mesh, idx[t + 1]), *p2 = P(mesh, idx[t + 2]);
+                    float u[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]}, v[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+                    float n[3] = {u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0]};
+                    wrong += (eye[0] - p0[0]) * n[0] + (eye[1] - p0[1]) * n[1] + (eye[2] - p0[2]) * n[2] > 0.0f;
+                }
+            }
+        }
+    std::printf("\ncone culling: %zu finest-level clusters culled over 16 views, %zu front-facing triangles among them\n",
+                culled, wrong);
+    failures += wrong != 0;
+    return failures;
+}
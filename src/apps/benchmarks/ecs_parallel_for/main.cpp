@@ -0,0 +1,123 @@
+// Measures Query::ForEachParallel scaling on a pose-evaluation workload shaped
+// like AnimationSystem: 2,000 skinned characters with 64 bones each. The last
+// rows time the gJobSystem overload that the engine's systems use.
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "core/Archetype.hpp"
+#include "core/JobSystem.hpp"
+#include "core/Query.hpp"
+#include "../BenchTimer.h"
+
+namespace {
+
+struct Mat4
+{
+    float m[16];
+};
+
+Mat4 Mul(const Mat4& a, const Mat4& b)
+{
+    Mat4 r{};
+    for (int c = 0; c < 4; ++c)
+        for (int row = 0; row < 4; ++row)
+        {
+            float s = 0.0f;
+            for (int k = 0; k < 4; ++k) s += a.m[k * 4 + row] * b.m[c * 4 + k];
+            r.m[c * 4 + row] = s;
+        }
+    return r;
+}
+
+Mat4 Local(float t, int bone)
+{
+    float a = t + 0.1f * bone, c = std::cos(a), s = std::sin(a);
+    return {{c, s, 0, 0, -s, c, 0, 0, 0, 0, 1, 0, 0.1f, 0.2f * bone, 0, 1}};
+}
+
+// Heap-backed like SkeletonComponent: the chunk holds the vector headers.
+struct SkeletonPose
+{
+    std::vector<int> parents;
+    std::vector<Mat4> pose;
+};
+
+struct Playback
+{
+    float time = 0.0f;
+    float speed = 1.0f;
+};
+
+constexpr ComponentType kSkeleton = 0, kPlayback = 1;
+constexpr int kCharacters = 2000;
+constexpr int kBones = 64;
+constexpr int kFrames = 30;
+
+void Evaluate(Playback& play, SkeletonPose& skel, float dt)
+{
+    play.time += dt * play.speed;
+    for (int b = 0; b < kBones; ++b)
+    {
+        Mat4 local = Local(play.time, b);
+        int parent = skel.parents[b];
+        skel.pose[b] = parent >= 0 ? Mul(skel.pose[parent], local) : local;
+    }
+}
+
+}  // namespace
+
+int main()
+{
+    ArchetypeStorage storage;
+    storage.RegisterComponent<SkeletonPose>(kSkeleton);
+    storage.RegisterComponent<Playback>(kPlayback);
+    for (Entity e = 0; e < kCharacters; ++e)
+    {
+        storage.AddEntity(e);
+        SkeletonPose skel;
+        for (int b = 0; b < kBones; ++b) skel.parents.push_back(b - 1);
+        skel.pose.resize(kBones);
+        storage.Add(e, kSkeleton, std::move(skel));
+        Playback play;
+        play.speed = 0.5f + 0.001f * e;
+        storage.Add(e, kPlayback, play);
+    }
+    Signature required;
+    required.set(kSkeleton);
+    required.set(kPlayback);
+    Query<Playback, SkeletonPose> query(storage.RegisterQuery(required), {kPlayback, kSkeleton});
+    auto body = [](Entity, Playback& play, SkeletonPose& skel) { Evaluate(play, skel, 1.0f / 60.0f); };
+
+    auto t0 = Clock::now();
+    for (int f = 0; f < kFrames; ++f) query.ForEach(body);
+    double serial = MsSince(t0) / kFrames;
+    std::size_t chunks = 0;
+    for (Archetype* archetype : query.Archetypes()) chunks += archetype->ChunkCount();
+    std::printf("%d characters x %d bones, %zu chunks\n", kCharacters, kBones, chunks);
+    std::printf("%-10s %14s %10s\n", "workers", "ms/frame", "speedup");
+    std::printf("%-10s %14.3f %10s\n", "serial", serial, "1.0");
+
+    for (std::size_t workers : {std::size_t(1), std::size_t(2), std::size_t(4), std::size_t(8), std::size_t(16)})
+    {
+        JobSystem jobs(workers);
+        query.ForEachParallel(jobs, body);  // warm up workers
+        auto t1 = Clock::now();
+        for (int f = 0; f < kFrames; ++f) query.ForEachParallel(jobs, body);
+        double ms = MsSince(t1) / kFrames;
+        std::printf("%-10zu %14.3f %10.1f\n", workers, ms, serial / ms);
+    }
+
+    // The overload the engine's systems call: gJobSystem with the automatic
+    // grain, next to the one-entity grain it must not fall back to.
+    std::printf("\ngJobSystem (%zu workers)\n", gJobSystem.WorkerCount());
+    for (std::size_t grain : {std::size_t(0), std::size_t(1)})
+    {
+        query.ForEachParallel(body, grain);
+        auto t1 = Clock::now();
+        for (int f = 0; f < kFrames; ++f) query.ForEachParallel(body, grain);
+        double ms = MsSince(t1) / kFrames;
+        std::printf("%-10s %14.3f %10.1f\n", grain ? "grain 1" : "default", ms, serial / ms);
+    }
+    return 0;
+}
@@ -0,0 +1,152 @@
+// Compares the archetype (chunked SoA) component storage used by Coordinator
+// against the previous per-type hash-map storage at 5k, 50k and 500k entities.
+#include <cstdio>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "core/Archetype.hpp"
+#include "components/TransformComponent.hpp"
+#include "components/VelocityComponent.hpp"
+#include "components/HealthComponent.hpp"
+#include "../BenchTimer.h"
+
+namespace {
+
+// Mirrors the pre-archetype path: one packed array per type indexed through an
+// unordered_map under a mutex, and queries scanning an Entity -> Signature map.
+template <typename T>
+struct LegacyArray
+{
+    std::vector<T> data;
+    std::unordered_map<Entity, size_t> entityToIndex;
+    std::mutex mutex;
+
+    void Insert(Entity e, const T& c)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        entityToIndex[e] = data.size();
+        data.push_back(c);
+    }
+    T& Get(Entity e)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return data[entityToIndex[e]];
+    }
+};
+
+struct LegacyWorld
+{
+    LegacyArray<TransformComponent> transforms;
+    LegacyArray<VelocityComponent> velocities;
+    LegacyArray<HealthComponent> healths;
+    std::unordered_map<Entity, Signature> signatures;
+};
+
+struct Result
+{
+    double populateMs;
+    double iterateMs;
+    double checksum;
+};
+
+constexpr ComponentType kTransform = 0, kVelocity = 1, kHealth = 2;
+constexpr int kFrames = 20;
+
+Result RunLegacy(Entity count)
+{
+    LegacyWorld w;
+    auto t0 = Clock::now();
+    for (Entity e = 0; e < count; ++e)
+    {
+        w.transforms.Insert(e, {});
+        w.signatures[e].set(kTransform);
+        VelocityComponent v; v.linear = {1.0f, 0.0f, 0.5f};
+        w.velocities.Insert(e, v);
+        w.signatures[e].set(kVelocity);
+        if (e % 4 == 0) { w.healths.Insert(e, {}); w.signatures[e].set(kHealth); }
+    }
+    double populate = MsSince(t0);
+
+    Signature required; required.set(kTransform); required.set(kVelocity);
+    auto t1 = Clock::now();
+    for (int f = 0; f < kFrames; ++f)
+    {
+        std::vector<Entity> matched;
+        for (const auto& [e, sig] : w.signatures)
+            if ((sig & required) == required) matched.push_back(e);
+        for (Entity e : matched)
+        {
+            auto& tr = w.transforms.Get(e);
+            auto& v = w.velocities.Get(e);
+            for (int i = 0; i < 3; ++i) tr.position[i] += v.linear[i] * 0.016f;
+        }
+    }
+    double iterate = MsSince(t1) / kFrames;
+
+    double sum = 0.0;
+    for (auto& tr : w.transforms.data) sum += tr.position[0];
+    return {populate, iterate, sum};
+}
+
+Result RunArchetype(Entity count)
+{
+    ArchetypeStorage storage;
+    storage.RegisterComponent<TransformComponent>(kTransform);
+    storage.RegisterComponent<VelocityComponent>(kVelocity);
+    storage.RegisterComponent<HealthComponent>(kHealth);
+
+    auto t0 = Clock::now();
+    for (Entity e = 0; e < count; ++e)
+    {
+        storage.AddEntity(e);
+        storage.Add(e, kTransform, TransformComponent{});
+        VelocityComponent v; v.linear = {1.0f, 0.0f, 0.5f};
+        storage.Add(e, kVelocity, v);
+        if (e % 4 == 0) storage.Add(e, kHealth, HealthComponent{});
+    }
+    double populate = MsSince(t0);
+
+    Signature required; required.set(kTransform); required.set(kVelocity);
+    auto t1 = Clock::now();
+    for (int f = 0; f < kFrames; ++f)
+    {
+        storage.ForEachArchetype(required, [](Archetype& a) {
+            for (size_t c = 0; c < a.ChunkCount(); ++c)
+            {
+                auto* tr = a.Column<TransformComponent>(c, kTransform);
+                auto* v = a.Column<VelocityComponent>(c, kVelocity);
+                for (uint32_t r = 0, n = a.GetChunk(c).count; r < n; ++r)
+                    for (int i = 0; i < 3; ++i) tr[r].position[i] += v[r].linear[i] * 0.016f;
+            }
+        });
+    }
+    double iterate = MsSince(t1) / kFrames;
+
+    double sum = 0.0;
+    storage.ForEachArchetype(required, [&](Archetype& a) {
+        for (size_t c = 0; c < a.ChunkCount(); ++c)
+        {
+            auto* tr = a.Column<TransformComponent>(c, kTransform);
+            for (uint32_t r = 0, n = a.GetChunk(c).count; r < n; ++r) sum += tr[r].position[0];
+        }
+    });
+    return {populate, iterate, sum};
+}
+
+}  // namespace
+
+int main()
+{
+    std::printf("%-10s %-10s %14s %16s\n", "entities", "storage", "populate (ms)", "iterate (ms/frame)");
+    for (Entity count : {Entity(5000), Entity(50000), Entity(500000)})
+    {
+        Result legacy = RunLegacy(count);
+        Result arch = RunArchetype(count);
+        std::printf("%-10u %-10s %14.3f %16.4f\n", count, "hashmap", legacy.populateMs, legacy.iterateMs);
+        std::printf("%-10u %-10s %14.3f %16.4f  (x%.1f)\n", count, "archetype", arch.populateMs, arch.iterateMs,
+                    legacy.iterateMs / (arch.iterateMs > 0.0 ? arch.iterateMs : 1e-9));
+        if (legacy.checksum != arch.checksum) std::printf("  checksum mismatch: %f vs %f\n", legacy.checksum, arch.checksum);
+    }
+    return 0;
+}
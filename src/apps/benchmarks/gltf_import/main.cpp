@@ -0,0 +1,459 @@
+// glTF loading: Assimp (parse into its own copy of the scene, then
+// ConvertAssimpScene, as LoadGltfModel did) against the native loader
+// (LoadGltf maps the .glb and reads accessors in place, ConvertGltfScene
+// converts from there), for time and peak memory. Writes a large .glb: a district of
+// grid-patch meshes instanced over many nodes, half of them with interleaved
+// attributes (strided copies) and half with separate ones (read in place),
+// 16- and 32-bit indices, textured materials, a triangle fan and a skinned
+// mesh. Pass a .gltf/.glb path to load that instead. Each run happens in a
+// child process so its peak RSS can be read back (Linux; elsewhere the runs
+// are in-process and memory is not reported). Also checks that both paths
+// produce the same triangles (count, area and area-weighted centroid) and
+// that damaged files are refused.
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "aartze/import/Gltf.h"
+#include "utils/MeshUtils.hpp"
+#include "../BenchTimer.h"
+
+#if defined(__linux__)
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+using nlohmann::json;
+
+// Builds the buffer, views and accessors of a .glb.
+struct GlbWriter
+{
+    std::vector<unsigned char> bin;
+    json doc = {{"asset", {{"version", "2.0"}}}, {"bufferViews", json::array()}, {"accessors", json::array()}};
+
+    size_t View(const void* data, size_t bytes, size_t stride = 0)
+    {
+        bin.resize((bin.size() + 3) & ~size_t(3));
+        json view = {{"buffer", 0}, {"byteOffset", bin.size()}, {"byteLength", bytes}};
+        if (stride) view["byteStride"] = stride;
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        bin.insert(bin.end(), p, p + bytes);
+        doc["bufferViews"].push_back(view);
+        return doc["bufferViews"].size() - 1;
+    }
+    size_t Accessor(size_t view, size_t offset, uint32_t componentType, const char* type, size_t count,
+                    bool normalized = false)
+    {
+        json a = {{"bufferView", view}, {"byteOffset", offset}, {"componentType", componentType}, {"type", type},
+                  {"count", count}};
+        if (normalized) a["normalized"] = true;
+        doc["accessors"].push_back(a);
+        return doc["accessors"].size() - 1;
+    }
+    bool Write(const std::string& path)
+    {
+        doc["buffers"] = json::array({{{"byteLength", bin.size()}}});
+        std::string text = doc.dump();
+        text.resize((text.size() + 3) & ~size_t(3), ' ');
+        bin.resize((bin.size() + 3) & ~size_t(3), 0);
+        const uint32_t header[3] = {0x46546C67u, 2u, uint32_t(12 + 8 + text.size() + 8 + bin.size())};
+        const uint32_t jsonChunk[2] = {uint32_t(text.size()), 0x4E4F534Au};
+        const uint32_t binChunk[2] = {uint32_t(bin.size()), 0x004E4942u};
+        std::ofstream f(path, std::ios::binary);
+        f.write(reinterpret_cast<const char*>(header), sizeof(header));
+        f.write(reinterpret_cast<const char*>(jsonChunk), sizeof(jsonChunk));
+        f.write(text.data(), text.size());
+        f.write(reinterpret_cast<const char*>(binChunk), sizeof(binChunk));
+        f.write(reinterpret_cast<const char*>(bin.data()), bin.size());
+        return bool(f);
+    }
+};
+
+// A bent grid patch of `cells` x `cells` cells as one primitive.
+json WritePatch(GlbWriter& w, int cells, int variant, bool interleaved, bool shortIndices, int material)
+{
+    const int row = cells + 1;
+    const size_t count = size_t(row) * row;
+    std::vector<float> positions(count * 3), normals(count * 3), uvs(count * 2);
+    for (int z = 0; z < row; ++z)
+        for (int x = 0; x < row; ++x)
+        {
+            const size_t i = size_t(z) * row + x;
+            const float u = float(x) / cells, v = float(z) / cells;
+            const float k = 1.0f + 0.2f * variant;
+            positions[i * 3 + 0] = u * 8.0f;
+            positions[i * 3 + 1] = 0.5f * std::sin(u * 5.0f * k) * std::cos(v * 3.0f);
+            positions[i * 3 + 2] = v * 8.0f;
+            float n[3] = {-0.3125f * k * std::cos(u * 5.0f * k) * std::cos(v * 3.0f), 1.0f,
+                          0.1875f * std::sin(u * 5.0f * k) * std::sin(v * 3.0f)};
+            const float l = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+            for (int a = 0; a < 3; ++a) normals[i * 3 + a] = n[a] / l;
+            uvs[i * 2 + 0] = u;
+            uvs[i * 2 + 1] = v;
+        }
+    std::vector<uint32_t> indices;
+    for (int z = 0; z < cells; ++z)
+        for (int x = 0; x < cells; ++x)
+        {
+            const uint32_t a = z * row + x, b = a + 1, c = a + row, d = c + 1;
+            indices.insert(indices.end(), {a, c, b, b, c, d});
+        }
+
+    json attributes;
+    if (interleaved)
+    {
+        std::vector<float> vertices(count * 8);
+        for (size_t i = 0; i < count; ++i)
+        {
+            std::copy_n(&positions[i * 3], 3, &vertices[i * 8]);
+            std::copy_n(&normals[i * 3], 3, &vertices[i * 8 + 3]);
+            std::copy_n(&uvs[i * 2], 2, &vertices[i * 8 + 6]);
+        }
+        const size_t view = w.View(vertices.data(), vertices.size() * sizeof(float), 32);
+        attributes["POSITION"] = w.Accessor(view, 0, 5126, "VEC3", count);
+        attributes["NORMAL"] = w.Accessor(view, 12, 5126, "VEC3", count);
+        attributes["TEXCOORD_0"] = w.Accessor(view, 24, 5126, "VEC2", count);
+    }
+    else
+    {
+        attributes["POSITION"] = w.Accessor(w.View(positions.data(), positions.size() * 4), 0, 5126, "VEC3", count);
+        attributes["NORMAL"] = w.Accessor(w.View(normals.data(), normals.size() * 4), 0, 5126, "VEC3", count);
+        attributes["TEXCOORD_0"] = w.Accessor(w.View(uvs.data(), uvs.size() * 4), 0, 5126, "VEC2", count);
+    }
+    w.doc["accessors"][size_t(attributes["POSITION"])]["min"] = {0.0f, -0.5f, 0.0f};
+    w.doc["accessors"][size_t(attributes["POSITION"])]["max"] = {8.0f, 0.5f, 8.0f};
+    size_t indexAccessor;
+    if (shortIndices)
+    {
+        std::vector<uint16_t> narrow(indices.begin(), indices.end());
+        indexAccessor = w.Accessor(w.View(narrow.data(), narrow.size() * 2), 0, 5123, "SCALAR", narrow.size());
+    }
+    else
+    {
+        indexAccessor = w.Accessor(w.View(indices.data(), indices.size() * 4), 0, 5125, "SCALAR", indices.size());
+    }
+    return {{"attributes", attributes}, {"indices", indexAccessor}, {"material", material}};
+}
+
+bool WriteDistrict(const std::string& path, int meshCount, int instancesPerMesh, int cells)
+{
+    GlbWriter w;
+    const int materialCount = 8;
+    w.doc["images"] = json::array();
+    w.doc["textures"] = json::array();
+    w.doc["materials"] = json::array();
+    for (int m = 0; m < materialCount; ++m)
+    {
+        w.doc["images"].push_back({{"uri", "facade_" + std::to_string(m) + ".png"}});
+        w.doc["textures"].push_back({{"source", m}});
+        w.doc["materials"].push_back(
+            {{"name", "facade" + std::to_string(m)},
+             {"pbrMetallicRoughness",
+              {{"baseColorFactor", {0.3f + 0.08f * m, 0.6f, 0.9f - 0.08f * m, 1.0f}},
+               {"baseColorTexture", {{"index", m}}},
+               {"metallicFactor", 0.0f}}}});
+    }
+
+    json meshes = json::array(), nodes = json::array(), roots = json::array();
+    for (int m = 0; m < meshCount; ++m)
+    {
+        json primitive = WritePatch(w, cells, m % 7, m % 2 == 0, m % 3 != 0, m % materialCount);
+        meshes.push_back({{"name", "block" + std::to_string(m)}, {"primitives", json::array({primitive})}});
+    }
+
+    // A fan cap and a skinned strip of two bones hang off the last block.
+    {
+        const float fan[] = {0, 1, 0, 1, 1, 0, 0.7f, 1, 0.7f, 0, 1, 1, -0.7f, 1, 0.7f, -1, 1, 0};
+        const size_t view = w.View(fan, sizeof(fan));
+        json primitive = {{"attributes", {{"POSITION", w.Accessor(view, 0, 5126, "VEC3", 6)}}}, {"mode", 6}};
+        meshes.push_back({{"name", "cap"}, {"primitives", json::array({primitive})}});
+
+        const float positions[] = {0, 0, 0, 1, 0, 0, 0, 1, 0, 1, 1, 0, 0, 2, 0, 1, 2, 0};
+        const uint8_t joints[] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0};
+        const uint8_t weights[] = {255, 0, 0, 0, 255, 0, 0, 0, 128, 127, 0, 0,
+                                   128, 127, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0};
+        const uint16_t strip[] = {0, 1, 2, 3, 4, 5};
+        const float inverseBind[32] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1,
+                                       1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, -1, 0, 1};
+        json skinned = {{"attributes",
+                         {{"POSITION", w.Accessor(w.View(positions, sizeof(positions)), 0, 5126, "VEC3", 6)},
+                          {"JOINTS_0", w.Accessor(w.View(joints, sizeof(joints)), 0, 5121, "VEC4", 6)},
+                          {"WEIGHTS_0", w.Accessor(w.View(weights, sizeof(weights)), 0, 5121, "VEC4", 6, true)}}},
+                        {"indices", w.Accessor(w.View(strip, sizeof(strip)), 0, 5123, "SCALAR", 6)},
+                        {"mode", 5}};
+        meshes.push_back({{"name", "banner"}, {"primitives", json::array({skinned})}});
+        w.doc["skins"] = json::array(
+            {{{"joints", {meshCount * instancesPerMesh + 2, meshCount * instancesPerMesh + 3}},
+              {"inverseBindMatrices", w.Accessor(w.View(inverseBind, sizeof(inverseBind)), 0, 5126, "MAT4", 2)}}});
+    }
+
+    // Instances on a grid, turned and some mirrored, so the node transforms matter.
+    const int side = int(std::ceil(std::sqrt(double(meshCount * instancesPerMesh))));
+    for (int i = 0; i < meshCount * instancesPerMesh; ++i)
+    {
+        const float angle = 0.5f * float(i % 4);
+        const float scaleX = i % 5 == 4 ? -1.0f : 1.0f;
+        nodes.push_back({{"mesh", i % meshCount},
+                         {"translation", {float(i % side) * 10.0f, 0.0f, float(i / side) * 10.0f}},
+                         {"rotation", {0.0f, std::sin(angle / 2), 0.0f, std::cos(angle / 2)}},
+                         {"scale", {scaleX, 1.0f, 1.0f}}});
+        roots.push_back(i);
+    }
+    const int first = meshCount * instancesPerMesh;
+    nodes.push_back({{"mesh", meshCount}, {"translation", {-5.0f, 2.0f, -5.0f}}});
+    nodes.push_back({{"mesh", meshCount + 1}, {"skin", 0}, {"children", {first + 2}}});
+    nodes.push_back({{"name", "root bone"}, {"children", {first + 3}}});
+    nodes.push_back({{"name", "tip bone"}, {"translation", {0.0f, 1.0f, 0.0f}}});
+    roots.push_back(first);
+    roots.push_back(first + 1);
+
+    w.doc["meshes"] = meshes;
+    w.doc["nodes"] = nodes;
+    w.doc["scenes"] = json::array({{{"nodes", roots}}});
+    w.doc["scene"] = 0;
+    return w.Write(path);
+}
+
+// What a run hands back, enough to tell the two paths produced the same surface.
+struct Result
+{
+    double ms = 0.0;
+    uint64_t triangles = 0;
+    uint64_t vertices = 0;
+    double area = 0.0;
+    double centroid[3] = {0.0, 0.0, 0.0};  // area-weighted
+    long peakKb = -1;
+};
+
+void Summarize(const MeshData& data, Result& r)
+{
+    const size_t count = data.indices.empty() ? data.vertices.size() / 3
+                                              : (data.lods.empty() ? data.indices.size() : data.lods[0].indexCount);
+    const uint32_t first = data.lods.empty() ? 0 : data.lods[0].firstIndex;
+    r.vertices = data.vertices.size() / 3;
+    r.triangles = count / 3;
+    for (size_t t = 0; t < count / 3; ++t)
+    {
+        const float* p[3];
+        for (int k = 0; k < 3; ++k)
+        {
+            const size_t v = data.indices.empty() ? t * 3 + k : data.indices[first + t * 3 + k];
+            p[k] = &data.vertices[v * 3];
+        }
+        const double u[3] = {p[1][0] - p[0][0], p[1][1] - p[0][1], p[1][2] - p[0][2]};
+        const double w[3] = {p[2][0] - p[0][0], p[2][1] - p[0][1], p[2][2] - p[0][2]};
+        const double n[3] = {u[1] * w[2] - u[2] * w[1], u[2] * w[0] - u[0] * w[2], u[0] * w[1] - u[1] * w[0]};
+        const double area = 0.5 * std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        r.area += area;
+        for (int a = 0; a < 3; ++a) r.centroid[a] += area * (p[0][a] + p[1][a] + p[2][a]) / 3.0;
+    }
+    for (double& c : r.centroid) c /= std::max(r.area, 1e-30);
+}
+
+// Run `fn` in a child process and read back its result and peak RSS.
+template <class Fn>
+bool Measure(Fn&& fn, Result& out)
+{
+#if defined(__linux__)
+    int fds[2];
+    if (pipe(fds) != 0) return false;
+    std::fflush(stdout);  // or the child's copy of the buffer is printed twice
+    const pid_t pid = fork();
+    if (pid == 0)
+    {
+        close(fds[0]);
+        Result r;
+        const bool ok = fn(r);
+        if (ok && write(fds[1], &r, sizeof(r)) != ssize_t(sizeof(r))) _exit(2);
+        _exit(ok ? 0 : 1);
+    }
+    close(fds[1]);
+    const bool got = pid > 0 && read(fds[0], &out, sizeof(out)) == ssize_t(sizeof(out));
+    close(fds[0]);
+    int status = 0;
+    rusage usage{};
+    if (pid > 0 && wait4(pid, &status, 0, &usage) == pid) out.peakKb = usage.ru_maxrss;
+    return got && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+#else
+    return fn(out);
+#endif
+}
+
+bool Same(const Result& a, const Result& b)
+{
+    const double tolerance = 1e-4 * std::max(1.0, std::abs(a.area));
+    return a.triangles == b.triangles && std::abs(a.area - b.area) <= tolerance &&
+           std::abs(a.centroid[0] - b.centroid[0]) <= 1e-4 && std::abs(a.centroid[1] - b.centroid[1]) <= 1e-4 &&
+           std::abs(a.centroid[2] - b.centroid[2]) <= 1e-4;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    int failures = 0;
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "aartze_bench_gltf_import";
+    std::filesystem::create_directories(dir);
+    std::string path = argc > 1 ? argv[1] : (dir / "district.glb").string();
+    if (argc <= 1 && !WriteDistrict(path, 64, 3, 80))
+    {
+        std::printf("could not write %s\n", path.c_str());
+        return 1;
+    }
+    std::string directory;
+    const size_t slash = path.find_last_of("/\\");
+    if (slash != std::string::npos) directory = path.substr(0, slash + 1);
+    std::printf("%s: %.1f MB\n", path.c_str(), std::filesystem::file_size(path) / 1e6);
+
+    // The scene as the native loader sees it.
+    {
+        aartze::importer::GltfScene scene;
+        std::string error;
+        auto t0 = Clock::now();
+        if (!aartze::importer::LoadGltf(path, scene, &error))
+        {
+            std::printf("%s\n", error.c_str());
+            return 1;
+        }
+        const double ms = MsSince(t0);
+        size_t primitives = 0, borrowed = 0, copied = 0;
+        for (const auto& mesh : scene.meshes)
+            for (const auto& p : mesh.primitives)
+            {
+                ++primitives;
+                for (const auto* s : {&p.positions, &p.normals, &p.texCoords[0]})
+                    if (!s->Empty()) (s->Borrowed() ? borrowed : copied) += s->count * s->components * sizeof(float);
+                if (!p.indices.Empty())
+                    (p.indices.Borrowed() ? borrowed : copied) += p.indices.count * sizeof(uint32_t);
+            }
+        std::printf("%zu meshes, %zu primitives, %zu nodes, %zu materials, %zu skins; LoadGltf %.2f ms, "
+                    "%.1f MB read in place, %.1f MB copied\n\n",
+                    scene.meshes.size(), primitives, scene.nodes.size(), scene.materials.size(), scene.skins.size(),
+                    ms, borrowed / 1e6, copied / 1e6);
+        if (argc <= 1 && (borrowed == 0 || copied == 0))
+        {
+            std::printf("expected both in-place and converted streams\n");
+            ++failures;
+        }
+    }
+
+    Result idle;
+    Measure([](Result&) { return true; }, idle);
+
+    struct Path
+    {
+        const char* name;
+        bool (*run)(const std::string& path, const std::string& directory, Result& r);
+    };
+    const Path paths[] = {
+        {"assimp + convert",
+         [](const std::string& path, const std::string& directory, Result& r) {
+             auto t0 = Clock::now();
+             Assimp::Importer importer;
+             const aiScene* scene = importer.ReadFile(
+                 path, aiProcess_Triangulate | aiProcess_JoinIdenticalVertices | aiProcess_PreTransformVertices);
+             if (!scene || !scene->HasMeshes()) return false;
+             MeshData data = ConvertAssimpScene(scene, directory, true, 1.0f, true);
+             r.ms = MsSince(t0);
+             Summarize(data, r);
+             return true;
+         }},
+        {"native + convert",
+         [](const std::string& path, const std::string&, Result& r) {
+             auto t0 = Clock::now();
+             aartze::importer::GltfScene scene;
+             if (!aartze::importer::LoadGltf(path, scene)) return false;
+             MeshData data = ConvertGltfScene(scene, true, 1.0f);
+             r.ms = MsSince(t0);
+             Summarize(data, r);
+             return true;
+         }},
+        {"assimp full import",
+         [](const std::string& path, const std::string&, Result& r) {
+             auto t0 = Clock::now();
+             MeshData data = ImportAssimpFile(path, true, 1.0f, true);
+             r.ms = MsSince(t0);
+             Summarize(data, r);
+             return !data.vertices.empty();
+         }},
+        {"native full import",
+         [](const std::string& path, const std::string&, Result& r) {
+             auto t0 = Clock::now();
+             MeshData data = ImportGltfFile(path, true, 1.0f);
+             r.ms = MsSince(t0);
+             Summarize(data, r);
+             return !data.vertices.empty();
+         }},
+    };
+
+    std::printf("%-20s %10s %10s %11s %10s\n", "path", "ms", "triangles", "vertices", "peak MB");
+    Result results[4];
+    const int runs = 3;
+    for (int i = 0; i < 4; ++i)
+    {
+        Result best;
+        best.ms = 1e30;
+        bool ok = true;
+        for (int run = 0; run < runs && ok; ++run)
+        {
+            Result r;
+            ok = Measure([&](Result& out) { return paths[i].run(path, directory, out); }, r);
+            if (r.ms < best.ms) best = r;
+            best.peakKb = std::max(best.peakKb, r.peakKb);
+        }
+        if (!ok)
+        {
+            std::printf("%-20s failed\n", paths[i].name);
+            ++failures;
+            continue;
+        }
+        results[i] = best;
+        if (best.peakKb >= 0)
+            std::printf("%-20s %10.1f %10llu %11llu %10.1f\n", paths[i].name, best.ms,
+                        (unsigned long long)best.triangles, (unsigned long long)best.vertices,
+                        (best.peakKb - idle.peakKb) / 1024.0);
+        else
+            std::printf("%-20s %10.1f %10llu %11llu %10s\n", paths[i].name, best.ms,
+                        (unsigned long long)best.triangles, (unsigned long long)best.vertices, "n/a");
+    }
+    std::printf("(peak MB is above an idle child's %.1f MB)\n", idle.peakKb / 1024.0);
+
+    // Both paths must draw the same surface; the full imports also agree at LOD 0.
+    for (int i = 0; i < 4; i += 2)
+        if (results[i].triangles && results[i + 1].triangles && !Same(results[i], results[i + 1]))
+        {
+            std::printf("%s and %s disagree: %llu vs %llu triangles, area %.6f vs %.6f\n", paths[i].name,
+                        paths[i + 1].name, (unsigned long long)results[i].triangles,
+                        (unsigned long long)results[i + 1].triangles, results[i].area, results[i + 1].area);
+            ++failures;
+        }
+    if (results[0].ms > 0.0 && results[1].ms > 0.0)
+        std::printf("\nnative load + convert is %.1fx faster, full import %.1fx\n", results[0].ms / results[1].ms,
+                    results[3].ms > 0.0 ? results[2].ms / results[3].ms : 0.0);
+
+    // Damaged files are refused rather than read past their end.
+    if (argc <= 1)
+    {
+        const std::string bad = (dir / "truncated.glb").string();
+        std::filesystem::copy_file(path, bad, std::filesystem::copy_options::overwrite_existing);
+        std::filesystem::resize_file(bad, std::filesystem::file_size(bad) / 2);
+        aartze::importer::GltfScene scene;
+        std::string error;
+        const bool loaded = aartze::importer::LoadGltf(bad, scene, &error);
+        std::printf("truncated file %s%s\n", loaded ? "ACCEPTED" : "rejected: ", loaded ? "" : error.c_str());
+        failures += loaded;
+        std::filesystem::remove_all(dir);
+    }
+    return failures;
+}
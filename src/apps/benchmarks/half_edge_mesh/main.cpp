@@ -0,0 +1,136 @@
+// Builds aartze::geometry::HalfEdgeMesh from the indexed buffers of a
+// 2M-triangle torus and a 2M-triangle open grid, reports build throughput,
+// then runs random edge flips, splits and collapses and checks that the
+// result stays manifold with the same Euler characteristic before and after
+// Compact().
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "aartze/geometry/HalfEdgeMesh.h"
+#include "core/JobSystem.hpp"
+#include "../BenchTimer.h"
+
+namespace {
+
+using aartze::geometry::HalfEdgeMesh;
+using aartze::geometry::TopologyReport;
+
+constexpr float kPi = 3.14159265f;
+
+struct Model
+{
+    const char* name;
+    std::vector<float> positions;
+    std::vector<uint32_t> indices;
+};
+
+// rows x columns quads; `wrap` closes both directions into a torus.
+Model Grid(const char* name, int rows, int columns, bool wrap)
+{
+    Model m{name, {}, {}};
+    const int vr = wrap ? rows : rows + 1, vc = wrap ? columns : columns + 1;
+    m.positions.reserve(size_t(vr) * vc * 3);
+    for (int r = 0; r < vr; ++r)
+        for (int c = 0; c < vc; ++c)
+        {
+            if (wrap)
+            {
+                float u = 2 * kPi * r / rows, v = 2 * kPi * c / columns;
+                m.positions.insert(m.positions.end(), {(2 + std::cos(v)) * std::cos(u), std::sin(v),
+                                                       (2 + std::cos(v)) * std::sin(u)});
+            }
+            else
+                m.positions.insert(m.positions.end(), {float(c), 0.0f, float(r)});
+        }
+    m.indices.reserve(size_t(rows) * columns * 6);
+    for (int r = 0; r < rows; ++r)
+        for (int c = 0; c < columns; ++c)
+        {
+            uint32_t a = r * vc + c, b = r * vc + (c + 1) % vc, d = ((r + 1) % vr) * vc + c,
+                     e = ((r + 1) % vr) * vc + (c + 1) % vc;
+            m.indices.insert(m.indices.end(), {a, d, b, b, d, e});
+        }
+    return m;
+}
+
+long long Euler(const HalfEdgeMesh& mesh, const TopologyReport& report)
+{
+    // Every interior edge has two half-edges, every boundary edge one.
+    const size_t edges = (mesh.LiveFaceCount() * 3 + report.boundaryEdges) / 2;
+    return (long long)mesh.LiveVertexCount() - (long long)edges + (long long)mesh.LiveFaceCount();
+}
+
+void Print(const char* label, const HalfEdgeMesh& mesh, const TopologyReport& r)
+{
+    std::printf("  %-10s V %zu F %zu, boundary edges %zu in %zu loops, non-manifold edges %zu vertices %zu, chi %lld\n",
+                label, mesh.LiveVertexCount(), mesh.LiveFaceCount(), r.boundaryEdges, r.boundaryLoops,
+                r.nonManifoldEdges, r.nonManifoldVertices, Euler(mesh, r));
+}
+
+}  // namespace
+
+int main()
+{
+    int failures = 0;
+    const Model models[] = {Grid("torus", 1000, 1000, true), Grid("grid", 1000, 1000, false)};
+    std::printf("%zu workers\n", gJobSystem.WorkerCount());
+    for (const Model& model : models)
+    {
+        const size_t triangles = model.indices.size() / 3;
+        HalfEdgeMesh mesh;
+        double best = 1e30;
+        for (int run = 0; run < 3; ++run)
+        {
+            auto t0 = Clock::now();
+            mesh.Build(model.positions.data(), sizeof(float) * 3, model.positions.size() / 3, model.indices.data(),
+                       model.indices.size());
+            best = std::min(best, MsSince(t0));
+        }
+        std::printf("%s: %zu triangles, build %.1f ms (%.1f Mtri/s)\n", model.name, triangles, best,
+                    triangles / (best * 1000.0));
+
+        auto t1 = Clock::now();
+        const TopologyReport before = mesh.CheckTopology();
+        std::printf("  topology check %.1f ms\n", MsSince(t1));
+        Print("built", mesh, before);
+        const long long chi = Euler(mesh, before);
+
+        std::mt19937 rng(3);
+        const int operations = 200000;
+        int flips = 0, splits = 0, collapses = 0;
+        auto t2 = Clock::now();
+        for (int i = 0; i < operations; ++i)
+        {
+            const uint32_t h = rng() % mesh.HalfEdgeCount();
+            if (!mesh.FaceAlive(HalfEdgeMesh::Face(h))) continue;
+            switch (i % 3)
+            {
+                case 0: flips += mesh.FlipEdge(h); break;
+                case 1: splits += mesh.SplitEdge(h) != HalfEdgeMesh::kInvalid; break;
+                default: collapses += mesh.CollapseEdge(h); break;
+            }
+        }
+        const double opsMs = MsSince(t2);
+        std::printf("  %d operations in %.1f ms: %d flips, %d splits, %d collapses\n", operations, opsMs, flips, splits,
+                    collapses);
+        const TopologyReport edited = mesh.CheckTopology();
+        Print("edited", mesh, edited);
+
+        auto t3 = Clock::now();
+        mesh.Compact();
+        const double compactMs = MsSince(t3);
+        const TopologyReport compacted = mesh.CheckTopology();
+        Print("compacted", mesh, compacted);
+        std::printf("  compact %.1f ms\n", compactMs);
+
+        const bool ok = edited.Manifold() && compacted.Manifold() && Euler(mesh, compacted) == chi &&
+                        compacted.boundaryLoops == before.boundaryLoops && mesh.FaceCount() == mesh.LiveFaceCount();
+        std::printf("  topology %s\n", ok ? "preserved" : "BROKEN");
+        failures += !ok;
+    }
+    return failures;
+}
@@ -0,0 +1,177 @@
+// Compares the work-stealing JobSystem against the previous single-queue
+// ThreadPool (one mutex, one std::function queue, packaged_task per task) at
+// 1, 4 and 16 worker threads.
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "core/JobSystem.hpp"
+#include "../BenchTimer.h"
+
+namespace {
+
+// Mirrors the old AARTZE/core/ThreadPool.hpp.
+class LegacyPool
+{
+   public:
+    explicit LegacyPool(size_t threads)
+    {
+        for (size_t i = 0; i < threads; ++i)
+        {
+            workers.emplace_back([this]() {
+                for (;;)
+                {
+                    std::function<void()> task;
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        condition.wait(lock, [this]() { return stop || !tasks.empty(); });
+                        if (stop && tasks.empty()) return;
+                        task = std::move(tasks.front());
+                        tasks.pop();
+                    }
+                    task();
+                }
+            });
+        }
+    }
+
+    ~LegacyPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        condition.notify_all();
+        for (std::thread& worker : workers) worker.join();
+    }
+
+    template <class F>
+    std::future<void> enqueue(F&& f)
+    {
+        auto task = std::make_shared<std::packaged_task<void()>>(std::forward<F>(f));
+        std::future<void> res = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.emplace([task]() { (*task)(); });
+        }
+        condition.notify_one();
+        return res;
+    }
+
+   private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool stop = false;
+};
+
+constexpr size_t kTinyTasks = 200000;
+constexpr size_t kElements = 1 << 22;
+constexpr size_t kGrain = 4096;
+
+// Small unit of work so scheduling overhead dominates.
+float Work(size_t i)
+{
+    return std::sqrt(static_cast<float>(i)) * 0.5f;
+}
+
+double TinyLegacy(LegacyPool& pool, std::vector<float>& out)
+{
+    auto t0 = Clock::now();
+    std::vector<std::future<void>> futures;
+    futures.reserve(kTinyTasks);
+    for (size_t i = 0; i < kTinyTasks; ++i) futures.push_back(pool.enqueue([&out, i]() { out[i] = Work(i); }));
+    for (auto& f : futures) f.get();
+    return MsSince(t0);
+}
+
+double TinyJobs(JobSystem& jobs, std::vector<float>& out)
+{
+    auto t0 = Clock::now();
+    JobCounter counter;
+    for (size_t i = 0; i < kTinyTasks; ++i) jobs.Run([&out, i]() { out[i] = Work(i); }, &counter);
+    jobs.Wait(counter);
+    return MsSince(t0);
+}
+
+double ForLegacy(LegacyPool& pool, std::vector<float>& out)
+{
+    auto t0 = Clock::now();
+    std::vector<std::future<void>> futures;
+    for (size_t b = 0; b < out.size(); b += kGrain)
+    {
+        size_t e = std::min(out.size(), b + kGrain);
+        futures.push_back(pool.enqueue([&out, b, e]() {
+            for (size_t i = b; i < e; ++i) out[i] = Work(i);
+        }));
+    }
+    for (auto& f : futures) f.get();
+    return MsSince(t0);
+}
+
+double ForJobs(JobSystem& jobs, std::vector<float>& out)
+{
+    auto t0 = Clock::now();
+    jobs.ParallelFor(0, out.size(), kGrain, [&out](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i) out[i] = Work(i);
+    });
+    return MsSince(t0);
+}
+
+// Nested fork/join: the old pool cannot wait on children from a worker
+// without blocking it, so this only runs on the job system.
+long Fib(JobSystem& jobs, int n)
+{
+    if (n < 16)
+    {
+        long a = 0, b = 1;
+        for (int i = 0; i < n; ++i) { long t = a + b; a = b; b = t; }
+        return a;
+    }
+    long x = 0;
+    JobCounter counter;
+    jobs.Run([&jobs, &x, n]() { x = Fib(jobs, n - 1); }, &counter);
+    long y = Fib(jobs, n - 2);
+    jobs.Wait(counter);
+    return x + y;
+}
+
+}  // namespace
+
+int main()
+{
+    std::vector<float> out(kElements);
+    std::printf("%-8s %-12s %16s %18s %14s\n", "threads", "scheduler", "200k tasks (ms)", "parallel-for (ms)",
+                "fork/join (ms)");
+    for (size_t threads : {size_t(1), size_t(4), size_t(16)})
+    {
+        double tinyLegacy, forLegacy;
+        {
+            LegacyPool pool(threads);
+            tinyLegacy = TinyLegacy(pool, out);
+            forLegacy = ForLegacy(pool, out);
+        }
+        double tinyJobs, forJobs, fibMs;
+        long fib;
+        {
+            JobSystem jobs(threads);
+            tinyJobs = TinyJobs(jobs, out);
+            forJobs = ForJobs(jobs, out);
+            auto t0 = Clock::now();
+            fib = Fib(jobs, 30);
+            fibMs = MsSince(t0);
+        }
+        std::printf("%-8zu %-12s %16.2f %18.2f %14s\n", threads, "threadpool", tinyLegacy, forLegacy, "n/a");
+        std::printf("%-8zu %-12s %16.2f %18.2f %14.2f  (x%.1f tasks, x%.1f for)\n", threads, "jobsystem", tinyJobs,
+                    forJobs, fibMs, tinyLegacy / tinyJobs, forLegacy / forJobs);
+        if (fib != 832040) std::printf("  fork/join result mismatch: %ld\n", fib);
+    }
+    return 0;
+}
@@ -0,0 +1,240 @@
+// Cold-start mesh loading: the Assimp import every load pays today
+// (LoadMeshAny: parse, weld, optimize, LOD chain, then packing the way
+// UploadMesh does) against mapping the same assets cooked to .amesh. Writes
+// a pedestrian, a car and a building block as OBJ files, cooks each once,
+// then times both paths with the files evicted from the page cache before
+// every run (posix_fadvise, Linux; elsewhere the runs are warm). The GL
+// upload is stood in for by copying the final blobs into a staging buffer,
+// which is the copy glBufferData makes. Also checks that the cooked blobs
+// are byte-identical to what UploadMesh would have built.
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "utils/CookedMesh.hpp"
+#include "utils/MeshUtils.hpp"
+#include "../BenchTimer.h"
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr float kPi = 3.14159265f;
+
+// Drop the file's pages so the next read comes from disk.
+bool Evict(const std::string& path)
+{
+#if defined(__linux__)
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    const bool ok = fdatasync(fd) == 0 && posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+    ::close(fd);
+    return ok;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+// Closed lat-long surface with normals and UVs, written as an OBJ with its
+// own UV seam column so the importer has something to weld.
+bool WriteBlob(const std::string& path, int rings, int segments, float rx, float ry, float rz, float bumps)
+{
+    std::FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) return false;
+    for (int r = 0; r <= rings; ++r)
+        for (int s = 0; s <= segments; ++s)
+        {
+            float theta = kPi * r / rings, phi = 2 * kPi * s / segments;
+            float k = 1.0f + bumps * std::sin(7 * theta) * std::sin(5 * phi);
+            float n[3] = {std::sin(theta) * std::cos(phi) / rx, std::cos(theta) / ry, std::sin(theta) * std::sin(phi) / rz};
+            float l = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+            std::fprintf(f, "v %.6f %.6f %.6f\nvn %.5f %.5f %.5f\nvt %.5f %.5f\n",
+                         rx * k * std::sin(theta) * std::cos(phi), ry * k * std::cos(theta),
+                         rz * k * std::sin(theta) * std::sin(phi), n[0] / l, n[1] / l, n[2] / l,
+                         float(s) / segments, float(r) / rings);
+        }
+    const int row = segments + 1;
+    for (int r = 0; r < rings; ++r)
+        for (int s = 0; s < segments; ++s)
+        {
+            int a = r * row + s + 1, b = a + 1, c = a + row, d = c + 1;
+            if (r > 0) std::fprintf(f, "f %d/%d/%d %d/%d/%d %d/%d/%d\n", a, a, a, b, b, b, c, c, c);
+            if (r < rings - 1) std::fprintf(f, "f %d/%d/%d %d/%d/%d %d/%d/%d\n", b, b, b, d, d, d, c, c, c);
+        }
+    return std::fclose(f) == 0;
+}
+
+struct Asset
+{
+    const char* name;
+    int rings, segments;
+    float rx, ry, rz, bumps;
+    std::string source, cooked;
+    size_t sourceBytes = 0, cookedBytes = 0;
+    double cookMs = 0.0;
+};
+
+// Everything UploadMesh builds on the CPU before glBufferData.
+struct Blobs
+{
+    std::vector<PackedVertex> vertices;
+    std::vector<unsigned char> indices;
+};
+
+Blobs BuildUploadBlobs(const MeshData& data)
+{
+    Blobs out;
+    const size_t vcount = data.vertices.size() / 3;
+    out.vertices.resize(vcount);
+    PackMeshVertices(data, out.vertices.data());
+    if (vcount <= 0x10000)
+    {
+        std::vector<uint16_t> shortIndices(data.indices.begin(), data.indices.end());
+        out.indices.resize(shortIndices.size() * sizeof(uint16_t));
+        std::memcpy(out.indices.data(), shortIndices.data(), out.indices.size());
+    }
+    else
+    {
+        out.indices.resize(data.indices.size() * sizeof(uint32_t));
+        std::memcpy(out.indices.data(), data.indices.data(), out.indices.size());
+    }
+    return out;
+}
+
+}  // namespace
+
+int main()
+{
+    int failures = 0;
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "aartze_bench_mesh_cooking";
+    std::filesystem::create_directories(dir);
+    Asset assets[] = {{"pedestrian", 120, 96, 0.25f, 0.9f, 0.2f, 0.04f},
+                      {"car", 160, 120, 2.2f, 0.75f, 0.9f, 0.03f},
+                      {"building", 400, 300, 8.0f, 20.0f, 8.0f, 0.02f}};
+    for (Asset& a : assets)
+    {
+        a.source = (dir / (std::string(a.name) + ".obj")).string();
+        a.cooked = (dir / (std::string(a.name) + ".amesh")).string();
+        if (!WriteBlob(a.source, a.rings, a.segments, a.rx, a.ry, a.rz, a.bumps))
+        {
+            std::printf("could not write %s\n", a.source.c_str());
+            return 1;
+        }
+        auto t0 = Clock::now();
+        if (!CookMeshAsset(a.source, a.cooked))
+        {
+            std::printf("cooking %s failed\n", a.name);
+            return 1;
+        }
+        a.cookMs = MsSince(t0);
+        a.sourceBytes = std::filesystem::file_size(a.source);
+        a.cookedBytes = std::filesystem::file_size(a.cooked);
+    }
+
+    const bool cold = Evict(assets[0].source);
+    std::printf("%s runs; staging copy stands in for glBufferData\n\n", cold ? "cold (page cache evicted)" : "warm");
+    std::printf("%-11s %9s %9s %9s %10s %10s %9s %8s\n", "asset", "vertices", "triangles", "cook ms", "assimp ms",
+                "cooked ms", "speedup", "MB/MB");
+    std::vector<unsigned char> staging;
+    const int runs = 5;
+    double totalAssimp = 0.0, totalCooked = 0.0;
+    for (Asset& a : assets)
+    {
+        // Source path: what StreamingSystem and EditorActions did for every load.
+        double assimpMs = 1e30;
+        Blobs reference;
+        MeshData imported;
+        for (int run = 0; run < runs; ++run)
+        {
+            Evict(a.source);
+            auto t0 = Clock::now();
+            imported = LoadMeshAny(a.source, true, 1.0f);
+            reference = BuildUploadBlobs(imported);
+            staging.assign(reinterpret_cast<const unsigned char*>(reference.vertices.data()),
+                           reinterpret_cast<const unsigned char*>(reference.vertices.data() + reference.vertices.size()));
+            staging.insert(staging.end(), reference.indices.begin(), reference.indices.end());
+            assimpMs = std::min(assimpMs, MsSince(t0));
+        }
+
+        // Cooked path: map, validate, copy the blobs out as the driver would.
+        double cookedMs = 1e30;
+        uint32_t vertexCount = 0, lod0Triangles = 0;
+        for (int run = 0; run < runs; ++run)
+        {
+            Evict(a.cooked);
+            auto t0 = Clock::now();
+            MappedFile file;
+            CookedMeshView view;
+            if (!OpenCookedMesh(a.cooked, file, view))
+            {
+                ++failures;
+                break;
+            }
+            const unsigned char* vertices = reinterpret_cast<const unsigned char*>(view.vertices);
+            const unsigned char* indices = static_cast<const unsigned char*>(view.indices);
+            staging.assign(vertices, vertices + view.VertexBytes());
+            staging.insert(staging.end(), indices, indices + view.IndexBytes());
+            cookedMs = std::min(cookedMs, MsSince(t0));
+            vertexCount = view.header->vertexCount;
+            lod0Triangles = view.lods[0].indexCount / 3;
+
+            // The cooked blobs must be exactly what UploadMesh builds from the import.
+            const bool same = view.VertexBytes() == reference.vertices.size() * sizeof(PackedVertex) &&
+                              view.IndexBytes() == reference.indices.size() &&
+                              std::memcmp(vertices, reference.vertices.data(), view.VertexBytes()) == 0 &&
+                              std::memcmp(indices, reference.indices.data(), view.IndexBytes()) == 0 &&
+                              view.header->lodCount == std::max<size_t>(1, imported.lods.size());
+            if (run == 0 && !same)
+            {
+                std::printf("%s: cooked blobs differ from the imported mesh\n", a.name);
+                ++failures;
+            }
+        }
+
+        totalAssimp += assimpMs;
+        totalCooked += cookedMs;
+        std::printf("%-11s %9u %9u %9.1f %10.2f %10.2f %8.0fx %4.1f/%3.1f\n", a.name, vertexCount, lod0Triangles, a.cookMs,
+                    assimpMs, cookedMs, assimpMs / cookedMs, a.sourceBytes / 1e6, a.cookedBytes / 1e6);
+    }
+    std::printf("\nall assets: assimp %.1f ms, cooked %.2f ms (%.0fx)\n", totalAssimp, totalCooked,
+                totalAssimp / totalCooked);
+
+    // Damaged files are refused rather than uploaded.
+    {
+        std::string bad = (dir / "truncated.amesh").string();
+        std::filesystem::copy_file(assets[0].cooked, bad, std::filesystem::copy_options::overwrite_existing);
+        std::filesystem::resize_file(bad, std::filesystem::file_size(bad) / 2);
+        MappedFile file;
+        CookedMeshView view;
+        const bool opened = OpenCookedMesh(bad, file, view);
+        std::printf("truncated file %s\n", opened ? "ACCEPTED" : "rejected");
+        failures += opened;
+    }
+    {
+        // A whole file whose first index points past the vertices.
+        std::string bad = (dir / "bad_index.amesh").string();
+        std::filesystem::copy_file(assets[0].cooked, bad, std::filesystem::copy_options::overwrite_existing);
+        std::FILE* f = std::fopen(bad.c_str(), "r+b");
+        AmeshHeader header;
+        const bool patched = f && std::fread(&header, sizeof(header), 1, f) == 1 &&
+                             std::fseek(f, long(header.indexOffset), SEEK_SET) == 0 &&
+                             std::fwrite("\xff\xff\xff\xff", header.indexSize, 1, f) == 1;
+        if (f) std::fclose(f);
+        MappedFile file;
+        CookedMeshView view;
+        const bool opened = OpenCookedMesh(bad, file, view);
+        std::printf("out-of-range index %s\n", opened ? "ACCEPTED" : "rejected");
+        failures += opened || !patched;
+    }
+    std::filesystem::remove_all(dir);
+    return failures;
+}
@@ -0,0 +1,199 @@
+// Runs the import-time mesh optimization (MeshOps: weld, vertex cache,
+// overdraw, vertex fetch) on procedural sample meshes and reports the
+// post-transform cache efficiency before and after: ACMR (vertices
+// transformed per triangle) and ATVR (vertices transformed per unique vertex)
+// for 16- and 32-entry FIFO caches, plus the time each stage takes.
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "aartze/geometry/MeshOps.h"
+#include "../BenchTimer.h"
+
+namespace {
+
+using aartze::geometry::MeshOps;
+using aartze::geometry::VertexStream;
+
+struct Vertex
+{
+    float position[3];
+    float normal[3];
+    float uv[2];
+};
+
+// One vertex per triangle corner, as the engine's loaders emit them.
+struct Sample
+{
+    std::string name;
+    std::vector<Vertex> corners;
+};
+
+constexpr float kPi = 3.14159265f;
+
+Vertex MakeVertex(float x, float y, float z, float nx, float ny, float nz, float u, float v)
+{
+    return {{x, y, z}, {nx, ny, nz}, {u, v}};
+}
+
+void AddQuad(Sample& s, const Vertex& a, const Vertex& b, const Vertex& c, const Vertex& d)
+{
+    s.corners.insert(s.corners.end(), {a, b, c, a, c, d});
+}
+
+Sample Sphere(int rings, int segments)
+{
+    Sample s{"uv sphere", {}};
+    auto at = [&](int r, int g) {
+        float theta = kPi * r / rings, phi = 2 * kPi * g / segments;
+        float x = std::sin(theta) * std::cos(phi), y = std::cos(theta), z = std::sin(theta) * std::sin(phi);
+        return MakeVertex(x, y, z, x, y, z, float(g) / segments, float(r) / rings);
+    };
+    for (int r = 0; r < rings; ++r)
+        for (int g = 0; g < segments; ++g) AddQuad(s, at(r, g), at(r + 1, g), at(r + 1, g + 1), at(r, g + 1));
+    return s;
+}
+
+Sample Torus(int rings, int sides)
+{
+    Sample s{"torus", {}};
+    auto at = [&](int r, int d) {
+        float u = 2 * kPi * r / rings, v = 2 * kPi * d / sides;
+        float nx = std::cos(v) * std::cos(u), ny = std::sin(v), nz = std::cos(v) * std::sin(u);
+        return MakeVertex(std::cos(u) * (1 + 0.3f * std::cos(v)), 0.3f * ny, std::sin(u) * (1 + 0.3f * std::cos(v)),
+                          nx, ny, nz, float(r) / rings, float(d) / sides);
+    };
+    // Column-major walk: long strides between neighbouring quads.
+    for (int d = 0; d < sides; ++d)
+        for (int r = 0; r < rings; ++r) AddQuad(s, at(r, d), at(r + 1, d), at(r + 1, d + 1), at(r, d + 1));
+    return s;
+}
+
+// Terrain grid whose triangles arrive in random order, like an exporter that
+// doesn't care about locality.
+Sample ShuffledGrid(int n)
+{
+    Sample s{"shuffled grid", {}};
+    auto at = [&](int x, int z) {
+        float h = 0.1f * std::sin(x * 0.2f) * std::cos(z * 0.2f);
+        return MakeVertex(float(x), h, float(z), 0, 1, 0, float(x) / n, float(z) / n);
+    };
+    for (int z = 0; z < n; ++z)
+        for (int x = 0; x < n; ++x) AddQuad(s, at(x, z), at(x, z + 1), at(x + 1, z + 1), at(x + 1, z));
+    std::vector<std::array<Vertex, 3>> triangles(s.corners.size() / 3);
+    std::copy(s.corners.begin(), s.corners.end(), &triangles[0][0]);
+    std::shuffle(triangles.begin(), triangles.end(), std::mt19937(11));
+    std::copy(&triangles[0][0], &triangles[0][0] + s.corners.size(), s.corners.begin());
+    return s;
+}
+
+// Hard-edged boxes: welding has to keep per-face normals apart.
+Sample BoxField(int count)
+{
+    Sample s{"box field", {}};
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> unit(-20.0f, 20.0f);
+    for (int i = 0; i < count; ++i)
+    {
+        float c[3] = {unit(rng), unit(rng), unit(rng)};
+        for (int axis = 0; axis < 3; ++axis)
+            for (float sign : {-1.0f, 1.0f})
+            {
+                int u = (axis + 1) % 3, v = (axis + 2) % 3;
+                Vertex q[4];
+                for (int k = 0; k < 4; ++k)
+                {
+                    float p[3] = {c[0], c[1], c[2]}, n[3] = {0, 0, 0};
+                    p[axis] += sign;
+                    p[u] += (k == 1 || k == 2) ? 1.0f : -1.0f;
+                    p[v] += (k >= 2) ? 1.0f : -1.0f;
+                    n[axis] = sign;
+                    q[k] = MakeVertex(p[0], p[1], p[2], n[0], n[1], n[2], float(k & 1), float(k >> 1));
+                }
+                if (sign > 0) AddQuad(s, q[0], q[1], q[2], q[3]);
+                else AddQuad(s, q[0], q[3], q[2], q[1]);
+            }
+    }
+    return s;
+}
+
+// Order-independent triangle set, for checking nothing was lost or flipped.
+std::vector<std::array<float, 9>> TriangleSet(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
+{
+    std::vector<std::array<float, 9>> set(indices.size() / 3);
+    for (size_t t = 0; t < set.size(); ++t)
+    {
+        // Rotate so the smallest index-independent corner comes first; winding is kept.
+        std::array<std::array<float, 3>, 3> c;
+        for (int k = 0; k < 3; ++k)
+            for (int a = 0; a < 3; ++a) c[k][a] = vertices[indices[t * 3 + k]].position[a];
+        int first = int(std::min_element(c.begin(), c.end()) - c.begin());
+        for (int k = 0; k < 3; ++k)
+            for (int a = 0; a < 3; ++a) set[t][k * 3 + a] = c[(first + k) % 3][a];
+    }
+    std::sort(set.begin(), set.end());
+    return set;
+}
+
+void Report(const char* label, const std::vector<uint32_t>& indices, size_t vertexCount)
+{
+    auto s16 = MeshOps::AnalyzeVertexCache(indices.data(), indices.size(), vertexCount, 16);
+    auto s32 = MeshOps::AnalyzeVertexCache(indices.data(), indices.size(), vertexCount, 32);
+    std::printf("  %-8s ACMR %5.3f / %5.3f   ATVR %5.3f / %5.3f\n", label, s16.acmr, s32.acmr, s16.atvr, s32.atvr);
+}
+
+}  // namespace
+
+int main()
+{
+    const Sample samples[] = {Sphere(128, 256), Torus(256, 96), ShuffledGrid(256), BoxField(5000)};
+    std::printf("cache sizes 16 / 32\n");
+    for (const Sample& sample : samples)
+    {
+        const size_t corners = sample.corners.size();
+        const VertexStream stream{sample.corners.data(), sizeof(Vertex), sizeof(Vertex)};
+
+        auto t0 = Clock::now();
+        std::vector<uint32_t> remap(corners);
+        const size_t unique = MeshOps::Weld(remap.data(), nullptr, corners, corners, &stream, 1);
+        std::vector<Vertex> vertices(unique);
+        MeshOps::RemapVertexBuffer(vertices.data(), sample.corners.data(), corners, sizeof(Vertex), remap.data());
+        std::vector<uint32_t> indices(corners);
+        MeshOps::RemapIndexBuffer(indices.data(), nullptr, corners, remap.data());
+        const double weldMs = MsSince(t0);
+        const std::vector<uint32_t> welded = indices;
+
+        auto t1 = Clock::now();
+        MeshOps::OptimizeVertexCache(indices.data(), indices.data(), indices.size(), unique);
+        const double cacheMs = MsSince(t1);
+        const std::vector<uint32_t> cacheOnly = indices;
+
+        auto t2 = Clock::now();
+        MeshOps::OptimizeOverdraw(indices.data(), indices.data(), indices.size(), vertices[0].position, unique,
+                                  sizeof(Vertex));
+        const double overdrawMs = MsSince(t2);
+
+        auto t3 = Clock::now();
+        std::vector<uint32_t> fetch(unique);
+        const size_t used = MeshOps::OptimizeVertexFetch(fetch.data(), indices.data(), indices.size(), unique);
+        std::vector<Vertex> ordered(used);
+        MeshOps::RemapVertexBuffer(ordered.data(), vertices.data(), unique, sizeof(Vertex), fetch.data());
+        MeshOps::RemapIndexBuffer(indices.data(), indices.data(), indices.size(), fetch.data());
+        const double fetchMs = MsSince(t3);
+
+        const bool intact = TriangleSet(vertices, welded) == TriangleSet(ordered, indices);
+        std::printf("%s: %zu triangles, %zu corners welded to %zu vertices, triangles %s\n", sample.name.c_str(),
+                    corners / 3, corners, unique, intact ? "preserved" : "CHANGED");
+        Report("welded", welded, unique);
+        Report("cache", cacheOnly, unique);
+        Report("final", indices, used);
+        std::printf("  weld %.2f ms, cache %.2f ms, overdraw %.2f ms, fetch %.2f ms\n", weldMs, cacheMs, overdrawMs,
+                    fetchMs);
+    }
+    return 0;
+}
@@ -0,0 +1,169 @@
+// Measures the CPU culling stages RenderQueue runs before submission on a
+// dense city: 50,000 boxes (buildings plus street props) on a block grid
+// centred on Downtown, seen from street level. Reports how much the frustum
+// and the Hi-Z occlusion stage remove and what each stage costs.
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "core/JobSystem.hpp"
+#include "systems/RenderingSystem/FrustumCulling.hpp"
+#include "systems/RenderingSystem/OcclusionCulling.hpp"
+#include "World/ZoneRegistry.hpp"
+#include "../BenchTimer.h"
+
+namespace {
+
+constexpr int kBlocks = 40;            // kBlocks x kBlocks city blocks
+constexpr float kBlockSize = 30.0f;    // building footprint + sidewalk
+constexpr float kStreetWidth = 10.0f;
+constexpr int kBoxes = 50000;
+constexpr int kFrames = 60;
+constexpr std::size_t kMaxOccluders = 48;
+
+struct Box
+{
+    float mn[3], mx[3];
+    bool occluder;
+};
+
+void Perspective(float m[16], float fovy, float aspect, float n, float f)
+{
+    float t = 1.0f / std::tan(fovy / 2);
+    std::fill(m, m + 16, 0.0f);
+    m[0] = t / aspect; m[5] = t; m[10] = (f + n) / (n - f); m[11] = -1.0f; m[14] = 2 * f * n / (n - f);
+}
+
+void LookAlong(float m[16], const float eye[3], float yaw)
+{
+    // Right-handed view looking along (cos yaw, 0, sin yaw).
+    float F[3] = {std::cos(yaw), 0.0f, std::sin(yaw)};
+    float S[3] = {-F[2], 0.0f, F[0]};
+    float U[3] = {0.0f, 1.0f, 0.0f};
+    float r[16] = {S[0], U[0], -F[0], 0, S[1], U[1], -F[1], 0, S[2], U[2], -F[2], 0, 0, 0, 0, 1};
+    for (int i = 0; i < 16; ++i) m[i] = r[i];
+    for (int row = 0; row < 3; ++row) m[12 + row] = -(r[row] * eye[0] + r[4 + row] * eye[1] + r[8 + row] * eye[2]);
+}
+
+std::vector<Box> BuildCity(const float origin[3])
+{
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<Box> boxes;
+    boxes.reserve(kBoxes);
+    const float pitch = kBlockSize + kStreetWidth;
+    const float half = kBlocks * pitch * 0.5f;
+    for (int bz = 0; bz < kBlocks; ++bz)
+        for (int bx = 0; bx < kBlocks; ++bx)
+        {
+            float x0 = origin[0] - half + bx * pitch, z0 = origin[2] - half + bz * pitch;
+            float height = 10.0f + 50.0f * unit(rng);
+            boxes.push_back({{x0 + 2, 0, z0 + 2}, {x0 + kBlockSize - 2, height, z0 + kBlockSize - 2}, true});
+        }
+    const std::size_t buildings = boxes.size();
+    while (boxes.size() < kBoxes)
+    {
+        // Props (cars, kiosks, lamps) scattered over the blocks and streets.
+        const Box& block = boxes[std::size_t(unit(rng) * buildings) % buildings];
+        float x = block.mn[0] - kStreetWidth + unit(rng) * (kBlockSize + kStreetWidth);
+        float z = block.mn[2] - kStreetWidth + unit(rng) * (kBlockSize + kStreetWidth);
+        float s = 0.5f + 2.0f * unit(rng);
+        boxes.push_back({{x, 0, z}, {x + s, s * (0.5f + unit(rng)), z + s}, false});
+    }
+    return boxes;
+}
+
+}  // namespace
+
+int main()
+{
+    float origin[3] = {0.0f, 0.0f, 0.0f};
+    for (const auto& [name, position] : ZonePositions)
+        if (name == "Downtown") std::copy(position.begin(), position.end(), origin);
+    const std::vector<Box> boxes = BuildCity(origin);
+    const std::size_t n = boxes.size();
+
+    std::vector<float> sx(n), sy(n), sz(n), sr(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const Box& b = boxes[i];
+        sx[i] = 0.5f * (b.mn[0] + b.mx[0]); sy[i] = 0.5f * (b.mn[1] + b.mx[1]); sz[i] = 0.5f * (b.mn[2] + b.mx[2]);
+        float dx = b.mx[0] - sx[i], dy = b.mx[1] - sy[i], dz = b.mx[2] - sz[i];
+        sr[i] = std::sqrt(dx * dx + dy * dy + dz * dz);
+    }
+
+    float proj[16];
+    Perspective(proj, 60.0f * 3.1415926f / 180.0f, 16.0f / 9.0f, 0.1f, 1000.0f);
+    OcclusionBuffer occlusion;
+    std::vector<uint8_t> visible(n);
+    std::vector<std::size_t> occluders;
+    double frustumMs = 0, rasterMs = 0, pyramidMs = 0, testMs = 0;
+    std::uint64_t inFrustum = 0, occluded = 0;
+
+    for (int f = 0; f < kFrames; ++f)
+    {
+        // Walk down the street between the first two block rows, turning slowly.
+        const float pitch = kBlockSize + kStreetWidth;
+        float eye[3] = {origin[0] - kBlocks * pitch * 0.5f + f * 4.0f, 1.7f,
+                        origin[2] - kBlocks * pitch * 0.5f + kBlocks / 2 * pitch - kStreetWidth * 0.5f};
+        float view[16];
+        LookAlong(view, eye, 0.3f * std::sin(f * 0.1f));
+        const Frustum frustum = ExtractFrustum(proj, view);
+
+        auto t0 = Clock::now();
+        std::size_t passed = CullSpheres(frustum, sx.data(), sy.data(), sz.data(), sr.data(), visible.data(), n);
+        frustumMs += MsSince(t0);
+        inFrustum += passed;
+
+        auto t1 = Clock::now();
+        occluders.clear();
+        for (std::size_t i = 0; i < n; ++i)
+            if (visible[i] && boxes[i].occluder) occluders.push_back(i);
+        auto score = [&](std::size_t i) {
+            const float* vp = frustum.viewProj;
+            return sr[i] / std::max(vp[3] * sx[i] + vp[7] * sy[i] + vp[11] * sz[i] + vp[15], 0.1f);
+        };
+        if (occluders.size() > kMaxOccluders)
+        {
+            std::nth_element(occluders.begin(), occluders.begin() + kMaxOccluders, occluders.end(),
+                             [&](std::size_t a, std::size_t b) { return score(a) > score(b); });
+            occluders.resize(kMaxOccluders);
+        }
+        occlusion.Clear();
+        for (std::size_t i : occluders) occlusion.RasterizeBox(frustum.viewProj, boxes[i].mn, boxes[i].mx);
+        rasterMs += MsSince(t1);
+
+        auto t2 = Clock::now();
+        occlusion.BuildPyramid();
+        pyramidMs += MsSince(t2);
+
+        auto t3 = Clock::now();
+        std::atomic<std::uint64_t> hidden{0};
+        gJobSystem.ParallelFor(0, n, 1024, [&](std::size_t first, std::size_t last) {
+            std::uint64_t local = 0;
+            for (std::size_t i = first; i < last; ++i)
+                if (visible[i] && !boxes[i].occluder && !occlusion.IsVisible(frustum.viewProj, boxes[i].mn, boxes[i].mx))
+                    ++local;
+            hidden.fetch_add(local, std::memory_order_relaxed);
+        });
+        testMs += MsSince(t3);
+        occluded += hidden.load();
+    }
+
+    const double total = double(n) * kFrames;
+    std::printf("%zu boxes (%d buildings), %dx%d occlusion buffer, %d frames\n", n, kBlocks * kBlocks,
+                occlusion.Width(), occlusion.Height(), kFrames);
+    std::printf("%-22s %10.1f%%\n", "frustum culled", 100.0 * (total - inFrustum) / total);
+    std::printf("%-22s %10.1f%%\n", "occlusion culled", 100.0 * occluded / total);
+    std::printf("%-22s %10.1f%%\n", "of in-frustum", inFrustum ? 100.0 * occluded / inFrustum : 0.0);
+    std::printf("%-22s %10.1f%%\n", "total culled", 100.0 * (total - inFrustum + occluded) / total);
+    std::printf("%-22s %10.3f ms\n", "frustum test", frustumMs / kFrames);
+    std::printf("%-22s %10.3f ms\n", "occluder raster", rasterMs / kFrames);
+    std::printf("%-22s %10.3f ms\n", "pyramid build", pyramidMs / kFrames);
+    std::printf("%-22s %10.3f ms\n", "occlusion test", testMs / kFrames);
+    return 0;
+}
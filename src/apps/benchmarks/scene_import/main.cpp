@@ -0,0 +1,398 @@
+// Assimp scene import: the serial push_back loop LoadFbxModel and
+// LoadGltfModel used to run over every face corner of every aiMesh, against
+// ConvertAssimpScene, which sizes the streams up front, copies each mesh's
+// vertices once and writes its triangles as offset indices, as parallel jobs
+// over ranges of the meshes (large ones split into 16K-face ranges). The
+// scene is built in memory: 500 grid patches of mixed size with normals, UVs
+// and a material each, some with vertex colours, a few large enough to be
+// split and a few carrying point faces. Then the whole ImportAssimpFile
+// (parse, convert, optimize without the weld, LOD chain) is timed against the
+// same stages with the serial loop and the full weld it needed, on the scene
+// written out as an OBJ. Pass a model path to use that instead. Also checks
+// that every stream, read through the indices, is bitwise identical to the
+// serial loop's at every thread count, and that both imports keep the same
+// triangles.
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "utils/MeshUtils.hpp"
+#include "../BenchTimer.h"
+
+namespace {
+
+// Tessellated quad of `cells` x `cells` cells, bent a little so the normals
+// vary, placed at `offset`.
+aiMesh* MakePatch(int cells, const float offset[3], unsigned material, bool withColors, bool withPoints)
+{
+    const int row = cells + 1;
+    aiMesh* mesh = new aiMesh();
+    mesh->mPrimitiveTypes = aiPrimitiveType_TRIANGLE | (withPoints ? aiPrimitiveType_POINT : 0);
+    mesh->mMaterialIndex = material;
+    mesh->mNumVertices = row * row;
+    mesh->mVertices = new aiVector3D[mesh->mNumVertices];
+    mesh->mNormals = new aiVector3D[mesh->mNumVertices];
+    mesh->mTextureCoords[0] = new aiVector3D[mesh->mNumVertices];
+    mesh->mNumUVComponents[0] = 2;
+    if (withColors) mesh->mColors[0] = new aiColor4D[mesh->mNumVertices];
+    for (int z = 0; z < row; ++z)
+        for (int x = 0; x < row; ++x)
+        {
+            const unsigned i = z * row + x;
+            const float u = float(x) / cells, v = float(z) / cells;
+            const float height = 0.25f * std::sin(u * 6.0f) * std::cos(v * 4.0f);
+            mesh->mVertices[i] = aiVector3D(offset[0] + u * 4.0f, offset[1] + height, offset[2] + v * 4.0f);
+            aiVector3D n(-1.5f * std::cos(u * 6.0f) * std::cos(v * 4.0f) / 4.0f, 1.0f,
+                         std::sin(u * 6.0f) * std::sin(v * 4.0f) / 4.0f);
+            mesh->mNormals[i] = n.Normalize();
+            mesh->mTextureCoords[0][i] = aiVector3D(u, v, 0.0f);
+            if (withColors) mesh->mColors[0][i] = aiColor4D(u, v, 1.0f - u, 1.0f);
+        }
+    const unsigned points = withPoints ? 3 : 0;
+    mesh->mNumFaces = cells * cells * 2 + points;
+    mesh->mFaces = new aiFace[mesh->mNumFaces];
+    unsigned f = 0;
+    for (int z = 0; z < cells; ++z)
+        for (int x = 0; x < cells; ++x)
+        {
+            const unsigned a = z * row + x, b = a + 1, c = a + row, d = c + 1;
+            const unsigned quad[2][3] = {{a, c, b}, {b, c, d}};
+            for (const auto& tri : quad)
+            {
+                // Points land among the triangles, as Assimp leaves them.
+                if (f == mesh->mNumFaces / 2 && points)
+                    for (unsigned p = 0; p < points; ++p, ++f)
+                    {
+                        mesh->mFaces[f].mNumIndices = 1;
+                        mesh->mFaces[f].mIndices = new unsigned[1]{p};
+                    }
+                mesh->mFaces[f].mNumIndices = 3;
+                mesh->mFaces[f].mIndices = new unsigned[3]{tri[0], tri[1], tri[2]};
+                ++f;
+            }
+        }
+    return mesh;
+}
+
+aiScene* MakeScene(unsigned meshCount, unsigned materialCount)
+{
+    aiScene* scene = new aiScene();
+    scene->mRootNode = new aiNode();
+    scene->mNumMaterials = materialCount;
+    scene->mMaterials = new aiMaterial*[materialCount];
+    for (unsigned m = 0; m < materialCount; ++m)
+    {
+        scene->mMaterials[m] = new aiMaterial();
+        const aiColor3D diffuse(0.2f + 0.1f * m, 0.5f, 0.9f - 0.1f * m);
+        scene->mMaterials[m]->AddProperty(&diffuse, 1, AI_MATKEY_COLOR_DIFFUSE);
+        if (m % 2 == 0)
+        {
+            aiString file(("patch" + std::to_string(m) + ".png").c_str());
+            scene->mMaterials[m]->AddProperty(&file, AI_MATKEY_TEXTURE_DIFFUSE(0));
+        }
+    }
+    scene->mNumMeshes = meshCount;
+    scene->mMeshes = new aiMesh*[meshCount];
+    uint32_t seed = 12345;
+    for (unsigned m = 0; m < meshCount; ++m)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        const int cells = m % 100 == 7 ? 128 : 4 + int(seed >> 8) % 44;
+        const float offset[3] = {float(m % 25) * 5.0f, float(m % 3), float(m / 25) * 5.0f};
+        scene->mMeshes[m] = MakePatch(cells, offset, m % materialCount, m % 5 == 0, m % 50 == 3);
+    }
+    return scene;
+}
+
+// The loop LoadFbxModel ran before, minus the four zero bone indices and
+// weights per corner nothing read. It now skips point and line faces, which
+// the old loop read three indices from regardless.
+MeshData SerialConvert(const aiScene* scene, const std::string& directory, bool normalize, float scaleFactor)
+{
+    MeshData data;
+    float minX = std::numeric_limits<float>::max(), minY = minX, minZ = minX;
+    float maxX = std::numeric_limits<float>::lowest(), maxY = maxX, maxZ = maxX;
+    for (unsigned m = 0; m < scene->mNumMeshes; ++m)
+    {
+        const aiMesh* mesh = scene->mMeshes[m];
+        for (unsigned i = 0; i < mesh->mNumFaces; ++i)
+        {
+            const aiFace& face = mesh->mFaces[i];
+            if (face.mNumIndices != 3) continue;
+            for (unsigned j = 0; j < 3; ++j)
+            {
+                const unsigned index = face.mIndices[j];
+                const auto& v = mesh->mVertices[index];
+                data.vertices.push_back(v.x);
+                data.vertices.push_back(v.y);
+                data.vertices.push_back(v.z);
+                aiVector3D n(0.0f, 0.0f, 1.0f);
+                if (mesh->HasNormals()) n = mesh->mNormals[index];
+                data.normals.push_back(n.x);
+                data.normals.push_back(n.y);
+                data.normals.push_back(n.z);
+                aiVector3D uv(0.0f, 0.0f, 0.0f);
+                if (mesh->HasTextureCoords(0)) uv = mesh->mTextureCoords[0][index];
+                data.texCoords.push_back(uv.x);
+                data.texCoords.push_back(uv.y);
+                aiColor3D color(1.0f, 1.0f, 1.0f);
+                if (mesh->HasVertexColors(0))
+                {
+                    const auto& c = mesh->mColors[0][index];
+                    color = aiColor3D(c.r, c.g, c.b);
+                }
+                else if (mesh->mMaterialIndex < scene->mNumMaterials)
+                {
+                    scene->mMaterials[mesh->mMaterialIndex]->Get(AI_MATKEY_COLOR_DIFFUSE, color);
+                }
+                data.colors.push_back(color.r);
+                data.colors.push_back(color.g);
+                data.colors.push_back(color.b);
+                minX = std::min(minX, v.x);
+                minY = std::min(minY, v.y);
+                minZ = std::min(minZ, v.z);
+                maxX = std::max(maxX, v.x);
+                maxY = std::max(maxY, v.y);
+                maxZ = std::max(maxZ, v.z);
+            }
+        }
+        if (mesh->mMaterialIndex < scene->mNumMaterials)
+        {
+            aiString texPath;
+            if (scene->mMaterials[mesh->mMaterialIndex]->GetTexture(aiTextureType_DIFFUSE, 0, &texPath) == AI_SUCCESS)
+                data.texturePaths.push_back(directory + texPath.C_Str());
+            else
+                data.texturePaths.emplace_back();
+        }
+    }
+    const float centerX = (minX + maxX) * 0.5f, centerY = (minY + maxY) * 0.5f, centerZ = (minZ + maxZ) * 0.5f;
+    const float maxExtent = std::max({maxX - minX, maxY - minY, maxZ - minZ});
+    const bool fit = normalize && maxExtent > 0.0f;
+    const float scale = fit ? 2.0f / maxExtent * scaleFactor : scaleFactor;
+    for (size_t i = 0; i < data.vertices.size(); i += 3)
+    {
+        data.vertices[i] = fit ? (data.vertices[i] - centerX) * scale : data.vertices[i] * scale;
+        data.vertices[i + 1] = fit ? (data.vertices[i + 1] - centerY) * scale : data.vertices[i + 1] * scale;
+        data.vertices[i + 2] = fit ? (data.vertices[i + 2] - centerZ) * scale : data.vertices[i + 2] * scale;
+    }
+    return data;
+}
+
+// Write the generated scene as an OBJ with its .mtl next to it, one group
+// per mesh. Vertex colours are left out: Assimp's OBJ reader only takes them
+// when every vertex of the file has one.
+bool WriteObj(const aiScene* scene, const std::string& path, const std::string& mtlName)
+{
+    std::FILE* mtl = std::fopen((std::filesystem::path(path).parent_path() / mtlName).string().c_str(), "w");
+    if (!mtl) return false;
+    for (unsigned m = 0; m < scene->mNumMaterials; ++m)
+    {
+        aiColor3D diffuse(1.0f, 1.0f, 1.0f);
+        scene->mMaterials[m]->Get(AI_MATKEY_COLOR_DIFFUSE, diffuse);
+        std::fprintf(mtl, "newmtl material%u\nKd %.6f %.6f %.6f\n", m, diffuse.r, diffuse.g, diffuse.b);
+        aiString texture;
+        if (scene->mMaterials[m]->GetTexture(aiTextureType_DIFFUSE, 0, &texture) == AI_SUCCESS)
+            std::fprintf(mtl, "map_Kd %s\n", texture.C_Str());
+    }
+    if (std::fclose(mtl) != 0) return false;
+
+    std::FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) return false;
+    std::fprintf(f, "mtllib %s\n", mtlName.c_str());
+    size_t base = 1;
+    for (unsigned m = 0; m < scene->mNumMeshes; ++m)
+    {
+        const aiMesh* mesh = scene->mMeshes[m];
+        std::fprintf(f, "g patch%u\nusemtl material%u\n", m, mesh->mMaterialIndex);
+        for (unsigned v = 0; v < mesh->mNumVertices; ++v)
+        {
+            const aiVector3D& p = mesh->mVertices[v];
+            const aiVector3D& n = mesh->mNormals[v];
+            const aiVector3D& uv = mesh->mTextureCoords[0][v];
+            std::fprintf(f, "v %.6f %.6f %.6f\nvn %.5f %.5f %.5f\nvt %.5f %.5f\n", p.x, p.y, p.z, n.x, n.y, n.z,
+                         uv.x, uv.y);
+        }
+        for (unsigned i = 0; i < mesh->mNumFaces; ++i)
+        {
+            const aiFace& face = mesh->mFaces[i];
+            if (face.mNumIndices == 1)
+            {
+                std::fprintf(f, "p %zu\n", base + face.mIndices[0]);
+                continue;
+            }
+            std::fputc('f', f);
+            for (unsigned j = 0; j < face.mNumIndices; ++j)
+            {
+                const size_t k = base + face.mIndices[j];
+                std::fprintf(f, " %zu/%zu/%zu", k, k, k);
+            }
+            std::fputc('\n', f);
+        }
+        base += mesh->mNumVertices;
+    }
+    return std::fclose(f) == 0;
+}
+
+// The same floats, read through `indices` for `a`, one per corner for `b`.
+bool SameCorners(const std::vector<float>& a, const std::vector<uint32_t>& indices, const std::vector<float>& b,
+                 size_t n)
+{
+    if (indices.size() * n != b.size()) return false;
+    for (size_t c = 0; c < indices.size(); ++c)
+    {
+        if (size_t(indices[c]) * n + n > a.size()) return false;
+        if (std::memcmp(&a[size_t(indices[c]) * n], &b[c * n], n * sizeof(float)) != 0) return false;
+    }
+    return true;
+}
+
+bool SameMesh(const MeshData& indexed, const MeshData& corners)
+{
+    return SameCorners(indexed.vertices, indexed.indices, corners.vertices, 3) &&
+           SameCorners(indexed.normals, indexed.indices, corners.normals, 3) &&
+           SameCorners(indexed.texCoords, indexed.indices, corners.texCoords, 2) &&
+           SameCorners(indexed.colors, indexed.indices, corners.colors, 3) &&
+           indexed.texturePaths == corners.texturePaths;
+}
+
+size_t Lod0Triangles(const MeshData& data)
+{
+    return (data.lods.empty() ? data.indices.size() : data.lods[0].indexCount) / 3;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    int failures = 0;
+    Assimp::Importer importer;
+    std::unique_ptr<aiScene> built;
+    const aiScene* scene = nullptr;
+    std::string path, directory;
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "aartze_bench_scene_import";
+    if (argc > 1)
+    {
+        path = argv[1];
+        scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_JoinIdenticalVertices |
+                                            aiProcess_PreTransformVertices);
+        if (!scene || !scene->HasMeshes())
+        {
+            std::printf("could not read %s: %s\n", argv[1], importer.GetErrorString());
+            return 1;
+        }
+        const size_t slash = path.find_last_of("/\\");
+        if (slash != std::string::npos) directory = path.substr(0, slash + 1);
+    }
+    else
+    {
+        built.reset(MakeScene(500, 8));
+        scene = built.get();
+        std::filesystem::create_directories(dir);
+        path = (dir / "scene.obj").string();
+        if (!WriteObj(scene, path, "scene.mtl"))
+        {
+            std::printf("could not write %s\n", path.c_str());
+            return 1;
+        }
+    }
+    size_t faces = 0;
+    for (unsigned m = 0; m < scene->mNumMeshes; ++m) faces += scene->mMeshes[m]->mNumFaces;
+    std::printf("%s: %u meshes, %zu faces\n\n", argc > 1 ? argv[1] : "generated scene", scene->mNumMeshes, faces);
+
+    const int runs = 5;
+    double serialMs = 1e30;
+    MeshData reference;
+    for (int run = 0; run < runs; ++run)
+    {
+        auto t0 = Clock::now();
+        reference = SerialConvert(scene, directory, true, 1.0f);
+        serialMs = std::min(serialMs, MsSince(t0));
+    }
+    const double corners = reference.vertices.size() / 3.0;
+    std::printf("%-26s %10s %12s %9s\n", "conversion", "ms", "Mcorners/s", "speedup");
+    std::printf("%-26s %10.2f %12.1f %9s\n", "serial push_back", serialMs, corners / serialMs / 1e3, "1.0x");
+
+    // The calling thread works through ParallelFor too, so N workers convert on N + 1 threads.
+    const unsigned hardware = std::max(2u, std::thread::hardware_concurrency());
+    size_t vertices = 0;
+    for (unsigned workers = 1;; workers = std::min(workers * 2, hardware - 1))
+    {
+        JobSystem jobs(workers);
+        double ms = 1e30;
+        for (int run = 0; run < runs; ++run)
+        {
+            auto t0 = Clock::now();
+            MeshData data = ConvertAssimpScene(scene, directory, true, 1.0f, true, jobs);
+            ms = std::min(ms, MsSince(t0));
+            vertices = data.vertices.size() / 3;
+            if (run == 0 && !SameMesh(data, reference))
+            {
+                std::printf("%u threads: streams differ from the serial conversion\n", workers + 1);
+                ++failures;
+            }
+        }
+        const std::string label = "indexed, " + std::to_string(workers + 1) + " threads";
+        std::printf("%-26s %10.2f %12.1f %8.1fx\n", label.c_str(), ms, corners / ms / 1e3, serialMs / ms);
+        if (workers == hardware - 1) break;
+    }
+    std::printf("\n%.0f corners over %zu vertices, %.1f MB of corner streams\n\n", corners, vertices,
+                (reference.vertices.size() + reference.normals.size() + reference.texCoords.size() +
+                 reference.colors.size()) * sizeof(float) / 1e6);
+
+    // Whole import from the file: what ImportAssimpFile did before (serial
+    // loop, weld of every corner) against what it does now.
+    const int importRuns = 3;
+    double beforeMs = 1e30;
+    MeshData before;
+    for (int run = 0; run < importRuns; ++run)
+    {
+        auto t0 = Clock::now();
+        Assimp::Importer fileImporter;
+        const aiScene* fileScene = fileImporter.ReadFile(
+            path, aiProcess_Triangulate | aiProcess_JoinIdenticalVertices | aiProcess_PreTransformVertices);
+        if (!fileScene || !fileScene->HasMeshes())
+        {
+            std::printf("could not read %s: %s\n", path.c_str(), fileImporter.GetErrorString());
+            return 1;
+        }
+        before = SerialConvert(fileScene, directory, true, 1.0f);
+        OptimizeMesh(before);
+        GenerateLods(before);
+        beforeMs = std::min(beforeMs, MsSince(t0));
+    }
+    std::printf("%-26s %10s %12s %11s %9s\n", "ImportAssimpFile", "ms", "triangles", "vertices", "speedup");
+    std::printf("%-26s %10.2f %12zu %11zu %9s\n", "serial + weld", beforeMs, Lod0Triangles(before),
+                before.vertices.size() / 3, "1.0x");
+    for (unsigned workers = 1;; workers = std::min(workers * 2, hardware - 1))
+    {
+        JobSystem jobs(workers);
+        double ms = 1e30;
+        MeshData data;
+        for (int run = 0; run < importRuns; ++run)
+        {
+            auto t0 = Clock::now();
+            data = ImportAssimpFile(path, true, 1.0f, true, jobs);
+            ms = std::min(ms, MsSince(t0));
+        }
+        if (Lod0Triangles(data) != Lod0Triangles(before))
+        {
+            std::printf("%u threads: imported %zu triangles, expected %zu\n", workers + 1, Lod0Triangles(data),
+                        Lod0Triangles(before));
+            ++failures;
+        }
+        const std::string label = "indexed, " + std::to_string(workers + 1) + " threads";
+        std::printf("%-26s %10.2f %12zu %11zu %8.1fx\n", label.c_str(), ms, Lod0Triangles(data),
+                    data.vertices.size() / 3, beforeMs / ms);
+        if (workers == hardware - 1) break;
+    }
+    if (argc <= 1) std::filesystem::remove_all(dir);
+    return failures;
+}